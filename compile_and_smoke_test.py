@@ -21,6 +21,35 @@ EnableDataValidation = 'false' #冒烟测试无需校验一致性
 TEST_CASES = [201, 202, 204, 216, 230, 900]
 TEST_DURATION = 0
 
+# 仅 Mock 版本执行的场景用例: 开启有状态存储, 逐个覆盖 900 以后的 TestCase 以及协程 + 多桶 + 限速的组合。
+# (标签, 追加的配置, 是否分布式 (Coordinator + 2 Agent), 判定)
+#   判定 "failed":     不允许任何失败请求
+#   判定 "validation": 只要求 Internal Validation Fail 为 0 (热点 Key 混合中的 DELETE 会带来预期内的 404)
+#   判定 "requests=N": 不允许失败, 且总请求数恰好为 N (多桶建桶每个桶只建一次)
+# 热点 Key 每个版本写入不同内容, 校验须被自动关闭 (改由 ETag 判定), 因此 930 开启数据校验运行
+MOCK_CONFIG = 'smoke_mock.dat'
+MOCK_TRACE_FILE = 'smoke_trace.csv'
+MOCK_BASE_OVERRIDES = "\nMockStore=true\nUsers=1\nThreadsPerUser=2\nRunSeconds=0\n"
+MOCK_CASES = [
+    ("910", f"TestCase=910\nTraceFile={MOCK_TRACE_FILE}\nRequestsPerThread=0\n", False, "failed"),
+    ("920", "TestCase=920\nVisibilityReaders=1\nRequestsPerThread=5\n", False, "failed"),
+    ("930", "TestCase=930\nEnableDataValidation=true\nRunSeconds=2\n", False, "validation"),
+    ("930-dist", "TestCase=930\nEnableDataValidation=true\nRunSeconds=2\n", True, "validation"),
+    ("940", "TestCase=940\nChurnWorkingSet=64\nRequestsPerThread=200\n", False, "failed"),
+    ("950", "TestCase=950\nRequestsPerThread=2\n", False, "failed"),
+    ("970", "TestCase=970\nPfsTreeDepth=2\nPfsTreeFanout=2\nPfsFilesPerLeaf=2\n", False, "failed"),
+    ("980", "TestCase=980\nRequestsPerThread=20\n", False, "failed"),
+    # 协程让出期间其他虚拟客户端不得改写本请求的桶 / 接入点 (曾出现大量 404)
+    ("900-vc", "TestCase=900\nMixOperation=201,202\nMixLoopCount=1\nRequestsPerThread=20\n"
+               "VirtualClientsPerThread=16\nBucketsPerUser=8\nThreadRateLimitTps=400\n", False, "failed"),
+    ("101-vc", "TestCase=101\nVirtualClientsPerThread=4\nBucketsPerUser=16\n", False, "requests=16"),
+]
+DIST_OVERRIDES = "DistributedAgents=2\nCoordinatorBind=127.0.0.1\nCoordinatorPort=19390\nDistributedStartDelayMs=500\n"
+DIST_AGENTS = 2
+DIST_TOKEN = 'smoke-test-token'
+USERS_FILE = 'users.dat'        # 用户列表; 不存在时临时生成 Mock 凭证
+MOCK_BUILDS = ("Mock", "Mock_ASan")
+
 # 编译任务顺序: (显示名称, Make命令, 产物文件名)
 # 顺序: Mock -> Standard -> Mock_ASan -> ASan
 BUILD_TASKS = [
@@ -107,6 +136,8 @@ class BenchmarkTester:
         if m_failed: stats["failed"] = int(m_failed.group(1))
         m_success = re.search(r"Success:\s+(\d+)", output)
         if m_success: stats["success"] = int(m_success.group(1))
+        m_val = re.search(r"Internal Validation Fail:\s+(\d+)", output)
+        stats["validation"] = int(m_val.group(1)) if m_val else 0
         return stats
 
     def stage_compile_all(self):
@@ -187,9 +218,89 @@ class BenchmarkTester:
                     "Detail": detail
                 })
 
+    def run_mock_case(self, bin_path, overrides, distributed):
+        """Mock 场景用例; 分布式时本机启动 Coordinator 与 DIST_AGENTS 个 Agent, 返回 Coordinator 的 (returncode, 输出)
+        缺少 users.dat 时临时生成 Mock 凭证, 结束后删除"""
+        with open(CONFIG_FILE) as f:
+            text = f.read()
+        with open(MOCK_CONFIG, 'w') as f:
+            f.write(text + MOCK_BASE_OVERRIDES + overrides + (DIST_OVERRIDES if distributed else "DistributedAgents=0\n"))
+        temp_users = not os.path.exists(USERS_FILE)
+        if temp_users:
+            with open(USERS_FILE, 'w') as f:
+                f.write("".join(f"smoke{i},ak{i},sk{i}\n" for i in range(64)))
+        if not distributed:
+            ret, output = self.run_cmd(f"{bin_path} {MOCK_CONFIG}")
+            if temp_users: os.remove(USERS_FILE)
+            return ret, output
+
+        env = dict(self.env, OBS_BENCH_DIST_TOKEN=DIST_TOKEN)
+        coord = subprocess.Popen([bin_path, MOCK_CONFIG], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                 text=True, env=env)
+        time.sleep(0.5)
+        agents = [subprocess.Popen([bin_path, "--agent", "127.0.0.1:19390"], stdout=subprocess.DEVNULL,
+                                   stderr=subprocess.DEVNULL, env=env) for _ in range(DIST_AGENTS)]
+        try:
+            output, _ = coord.communicate(timeout=120)
+        except subprocess.TimeoutExpired:
+            coord.kill()
+            output, _ = coord.communicate()
+            output += "\n[Smoke] coordinator timed out"
+        for a in agents:
+            try:
+                a.wait(timeout=30)
+            except subprocess.TimeoutExpired:
+                a.kill()
+        if temp_users: os.remove(USERS_FILE)
+        return coord.returncode, output
+
+    def stage_mock_cases(self):
+        """Stage 3: Mock 版本的场景用例 (910 ~ 980 与协程组合)"""
+        print("\n" + "=" * 60)
+        print(">>> Stage 3: Scenario cases (910~980, fibers), Mock builds only")
+        print("=" * 60)
+
+        # 回放用的小 trace: 每个 Key 依次 PUT / GET / DELETE, 0.5 秒内放完
+        with open(MOCK_TRACE_FILE, 'w') as f:
+            for i in range(50):
+                for k, op in enumerate(("PUT", "GET", "DELETE")):
+                    f.write(f"{i * 0.01 + k * 0.002:.3f},{op},trace/obj{i},4096\n")
+
+        for name, _, bin_name in BUILD_TASKS:
+            if name not in MOCK_BUILDS:
+                continue
+            bin_path = os.path.join(CACHE_DIR, bin_name)
+            print(f"\n--- Testing Build: {name} ---")
+            for label, overrides, distributed, criterion in MOCK_CASES:
+                print(f"  Case {label:<8} ... ", end='', flush=True)
+                start_t = time.time()
+                ret, output = self.run_mock_case(bin_path, overrides, distributed)
+                duration = time.time() - start_t
+                stats = self.parse_stats(output)
+
+                status, detail = "PASS", ""
+                if ret != 0:
+                    status, detail = "FAIL", f"Exit {ret}"
+                    if "AddressSanitizer" in output: detail = "ASan Error"
+                elif "AddressSanitizer" in output:
+                    status, detail = "FAIL", "ASan Error (Exit 0)"
+                elif stats['validation'] > 0:
+                    status, detail = "FAIL", f"Validation Fail ({stats['validation']} errs)"
+                elif criterion != "validation" and stats['failed'] > 0:
+                    status, detail = "FAIL", f"Business Fail ({stats['failed']} errs)"
+                elif criterion.startswith("requests=") and stats['success'] != int(criterion.split("=")[1]):
+                    status, detail = "FAIL", f"Expected {criterion.split('=')[1]} requests"
+                elif stats['success'] == 0:
+                    status, detail = "WARN", "0 Success"
+
+                print(f"{status} (Succ:{stats['success']}, Fail:{stats['failed']}, {duration:.1f}s)")
+                self.results.append({"Build": name, "Case": label, "Status": status, "Detail": detail})
+        for path in (MOCK_CONFIG, MOCK_TRACE_FILE):
+            if os.path.exists(path): os.remove(path)
+
     def print_summary(self):
         print("\n" + "=" * 60)
-        print(f"{'BUILD':<12} | {'CASE':<6} | {'STATUS':<10} | {'DETAIL'}")
+        print(f"{'BUILD':<12} | {'CASE':<8} | {'STATUS':<10} | {'DETAIL'}")
         print("-" * 60)
         
         pass_count = 0
@@ -203,7 +314,7 @@ class BenchmarkTester:
             else:
                 failed_tests.append(r)
             
-            print(f"{r['Build']:<12} | {r['Case']:<6} | {r['Status']:<10} | {r['Detail']}")
+            print(f"{r['Build']:<12} | {str(r['Case']):<8} | {r['Status']:<10} | {r['Detail']}")
             
         print("-" * 60)
         print(f"Summary: {pass_count}/{total_count} Passed")
@@ -224,6 +335,7 @@ class BenchmarkTester:
                 print(">>> ABORTING: Compilation failed.")
                 sys.exit(1)
             self.stage_smoke_test()
+            self.stage_mock_cases()
             self.print_summary()
         except KeyboardInterrupt:
             print("\nInterrupted.")
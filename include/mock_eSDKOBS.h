@@ -229,6 +229,7 @@ typedef struct {
     int connect_time;
     int max_connected_time;
     bool keep_alive;
+    bool forbid_reuse_tcp;          // 本次请求结束后关闭连接, 不放回连接池
     
     // --- 同步真实 SDK 最新国密与双向认证字段 ---
     char* server_cert_path;
@@ -300,10 +301,27 @@ typedef struct {
     char *etag;
 } obs_complete_upload_Info;
 
+typedef enum { OBS_ENCRYPTION_KMS, OBS_ENCRYPTION_SSEC } obs_encryption_type;
+
 typedef struct {
-    // dummy
+    obs_encryption_type encryption_type;
+    char *kms_server_side_encryption;
+    char *kms_key_id;
+    char *ssec_customer_algorithm;
+    char *ssec_customer_key;
+    char *des_ssec_customer_algorithm;
+    char *des_ssec_customer_key;
 } server_side_encryption_params;
 
+typedef struct {
+    char *destination_bucket;
+    char *destination_key;
+    char *version_id;
+    int64_t *last_modified_return;
+    int etag_return_size;
+    char *etag_return;
+} obs_copy_destination_object_info;
+
 // --- Callbacks ---
 typedef struct { 
     const char *request_id; // [新增] 补充 Request ID，解决 mock 模式下的编译报错
@@ -366,11 +384,68 @@ typedef struct {
     // dummy
 } obs_upload_file_server_callback;
 
+// --- Bucket configuration (控制面) ---
+#define OBS_VERSION_STATUS_ENABLED   "Enabled"
+#define OBS_VERSION_STATUS_SUSPENDED "Suspended"
+
+typedef enum { OBS_STORAGE_CLASS_STANDARD = 0, OBS_STORAGE_CLASS_STANDARD_IA = 1, OBS_STORAGE_CLASS_GLACIER = 2 } obs_storage_class;
+
+typedef struct obs_name_value { char *name; char *value; } obs_name_value;
+
+typedef struct { const char *date; const char *days; obs_storage_class storage_class; } obs_lifecycle_transtion;
+typedef struct { const char *noncurrent_version_days; obs_storage_class storage_class; } obs_lifecycle_noncurrent_transtion;
+
+typedef struct {
+    const char *date;
+    const char *days;
+    const char *id;
+    const char *prefix;
+    const char *status;
+    const char *noncurrent_version_days;
+    obs_lifecycle_transtion *transition;
+    unsigned int transition_num;
+    obs_lifecycle_noncurrent_transtion *noncurrent_version_transition;
+    unsigned int noncurrent_version_transition_num;
+} obs_lifecycle_conf;
+
+typedef struct {
+    const char *id;
+    const char **allowed_method;
+    unsigned int allowed_method_number;
+    const char **allowed_origin;
+    unsigned int allowed_origin_number;
+    const char **allowed_header;
+    unsigned int allowed_header_number;
+    const char *max_age_seconds;
+    const char **expose_header;
+    unsigned int expose_header_number;
+} obs_bucket_cors_conf;
+
+typedef obs_status (get_lifecycle_configuration_callback)(obs_lifecycle_conf *bucket_lifecycle_conf, unsigned int blcc_number, void *callback_data);
+typedef obs_status (get_cors_configuration_callback)(obs_bucket_cors_conf *bucket_cors_conf, unsigned int bcc_number, void *callback_data);
+typedef obs_status (obs_get_bucket_tagging_callback)(int tagging_count, obs_name_value *tagging_list, void *callback_data);
+
+typedef struct {
+    obs_response_handler response_handler;
+    get_lifecycle_configuration_callback *get_lifecycle_callback;
+} obs_lifecycle_handler;
+
+typedef struct {
+    obs_response_handler response_handler;
+    get_cors_configuration_callback *get_cors_callback;
+} obs_cors_handler;
+
+typedef struct {
+    obs_response_handler response_handler;
+    obs_get_bucket_tagging_callback *get_bucket_tagging_callback;
+} obs_get_bucket_tagging_handler;
+
 // --- Functions ---
 obs_status obs_initialize(int flags);
 void obs_deinitialize();
 const char* obs_get_status_name(obs_status status);
 void init_obs_options(obs_options *options);
+int obs_status_is_retryable(obs_status status);
 void init_put_properties(obs_put_properties *options);
 void init_get_properties(obs_get_conditions *options);
 void create_bucket(const obs_options *options, obs_canned_acl canned_acl, const char *location_constraint, obs_response_handler *handler, void *callback_data);
@@ -385,6 +460,10 @@ void get_object(const obs_options *options, obs_object_info *object_info,
                 server_side_encryption_params *encryption_params,
                 obs_get_object_handler *handler, void *callback_data);
 
+void get_object_metadata(const obs_options *options, obs_object_info *object_info,
+                         server_side_encryption_params *encryption_params,
+                         obs_response_handler *handler, void *callback_data);
+
 void delete_object(const obs_options *options, obs_object_info *object_info,
                    obs_response_handler *handler, void *callback_data);
 
@@ -414,8 +493,126 @@ void upload_file(const obs_options *options, char *key, server_side_encryption_p
                  obs_upload_file_response_handler *handler,
                  void *callback_data);
 
+void copy_object(const obs_options *options, char *key, const char *version_id, obs_copy_destination_object_info *object_info,
+                 unsigned int is_copy, obs_put_properties *put_properties, server_side_encryption_params *encryption_params,
+                 obs_response_handler *handler, void *callback_data);
+
+// only pfs bucket can use rename_object
+void rename_object(const obs_options *options, char *key, char *new_object_name,
+                   obs_response_handler *handler, void *callback_data);
+
+void obs_head_bucket(const obs_options *options, obs_response_handler *handler, void *callback_data);
+void set_bucket_policy(const obs_options *options, const char *policy, obs_response_handler *handler, void *callback_data);
+void get_bucket_policy(const obs_options *options, int policy_return_size, char *policy_return,
+                       obs_response_handler *handler, void *callback_data);
+void set_bucket_version_configuration(const obs_options *options, const char *version_status,
+                                      obs_response_handler *handler, void *callback_data);
+void get_bucket_version_configuration(const obs_options *options, int status_return_size, char *status_return,
+                                      obs_response_handler *handler, void *callback_data);
+void set_bucket_tagging(const obs_options *options, obs_name_value *tagging_list, unsigned int number,
+                        obs_response_handler *handler, void *callback_data);
+void get_bucket_tagging(const obs_options *options, obs_get_bucket_tagging_handler *handler, void *callback_data);
+void set_bucket_lifecycle_configuration(const obs_options *options, obs_lifecycle_conf *bucket_lifecycle_conf,
+                                        unsigned int blcc_number, obs_response_handler *handler, void *callback_data);
+void get_bucket_lifecycle_configuration(const obs_options *options, obs_lifecycle_handler *handler, void *callback_data);
+void set_bucket_cors_configuration(const obs_options *options, obs_bucket_cors_conf *obs_cors_conf_info,
+                                   unsigned int conf_num, obs_response_handler *handler, void *callback_data);
+void get_bucket_cors_configuration(const obs_options *options, obs_cors_handler *handler, void *callback_data);
+
 void initialize_break_point_lock();
 void deinitialize_break_point_lock();
 
+// ----------------------------------------------------------------------------
+// Mock 专用扩展: 时延 / 带宽 / 故障注入模型 (真实 SDK 中没有这些接口)
+// ----------------------------------------------------------------------------
+typedef enum {
+    MOCK_SDK_OP_PUT = 0,
+    MOCK_SDK_OP_GET,
+    MOCK_SDK_OP_HEAD,
+    MOCK_SDK_OP_DELETE,
+    MOCK_SDK_OP_LIST,
+    MOCK_SDK_OP_COPY,
+    MOCK_SDK_OP_MULTIPART,          // 初始化 / 上传分段 / 合并
+    MOCK_SDK_OP_RESUMABLE,
+    MOCK_SDK_OP_BUCKET,             // 建删桶与桶配置类接口
+    MOCK_SDK_OP_SLOTS
+} mock_sdk_op;
+
+typedef enum {
+    MOCK_SDK_LATENCY_NONE = 0,
+    MOCK_SDK_LATENCY_CONSTANT,
+    MOCK_SDK_LATENCY_EXPONENTIAL,
+    MOCK_SDK_LATENCY_LOGNORMAL
+} mock_sdk_latency_dist;
+
+typedef struct {
+    mock_sdk_latency_dist latency_dist;
+    double latency_ms[MOCK_SDK_OP_SLOTS];   // 各操作首字节时延的均值
+    double latency_cv;                      // lognormal 的变异系数 (标准差 / 均值)
+    double bandwidth_mbps;                  // 单连接 (单次调用) 带宽上限 MB/s, 0 = 不限
+    double connect_ms;                      // 新建连接 (TCP + TLS 握手) 的耗时, 每线程保持一条连接, 0 = 不模拟
+    // 每次调用的故障概率 (0~1), 按下列顺序互斥抽取
+    double conn_fail_rate;                  // 连接失败 (OBS_STATUS_ConnectionFailed)
+    double slow_down_rate;                  // 503 SlowDown
+    double fail_403_rate;
+    double fail_404_rate;
+    double fail_409_rate;
+    // 仅作用于数据传输: 响应体中途截断 / 单字节损坏 (上传截断表现为连接中断)
+    double truncate_rate;
+    double corrupt_rate;
+} mock_sdk_model;
+
+void mock_sdk_set_model(const mock_sdk_model *model);
+
+// ----------------------------------------------------------------------------
+// Mock 专用扩展: 有状态对象存储 (mock_store.c)
+// 开启后 PUT / GET / HEAD / DELETE / LIST / COPY / 分段上传读写同一份内存数据, 行为与服务端一致
+// (不存在的 Key 返回 NoSuchKey, 越界 Range 返回 InvalidRange, 读到的是写入的字节)
+// ----------------------------------------------------------------------------
+#define MOCK_STORE_BLOCK_SIZE   (64 * 1024)
+
+typedef struct mock_object mock_object;
+struct mock_block;
+
+typedef struct {
+    char *pending;                  // 未满一个块的数据
+    uint32_t pending_len;
+    uint64_t size;
+    struct mock_block **blocks;
+    int block_count;
+    int block_cap;
+} mock_writer;
+
+typedef struct {
+    char *key;
+    mock_object *obj;
+} mock_list_item;
+
+void mock_sdk_set_store(int enabled);
+
+void mock_writer_init(mock_writer *w);
+int mock_writer_append(mock_writer *w, const char *data, size_t len);
+mock_object *mock_writer_finish(mock_writer *w);
+void mock_writer_abort(mock_writer *w);
+
+void mock_object_ref(mock_object *obj);
+void mock_object_unref(mock_object *obj);
+uint64_t mock_object_size(const mock_object *obj);
+const char *mock_object_etag(const mock_object *obj);
+int64_t mock_object_mtime(const mock_object *obj);
+const char *mock_object_read(const mock_object *obj, uint64_t offset, uint64_t *avail);
+mock_object *mock_object_copy(mock_object *src);
+
+void mock_store_put(const char *bucket, const char *key, mock_object *obj);
+mock_object *mock_store_get(const char *bucket, const char *key);
+mock_list_item *mock_store_list(const char *bucket, const char *prefix, const char *marker, int max_keys,
+                                int *out_count, int *out_truncated);
+void mock_store_list_free(mock_list_item *items, int count);
+
+int mock_store_upload_begin(const char *bucket, const char *key, char *id_out, int id_len);
+obs_status mock_store_upload_part(const char *upload_id, int part_number, mock_object *part);
+obs_status mock_store_upload_complete(const char *upload_id, const unsigned int *part_numbers, int count,
+                                      char *etag_out, int etag_len);
+
 #endif
 
@@ -0,0 +1,272 @@
+#include "bench.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <strings.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+// CPU 亲和性与 NUMA 感知的线程放置
+// - cpus: Worker 依次绑定到 AffinityCpuList 中的单个 CPU
+// - numa: Worker 按 NUMA 节点轮转, 绑定到节点的全部 CPU
+// Worker 在线程创建时即完成绑定, 线程内 malloc 并首次写入的 pattern buffer
+// 由内核 first-touch 策略分配到本地节点, 无需依赖 libnuma。
+// ----------------------------------------------------------------------------
+
+// 未知取值返回 -1
+int affinity_mode_from_string(const char *val) {
+    if (strcasecmp(val, "none") == 0) return AFFINITY_MODE_NONE;
+    if (strcasecmp(val, "cpus") == 0) return AFFINITY_MODE_CPUS;
+    if (strcasecmp(val, "numa") == 0) return AFFINITY_MODE_NUMA;
+    return -1;
+}
+
+const char *affinity_mode_to_string(int mode) {
+    switch (mode) {
+        case AFFINITY_MODE_CPUS: return "cpus";
+        case AFFINITY_MODE_NUMA: return "numa";
+        default:                 return "none";
+    }
+}
+
+// 解析 "0-15,32,64-79" 形式的列表, 返回元素个数, 格式错误返回 -1
+int affinity_parse_list(const char *s, int *out, int max) {
+    int count = 0;
+    const char *p = s;
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\n') p++;
+        if (!*p) break;
+        if (!isdigit((unsigned char)*p)) return -1;
+        char *end;
+        long lo = strtol(p, &end, 10);
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            p++;
+            if (!isdigit((unsigned char)*p)) return -1;
+            hi = strtol(p, &end, 10);
+            p = end;
+        }
+        if (hi < lo) return -1;
+        for (long v = lo; v <= hi && count < max; v++) out[count++] = (int)v;
+        if (*p && *p != ',' && *p != ' ' && *p != '\n') return -1;
+    }
+    return count;
+}
+
+static int read_first_line(const char *path, char *buf, size_t size) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    int ok = (fgets(buf, (int)size, fp) != NULL);
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+static int node_index_of(const AffinityPlan *plan, int node_id) {
+    for (int i = 0; i < plan->node_count; i++) {
+        if (plan->node_ids[i] == node_id) return i;
+    }
+    return -1;
+}
+
+// 读取 /sys/devices/system/node/node*/cpulist; 无 NUMA 信息时视为单节点
+static void discover_topology(AffinityPlan *plan) {
+    static int cpus[CPU_SETSIZE];
+    for (int c = 0; c < CPU_SETSIZE; c++) plan->cpu_node[c] = -1;
+
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (dir) {
+        struct dirent *ent;
+        while ((ent = readdir(dir)) != NULL && plan->node_count < AFFINITY_MAX_NODES) {
+            if (strncmp(ent->d_name, "node", 4) != 0 || !isdigit((unsigned char)ent->d_name[4])) continue;
+            char path[512], line[4096];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", ent->d_name);
+            if (read_first_line(path, line, sizeof(line)) != 0) continue;
+            int n = affinity_parse_list(line, cpus, CPU_SETSIZE);
+            if (n <= 0) continue;
+
+            int idx = plan->node_count++;
+            plan->node_ids[idx] = atoi(ent->d_name + 4);
+            CPU_ZERO(&plan->node_cpus[idx]);
+            for (int k = 0; k < n; k++) {
+                if (cpus[k] >= CPU_SETSIZE) continue;
+                CPU_SET(cpus[k], &plan->node_cpus[idx]);
+                plan->cpu_node[cpus[k]] = (short)idx;
+            }
+        }
+        closedir(dir);
+    }
+
+    if (plan->node_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (online <= 0) online = 1;
+        if (online > CPU_SETSIZE) online = CPU_SETSIZE;
+        plan->node_count = 1;
+        plan->node_ids[0] = 0;
+        CPU_ZERO(&plan->node_cpus[0]);
+        for (int c = 0; c < online; c++) {
+            CPU_SET(c, &plan->node_cpus[0]);
+            plan->cpu_node[c] = 0;
+        }
+    }
+}
+
+int affinity_plan_init(AffinityPlan *plan, const Config *cfg) {
+    memset(plan, 0, sizeof(AffinityPlan));
+    plan->mode = cfg->affinity_mode;
+    discover_topology(plan);
+
+    if (plan->mode == AFFINITY_MODE_CPUS) {
+        int n = affinity_parse_list(cfg->affinity_cpu_list, plan->cpu_list, CPU_SETSIZE);
+        for (int i = 0; i < n; i++) {
+            if (plan->cpu_list[i] >= CPU_SETSIZE || plan->cpu_node[plan->cpu_list[i]] < 0) {
+                LOG_ERROR("AffinityCpuList contains CPU %d which is not online.", plan->cpu_list[i]);
+                return -1;
+            }
+        }
+        if (n <= 0) {
+            LOG_ERROR("AffinityMode=cpus requires a non-empty AffinityCpuList.");
+            return -1;
+        }
+        plan->cpu_count = n;
+    } else if (plan->mode == AFFINITY_MODE_NUMA) {
+        if (strlen(cfg->affinity_numa_nodes) > 0) {
+            int ids[AFFINITY_MAX_NODES];
+            int n = affinity_parse_list(cfg->affinity_numa_nodes, ids, AFFINITY_MAX_NODES);
+            for (int i = 0; i < n; i++) {
+                int idx = node_index_of(plan, ids[i]);
+                if (idx < 0) {
+                    LOG_ERROR("AffinityNumaNodes contains unknown NUMA node %d.", ids[i]);
+                    return -1;
+                }
+                plan->numa_sel[plan->numa_sel_count++] = idx;
+            }
+        } else {
+            for (int i = 0; i < plan->node_count; i++) plan->numa_sel[plan->numa_sel_count++] = i;
+        }
+        if (plan->numa_sel_count == 0) {
+            LOG_ERROR("AffinityMode=numa found no usable NUMA node.");
+            return -1;
+        }
+    }
+
+    if (strlen(cfg->affinity_service_cpus) > 0) {
+        int n = affinity_parse_list(cfg->affinity_service_cpus, plan->service_cpus, CPU_SETSIZE);
+        if (n <= 0) {
+            LOG_ERROR("Invalid AffinityServiceCpus: %s", cfg->affinity_service_cpus);
+            return -1;
+        }
+        plan->service_cpu_count = n;
+    }
+    return 0;
+}
+
+// 计算第 local_idx 个 Worker 的 CPU 集合; 返回 0 表示不绑定
+int affinity_worker_cpuset(const AffinityPlan *plan, int local_idx, cpu_set_t *set, int *out_cpu, int *out_node) {
+    *out_cpu = -1;
+    *out_node = -1;
+    if (plan->mode == AFFINITY_MODE_CPUS) {
+        int cpu = plan->cpu_list[local_idx % plan->cpu_count];
+        CPU_ZERO(set);
+        CPU_SET(cpu, set);
+        *out_cpu = cpu;
+        *out_node = plan->cpu_node[cpu];
+        return 1;
+    }
+    if (plan->mode == AFFINITY_MODE_NUMA) {
+        int idx = plan->numa_sel[local_idx % plan->numa_sel_count];
+        *set = plan->node_cpus[idx];
+        *out_node = idx;
+        return 1;
+    }
+    return 0;
+}
+
+// 监控 / 控制面等非发流线程
+int affinity_service_cpuset(const AffinityPlan *plan, cpu_set_t *set) {
+    if (plan->service_cpu_count <= 0) return 0;
+    CPU_ZERO(set);
+    for (int i = 0; i < plan->service_cpu_count; i++) {
+        if (plan->service_cpus[i] < CPU_SETSIZE) CPU_SET(plan->service_cpus[i], set);
+    }
+    return 1;
+}
+
+// 以预先计算好的 CPU 集合创建线程, 绑定失败时退化为不绑定
+int affinity_thread_create(pthread_t *tid, const cpu_set_t *set, void *(*routine)(void *), void *arg) {
+    if (set) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        if (pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), set) == 0 &&
+            pthread_create(tid, &attr, routine, arg) == 0) {
+            pthread_attr_destroy(&attr);
+            return 0;
+        }
+        pthread_attr_destroy(&attr);
+        LOG_WARN("Failed to create pinned thread, falling back to unpinned.");
+    }
+    return pthread_create(tid, NULL, routine, arg);
+}
+
+static void format_cpuset(const cpu_set_t *set, char *buf, size_t size) {
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int c = 0; c < CPU_SETSIZE && len + 16 < size; c++) {
+        if (!CPU_ISSET(c, set)) continue;
+        int hi = c;
+        while (hi + 1 < CPU_SETSIZE && CPU_ISSET(hi + 1, set)) hi++;
+        if (hi > c) len += snprintf(buf + len, size - len, "%s%d-%d", len ? "," : "", c, hi);
+        else len += snprintf(buf + len, size - len, "%s%d", len ? "," : "", c);
+        c = hi;
+    }
+}
+
+// 输出 placement.txt: 拓扑、每线程放置与每节点吞吐
+void affinity_save_report(const Config *cfg, const AffinityPlan *plan, const WorkerArgs *t_args, int count, double elapsed_s) {
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/placement.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (!fp) return;
+
+    char cpus[1024];
+    fprintf(fp, "AffinityMode: %s\n", affinity_mode_to_string(plan->mode));
+    fprintf(fp, "[Topology]\n");
+    for (int i = 0; i < plan->node_count; i++) {
+        format_cpuset(&plan->node_cpus[i], cpus, sizeof(cpus));
+        fprintf(fp, "  node%-3d cpus %s\n", plan->node_ids[i], cpus);
+    }
+    if (plan->service_cpu_count > 0) {
+        cpu_set_t set;
+        affinity_service_cpuset(plan, &set);
+        format_cpuset(&set, cpus, sizeof(cpus));
+        fprintf(fp, "  service threads -> cpus %s\n", cpus);
+    }
+
+    fprintf(fp, "[Threads]\n");
+    for (int i = 0; i < count; i++) {
+        const WorkerArgs *a = &t_args[i];
+        int node_id = a->numa_node >= 0 ? plan->node_ids[a->numa_node] : -1;
+        if (a->cpu >= 0) fprintf(fp, "  thread %-6d user %-16s cpu %-4d node %d\n", a->thread_id, a->username, a->cpu, node_id);
+        else fprintf(fp, "  thread %-6d user %-16s cpu any  node %d\n", a->thread_id, a->username, node_id);
+    }
+
+    fprintf(fp, "[PerNode]\n");
+    printf("\n--- Per-Node Throughput ---\n");
+    for (int n = 0; n < plan->node_count; n++) {
+        int threads = 0;
+        long long success = 0, fail = 0, bytes = 0;
+        for (int i = 0; i < count; i++) {
+            if (t_args[i].numa_node != n) continue;
+            threads++;
+            success += t_args[i].stats.success_count;
+            fail += stats_total_fail(&t_args[i].stats);
+            bytes += t_args[i].stats.total_success_bytes;
+        }
+        if (threads == 0) continue;
+        double tps = elapsed_s > 0 ? (success + fail) / elapsed_s : 0.0;
+        double mbps = elapsed_s > 0 ? bytes / 1024.0 / 1024.0 / elapsed_s : 0.0;
+        fprintf(fp, "  node%-3d threads %-5d success %-10lld fail %-8lld TPS %10.2f  BW %8.2f MB/s\n",
+                plan->node_ids[n], threads, success, fail, tps, mbps);
+        printf("node%-3d threads %-5d TPS %10.2f | BW %8.2f MB/s\n", plan->node_ids[n], threads, tps, mbps);
+    }
+    fclose(fp);
+}
@@ -0,0 +1,168 @@
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// SlowDown 感知的 AIMD 闭环限速 (每用户)
+// - 收到 SlowDown / 503: 发送速率乘性下降 (每个窗口最多一次, 避免一串拒绝把速率打穿)
+// - 一个窗口内无拥塞: 发送速率加性上升
+// 速率直接作用于该用户共享的令牌桶; 监控线程周期性采样, 报告取后半程的收敛值。
+// ----------------------------------------------------------------------------
+
+// share: 本 Agent 分得的配额比例, 上下限与初始速率一同缩放
+int aimd_init(AimdController *c, TokenBucket *bucket, const Config *cfg, const char *username, double share) {
+    memset(c, 0, sizeof(AimdController));
+    c->bucket = bucket;
+    c->cfg = cfg;
+    snprintf(c->username, sizeof(c->username), "%s", username);
+    c->min_tps = cfg->aimd_min_tps * share;
+    c->max_tps = cfg->aimd_max_tps * share;
+    long long now = monotonic_now_ns();
+    c->window_end_ns = now + (long long)(cfg->aimd_window_ms * 1e6);
+    c->last_decrease_ns = 0;
+    c->sample_cap = 256;
+    c->samples = (AimdSample *)malloc(c->sample_cap * sizeof(AimdSample));
+    if (!c->samples) {
+        c->sample_cap = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void aimd_release(AimdController *c) {
+    free(c->samples);
+    c->samples = NULL;
+    c->sample_cap = c->sample_count = 0;
+}
+
+static int aimd_is_congestion(obs_status status) {
+    return status == OBS_STATUS_SlowDown || status == OBS_STATUS_ServiceUnavailable;
+}
+
+void aimd_on_result(AimdController *c, obs_status status, long long bytes) {
+    if (!c) return;
+    const Config *cfg = c->cfg;
+    long long now = monotonic_now_ns();
+    long long window_ns = (long long)(cfg->aimd_window_ms * 1e6);
+
+    if (aimd_is_congestion(status)) {
+        __atomic_add_fetch(&c->congestion_count, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&c->congested, 1, __ATOMIC_RELAXED);
+
+        long long last = __atomic_load_n(&c->last_decrease_ns, __ATOMIC_RELAXED);
+        if (now - last >= window_ns &&
+            __atomic_compare_exchange_n(&c->last_decrease_ns, &last, now, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            double rate = token_bucket_get_rate(c->bucket) * cfg->aimd_decrease_factor;
+            if (rate < c->min_tps) rate = c->min_tps;
+            token_bucket_set_rate(c->bucket, rate);
+            __atomic_add_fetch(&c->decrease_events, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+
+    if (status == OBS_STATUS_OK) {
+        __atomic_add_fetch(&c->success_count, 1, __ATOMIC_RELAXED);
+        if (bytes > 0) __atomic_add_fetch(&c->success_bytes, bytes, __ATOMIC_RELAXED);
+    }
+
+    // 窗口结束: 由第一个观察到的线程认领并决定是否加性上升
+    long long end = __atomic_load_n(&c->window_end_ns, __ATOMIC_RELAXED);
+    if (now >= end &&
+        __atomic_compare_exchange_n(&c->window_end_ns, &end, now + window_ns, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        int congested = __atomic_exchange_n(&c->congested, 0, __ATOMIC_RELAXED);
+        if (!congested) {
+            double rate = token_bucket_get_rate(c->bucket) + cfg->aimd_increase_tps;
+            if (c->max_tps > 0 && rate > c->max_tps) rate = c->max_tps;
+            token_bucket_set_rate(c->bucket, rate);
+        }
+    }
+}
+
+// 由监控线程调用, 采样数组只在监控线程内增长
+void aimd_sample(AimdController *ctrls, int count, double elapsed_s) {
+    for (int i = 0; i < count; i++) {
+        AimdController *c = &ctrls[i];
+        if (c->sample_cap == 0) continue;
+        if (c->sample_count >= c->sample_cap) {
+            AimdSample *grown = (AimdSample *)realloc(c->samples, c->sample_cap * 2 * sizeof(AimdSample));
+            if (!grown) continue;
+            c->samples = grown;
+            c->sample_cap *= 2;
+        }
+        AimdSample *smp = &c->samples[c->sample_count++];
+        smp->elapsed_s = elapsed_s;
+        smp->rate_tps = token_bucket_get_rate(c->bucket);
+        smp->success_count = __atomic_load_n(&c->success_count, __ATOMIC_RELAXED);
+        smp->success_bytes = __atomic_load_n(&c->success_bytes, __ATOMIC_RELAXED);
+    }
+}
+
+// 收敛值: 取后半程采样区间内的实际成功 TPS / 带宽与平均限速
+void aimd_converged(const AimdController *c, double *out_tps, double *out_mbps, double *out_rate) {
+    *out_tps = *out_mbps = 0;
+    *out_rate = token_bucket_get_rate(c->bucket);
+    if (c->sample_count < 2) return;
+
+    const AimdSample *last = &c->samples[c->sample_count - 1];
+    int mid_idx = 0;
+    for (int i = 0; i < c->sample_count; i++) {
+        if (c->samples[i].elapsed_s >= last->elapsed_s / 2.0) {
+            mid_idx = i;
+            break;
+        }
+    }
+    if (mid_idx >= c->sample_count - 1) mid_idx = c->sample_count - 2;
+    const AimdSample *mid = &c->samples[mid_idx];
+
+    double dt = last->elapsed_s - mid->elapsed_s;
+    if (dt <= 0) return;
+    *out_tps = (last->success_count - mid->success_count) / dt;
+    *out_mbps = (last->success_bytes - mid->success_bytes) / 1024.0 / 1024.0 / dt;
+
+    double rate_sum = 0;
+    for (int i = mid_idx; i < c->sample_count; i++) rate_sum += c->samples[i].rate_tps;
+    *out_rate = rate_sum / (c->sample_count - mid_idx);
+}
+
+// 输出 aimd.csv (速率收敛过程) 与 aimd.txt (每用户收敛后的可持续 TPS / 带宽)
+void aimd_save_report(const Config *cfg, const AimdController *ctrls, int count) {
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/aimd.csv", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "RunTime(s),User,RateLimit(TPS),Cumul_Success,Cumul_Bytes\n");
+        for (int i = 0; i < count; i++) {
+            for (int k = 0; k < ctrls[i].sample_count; k++) {
+                const AimdSample *smp = &ctrls[i].samples[k];
+                fprintf(fp, "%.1f,%s,%.2f,%lld,%lld\n", smp->elapsed_s, ctrls[i].username,
+                        smp->rate_tps, smp->success_count, smp->success_bytes);
+            }
+        }
+        fclose(fp);
+    }
+
+    snprintf(filepath, sizeof(filepath), "%s/aimd.txt", cfg->task_log_dir);
+    fp = fopen(filepath, "w");
+    if (!fp) return;
+    fprintf(fp, "AIMD: initial %.1f TPS, +%.1f TPS per %.0f ms window, x%.2f on SlowDown/503, min %.1f TPS, max %.1f TPS (0 = unbounded)\n",
+            cfg->aimd_initial_tps, cfg->aimd_increase_tps, cfg->aimd_window_ms, cfg->aimd_decrease_factor,
+            cfg->aimd_min_tps, cfg->aimd_max_tps);
+    fprintf(fp, "Converged values are measured over the second half of the run.\n\n");
+    fprintf(fp, "%-20s %14s %14s %14s %12s %12s %12s\n", "User", "Sustain(TPS)", "Sustain(MB/s)",
+            "AvgLimit(TPS)", "SlowDowns", "Decreases", "FinalLimit");
+
+    double sum_tps = 0, sum_mbps = 0;
+    printf("\n--- AIMD Converged Throughput ---\n");
+    for (int i = 0; i < count; i++) {
+        const AimdController *c = &ctrls[i];
+        double tps, mbps, rate;
+        aimd_converged(c, &tps, &mbps, &rate);
+        sum_tps += tps;
+        sum_mbps += mbps;
+        fprintf(fp, "%-20s %14.2f %14.2f %14.2f %12lld %12lld %12.2f\n", c->username, tps, mbps, rate,
+                c->congestion_count, c->decrease_events, token_bucket_get_rate(c->bucket));
+        printf("User %-16s Sustainable: %10.2f TPS | %8.2f MB/s (limit avg %.2f TPS, %lld SlowDown/503)\n",
+               c->username, tps, mbps, rate, c->congestion_count);
+    }
+    fprintf(fp, "%-20s %14.2f %14.2f\n", "TOTAL", sum_tps, sum_mbps);
+    printf("Total Sustainable: %.2f TPS | %.2f MB/s\n", sum_tps, sum_mbps);
+    fclose(fp);
+}
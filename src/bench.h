@@ -5,9 +5,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <signal.h>
 #include "log.h" 
 
@@ -25,15 +27,50 @@ extern volatile sig_atomic_t g_graceful_stop;
 // 定义统一的最大 Key 长度
 #define MAX_KEY_LEN             1025
 
+// 对象 Key 命名方案 (KeyScheme)
+#define KEY_SCHEME_FLAT         0   // <prefix>-<user>-<owner>-<seq>
+#define KEY_SCHEME_HASHED       1   // <hex32>-<prefix>-<user>-<owner>-<seq>
+#define KEY_SCHEME_TREE         2   // <prefix>/<d1>/.../<dN>/<user>-<owner>-<seq>
+#define KEY_SCHEME_FIXED        3   // 编号补零到固定宽度, 同一用户的 Key 等长
+#define KEY_SCHEME_TEMPLATE     4   // KeyTemplate 自定义
+#define KEY_TREE_MAX_DEPTH      16
+#define KEY_GEN_MAX_SEGS        32
+
 // TestCase 编号定义
 #define TEST_CASE_CREATE_BUCKET 101
 #define TEST_CASE_DELETE_BUCKET 104
 #define TEST_CASE_PUT           201
 #define TEST_CASE_GET           202
 #define TEST_CASE_DELETE        204
+#define TEST_CASE_COPY          205
 #define TEST_CASE_MULTIPART     216
 #define TEST_CASE_RESUMABLE     230
 #define TEST_CASE_MIX           900
+#define TEST_CASE_TRACE         910
+#define TEST_CASE_VISIBILITY    920
+#define TEST_CASE_HOTKEY        930
+#define TEST_CASE_CHURN         940
+#define TEST_CASE_CONTROL_PLANE 950
+#define TEST_CASE_PFS_TREE      970
+#define TEST_CASE_CONN_COST     980
+
+// 控制面压测中各桶配置接口的 OpType (仅用于明细日志与统计, 不可直接作为 TestCase)
+#define TEST_CASE_HEAD_BUCKET       951
+#define TEST_CASE_SET_POLICY        952
+#define TEST_CASE_GET_POLICY        953
+#define TEST_CASE_SET_LIFECYCLE     954
+#define TEST_CASE_GET_LIFECYCLE     955
+#define TEST_CASE_SET_CORS          956
+#define TEST_CASE_GET_CORS          957
+#define TEST_CASE_SET_TAGGING       958
+#define TEST_CASE_GET_TAGGING       959
+#define TEST_CASE_SET_VERSIONING    960
+#define TEST_CASE_GET_VERSIONING    961
+
+// 目录树压测 (970) 中的对象 / 目录接口 OpType (仅用于明细日志与统计, 不可直接作为 TestCase)
+#define TEST_CASE_HEAD_OBJECT       971
+#define TEST_CASE_LIST_DIR          972
+#define TEST_CASE_RENAME            973
 
 #define MAX_MIX_OPS 32 
 #define MAX_RANGE_OPTIONS 64 
@@ -41,6 +78,190 @@ extern volatile sig_atomic_t g_graceful_stop;
 // 批量落盘大小
 #define BATCH_SIZE 1000
 
+// 时延直方图参数 (微秒, 对数-线性分桶, 上限 2^32 us)
+#define HIST_SUB_BUCKET_BITS    5
+#define HIST_SUB_BUCKETS        (1 << HIST_SUB_BUCKET_BITS)
+#define HIST_MAX_MAGNITUDE      32
+#define HIST_BUCKET_COUNT       ((HIST_MAX_MAGNITUDE - HIST_SUB_BUCKET_BITS + 1) * HIST_SUB_BUCKETS)
+
+typedef struct {
+    long long count;
+    long long buckets[HIST_BUCKET_COUNT];
+} LatencyHistogram;
+
+// 线程放置策略
+#define AFFINITY_MODE_NONE          0
+#define AFFINITY_MODE_CPUS          1
+#define AFFINITY_MODE_NUMA          2
+#define AFFINITY_MAX_NODES          64
+
+// 对象大小分布
+#define SIZE_DIST_FIXED             0
+#define SIZE_DIST_UNIFORM           1
+#define SIZE_DIST_BUCKETS           2
+#define SIZE_DIST_LOGNORMAL         3
+#define SIZE_DIST_CDF               4
+#define SIZE_CLASS_MAX              16      // 报告档位上限 (含最后的开区间档)
+
+// 思考时间分布与节奏模式
+#define THINK_DIST_NONE             0
+#define THINK_DIST_CONSTANT         1
+#define THINK_DIST_EXPONENTIAL      2
+#define THINK_DIST_LOGNORMAL        3
+#define THINK_DIST_EMPIRICAL        4
+#define PACING_MODE_THINK           0
+#define PACING_MODE_ARRIVAL         1
+
+// 流量回放
+#define TRACE_FORMAT_AUTO           0
+#define TRACE_FORMAT_CSV            1
+#define TRACE_FORMAT_BIN            2
+#define TRACE_OP_SLOTS              3       // PUT / GET / DELETE
+#define TRACE_BIN_MAGIC             "OBSTRC01"
+
+// 可见性探测: 阶段与指标
+#define VIS_PHASE_PUT               1
+#define VIS_PHASE_DELETE            2
+#define VIS_PHASE_STOP              3
+#define VIS_GET_AFTER_PUT           0
+#define VIS_LIST_AFTER_PUT          1
+#define VIS_GET_AFTER_DELETE        2
+#define VIS_LIST_AFTER_DELETE       3
+#define VIS_METRICS                 4
+
+// 热点 Key 竞争: 操作槽位与读结果分类
+#define HOTKEY_OP_PUT               0
+#define HOTKEY_OP_GET               1
+#define HOTKEY_OP_DELETE            2
+#define HOTKEY_OP_SLOTS             3
+#define HOTKEY_HISTORY              8       // 每个 Key 保留的最近写入 (PUT / DELETE) 记录数
+#define HOTKEY_MAX_KEYS             1000000
+#define HOTKEY_READ_LATEST          0       // 读到读开始前最后确认的版本
+#define HOTKEY_READ_INFLIGHT        1       // 读到与本次读并发的写入
+#define HOTKEY_READ_REORDERED       2       // 读到较早确认、但与最后确认写入并发的版本 (服务端定序与确认顺序不同)
+#define HOTKEY_READ_STALE           3       // 读到已被后续写入覆盖的旧版本
+#define HOTKEY_READ_UNKNOWN         4       // ETag 不在记录范围内 (记录已滚出或由其他进程写入)
+#define HOTKEY_READ_OUTCOMES        5
+
+// 稳态对象流转: 操作槽位
+#define CHURN_OP_CREATE             0
+#define CHURN_OP_OVERWRITE          1
+#define CHURN_OP_READ               2
+#define CHURN_OP_DELETE             3
+#define CHURN_OP_SLOTS              4
+
+// 控制面压测: 每个桶生命周期内的操作槽位与可选配置组
+#define CP_OP_CREATE                0
+#define CP_OP_HEAD                  1
+#define CP_OP_SET_POLICY            2
+#define CP_OP_GET_POLICY            3
+#define CP_OP_SET_LIFECYCLE         4
+#define CP_OP_GET_LIFECYCLE         5
+#define CP_OP_SET_CORS              6
+#define CP_OP_GET_CORS              7
+#define CP_OP_SET_TAGGING           8
+#define CP_OP_GET_TAGGING           9
+#define CP_OP_SET_VERSIONING        10
+#define CP_OP_GET_VERSIONING        11
+#define CP_OP_DELETE                12
+#define CP_OP_SLOTS                 13
+#define CP_GROUP_HEAD               0x01
+#define CP_GROUP_POLICY             0x02
+#define CP_GROUP_LIFECYCLE          0x04
+#define CP_GROUP_CORS               0x08
+#define CP_GROUP_TAGGING            0x10
+#define CP_GROUP_VERSIONING         0x20
+#define CP_GROUP_ALL                0x3f
+#define CP_BUCKET_NAME_MAX          63      // 桶名长度上限
+#define BUCKET_INDEX_TEMP           (-2)    // 控制面临时桶: 明细日志中桶名取自 Key 列
+
+// 并行文件系统目录树压测: 统计阶段、可选步骤与树形上限
+#define PFS_PHASE_MKDIR             0
+#define PFS_PHASE_PUT               1
+#define PFS_PHASE_LIST              2
+#define PFS_PHASE_HEAD              3
+#define PFS_PHASE_GET               4
+#define PFS_PHASE_RENAME            5
+#define PFS_PHASE_DELETE            6
+#define PFS_PHASE_SLOTS             7
+#define PFS_STEP_CREATE             0x01    // mkdir + 写入文件
+#define PFS_STEP_LIST               0x02
+#define PFS_STEP_HEAD               0x04
+#define PFS_STEP_GET                0x08
+#define PFS_STEP_RENAME             0x10
+#define PFS_STEP_DELETE             0x20
+#define PFS_STEP_ALL                0x3f
+#define PFS_MAX_DEPTH               8
+#define PFS_MAX_NODES_PER_USER      100000000LL
+
+// 建连开销压测的三组对照 (ConnCostArms 按位选择)
+#define CONN_ARM_PERSISTENT         0       // 始终复用连接
+#define CONN_ARM_NEW                1       // 每个请求新建连接
+#define CONN_ARM_PERIODIC           2       // 每 N 个请求重建一次连接
+#define CONN_ARM_SLOTS              3
+#define CONN_ARM_ALL                0x07
+
+// 多接入点选择策略 (EndpointPolicy)
+#define ENDPOINT_POLICY_THREAD      0       // 线程按编号轮流绑定一个接入点
+#define ENDPOINT_POLICY_ROUND_ROBIN 1       // 每线程逐请求轮转
+#define ENDPOINT_POLICY_HASH        2       // 按 Key 哈希, 同一 Key 固定落在同一接入点
+#define ENDPOINT_POLICY_P2C         3       // 随机取两个, 选时延 EWMA 较低者
+#define ENDPOINT_MAX                32
+#define ENDPOINT_STALE_MS           1000.0  // P2C: 超过该时长没有样本的接入点视为最优, 保证重新探测
+
+// 域名解析方式 (DnsMode)
+#define DNS_MODE_SDK                0       // 由 SDK 在每次建连时解析
+#define DNS_MODE_RESOLVE            1       // 启动时解析一次, 请求固定发往解析出的 IP
+#define DNS_MODE_STATIC             2       // 使用 DnsStaticHosts 中的 host:IP 对应表
+#define DNS_MAX_PROBES              100
+
+// 服务端加密模式
+#define SSE_MODE_NONE               0
+#define SSE_MODE_KMS                1
+#define SSE_MODE_C                  2       // SSE-C, 客户端提供密钥
+#define SSE_C_KEY_LEN               44      // 32 字节 AES256 密钥的 Base64 长度
+
+// Mock SDK 模型的操作分类数, 与 mock_eSDKOBS.h 中的 MOCK_SDK_OP_* 对应
+#define MOCK_OP_SLOTS               9
+
+// 重试退避抖动策略
+#define RETRY_JITTER_NONE           0
+#define RETRY_JITTER_FULL           1
+#define RETRY_JITTER_DECORRELATED   2
+
+// 对象大小别名表 (Vose), 由配置编译而来, 只读共享
+typedef struct {
+    int n;
+    long long *lo;
+    long long *hi;
+    uint32_t *threshold;            // 低 32 位随机数 <= threshold 时取本区间, 否则取 alias
+    int *alias;
+    double mean;
+    long long max;
+} SizeDistTable;
+
+// 令牌桶 (GCRA), 独占缓存行避免多线程伪共享
+typedef struct {
+    volatile long long tat_ns;
+    double ns_per_unit;
+    long long tolerance_ns;
+    int enabled;
+} __attribute__((aligned(64))) TokenBucket;
+
+// 进程级重试预算 (千分之一令牌为单位)
+typedef struct {
+    volatile long long tokens_milli;
+    long long capacity_milli;
+    long long deposit_milli;
+    int enabled;
+} __attribute__((aligned(64))) RetryBudget;
+
+// 线程私有的退避状态
+typedef struct {
+    unsigned int seed;
+    double prev_delay_ms;
+} RetryState;
+
 typedef struct {
     char username[64];
     char ak[128];
@@ -59,12 +280,43 @@ typedef struct {
     int http_code;      
     long long bytes;
     char request_id[64];
+    int bucket_index;               // 多桶模式下所用的桶序号, -1 表示单桶
 } ReqRecord;
 
+// 客户端节奏状态 (每个线程 / 虚拟客户端一份)
+typedef struct {
+    long long deadline_ns;          // 下一次计划发起时刻
+    long long last_start_ns;
+    long long intended_gap_ns;      // 计划到达间隔: arrival 为采样值, think 为 时延 + 思考时间
+    int started;
+} PacingState;
+
+// 明细日志批量缓冲 (每个 Worker / 承载线程一份)
+typedef struct {
+    FILE *detail_fp;
+    ReqRecord *batch_buffer;
+    int batch_count;
+    int file_part_idx;
+    long long total_written_rows;
+} DetailLogState;
+
 typedef struct {
     char endpoint[256];
     char protocol[16];
     int keep_alive;
+    int path_style;                 // 1 = 路径方式访问桶 (/<bucket>/<key>), 用于本地替身服务等无桶域名的环境
+
+    // --- 多接入点 (Endpoints 非空时生效, endpoint 取第一个) ---
+    char endpoints[ENDPOINT_MAX][256];
+    int endpoint_count;
+    int endpoint_policy;            // ENDPOINT_POLICY_*
+    double endpoint_ewma_alpha;     // P2C 时延 EWMA 的平滑系数
+    char endpoint_origin[ENDPOINT_MAX][128];    // IP 固定后各接入点解析自的域名, 未固定时为空
+
+    // --- 域名预解析与 IP 固定 ---
+    int dns_mode;                   // DNS_MODE_*
+    char dns_static_hosts[1024];    // host:IP,host:IP,...
+    int dns_probe_count;            // 启动时每个域名的计时解析次数 / 每个 IP 的 TCP 建连探测次数
 
     // --- 超时防卡死配置 (秒) ---
     int connect_timeout_sec;
@@ -77,6 +329,7 @@ typedef struct {
     char bucket_name_prefix[64];
     char bucket_name_fixed[128];
     char bucket_location[64];
+    int buckets_per_user;           // >1 时每用户 N 个桶 (<桶名>-<序号>), Key 按哈希路由
 
     // --- 用户列表 ---
     UserCredential *user_list;
@@ -91,6 +344,15 @@ typedef struct {
     long long object_size_min;  
     long long object_size_max;  
     int is_dynamic_size;        
+    int object_size_dist;           // SIZE_DIST_*, 未配置时由 ObjectSize 推断 (fixed / uniform)
+    char object_size_buckets[1024]; // buckets: "4KB:50,64KB-1MB:30,1GB:1"
+    double object_size_median;      // lognormal: 中位数 (字节)
+    double object_size_sigma;       // lognormal: ln 尺度标准差
+    char object_size_file[256];     // cdf: 每行 "大小,累计概率"
+    char object_size_report_buckets[256];   // 报告档位边界, 留空使用 4KB,64KB,1MB,16MB,256MB,4GB
+    long long size_class_bounds[SIZE_CLASS_MAX];
+    int size_class_count;
+    SizeDistTable *size_table;
 
     // --- Range 下载配置 ---
     char *range_options[MAX_RANGE_OPTIONS];
@@ -103,6 +365,11 @@ typedef struct {
     
     LogLevel log_level;
     int obj_name_pattern_hash; 
+    int key_scheme;                 // KEY_SCHEME_*, 未配置时按 ObjNamePatternHash 取 flat / hashed
+    char key_template[256];         // KeyScheme=template 时的模板
+    int key_length;                 // > 0 时 Key 以填充字符补齐到该长度
+    int key_tree_depth;             // KeyScheme=tree 的目录层数
+    int key_tree_fanout;            // 每级目录数
 
     // --- 断点续传 ---
     int enable_checkpoint;      
@@ -124,12 +391,127 @@ typedef struct {
     char client_enc_cert_path[256];
     char client_enc_key_path[256];
 
+    // --- 服务端加密 ---
+    int sse_mode;                   // SSE_MODE_*
+    char sse_kms_key_id[256];       // SSE-KMS 主密钥 ID, 为空使用默认主密钥
+    char sse_c_key[SSE_C_KEY_LEN + 1];      // SSE-C 密钥 (Base64), 未配置时每次运行随机生成
+    int sse_c_key_generated;        // 1: 密钥为本次运行随机生成
+
     // --- 数据校验与日志 ---
     int enable_data_validation;
     int enable_detail_log;      
     int resumable_task_num;     
     char task_log_dir[256];     
 
+    // --- 分布式压测 (Coordinator / Agent) ---
+    int distributed_agents;         // >0 时本进程作为 Coordinator, 等待该数量的 Agent 接入
+    char coordinator_bind[64];      // Coordinator 监听地址 (默认仅本机)
+    char distributed_token[128];    // Agent 接入口令, 为空时读取环境变量 OBS_BENCH_DIST_TOKEN
+    int coordinator_port;
+    int distributed_start_delay_ms; // 下发配置后统一起跑的延迟
+    int agent_index;                // Agent 序号 (由 Coordinator 分配), 单机模式为 0
+    int agent_count;
+    int thread_id_base;             // 全局线程号偏移, 保证各 Agent 的 Key 空间互不重叠
+
+    // --- 限速 (令牌桶, 0 表示不限) ---
+    double rate_limit_tps;          // 全局请求数/秒
+    double rate_limit_mbps;         // 全局带宽 MB/s
+    double user_rate_limit_tps;     // 每用户
+    double user_rate_limit_mbps;
+    double thread_rate_limit_tps;   // 每线程
+    double thread_rate_limit_mbps;
+    double rate_limit_burst_ms;     // 允许的突发窗口
+
+    // --- 重试与退避 ---
+    int retry_max_attempts;         // 单个逻辑请求的最大尝试次数 (1 表示不重试)
+    double retry_base_delay_ms;     // 退避基数, 同时用于最终失败后的冷却
+    double retry_max_delay_ms;      // 退避上限
+    int retry_jitter;               // RETRY_JITTER_*
+    double retry_budget_ratio;      // 每个逻辑请求可换取的重试份额
+    int retry_budget_min;           // 预算桶容量 (允许的突发重试数)
+
+    // --- AIMD 闭环限速 (每用户, 遇 SlowDown/503 乘性下降, 无拥塞时加性上升) ---
+    int aimd_enable;
+    double aimd_initial_tps;
+    double aimd_increase_tps;       // 每个无拥塞窗口的增量
+    double aimd_decrease_factor;    // 拥塞时的乘性系数 (0~1)
+    double aimd_min_tps;
+    double aimd_max_tps;            // 0 表示不设上限
+    double aimd_window_ms;          // 调整窗口, 同时是两次下降之间的冷却时间
+
+    // --- CPU 亲和性与 NUMA 放置 ---
+    int affinity_mode;              // AFFINITY_MODE_*
+    char affinity_cpu_list[1024];   // cpus 模式: Worker 依次绑定的 CPU 列表, 如 "0-31,64-95"
+    char affinity_numa_nodes[256];  // numa 模式: 参与轮转的节点, 留空表示全部节点
+    char affinity_service_cpus[256];// 监控 / 控制面线程绑定的 CPU 列表, 留空不绑定
+
+    // --- 协程虚拟客户端 (0 表示关闭, 每个 Worker 线程即一个客户端) ---
+    int virtual_clients_per_thread;
+    int fiber_stack_kb;             // 每个虚拟客户端的栈大小
+
+    // --- 客户端节奏 (思考时间 / 到达间隔分布) ---
+    int think_time_dist;            // THINK_DIST_*
+    int pacing_mode;                // PACING_MODE_*
+    double think_time_mean_ms;
+    double think_time_stddev_ms;    // lognormal 使用
+    char think_time_file[256];      // empirical 使用
+    double *think_empirical_values;
+    double *think_empirical_cdf;
+    int think_empirical_count;
+
+    // --- 流量回放 (TestCase=910) ---
+    char trace_file[256];
+    int trace_format;               // TRACE_FORMAT_*
+    double trace_time_unit_us;      // trace 时间戳单位换算为微秒的系数
+    double trace_speedup;           // 时间压缩倍数, 如 24 表示一天的流量在一小时内回放
+    int trace_queue_depth;          // 每个 Worker 的预读队列深度
+
+    // --- 读写可见性探测 (TestCase=920) ---
+    int visibility_readers;         // 每个写者配对的读者线程数
+    int visibility_read_head;       // 1: 用 HEAD 判断存在 (只比较长度); 0: GET 并校验内容
+    int visibility_check_list;      // 同时探测 LIST 可见性
+    double visibility_poll_ms;      // 读者轮询间隔
+    double visibility_timeout_ms;   // 超过该时长仍不可见记为违例
+
+    // --- 热点 Key 竞争 (TestCase=930) ---
+    int hotkey_count;               // 热点集合大小, 1 为完全竞争
+    int hotkey_weights[HOTKEY_OP_SLOTS];    // PUT / GET / DELETE 权重
+
+    // --- 稳态对象流转 (TestCase=940) ---
+    long long churn_working_set;    // 每用户的对象槽位数 (分布式模式下由各 Agent 均分)
+    int churn_weights[CHURN_OP_SLOTS];      // 新建 / 覆盖 / 读取 / 删除 权重
+
+    // --- 控制面压测 (TestCase=950) ---
+    int cp_groups;                  // 建桶与删桶之间执行的配置组 (CP_GROUP_*)
+    char cp_bucket_prefix[32];      // 临时桶名前缀
+    unsigned int cp_run_tag;        // 本次运行的桶名标识 (启动时间), 区分多次运行遗留的桶
+
+    // --- 并行文件系统目录树 (TestCase=970) ---
+    int pfs_tree_depth;             // 根目录之下的目录层数
+    int pfs_tree_fanout;            // 每个目录的子目录数
+    int pfs_files_per_leaf;         // 每个叶子目录下的文件数
+    int pfs_steps;                  // 执行的步骤 (PFS_STEP_*)
+    int pfs_read_rounds;            // list / head / get 步骤的重复轮数
+
+    // 建连开销压测 (TestCase=980)
+    int conn_cost_arms;             // 执行的对照组, 按位 (1 << CONN_ARM_*)
+    int conn_reconnect_every;       // periodic 组每 N 个请求重建一次连接
+
+    // --- Mock SDK 时延 / 带宽 / 故障模型 (仅 Mock 版本生效) ---
+    int mock_latency_dist;          // THINK_DIST_* (不支持 empirical)
+    double mock_latency_ms[MOCK_OP_SLOTS];  // 各类操作的平均首字节时延
+    double mock_latency_cv;         // lognormal 的变异系数
+    double mock_bandwidth_mbps;     // 单连接带宽上限 MB/s, 0 = 不限
+    double mock_connect_ms;         // 新建连接 (含 TLS 握手) 的耗时, 0 = 不模拟
+    double mock_conn_fail_rate;
+    double mock_slow_down_rate;
+    double mock_fail_403_rate;
+    double mock_fail_404_rate;
+    double mock_fail_409_rate;
+    double mock_truncate_rate;      // 响应体中途截断 / 上传中途断连
+    double mock_corrupt_rate;       // 响应体损坏一个字节
+    int mock_store;                 // 1 = 对象读写内存存储 (有状态), 0 = 固定内容的虚拟对象
+
 } Config;
 
 typedef struct {
@@ -145,8 +527,283 @@ typedef struct {
     double total_latency_ms;
     double max_latency_ms;
     double min_latency_ms;
+    long long throttled_ns;         // 因限速而等待的累计时长
+    long long throttled_count;      // 被限速的请求数
+    long long attempt_count;        // 实际发出的请求次数 (含重试)
+    long long retry_count;
+    long long retry_budget_exhausted;
+    LatencyHistogram latency_hist;          // 逻辑请求端到端时延 (含重试与退避)
+    LatencyHistogram first_attempt_hist;    // 首次尝试时延
+    long long interarrival_ns;              // 实际到达间隔累计
+    long long intended_interarrival_ns;     // 计划到达间隔累计
+    long long pacing_lag_ns;                // 实际发起晚于计划时刻的累计时长
+    long long pacing_late_count;            // arrival 模式下计划时刻已过才发起的次数
+    LatencyHistogram interarrival_hist;     // 实际到达间隔分布
+    long long cpu_ns;                       // Worker 线程自身消耗的 CPU 时间 (客户端开销)
 } ThreadStats;
 
+// 每个对象大小档位的统计
+typedef struct {
+    long long success_count;
+    long long fail_count;
+    long long bytes;
+    double total_latency_ms;
+    LatencyHistogram latency_hist;
+} SizeClassStats;
+
+// 回放记录 (读取线程已换算为计划发起时刻)
+typedef struct {
+    long long sched_ns;             // CLOCK_MONOTONIC
+    long long size;
+    int op;                         // TEST_CASE_PUT / GET / DELETE
+    char key[MAX_KEY_LEN];
+} TraceRecord;
+
+// 单生产者单消费者环形队列: 读取线程写入, 对应 Worker 消费
+typedef struct {
+    TraceRecord *slots;
+    long long mask;
+    volatile long long head __attribute__((aligned(64)));   // 读取线程写入位置
+    volatile long long tail __attribute__((aligned(64)));   // Worker 消费位置
+    volatile int eof;               // 读取线程已读完
+    volatile int closed;            // Worker 已退出, 不再消费
+} TraceQueue;
+
+// 每个 Worker 的回放统计
+typedef struct {
+    long long issued;
+    long long lag_ns;               // 实际发起晚于计划时刻的累计时长
+    long long late_count;           // 滞后超过 1ms 的请求数
+    LatencyHistogram lag_hist;
+    SizeClassStats ops[TRACE_OP_SLOTS];
+} TraceWorkerStats;
+
+typedef struct {
+    const Config *cfg;
+    int queue_count;
+    TraceQueue *queues;             // 每个本地 Worker 一个, 按 Key 哈希分片
+    TraceWorkerStats *stats;
+    long long start_ns;             // trace 第一条记录对应的发起时刻
+    long long stop_ns;
+    int fd;
+    FILE *csv_fp;
+    const unsigned char *map;       // 二进制格式的 mmap 区域
+    long long file_size;
+    volatile long long bytes_read;
+    long long first_ts_us;
+    long long last_ts_us;
+    long long records_read;
+    long long records_local;        // 分片到本 Agent 的记录
+    long long skipped_malformed;
+    long long skipped_op;
+    long long reader_late;          // 入队时已晚于计划时刻 (读取线程跟不上)
+    long long reader_blocked_ns;    // 队列满而等待的累计时长
+} TraceReplay;
+
+// 写者与其读者之间的探测通道 (每组一个)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    long long epoch;                // 每发布一次探测递增
+    int phase;                      // VIS_PHASE_*
+    char key[MAX_KEY_LEN];
+    long long size;
+    long long stamp;                // 写入内容的 pattern 起始偏移
+    long long ack_ns;               // 写者收到 PUT / DELETE 响应的时刻
+    int readers;
+    int pending;                    // 尚未完成本阶段探测的读者数
+} VisibilityChannel;
+
+// 热点 Key 的一次写入 (DELETE 的 tag 为 0)
+typedef struct {
+    uint64_t tag;                   // ETag 的哈希
+    long long start_ns;
+    long long ack_ns;
+} HotKeyVersion;
+
+// 每个热点 Key 的共享状态, 同一桶内的全部线程共用
+typedef struct {
+    pthread_mutex_t lock;
+    HotKeyVersion history[HOTKEY_HISTORY];
+    int history_next;
+    long long ops;
+    long long fails;
+    long long code_409;
+    long long code_503;
+    long long overlapping_puts;     // 与其他 PUT 并发完成的 PUT
+    long long stale_reads;
+    double total_latency_ms;
+    double max_latency_ms;
+} __attribute__((aligned(64))) HotKeyState;
+
+typedef struct {
+    SizeClassStats ops[HOTKEY_OP_SLOTS];
+    long long code_409[HOTKEY_OP_SLOTS];
+    long long code_503[HOTKEY_OP_SLOTS];
+    long long reads[HOTKEY_READ_OUTCOMES];
+} HotKeyThreadStats;
+
+typedef struct {
+    HotKeyState *keys;              // group_count * key_count
+    int group_count;                // 固定桶时为 1, 否则每用户一组
+    int key_count;
+    HotKeyThreadStats *stats;       // 每线程一份
+    int thread_count;
+} HotKeySet;
+
+// 多桶模式下每线程按桶统计
+typedef struct {
+    long long success_count;
+    long long fail_count;
+    long long throttled_count;      // SlowDown / 503
+    long long bytes;
+    double total_latency_ms;
+    double max_latency_ms;
+} BucketStats;
+
+// 多接入点模式下每线程按接入点统计; ewma_ms 为本线程观测到的时延 EWMA (P2C 选择依据)
+typedef struct {
+    SizeClassStats io;
+    long long throttled_count;      // SlowDown / 503
+    long long error_count;          // 5xx 与网络 / SDK 类错误
+    double ewma_ms;
+    double last_sample_ms;          // 最近一次样本的时刻 (CLOCK_MONOTONIC_COARSE), 0 表示尚无样本
+} EndpointStats;
+
+// 每线程独占一段槽位, 位图记录哪些槽位当前存在对象
+typedef struct {
+    uint64_t *bitmap;
+    long long first_slot;           // 在本用户槽位空间中的起始编号
+    long long slot_count;
+    long long live;
+    long long peak_live;
+    long long fallbacks;            // 所选操作无可用槽位 (全满 / 全空) 而改做的次数
+    SizeClassStats ops[CHURN_OP_SLOTS];
+} ChurnThread;
+
+// 控制面压测: 每线程按操作统计, 一个周期为 建桶 -> 配置读写 -> 删桶
+typedef struct {
+    long long cycles;               // 完整走完的周期数
+    long long aborted;              // 建桶失败而跳过后续操作的周期数
+    long long leaked;               // 删桶失败、遗留在服务端的桶数
+    SizeClassStats ops[CP_OP_SLOTS];
+} ControlPlaneThread;
+
+// 分阶段同步点 (目录树 / 建连开销压测共用)
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int parties;                    // 参与同步的线程数, Worker 初始化失败时退出
+    int waiting;
+    unsigned long generation;
+    double mark_ms;                 // 上一次全体放行的时刻
+    double elapsed_ms;              // 最近一次放行距上一次放行的墙钟耗时
+} PhaseBarrier;
+
+// 目录树压测: 进程内全部 Worker 共享, 逐层 / 逐阶段同步, 统计按 [线程][阶段][层级] 排列
+// 层级 0 为每用户的根目录, 1 ~ depth 为各层目录, depth + 1 为文件
+typedef struct {
+    PhaseBarrier barrier;
+    double phase_ms[PFS_PHASE_SLOTS];       // 各阶段墙钟耗时 (多轮累加)
+    double level_ms[PFS_PHASE_SLOTS][PFS_MAX_DEPTH + 2];    // 逐层同步的阶段 (mkdir / delete) 中各层的耗时
+    int levels;                     // depth + 2
+    long long nodes[PFS_MAX_DEPTH + 2];     // 每用户各层的节点数
+    SizeClassStats *cells;
+} PfsTree;
+
+// 建连开销压测: 每线程按 [对照组][新建 / 复用连接] 统计
+typedef struct {
+    SizeClassStats ops[CONN_ARM_SLOTS][2];
+    long long handshakes[CONN_ARM_SLOTS];   // 按连接复用策略推算的建连次数
+} ConnCostThread;
+
+// 进程内全部 Worker 共享, 各组依次执行, 组间同步以分别计时
+typedef struct {
+    PhaseBarrier barrier;
+    double arm_ms[CONN_ARM_SLOTS];
+    ConnCostThread *threads;
+} ConnCost;
+
+// 可见性统计 (写者只使用 probes)
+typedef struct {
+    long long probes;
+    long long polls;
+    long long poll_errors;          // 既非存在也非 404 的探测结果
+    long long content_mismatch;     // 读到的内容或长度与写入不一致
+    long long first_miss[VIS_METRICS];      // 写入确认后的首次读取即未观察到新状态
+    long long timeouts[VIS_METRICS];
+    long long regressions[VIS_METRICS];     // 已观察到新状态后又读到旧状态
+    LatencyHistogram hist[VIS_METRICS];     // 写入确认到首次观察到新状态的时长
+} VisibilityStats;
+
+typedef struct {
+    int active;
+    TokenBucket thread_req;
+    TokenBucket thread_bytes;
+    TokenBucket *user_req;          // 同一用户的线程共享, 未开启时为 NULL
+    TokenBucket *user_bytes;
+    TokenBucket *global_req;        // 全部线程共享
+    TokenBucket *global_bytes;
+} RateLimitContext;
+
+typedef struct {
+    double elapsed_s;
+    double rate_tps;
+    long long success_count;
+    long long success_bytes;
+} AimdSample;
+
+// 每用户一个 AIMD 控制器, 由该用户的全部线程共享
+typedef struct {
+    TokenBucket *bucket;            // 受控的用户请求桶
+    const Config *cfg;
+    char username[64];
+    double min_tps, max_tps;        // 速率上下限, 与初始速率一样按本 Agent 的份额缩放 (max 为 0 表示不限)
+    volatile long long window_end_ns;
+    volatile long long last_decrease_ns;
+    volatile int congested;         // 当前窗口内是否出现过拥塞信号
+    volatile long long success_count;
+    volatile long long success_bytes;
+    volatile long long congestion_count;
+    volatile long long decrease_events;
+    AimdSample *samples;            // 仅监控线程写入
+    int sample_count;
+    int sample_cap;
+} __attribute__((aligned(64))) AimdController;
+
+// 预编译的 Key 模板片段: 常量片段指向 KeyGen.lit, 变量片段在请求时编码
+typedef struct {
+    unsigned char type;
+    unsigned char width;            // 编号补零宽度 / hash 位数
+    unsigned short off;
+    unsigned short len;
+} KeySegment;
+
+typedef struct {
+    KeySegment segs[KEY_GEN_MAX_SEGS];
+    int seg_count;
+    int max_len;                    // 生成 Key 的长度上界
+    int pad_to;
+    int tree_depth;
+    int tree_fanout;
+    int tree_width;
+    int lit_len;
+    char lit[MAX_KEY_LEN];
+} KeyGen;
+
+// 每线程请求模板: 线程启动时按配置构造一次 options 与各类 handler, 请求时整体复制
+typedef struct {
+    int ready;
+    obs_options options;
+    obs_response_handler response_handler;      // DELETE / COPY / HEAD / 初始化分段 / 桶操作
+    obs_put_object_handler put_handler;
+    obs_get_object_handler get_handler;
+    obs_list_objects_handler list_handler;
+    obs_upload_handler upload_part_handler;
+    obs_complete_multi_part_upload_handler complete_handler;
+    obs_upload_file_response_handler upload_file_handler;
+} RequestTemplate;
+
 typedef struct {
     int thread_id;
     Config *config;
@@ -163,27 +820,271 @@ typedef struct {
     char *pattern_buffer;       
     long long pattern_size;     
     long long pattern_mask;     
+
+    RateLimitContext rate_limit;
+    RetryBudget *retry_budget;
+    AimdController *aimd;           // 未开启 AIMD 时为 NULL
+    SizeClassStats *size_classes;   // 按大小档位统计 (size_class_count + 1 项), 未启用时为 NULL
+    TraceQueue *trace_queue;        // 回放模式下本线程的记录队列
+    TraceWorkerStats *trace_stats;
+    VisibilityChannel *vis_channel; // 可见性探测: 所在组的通道
+    VisibilityStats *vis_stats;
+    int vis_reader;                 // 1 为读者, 0 为写者
+    long long pattern_offset;       // PUT 写入与 GET 校验的 pattern 起始偏移 (可见性探测按 Key 打戳)
+    HotKeyState *hot_keys;          // 热点 Key 竞争: 本线程所在桶的 Key 状态
+    HotKeyThreadStats *hot_stats;
+    char last_etag[256];            // 最近一次 PUT / GET 响应的 ETag
+    ChurnThread *churn;             // 稳态对象流转: 本线程的槽位表
+    ControlPlaneThread *cp;         // 控制面压测: 本线程的按操作统计
+    PfsTree *pfs;                   // 目录树压测: 共享同步点
+    SizeClassStats *pfs_cells;      // 目录树压测: 本线程的 [阶段][层级] 统计
+    ConnCost *conn_cost;            // 建连开销压测: 共享同步点
+    ConnCostThread *conn_cost_stats;
+    char bucket_base[96];           // 多桶模式: 本用户的基础桶名, effective_bucket 随请求切换
+    int bucket_index;               // 当前请求所用的桶序号, -1 表示单桶, BUCKET_INDEX_TEMP 表示临时桶 (桶名即 Key)
+    int user_thread_idx;            // 在所属用户内的线程序号
+    BucketStats *bucket_stats;      // 多桶模式下 buckets_per_user 项, 否则为 NULL
+    EndpointStats *endpoint_stats;  // 多接入点模式下 endpoint_count 项, 否则为 NULL
+    int endpoint_index;             // 当前请求所用的接入点
+    unsigned int endpoint_seed;     // P2C 随机数状态
+    unsigned int endpoint_cursor;   // 逐请求轮转的游标
+    int cpu;                        // 绑定的 CPU, -1 表示未绑定到单个 CPU
+    int numa_node;                  // 所在 NUMA 节点 (拓扑下标), -1 表示未绑定
+    RequestTemplate req_tmpl;       // 请求模板, 由 worker_setup 构造
+    KeyGen key_gen;                 // Key 生成器, 由 worker_setup 按用户名编译
 } WorkerArgs;
 
+// 线程放置计划 (由 /sys/devices/system/node 拓扑与配置生成)
+typedef struct {
+    int mode;
+    int node_count;
+    int node_ids[AFFINITY_MAX_NODES];
+    cpu_set_t node_cpus[AFFINITY_MAX_NODES];
+    short cpu_node[CPU_SETSIZE];    // CPU -> 节点下标, -1 表示离线
+    int cpu_list[CPU_SETSIZE];
+    int cpu_count;
+    int numa_sel[AFFINITY_MAX_NODES];
+    int numa_sel_count;
+    int service_cpus[CPU_SETSIZE];
+    int service_cpu_count;
+} AffinityPlan;
+
 // 函数声明
 int load_config(const char *filename, Config *cfg);
 int load_users_file(const char *filename, Config *cfg, int is_temp_mode); 
+int validate_test_case(Config *cfg);
+const char *sse_mode_to_string(int mode);
 void *worker_routine(void *arg);
+int worker_setup(WorkerArgs *args, DetailLogState *dl);
+void worker_teardown(WorkerArgs *args, DetailLogState *dl);
+long long worker_planned_requests(const Config *cfg);
+int worker_should_stop(const WorkerArgs *args, long long op_index, long long planned);
+int worker_run_op(WorkerArgs *args, DetailLogState *dl, int key_owner_id, long long op_index,
+                  unsigned int *seed, RetryState *retry_state);
+obs_status worker_execute_op(WorkerArgs *args, DetailLogState *dl, int current_case, char *key, long long current_req_size,
+                             char *selected_range, RetryState *retry_state, double *out_latency_ms);
 void fill_pattern_buffer(char *buf, size_t size, int seed);
+void worker_format_key(const WorkerArgs *args, int key_owner_id, long long object_seq_id, char *key, size_t len);
+void detail_log_record(WorkerArgs *args, DetailLogState *dl, double timestamp_s, int op_type, const char *key,
+                       double latency_ms, obs_status status, int http_code, long long bytes, const char *request_id);
+int infer_http_code(obs_status status);
+
+void save_benchmark_report(Config *cfg, const ThreadStats *total, double actual_time_s);
+void print_benchmark_result(const ThreadStats *total, double actual_time_s);
+int prepare_user_credentials(Config *cfg, const char *users_file);
+int run_local_benchmark(Config *cfg, int agent_fd, double start_wall_ms, ThreadStats *out_total, double *out_elapsed_s);
+
+// stats.c
+void hist_reset(LatencyHistogram *h);
+void hist_record(LatencyHistogram *h, double latency_ms);
+void hist_merge(LatencyHistogram *dst, const LatencyHistogram *src);
+double hist_percentile(const LatencyHistogram *h, double pct);
+double hist_bucket_upper_ms(int idx);
+void stats_init(ThreadStats *s);
+void stats_merge(ThreadStats *dst, const ThreadStats *src);
+long long stats_total_fail(const ThreadStats *s);
+void stats_record_latency(ThreadStats *s, double latency_ms);
+
+// rate_limiter.c
+long long monotonic_now_ns(void);
+void sleep_until_ns(long long deadline_ns);
+void token_bucket_init(TokenBucket *tb, double units_per_sec, double burst_ms);
+void token_bucket_set_rate(TokenBucket *tb, double units_per_sec);
+double token_bucket_get_rate(const TokenBucket *tb);
+long long token_bucket_reserve(TokenBucket *tb, long long units, long long now_ns);
+int rate_limit_enabled(const Config *cfg);
+void rate_limit_acquire(WorkerArgs *args, long long bytes);
+
+// retry_policy.c
+int retry_jitter_from_string(const char *val);
+const char *retry_jitter_to_string(int jitter);
+void retry_budget_init(RetryBudget *b, const Config *cfg);
+void retry_budget_deposit(RetryBudget *b);
+int retry_policy_should_retry(WorkerArgs *args, obs_status status, int attempt, int validation_failed);
+double retry_policy_backoff_ms(const Config *cfg, RetryState *st, int attempt);
+void retry_policy_sleep(const Config *cfg, RetryState *st, int attempt);
+
+// aimd.c
+int aimd_init(AimdController *c, TokenBucket *bucket, const Config *cfg, const char *username, double share);
+void aimd_release(AimdController *c);
+void aimd_on_result(AimdController *c, obs_status status, long long bytes);
+void aimd_sample(AimdController *ctrls, int count, double elapsed_s);
+void aimd_converged(const AimdController *c, double *out_tps, double *out_mbps, double *out_rate);
+void aimd_save_report(const Config *cfg, const AimdController *ctrls, int count);
+
+// affinity.c
+int affinity_mode_from_string(const char *val);
+const char *affinity_mode_to_string(int mode);
+int affinity_parse_list(const char *s, int *out, int max);
+int affinity_plan_init(AffinityPlan *plan, const Config *cfg);
+int affinity_worker_cpuset(const AffinityPlan *plan, int local_idx, cpu_set_t *set, int *out_cpu, int *out_node);
+int affinity_service_cpuset(const AffinityPlan *plan, cpu_set_t *set);
+int affinity_thread_create(pthread_t *tid, const cpu_set_t *set, void *(*routine)(void *), void *arg);
+void affinity_save_report(const Config *cfg, const AffinityPlan *plan, const WorkerArgs *t_args, int count, double elapsed_s);
+
+// size_dist.c
+int size_dist_from_string(const char *val);
+const char *size_dist_to_string(int dist);
+long long parse_size_bytes(const char *s);
+int size_dist_build(Config *cfg);
+void size_dist_free(SizeDistTable *t);
+long long size_dist_sample(const Config *cfg, uint64_t key_seed);
+int size_class_init(Config *cfg);
+int size_class_of(const Config *cfg, long long size);
+void size_class_record(SizeClassStats *sc, int ok, long long bytes, double latency_ms);
+void size_class_save_report(const Config *cfg, const SizeClassStats *classes, double elapsed_s);
+
+// pacing.c
+int think_dist_from_string(const char *val);
+const char *think_dist_to_string(int dist);
+int pacing_load_empirical(Config *cfg);
+double pacing_sample_ms(const Config *cfg, unsigned int *seed);
+void pacing_init(PacingState *ps, long long first_deadline_ns);
+void pacing_begin_op(WorkerArgs *args, PacingState *ps);
+void pacing_end_op(WorkerArgs *args, PacingState *ps, unsigned int *seed);
+
+// fiber.c
+int fiber_sleep_until(long long deadline_ns);
+void fiber_carrier_run(WorkerArgs *args, DetailLogState *dl);
+
+// trace.c
+int trace_op_from_string(const char *val);
+int trace_replay_init(TraceReplay *tr, const Config *cfg, double stop_timestamp_ms);
+void trace_replay_release(TraceReplay *tr);
+void *trace_reader_routine(void *arg);
+void trace_worker_run(WorkerArgs *args, DetailLogState *dl);
+double trace_progress(const TraceReplay *tr);
+void trace_save_report(const TraceReplay *tr, double elapsed_s);
+int trace_convert(const char *csv_path, const char *bin_path, double time_unit_us);
+
+// visibility.c
+void visibility_channel_init(VisibilityChannel *ch, int readers);
+void visibility_channel_destroy(VisibilityChannel *ch);
+void visibility_worker_run(WorkerArgs *args, DetailLogState *dl);
+void visibility_save_report(const Config *cfg, const VisibilityStats *stats, int count);
+
+// hotkey.c
+int hotkey_set_init(HotKeySet *set, const Config *cfg);
+void hotkey_set_release(HotKeySet *set);
+void hotkey_run_op(WorkerArgs *args, DetailLogState *dl, unsigned int *seed, RetryState *retry_state);
+void hotkey_save_report(const Config *cfg, const HotKeySet *set, double elapsed_s);
+
+// buckets.c
+int bucket_of_key(const Config *cfg, const char *key);
+void bucket_select(WorkerArgs *args, int idx);
+void bucket_route(WorkerArgs *args, const char *key);
+void bucket_format_name(char *out, size_t len, const char *base, int idx);
+void bucket_save_report(const Config *cfg, const WorkerArgs *t_args, double elapsed_s);
+
+// endpoints.c
+int endpoint_parse_key(Config *cfg, const char *key, const char *val);
+void endpoint_route(WorkerArgs *args, const char *key);
+void endpoint_record(WorkerArgs *args, int ok, int http_code, long long bytes, double latency_ms);
+void endpoint_write_brief(FILE *fp, const Config *cfg);
+void endpoint_save_report(const Config *cfg, const EndpointStats *stats, int threads, double elapsed_s);
+
+// dns_pin.c
+int dns_parse_key(Config *cfg, const char *key, const char *val);
+int dns_pin_endpoints(Config *cfg);
+
+// churn.c
+ChurnThread *churn_alloc(const Config *cfg);
+void churn_free(ChurnThread *threads, int count);
+void churn_run_op(WorkerArgs *args, DetailLogState *dl, unsigned int *seed, RetryState *retry_state);
+void churn_save_report(const Config *cfg, const ChurnThread *threads, int count, double elapsed_s);
+
+// control_plane.c
+int control_plane_parse_groups(const char *val);
+int control_plane_bucket_name(const Config *cfg, int key_owner_id, long long cycle, char *out, size_t len);
+void control_plane_run_cycle(WorkerArgs *args, DetailLogState *dl, int key_owner_id, long long cycle,
+                             RetryState *retry_state);
+void control_plane_save_report(const Config *cfg, const ControlPlaneThread *threads, int count, double elapsed_s);
+
+// pfs_tree.c
+int pfs_tree_parse_key(Config *cfg, const char *key, const char *val);
+long long pfs_tree_node_count(const Config *cfg);
+PfsTree *pfs_tree_alloc(const Config *cfg);
+void pfs_tree_free(PfsTree *tree);
+void pfs_tree_leave(PfsTree *tree);
+void pfs_tree_worker_run(WorkerArgs *args, DetailLogState *dl);
+void pfs_tree_write_brief(FILE *fp, const Config *cfg);
+void pfs_tree_save_report(const Config *cfg, const PfsTree *tree, int count);
+
+// phase_barrier.c
+void phase_barrier_init(PhaseBarrier *b, int parties);
+void phase_barrier_destroy(PhaseBarrier *b);
+int phase_barrier_wait(PhaseBarrier *b);
+void phase_barrier_leave(PhaseBarrier *b);
+
+// conn_cost.c
+int conn_cost_parse_key(Config *cfg, const char *key, const char *val);
+ConnCost *conn_cost_alloc(const Config *cfg);
+void conn_cost_free(ConnCost *cc);
+void conn_cost_leave(ConnCost *cc);
+void conn_cost_worker_run(WorkerArgs *args, DetailLogState *dl);
+void conn_cost_write_brief(FILE *fp, const Config *cfg);
+void conn_cost_save_report(const Config *cfg, const ConnCost *cc, int count);
+
+// mock_model.c
+int mock_model_parse_key(Config *cfg, const char *key, const char *val);
+int mock_model_validate(const Config *cfg);
+int mock_model_enabled(const Config *cfg);
+void mock_model_write_brief(FILE *fp, const Config *cfg);
+void mock_model_apply(const Config *cfg);
+
+// key_gen.c
+int key_scheme_from_string(const char *s);
+const char *key_scheme_to_string(int scheme);
+int key_gen_parse_key(Config *cfg, const char *key, const char *val);
+int key_gen_validate(Config *cfg);
+int key_gen_compile(KeyGen *kg, const Config *cfg, const char *username, char *err, size_t err_len);
+int key_gen_format(const KeyGen *kg, int key_owner_id, long long object_seq_id, char *out, size_t len);
+void key_gen_write_brief(FILE *fp, const Config *cfg);
+
+// microbench.c
+int microbench_run(const char *out_file, const char *baseline_file, double threshold_pct, int duration_ms);
 
-void save_benchmark_report(Config *cfg, long long total, 
-                           long long success, long long fail, 
-                           long long f403, long long f404, long long f409, long long f4other,
-                           long long f5xx, long long fother, long long fvalidate,
-                           double tps, double throughput);
+// distributed.c
+int run_coordinator(Config *cfg, const char *config_file);
+int run_agent(Config *cfg, const char *coordinator_addr);
+int agent_send_interval(int fd, double elapsed_s, long long success, long long fail, long long bytes);
 
+void adapter_build_template(WorkerArgs *args);
+void adapter_setup_options(obs_options *option, WorkerArgs *args);
 obs_status run_create_bucket_benchmark(WorkerArgs *args, char *out_req_id);
 obs_status run_delete_bucket_benchmark(WorkerArgs *args, char *out_req_id);
+obs_status run_bucket_config_benchmark(WorkerArgs *args, int op_case, char *out_req_id);
 obs_status run_put_benchmark(WorkerArgs *args, char *key, long long object_size, char *out_req_id);
 obs_status run_get_benchmark(WorkerArgs *args, char *key, char *range_str, char *out_req_id);
 obs_status run_delete_benchmark(WorkerArgs *args, char *key, char *out_req_id);
+obs_status run_copy_benchmark(WorkerArgs *args, char *key, char *out_req_id);
 obs_status run_list_benchmark(WorkerArgs *args, char *out_req_id);
+obs_status run_list_dir_benchmark(WorkerArgs *args, char *prefix, char *out_req_id);
+obs_status run_rename_benchmark(WorkerArgs *args, char *key, char *out_req_id);
 obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id);
+obs_status run_get_probe(WorkerArgs *args, char *key, int *out_mismatch, char *out_req_id);
+obs_status run_head_probe(WorkerArgs *args, char *key, long long *out_size, char *out_req_id);
+obs_status run_list_probe(WorkerArgs *args, char *key, int *out_found, char *out_req_id);
 obs_status run_upload_file_benchmark(WorkerArgs *args, char *key, char *out_req_id);
 
 #endif
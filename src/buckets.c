@@ -0,0 +1,107 @@
+#include "bench.h"
+#include <math.h>
+
+// ----------------------------------------------------------------------------
+// 多桶路由 (BucketsPerUser > 1)
+// 每个用户使用 N 个桶: <基础桶名>-0 ~ <基础桶名>-(N-1), 对象请求按 Key 的 FNV-1a 哈希
+// 路由, 同一 Key 的读写始终落在同一个桶。TestCase 101/104 由该用户在各 Agent 上的全部线程 (或虚拟客户端) 分摊 N 个桶。
+// 每线程按桶统计请求、失败、限流与时延, 结束时按用户合并, 用于观察热点桶的不均衡。
+// ----------------------------------------------------------------------------
+
+int bucket_of_key(const Config *cfg, const char *key) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const char *p = key; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 1099511628211ULL;
+    }
+    return (int)(h % (uint64_t)cfg->buckets_per_user);
+}
+
+void bucket_format_name(char *out, size_t len, const char *base, int idx) {
+    if (idx < 0) snprintf(out, len, "%s", base);
+    else snprintf(out, len, "%s-%d", base, idx);
+}
+
+void bucket_select(WorkerArgs *args, int idx) {
+    if (idx == args->bucket_index) return;
+    args->bucket_index = idx;
+    bucket_format_name(args->effective_bucket, sizeof(args->effective_bucket), args->bucket_base, idx);
+}
+
+void bucket_route(WorkerArgs *args, const char *key) {
+    if (args->config->buckets_per_user <= 1) return;
+    bucket_select(args, bucket_of_key(args->config, key));
+}
+
+void bucket_save_report(const Config *cfg, const WorkerArgs *t_args, double elapsed_s) {
+    int n = cfg->buckets_per_user;
+    BucketStats *merged = (BucketStats *)malloc(n * sizeof(BucketStats));
+    if (!merged) return;
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/buckets.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "BucketsPerUser:      %d (keys routed by FNV-1a hash)\n", n);
+        fprintf(fp, "\n%-16s %-40s %10s %8s %8s %8s %10s %10s %10s %10s\n", "User", "Bucket", "Requests", "Fail", "503",
+                "Share", "TPS", "BW(MB/s)", "Avg(ms)", "Max(ms)");
+    }
+    printf("\n--- Buckets ---\n");
+
+    for (int u = 0; u < cfg->loaded_user_count; u++) {
+        int first = u * cfg->threads_per_user;
+        if (first >= cfg->threads) break;
+        memset(merged, 0, n * sizeof(BucketStats));
+        for (int t = 0; t < cfg->threads_per_user && first + t < cfg->threads; t++) {
+            const BucketStats *src = t_args[first + t].bucket_stats;
+            if (!src) continue;
+            for (int b = 0; b < n; b++) {
+                merged[b].success_count += src[b].success_count;
+                merged[b].fail_count += src[b].fail_count;
+                merged[b].throttled_count += src[b].throttled_count;
+                merged[b].bytes += src[b].bytes;
+                merged[b].total_latency_ms += src[b].total_latency_ms;
+                if (src[b].max_latency_ms > merged[b].max_latency_ms) merged[b].max_latency_ms = src[b].max_latency_ms;
+            }
+        }
+
+        // 不均衡度: 最热桶请求数 / 平均值, 以及变异系数
+        long long total = 0, hottest = 0;
+        int hot_idx = 0;
+        for (int b = 0; b < n; b++) {
+            long long reqs = merged[b].success_count + merged[b].fail_count;
+            total += reqs;
+            if (reqs > hottest) {
+                hottest = reqs;
+                hot_idx = b;
+            }
+        }
+        double mean = (double)total / n;
+        double var = 0;
+        for (int b = 0; b < n; b++) {
+            double d = merged[b].success_count + merged[b].fail_count - mean;
+            var += d * d;
+        }
+        double cv = mean > 0 ? sqrt(var / n) / mean : 0.0;
+
+        const WorkerArgs *ua = &t_args[first];
+        char name[160];
+        bucket_format_name(name, sizeof(name), ua->bucket_base, hot_idx);
+        printf("User %-16s %d buckets | %lld reqs | hottest %s (%.2fx mean) | CV %.3f\n", ua->username, n, total,
+               name, mean > 0 ? hottest / mean : 0.0, cv);
+
+        if (!fp) continue;
+        for (int b = 0; b < n; b++) {
+            const BucketStats *bs = &merged[b];
+            long long reqs = bs->success_count + bs->fail_count;
+            bucket_format_name(name, sizeof(name), ua->bucket_base, b);
+            fprintf(fp, "%-16s %-40s %10lld %8lld %8lld %7.2f%% %10.2f %10.2f %10.2f %10.2f\n", ua->username, name, reqs,
+                    bs->fail_count, bs->throttled_count, total > 0 ? reqs * 100.0 / total : 0.0,
+                    elapsed_s > 0 ? reqs / elapsed_s : 0.0, elapsed_s > 0 ? bs->bytes / 1024.0 / 1024.0 / elapsed_s : 0.0,
+                    reqs > 0 ? bs->total_latency_ms / reqs : 0.0, bs->max_latency_ms);
+        }
+        fprintf(fp, "%-16s hottest/mean %.2f, CV %.3f\n\n", ua->username, mean > 0 ? hottest / mean : 0.0, cv);
+    }
+    if (fp) fclose(fp);
+    free(merged);
+}
@@ -0,0 +1,187 @@
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// 稳态对象流转 (TestCase=940)
+// 每个用户固定 ChurnWorkingSet 个对象槽位, 由该用户的线程 (及各 Agent) 均分, 每线程用位图
+// 记录自己的槽位中哪些当前存在对象。每次操作按权重在槽位内新建 / 覆盖 / 读取 / 删除:
+// 新建只落在空槽位, 其余只落在已存在的槽位, 所需槽位不存在时改做另一类操作。
+// 桶内对象数始终不超过工作集大小, 可无限期长跑, 用于观察 compaction / GC 压力。
+// ----------------------------------------------------------------------------
+
+static const char *g_op_names[CHURN_OP_SLOTS] = { "CREATE", "OVERWRITE", "READ", "DELETE" };
+
+ChurnThread *churn_alloc(const Config *cfg) {
+    ChurnThread *threads = (ChurnThread *)calloc(cfg->threads, sizeof(ChurnThread));
+    if (!threads) return NULL;
+
+    int agents = cfg->agent_count > 1 ? cfg->agent_count : 1;
+    long long share = cfg->churn_working_set / agents;
+    long long agent_base = (long long)cfg->agent_index * share;
+    int tpu = cfg->threads_per_user;
+    for (int i = 0; i < cfg->threads; i++) {
+        ChurnThread *ct = &threads[i];
+        int t_idx = i % tpu;
+        long long begin = share * t_idx / tpu;
+        long long end = share * (t_idx + 1) / tpu;
+        ct->first_slot = agent_base + begin;
+        ct->slot_count = end - begin;
+        ct->bitmap = (uint64_t *)calloc((ct->slot_count + 63) / 64 + 1, sizeof(uint64_t));
+        if (!ct->bitmap) {
+            churn_free(threads, cfg->threads);
+            return NULL;
+        }
+    }
+    return threads;
+}
+
+void churn_free(ChurnThread *threads, int count) {
+    if (!threads) return;
+    for (int i = 0; i < count; i++) free(threads[i].bitmap);
+    free(threads);
+}
+
+static inline int slot_live(const ChurnThread *ct, long long slot) {
+    return (ct->bitmap[slot >> 6] >> (slot & 63)) & 1;
+}
+
+// 从随机位置起查找一个 存在 (want_live=1) / 空 (want_live=0) 的槽位, 没有时返回 -1
+static long long find_slot(const ChurnThread *ct, unsigned int *seed, int want_live) {
+    if (want_live ? ct->live == 0 : ct->live >= ct->slot_count) return -1;
+    long long start = (((long long)rand_r(seed) << 31) ^ rand_r(seed)) % ct->slot_count;
+    if (slot_live(ct, start) == want_live) return start;
+
+    long long words = (ct->slot_count + 63) / 64;
+    for (long long i = 0; i < words; i++) {
+        long long w = (start / 64 + i) % words;
+        uint64_t bits = want_live ? ct->bitmap[w] : ~ct->bitmap[w];
+        long long tail = ct->slot_count - w * 64;
+        if (tail < 64) bits &= (1ULL << tail) - 1;
+        if (bits) return w * 64 + __builtin_ctzll(bits);
+    }
+    return -1;
+}
+
+static int pick_op(const Config *cfg, unsigned int *seed) {
+    int total = 0;
+    for (int k = 0; k < CHURN_OP_SLOTS; k++) total += cfg->churn_weights[k];
+    int r = rand_r(seed) % total;
+    for (int k = 0; k < CHURN_OP_SLOTS; k++) {
+        if (r < cfg->churn_weights[k]) return k;
+        r -= cfg->churn_weights[k];
+    }
+    return CHURN_OP_READ;
+}
+
+static inline void set_live(ChurnThread *ct, long long slot, int live) {
+    if (live) {
+        ct->bitmap[slot >> 6] |= 1ULL << (slot & 63);
+        ct->live++;
+        if (ct->live > ct->peak_live) ct->peak_live = ct->live;
+    } else {
+        ct->bitmap[slot >> 6] &= ~(1ULL << (slot & 63));
+        ct->live--;
+    }
+}
+
+void churn_run_op(WorkerArgs *args, DetailLogState *dl, unsigned int *seed, RetryState *retry_state) {
+    const Config *cfg = args->config;
+    ChurnThread *ct = args->churn;
+    int op = pick_op(cfg, seed);
+    long long slot;
+
+    if (op == CHURN_OP_CREATE) {
+        slot = find_slot(ct, seed, 0);
+        if (slot < 0) {
+            op = CHURN_OP_OVERWRITE;
+            slot = find_slot(ct, seed, 1);
+            ct->fallbacks++;
+        }
+    } else {
+        slot = find_slot(ct, seed, 1);
+        if (slot < 0) {
+            op = CHURN_OP_CREATE;
+            slot = find_slot(ct, seed, 0);
+            ct->fallbacks++;
+        }
+    }
+    if (slot < 0) return;
+
+    long long object_id = ct->first_slot + slot;
+    char key[MAX_KEY_LEN];
+    snprintf(key, sizeof(key), "%s-churn-%s-%lld", cfg->key_prefix, args->username, object_id);
+    long long size = cfg->size_table ? size_dist_sample(cfg, (uint64_t)object_id) : cfg->object_size_max;
+
+    // 新建 / 删除先占位, 协程模式下同一线程的其他客户端不会再选中该槽位做同类操作
+    if (op == CHURN_OP_CREATE) set_live(ct, slot, 1);
+    else if (op == CHURN_OP_DELETE) set_live(ct, slot, 0);
+
+    int current_case = (op == CHURN_OP_READ) ? TEST_CASE_GET : (op == CHURN_OP_DELETE ? TEST_CASE_DELETE : TEST_CASE_PUT);
+    long long prev_bytes = args->stats.total_success_bytes;
+    double latency_ms = 0;
+    obs_status status = worker_execute_op(args, dl, current_case, key, size, NULL, retry_state, &latency_ms);
+    int ok = (status == OBS_STATUS_OK);
+
+    // 失败时按保守方向回滚: 新建失败视为不存在, 删除失败视为仍存在
+    if (!ok && op == CHURN_OP_CREATE && slot_live(ct, slot)) set_live(ct, slot, 0);
+    else if (!ok && op == CHURN_OP_DELETE && !slot_live(ct, slot)) set_live(ct, slot, 1);
+
+    size_class_record(&ct->ops[op], ok, args->stats.total_success_bytes - prev_bytes, latency_ms);
+}
+
+void churn_save_report(const Config *cfg, const ChurnThread *threads, int count, double elapsed_s) {
+    SizeClassStats ops[CHURN_OP_SLOTS];
+    memset(ops, 0, sizeof(ops));
+    long long slots = 0, live = 0, peak = 0, fallbacks = 0, live_bytes = 0;
+    for (int i = 0; i < count; i++) {
+        const ChurnThread *ct = &threads[i];
+        slots += ct->slot_count;
+        live += ct->live;
+        peak += ct->peak_live;
+        fallbacks += ct->fallbacks;
+        for (int k = 0; k < CHURN_OP_SLOTS; k++) {
+            ops[k].success_count += ct->ops[k].success_count;
+            ops[k].fail_count += ct->ops[k].fail_count;
+            ops[k].bytes += ct->ops[k].bytes;
+            ops[k].total_latency_ms += ct->ops[k].total_latency_ms;
+            hist_merge(&ops[k].latency_hist, &ct->ops[k].latency_hist);
+        }
+        for (long long s = 0; s < ct->slot_count; s++) {
+            if (!slot_live(ct, s)) continue;
+            live_bytes += cfg->size_table ? size_dist_sample(cfg, (uint64_t)(ct->first_slot + s)) : cfg->object_size_max;
+        }
+    }
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/churn.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "WorkingSet:          %lld slots per user (%lld slots on this node)\n", cfg->churn_working_set, slots);
+        fprintf(fp, "Mix (C:O:R:D):       %d:%d:%d:%d\n", cfg->churn_weights[CHURN_OP_CREATE], cfg->churn_weights[CHURN_OP_OVERWRITE],
+                cfg->churn_weights[CHURN_OP_READ], cfg->churn_weights[CHURN_OP_DELETE]);
+        fprintf(fp, "Live At End:         %lld objects (%.2f%% full), %.2f MB\n", live,
+                slots > 0 ? live * 100.0 / slots : 0.0, live_bytes / 1024.0 / 1024.0);
+        fprintf(fp, "Peak Live:           %lld objects (sum of per-thread peaks)\n", peak);
+        fprintf(fp, "Fallbacks:           %lld (no slot for the chosen op)\n", fallbacks);
+        fprintf(fp, "\n%-10s %10s %8s %10s %10s %10s %10s %10s %10s\n", "Op", "Requests", "Fail", "TPS", "BW(MB/s)",
+                "Avg(ms)", "P50(ms)", "P99(ms)", "P99.9(ms)");
+    }
+
+    printf("\n--- Churn ---\n");
+    printf("Working Set:     %lld slots, %lld live at end (%.2f%%), peak %lld, %.2f MB live\n", slots, live,
+           slots > 0 ? live * 100.0 / slots : 0.0, peak, live_bytes / 1024.0 / 1024.0);
+    for (int k = 0; k < CHURN_OP_SLOTS; k++) {
+        const SizeClassStats *o = &ops[k];
+        long long reqs = o->success_count + o->fail_count;
+        if (reqs == 0) continue;
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        double mbps = elapsed_s > 0 ? o->bytes / 1024.0 / 1024.0 / elapsed_s : 0.0;
+        if (fp) {
+            fprintf(fp, "%-10s %10lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", g_op_names[k], reqs, o->fail_count,
+                    tps, mbps, o->total_latency_ms / reqs, hist_percentile(&o->latency_hist, 50.0),
+                    hist_percentile(&o->latency_hist, 99.0), hist_percentile(&o->latency_hist, 99.9));
+        }
+        printf("%-10s TPS %10.2f | BW %8.2f MB/s | Fail %lld | P50 %.2f | P99 %.2f ms\n", g_op_names[k], tps, mbps,
+               o->fail_count, hist_percentile(&o->latency_hist, 50.0), hist_percentile(&o->latency_hist, 99.0));
+    }
+    if (fp) fclose(fp);
+}
@@ -39,6 +39,36 @@ static int parse_mix_ops(const char *val, int *ops, int max_ops) {
     return count;
 }
 
+const char *sse_mode_to_string(int mode) {
+    switch (mode) {
+        case SSE_MODE_KMS: return "sse-kms";
+        case SSE_MODE_C:   return "sse-c";
+        default:           return "none";
+    }
+}
+
+// 生成本次运行的 SSE-C 密钥: 32 字节随机数的 Base64
+static int generate_sse_c_key(char *out) {
+    static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    unsigned char raw[33] = {0};
+    FILE *rf = fopen("/dev/urandom", "rb");
+    if (!rf) return -1;
+    size_t n = fread(raw, 1, 32, rf);
+    fclose(rf);
+    if (n != 32) return -1;
+
+    char *p = out;
+    for (int i = 0; i < 32; i += 3) {
+        uint32_t v = ((uint32_t)raw[i] << 16) | ((uint32_t)raw[i + 1] << 8) | raw[i + 2];
+        *p++ = tbl[(v >> 18) & 63];
+        *p++ = tbl[(v >> 12) & 63];
+        *p++ = (i + 1 < 32) ? tbl[(v >> 6) & 63] : '=';
+        *p++ = (i + 2 < 32) ? tbl[v & 63] : '=';
+    }
+    *p = '\0';
+    return 0;
+}
+
 int load_users_file(const char *filename, Config *cfg, int is_temp_mode) {
     FILE *fp = fopen(filename, "r");
     if (!fp) {
@@ -102,6 +132,9 @@ int load_config(const char *filename, Config *cfg) {
     cfg->parts_for_each_upload_id = 0; 
     cfg->log_level = LOG_INFO; 
     cfg->obj_name_pattern_hash = 0;
+    cfg->key_scheme = -1;
+    cfg->key_tree_depth = 3;
+    cfg->key_tree_fanout = 16;
     cfg->enable_checkpoint = 1; 
     cfg->upload_file_path[0] = '\0'; 
     cfg->requests_per_thread = 1; 
@@ -127,9 +160,90 @@ int load_config(const char *filename, Config *cfg) {
     
     cfg->enable_data_validation = 0;
     cfg->enable_detail_log = 0;
+
+    cfg->distributed_agents = 0;
+    strcpy(cfg->coordinator_bind, "127.0.0.1");
+    cfg->coordinator_port = 19090;
+    cfg->distributed_start_delay_ms = 3000;
+    cfg->agent_count = 1;
+
+    cfg->rate_limit_tps = cfg->rate_limit_mbps = 0;
+    cfg->user_rate_limit_tps = cfg->user_rate_limit_mbps = 0;
+    cfg->thread_rate_limit_tps = cfg->thread_rate_limit_mbps = 0;
+    cfg->rate_limit_burst_ms = 0;
+
+    cfg->retry_max_attempts = 1;
+    cfg->retry_base_delay_ms = 50;
+    cfg->retry_max_delay_ms = 5000;
+    cfg->retry_jitter = RETRY_JITTER_FULL;
+    cfg->retry_budget_ratio = 0.2;
+    cfg->retry_budget_min = 100;
+
+    cfg->aimd_enable = 0;
+    cfg->aimd_initial_tps = 100;
+    cfg->aimd_increase_tps = 10;
+    cfg->aimd_decrease_factor = 0.5;
+    cfg->aimd_min_tps = 1;
+    cfg->aimd_max_tps = 0;
+    cfg->aimd_window_ms = 1000;
+
+    cfg->affinity_mode = AFFINITY_MODE_NONE;
+
+    cfg->virtual_clients_per_thread = 0;
+    cfg->fiber_stack_kb = 256;
+
+    cfg->think_time_dist = THINK_DIST_NONE;
+    cfg->pacing_mode = PACING_MODE_THINK;
+    cfg->think_time_mean_ms = 0;
+    cfg->think_time_stddev_ms = 0;
+
+    cfg->trace_format = TRACE_FORMAT_AUTO;
+    cfg->trace_time_unit_us = 1e6;
+    cfg->trace_speedup = 1.0;
+    cfg->trace_queue_depth = 256;
+
+    cfg->visibility_readers = 1;
+    cfg->visibility_read_head = 0;
+    cfg->visibility_check_list = 1;
+    cfg->visibility_poll_ms = 10;
+    cfg->visibility_timeout_ms = 30000;
+
+    cfg->hotkey_count = 1;
+    cfg->hotkey_weights[HOTKEY_OP_PUT] = 50;
+    cfg->hotkey_weights[HOTKEY_OP_GET] = 40;
+    cfg->hotkey_weights[HOTKEY_OP_DELETE] = 10;
+
+    cfg->buckets_per_user = 1;
+
+    cfg->churn_working_set = 10000;
+    cfg->churn_weights[CHURN_OP_CREATE] = 25;
+    cfg->churn_weights[CHURN_OP_OVERWRITE] = 25;
+    cfg->churn_weights[CHURN_OP_READ] = 40;
+    cfg->churn_weights[CHURN_OP_DELETE] = 10;
+
+    cfg->cp_groups = CP_GROUP_ALL;
+    strcpy(cfg->cp_bucket_prefix, "bench-cp");
+
+    cfg->endpoint_policy = ENDPOINT_POLICY_THREAD;
+    cfg->endpoint_ewma_alpha = 0.3;
+    cfg->dns_mode = DNS_MODE_SDK;
+    cfg->dns_probe_count = 5;
+
+    cfg->pfs_tree_depth = 3;
+    cfg->pfs_tree_fanout = 4;
+    cfg->pfs_files_per_leaf = 16;
+    cfg->pfs_steps = PFS_STEP_ALL;
+    cfg->pfs_read_rounds = 1;
+
+    cfg->conn_cost_arms = CONN_ARM_ALL;
+    cfg->conn_reconnect_every = 10;
+
+    cfg->mock_latency_dist = THINK_DIST_NONE;
+    cfg->mock_latency_cv = 0.5;
     
     cfg->object_size_min = cfg->object_size_max = 1024;
     cfg->is_dynamic_size = 0;
+    cfg->object_size_dist = -1;
     
     cfg->range_count = 0;
     for(int i=0; i<MAX_RANGE_OPTIONS; i++) cfg->range_options[i] = NULL;
@@ -150,6 +264,7 @@ int load_config(const char *filename, Config *cfg) {
         if (strcmp(key, "Endpoint") == 0) strcpy(cfg->endpoint, val);
         else if (strcmp(key, "Protocol") == 0) strcpy(cfg->protocol, val);
         else if (strcmp(key, "KeepAlive") == 0) cfg->keep_alive = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
+        else if (strcmp(key, "PathStyle") == 0) cfg->path_style = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
         // [新增校验]: 对连接超时的配置值进行合法性检查
         else if (strcmp(key, "ConnectTimeoutSec") == 0) {
             if (strlen(val) > 0) {
@@ -200,6 +315,20 @@ int load_config(const char *filename, Config *cfg) {
                 cfg->object_size = cfg->object_size_max;
             }
         }
+        else if (strcmp(key, "ObjectSizeDistribution") == 0) {
+            if (strlen(val) > 0) {
+                cfg->object_size_dist = size_dist_from_string(val);
+                if (cfg->object_size_dist < 0) {
+                    printf("[Config Error] Unknown 'ObjectSizeDistribution': %s (fixed/uniform/buckets/lognormal/cdf)\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "ObjectSizeBuckets") == 0) strncpy(cfg->object_size_buckets, val, sizeof(cfg->object_size_buckets) - 1);
+        else if (strcmp(key, "ObjectSizeMedian") == 0) { if (strlen(val) > 0) cfg->object_size_median = (double)parse_size_bytes(val); }
+        else if (strcmp(key, "ObjectSizeSigma") == 0) { if (strlen(val) > 0) cfg->object_size_sigma = atof(val); }
+        else if (strcmp(key, "ObjectSizeFile") == 0) strncpy(cfg->object_size_file, val, sizeof(cfg->object_size_file) - 1);
+        else if (strcmp(key, "ObjectSizeReportBuckets") == 0) strncpy(cfg->object_size_report_buckets, val, sizeof(cfg->object_size_report_buckets) - 1);
         else if (strcmp(key, "Range") == 0) {
             char *temp = strdup(val);
             if (temp) {
@@ -246,14 +375,392 @@ int load_config(const char *filename, Config *cfg) {
         else if (strcmp(key, "EnableDataValidation") == 0) cfg->enable_data_validation = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
         else if (strcmp(key, "EnableDetailLog") == 0) cfg->enable_detail_log = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
         else if (strcmp(key, "ResumableTaskNum") == 0) cfg->resumable_task_num = atoi(val);
+
+        // ------------------
+        // 分布式压测
+        // ------------------
+        else if (strcmp(key, "DistributedAgents") == 0) cfg->distributed_agents = atoi(val);
+        else if (strcmp(key, "CoordinatorBind") == 0) strncpy(cfg->coordinator_bind, val, sizeof(cfg->coordinator_bind)-1);
+        else if (strcmp(key, "DistributedToken") == 0) {
+            if (strlen(val) >= sizeof(cfg->distributed_token)) {
+                printf("[Config Error] 'DistributedToken' must be shorter than %d chars.\n", (int)sizeof(cfg->distributed_token));
+                fclose(fp); return -1;
+            }
+            strcpy(cfg->distributed_token, val);
+        }
+        else if (strcmp(key, "CoordinatorPort") == 0) {
+            if (strlen(val) > 0) {
+                cfg->coordinator_port = atoi(val);
+                if (cfg->coordinator_port <= 0 || cfg->coordinator_port > 65535) {
+                    printf("[Config Error] 'CoordinatorPort' must be in 1~65535. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "DistributedStartDelayMs") == 0) {
+            if (strlen(val) > 0) cfg->distributed_start_delay_ms = atoi(val);
+        }
+
+        // ------------------
+        // 限速
+        // ------------------
+        else if (strcmp(key, "RateLimitTps") == 0) cfg->rate_limit_tps = atof(val);
+        else if (strcmp(key, "RateLimitMBps") == 0) cfg->rate_limit_mbps = atof(val);
+        else if (strcmp(key, "UserRateLimitTps") == 0) cfg->user_rate_limit_tps = atof(val);
+        else if (strcmp(key, "UserRateLimitMBps") == 0) cfg->user_rate_limit_mbps = atof(val);
+        else if (strcmp(key, "ThreadRateLimitTps") == 0) cfg->thread_rate_limit_tps = atof(val);
+        else if (strcmp(key, "ThreadRateLimitMBps") == 0) cfg->thread_rate_limit_mbps = atof(val);
+        else if (strcmp(key, "RateLimitBurstMs") == 0) cfg->rate_limit_burst_ms = atof(val);
+
+        // ------------------
+        // 重试与退避
+        // ------------------
+        else if (strcmp(key, "RetryMaxAttempts") == 0) {
+            if (strlen(val) > 0) {
+                cfg->retry_max_attempts = atoi(val);
+                if (cfg->retry_max_attempts < 1) {
+                    printf("[Config Error] 'RetryMaxAttempts' must be >= 1. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "RetryBaseDelayMs") == 0) { if (strlen(val) > 0) cfg->retry_base_delay_ms = atof(val); }
+        else if (strcmp(key, "RetryMaxDelayMs") == 0) { if (strlen(val) > 0) cfg->retry_max_delay_ms = atof(val); }
+        else if (strcmp(key, "RetryJitter") == 0) {
+            if (strlen(val) > 0) {
+                cfg->retry_jitter = retry_jitter_from_string(val);
+                if (cfg->retry_jitter < 0) {
+                    printf("[Config Error] 'RetryJitter' must be none / full / decorrelated. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "RetryBudgetRatio") == 0) { if (strlen(val) > 0) cfg->retry_budget_ratio = atof(val); }
+        else if (strcmp(key, "RetryBudgetMin") == 0) { if (strlen(val) > 0) cfg->retry_budget_min = atoi(val); }
+
+        // ------------------
+        // AIMD 闭环限速
+        // ------------------
+        else if (strcmp(key, "AimdEnable") == 0) cfg->aimd_enable = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
+        else if (strcmp(key, "AimdInitialTps") == 0) { if (strlen(val) > 0) cfg->aimd_initial_tps = atof(val); }
+        else if (strcmp(key, "AimdIncreaseTps") == 0) { if (strlen(val) > 0) cfg->aimd_increase_tps = atof(val); }
+        else if (strcmp(key, "AimdDecreaseFactor") == 0) {
+            if (strlen(val) > 0) {
+                cfg->aimd_decrease_factor = atof(val);
+                if (cfg->aimd_decrease_factor <= 0 || cfg->aimd_decrease_factor >= 1) {
+                    printf("[Config Error] 'AimdDecreaseFactor' must be in (0, 1). Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "AimdMinTps") == 0) { if (strlen(val) > 0) cfg->aimd_min_tps = atof(val); }
+        else if (strcmp(key, "AimdMaxTps") == 0) { if (strlen(val) > 0) cfg->aimd_max_tps = atof(val); }
+        else if (strcmp(key, "AimdWindowMs") == 0) { if (strlen(val) > 0) cfg->aimd_window_ms = atof(val); }
+
+        // ------------------
+        // CPU 亲和性与 NUMA 放置
+        // ------------------
+        else if (strcmp(key, "AffinityMode") == 0) {
+            if (strlen(val) > 0) {
+                cfg->affinity_mode = affinity_mode_from_string(val);
+                if (cfg->affinity_mode < 0) {
+                    printf("[Config Error] 'AffinityMode' must be none / cpus / numa. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "AffinityCpuList") == 0) strncpy(cfg->affinity_cpu_list, val, sizeof(cfg->affinity_cpu_list) - 1);
+        else if (strcmp(key, "AffinityNumaNodes") == 0) strncpy(cfg->affinity_numa_nodes, val, sizeof(cfg->affinity_numa_nodes) - 1);
+        else if (strcmp(key, "AffinityServiceCpus") == 0) strncpy(cfg->affinity_service_cpus, val, sizeof(cfg->affinity_service_cpus) - 1);
+
+        // ------------------
+        // 协程虚拟客户端
+        // ------------------
+        else if (strcmp(key, "VirtualClientsPerThread") == 0) { if (strlen(val) > 0) cfg->virtual_clients_per_thread = atoi(val); }
+        else if (strcmp(key, "FiberStackKB") == 0) {
+            if (strlen(val) > 0) {
+                cfg->fiber_stack_kb = atoi(val);
+                if (cfg->fiber_stack_kb < 32) {
+                    printf("[Config Error] 'FiberStackKB' must be >= 32. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+
+        // ------------------
+        // 客户端节奏
+        // ------------------
+        else if (strcmp(key, "ThinkTimeDistribution") == 0) {
+            cfg->think_time_dist = think_dist_from_string(val);
+            if (cfg->think_time_dist < 0) {
+                printf("[Config Error] Unknown 'ThinkTimeDistribution': %s (constant/exponential/lognormal/empirical/none)\n", val);
+                fclose(fp); return -1;
+            }
+        }
+        else if (strcmp(key, "PacingMode") == 0) cfg->pacing_mode = (strcasecmp(val, "arrival") == 0) ? PACING_MODE_ARRIVAL : PACING_MODE_THINK;
+        else if (strcmp(key, "ThinkTimeMeanMs") == 0) { if (strlen(val) > 0) cfg->think_time_mean_ms = atof(val); }
+        else if (strcmp(key, "ThinkTimeStddevMs") == 0) { if (strlen(val) > 0) cfg->think_time_stddev_ms = atof(val); }
+        else if (strcmp(key, "ThinkTimeFile") == 0) strncpy(cfg->think_time_file, val, sizeof(cfg->think_time_file) - 1);
+
+        // ------------------
+        // 流量回放
+        // ------------------
+        else if (strcmp(key, "TraceFile") == 0) strncpy(cfg->trace_file, val, sizeof(cfg->trace_file) - 1);
+        else if (strcmp(key, "TraceFormat") == 0) {
+            if (strcasecmp(val, "csv") == 0) cfg->trace_format = TRACE_FORMAT_CSV;
+            else if (strcasecmp(val, "binary") == 0 || strcasecmp(val, "bin") == 0) cfg->trace_format = TRACE_FORMAT_BIN;
+            else cfg->trace_format = TRACE_FORMAT_AUTO;
+        }
+        else if (strcmp(key, "TraceTimeUnit") == 0) {
+            if (strcasecmp(val, "ms") == 0) cfg->trace_time_unit_us = 1e3;
+            else if (strcasecmp(val, "us") == 0) cfg->trace_time_unit_us = 1.0;
+            else if (strlen(val) == 0 || strcasecmp(val, "s") == 0) cfg->trace_time_unit_us = 1e6;
+            else {
+                printf("[Config Error] Unknown 'TraceTimeUnit': %s (s/ms/us)\n", val);
+                fclose(fp); return -1;
+            }
+        }
+        else if (strcmp(key, "TraceSpeedup") == 0) {
+            if (strlen(val) > 0) {
+                cfg->trace_speedup = atof(val);
+                if (cfg->trace_speedup <= 0) {
+                    printf("[Config Error] 'TraceSpeedup' must be > 0. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "VisibilityReaders") == 0) {
+            if (strlen(val) > 0) {
+                cfg->visibility_readers = atoi(val);
+                if (cfg->visibility_readers < 1) {
+                    printf("[Config Error] 'VisibilityReaders' must be >= 1. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "VisibilityReadOp") == 0) cfg->visibility_read_head = (strcasecmp(val, "head") == 0);
+        else if (strcmp(key, "VisibilityCheckList") == 0) cfg->visibility_check_list = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
+        else if (strcmp(key, "VisibilityPollIntervalMs") == 0) { if (strlen(val) > 0) cfg->visibility_poll_ms = atof(val); }
+        else if (strcmp(key, "VisibilityTimeoutMs") == 0) {
+            if (strlen(val) > 0) {
+                cfg->visibility_timeout_ms = atof(val);
+                if (cfg->visibility_timeout_ms <= 0) {
+                    printf("[Config Error] 'VisibilityTimeoutMs' must be > 0. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "HotKeyCount") == 0) {
+            if (strlen(val) > 0) {
+                cfg->hotkey_count = atoi(val);
+                if (cfg->hotkey_count < 1 || cfg->hotkey_count > HOTKEY_MAX_KEYS) {
+                    printf("[Config Error] 'HotKeyCount' must be 1~%d. Invalid value: %s\n", HOTKEY_MAX_KEYS, val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "HotKeyPutWeight") == 0 || strcmp(key, "HotKeyGetWeight") == 0 || strcmp(key, "HotKeyDeleteWeight") == 0) {
+            int slot = strcmp(key, "HotKeyPutWeight") == 0 ? HOTKEY_OP_PUT :
+                       (strcmp(key, "HotKeyGetWeight") == 0 ? HOTKEY_OP_GET : HOTKEY_OP_DELETE);
+            if (strlen(val) > 0) {
+                cfg->hotkey_weights[slot] = atoi(val);
+                if (cfg->hotkey_weights[slot] < 0) {
+                    printf("[Config Error] '%s' must be >= 0. Invalid value: %s\n", key, val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "BucketsPerUser") == 0) {
+            if (strlen(val) > 0) {
+                cfg->buckets_per_user = atoi(val);
+                if (cfg->buckets_per_user < 1 || cfg->buckets_per_user > 10000) {
+                    printf("[Config Error] 'BucketsPerUser' must be 1~10000. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "ChurnWorkingSet") == 0) {
+            if (strlen(val) > 0) {
+                cfg->churn_working_set = atoll(val);
+                if (cfg->churn_working_set < 1) {
+                    printf("[Config Error] 'ChurnWorkingSet' must be >= 1. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "ChurnCreateWeight") == 0 || strcmp(key, "ChurnOverwriteWeight") == 0 ||
+                 strcmp(key, "ChurnReadWeight") == 0 || strcmp(key, "ChurnDeleteWeight") == 0) {
+            int slot = strcmp(key, "ChurnCreateWeight") == 0 ? CHURN_OP_CREATE :
+                       (strcmp(key, "ChurnOverwriteWeight") == 0 ? CHURN_OP_OVERWRITE :
+                       (strcmp(key, "ChurnReadWeight") == 0 ? CHURN_OP_READ : CHURN_OP_DELETE));
+            if (strlen(val) > 0) {
+                cfg->churn_weights[slot] = atoi(val);
+                if (cfg->churn_weights[slot] < 0) {
+                    printf("[Config Error] '%s' must be >= 0. Invalid value: %s\n", key, val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "ServerSideEncryption") == 0) {
+            if (strlen(val) == 0 || strcasecmp(val, "none") == 0) cfg->sse_mode = SSE_MODE_NONE;
+            else if (strcasecmp(val, "sse-kms") == 0 || strcasecmp(val, "kms") == 0) cfg->sse_mode = SSE_MODE_KMS;
+            else if (strcasecmp(val, "sse-c") == 0) cfg->sse_mode = SSE_MODE_C;
+            else {
+                printf("[Config Error] 'ServerSideEncryption' must be none / sse-kms / sse-c. Invalid value: %s\n", val);
+                fclose(fp); return -1;
+            }
+        }
+        else if (strcmp(key, "SseKmsKeyId") == 0) strncpy(cfg->sse_kms_key_id, val, sizeof(cfg->sse_kms_key_id)-1);
+        else if (strcmp(key, "SseCKey") == 0) {
+            if (strlen(val) > 0 && strlen(val) != SSE_C_KEY_LEN) {
+                printf("[Config Error] 'SseCKey' must be the Base64 of a 32-byte key (%d chars). Invalid length: %zu\n",
+                       SSE_C_KEY_LEN, strlen(val));
+                fclose(fp); return -1;
+            }
+            strcpy(cfg->sse_c_key, val);
+        }
+        else if (strcmp(key, "ControlPlaneOps") == 0) {
+            if (strlen(val) > 0) {
+                cfg->cp_groups = control_plane_parse_groups(val);
+                if (cfg->cp_groups < 0) {
+                    printf("[Config Error] 'ControlPlaneOps' accepts head,policy,lifecycle,cors,tagging,versioning,all,none. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        else if (strcmp(key, "ControlPlaneBucketPrefix") == 0) {
+            if (strlen(val) > 0) {
+                // 桶名只允许小写字母、数字与 '-', 留出运行标识与编号的长度
+                size_t len = strlen(val);
+                int valid = (len >= 1 && len < sizeof(cfg->cp_bucket_prefix) && val[0] != '-');
+                for (size_t i = 0; valid && i < len; i++) {
+                    if (!(islower((unsigned char)val[i]) || isdigit((unsigned char)val[i]) || val[i] == '-')) valid = 0;
+                }
+                if (!valid) {
+                    printf("[Config Error] 'ControlPlaneBucketPrefix' must be 1~31 chars of [a-z0-9-]. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+                strcpy(cfg->cp_bucket_prefix, val);
+            }
+        }
+        else if (strcmp(key, "TraceQueueDepth") == 0) {
+            if (strlen(val) > 0) {
+                cfg->trace_queue_depth = atoi(val);
+                if (cfg->trace_queue_depth < 1) {
+                    printf("[Config Error] 'TraceQueueDepth' must be >= 1. Invalid value: %s\n", val);
+                    fclose(fp); return -1;
+                }
+            }
+        }
+        // Key 命名方案 (KeyPrefix 已在前面处理)
+        else if (strncmp(key, "Key", 3) == 0) {
+            if (key_gen_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
+        // 多接入点 (Endpoint 已在前面处理)
+        else if (strncmp(key, "Endpoint", 8) == 0) {
+            if (endpoint_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
+        // 域名预解析与 IP 固定
+        else if (strncmp(key, "Dns", 3) == 0) {
+            if (dns_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
+        // 并行文件系统目录树
+        else if (strncmp(key, "Pfs", 3) == 0) {
+            if (pfs_tree_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
+        // 建连开销压测
+        else if (strncmp(key, "ConnCost", 8) == 0) {
+            if (conn_cost_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
+        // Mock SDK 时延 / 带宽 / 故障模型
+        else if (strncmp(key, "Mock", 4) == 0) {
+            if (mock_model_parse_key(cfg, key, val) < 0) {
+                fclose(fp); return -1;
+            }
+        }
     }
     
     if (cfg->part_size <= 0) cfg->part_size = 5 * 1024 * 1024; 
+    // 多接入点: 第一个同时作为 Endpoint, 供报告与单点流程使用
+    if (cfg->endpoint_count > 0) strcpy(cfg->endpoint, cfg->endpoints[0]);
     if (cfg->target_user_count <= 0) {
         printf("[Config Error] 'Users' must be greater than 0.\n");
         fclose(fp); return -1;
     }
 
+    if (cfg->aimd_enable) {
+        if (cfg->aimd_min_tps <= 0) cfg->aimd_min_tps = 1;
+        if (cfg->aimd_window_ms <= 0) cfg->aimd_window_ms = 1000;
+        if (cfg->aimd_initial_tps < cfg->aimd_min_tps) cfg->aimd_initial_tps = cfg->aimd_min_tps;
+        if (cfg->aimd_max_tps > 0 && cfg->aimd_max_tps < cfg->aimd_min_tps) {
+            printf("[Config Error] 'AimdMaxTps' must be >= 'AimdMinTps'.\n");
+            fclose(fp); return -1;
+        }
+    }
+
+    // 对象大小分布: 未显式配置时沿用 ObjectSize 的单值 / 区间语义
+    if (cfg->object_size_dist < 0) cfg->object_size_dist = cfg->is_dynamic_size ? SIZE_DIST_UNIFORM : SIZE_DIST_FIXED;
+    if (cfg->object_size_dist != SIZE_DIST_FIXED) {
+        if (size_dist_build(cfg) != 0 || size_class_init(cfg) != 0) {
+            fclose(fp); return -1;
+        }
+    }
+
+    if (cfg->think_time_dist == THINK_DIST_EMPIRICAL) {
+        if (strlen(cfg->think_time_file) == 0) {
+            printf("[Config Error] 'ThinkTimeDistribution=empirical' requires 'ThinkTimeFile'.\n");
+            fclose(fp); return -1;
+        }
+        if (pacing_load_empirical(cfg) != 0) {
+            fclose(fp); return -1;
+        }
+    } else if (cfg->think_time_dist != THINK_DIST_NONE && cfg->think_time_mean_ms <= 0) {
+        printf("[Config Error] 'ThinkTimeMeanMs' must be > 0 when ThinkTimeDistribution is set.\n");
+        fclose(fp); return -1;
+    }
+
+    if (cfg->hotkey_weights[HOTKEY_OP_PUT] + cfg->hotkey_weights[HOTKEY_OP_GET] + cfg->hotkey_weights[HOTKEY_OP_DELETE] <= 0) {
+        printf("[Config Error] At least one of HotKeyPutWeight / HotKeyGetWeight / HotKeyDeleteWeight must be > 0.\n");
+        fclose(fp); return -1;
+    }
+
+    if (cfg->churn_weights[CHURN_OP_CREATE] + cfg->churn_weights[CHURN_OP_OVERWRITE] +
+        cfg->churn_weights[CHURN_OP_READ] + cfg->churn_weights[CHURN_OP_DELETE] <= 0) {
+        printf("[Config Error] At least one Churn*Weight must be > 0.\n");
+        fclose(fp); return -1;
+    }
+
+    if (mock_model_validate(cfg) != 0) {
+        fclose(fp); return -1;
+    }
+
+    if (key_gen_validate(cfg) != 0) {
+        fclose(fp); return -1;
+    }
+
+    if (cfg->sse_mode == SSE_MODE_C && strlen(cfg->sse_c_key) == 0) {
+        if (generate_sse_c_key(cfg->sse_c_key) != 0) {
+            printf("[Config Error] Failed to generate the SSE-C key from /dev/urandom.\n");
+            fclose(fp); return -1;
+        }
+        cfg->sse_c_key_generated = 1;
+    }
+
+    if (cfg->affinity_mode == AFFINITY_MODE_CPUS && strlen(cfg->affinity_cpu_list) == 0) {
+        printf("[Config Error] 'AffinityMode=cpus' requires 'AffinityCpuList'.\n");
+        fclose(fp); return -1;
+    }
+
     if (cfg->test_case == TEST_CASE_MIX) {
         if (cfg->mix_op_count > 0) cfg->use_mix_mode = 1;
     } else {
@@ -299,3 +806,97 @@ int load_config(const char *filename, Config *cfg) {
     return 0;
 }
 
+// 按 TestCase 校验组合约束并修正不适用的配置: 单机、Coordinator 与各 Agent 加载配置后都要调用,
+// 保证三者对同一份配置的理解一致; 返回 0 通过, -1 不可运行 (已打印原因)
+int validate_test_case(Config *cfg) {
+    // ==========================================================
+    // [强校验拦截]: 如果是多段上传，必须显式配置 PartsForEachUploadID
+    // ==========================================================
+    if (cfg->test_case == TEST_CASE_MULTIPART) {
+        if (cfg->parts_for_each_upload_id <= 0) {
+            LOG_ERROR("FATAL: TestCase 216 (Multipart Upload) requires 'PartsForEachUploadID' to be explicitly set in config.dat (valid range: 1~10000).");
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_TRACE) {
+        if (strlen(cfg->trace_file) == 0) {
+            LOG_ERROR("FATAL: TestCase 910 (Trace Replay) requires 'TraceFile' in config.dat.");
+            return -1;
+        }
+        if (cfg->virtual_clients_per_thread > 0 || cfg->think_time_dist != THINK_DIST_NONE) {
+            LOG_ERROR("FATAL: TestCase 910 (Trace Replay) takes its timing from the trace; disable VirtualClientsPerThread and ThinkTimeDistribution.");
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_VISIBILITY) {
+        if (cfg->virtual_clients_per_thread > 0) {
+            LOG_ERROR("FATAL: TestCase 920 (Visibility) runs its own writer / reader loops per thread; disable VirtualClientsPerThread.");
+            return -1;
+        }
+        if (cfg->threads_per_user % (cfg->visibility_readers + 1) != 0) {
+            LOG_ERROR("FATAL: TestCase 920 (Visibility) requires ThreadsPerUser to be a multiple of VisibilityReaders + 1 (%d).",
+                      cfg->visibility_readers + 1);
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_CHURN) {
+        int agents = cfg->distributed_agents > 0 ? cfg->distributed_agents : cfg->agent_count;
+        long long min_set = (long long)cfg->threads_per_user * (agents > 0 ? agents : 1);
+        if (cfg->churn_working_set < min_set) {
+            LOG_ERROR("FATAL: TestCase 940 (Churn) requires ChurnWorkingSet >= ThreadsPerUser x agents (%lld) so every thread owns a slot.", min_set);
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_CONTROL_PLANE) {
+        if (cfg->virtual_clients_per_thread > 0) {
+            LOG_ERROR("FATAL: TestCase 950 (Control Plane) runs each bucket cycle on its thread's bucket state; disable VirtualClientsPerThread.");
+            return -1;
+        }
+        // 按最大发起者编号与计划周期数预先检查桶名长度 (不限请求数时运行中再检查)
+        int agents = cfg->distributed_agents > 0 ? cfg->distributed_agents : cfg->agent_count;
+        long long clients = (long long)cfg->target_user_count * cfg->threads_per_user * (agents > 0 ? agents : 1);
+        char bucket[CP_BUCKET_NAME_MAX + 1];
+        int len = control_plane_bucket_name(cfg, (int)(clients - 1), cfg->requests_per_thread > 0 ? cfg->requests_per_thread - 1 : 0,
+                                            bucket, sizeof(bucket));
+        if (len > CP_BUCKET_NAME_MAX) {
+            LOG_ERROR("FATAL: TestCase 950 (Control Plane) bucket names reach %d chars (max %d); shorten 'ControlPlaneBucketPrefix'.",
+                      len, CP_BUCKET_NAME_MAX);
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_PFS_TREE) {
+        if (cfg->virtual_clients_per_thread > 0 || cfg->buckets_per_user > 1) {
+            LOG_ERROR("FATAL: TestCase 970 (PFS Directory Tree) builds one tree per user in a single bucket; disable VirtualClientsPerThread and BucketsPerUser.");
+            return -1;
+        }
+        if (pfs_tree_node_count(cfg) < 0) {
+            LOG_ERROR("FATAL: TestCase 970 (PFS Directory Tree) shape exceeds %lld nodes per user; reduce PfsTreeDepth / PfsTreeFanout / PfsFilesPerLeaf.",
+                      PFS_MAX_NODES_PER_USER);
+            return -1;
+        }
+    }
+
+    if (cfg->test_case == TEST_CASE_CONN_COST) {
+        if (cfg->virtual_clients_per_thread > 0 || cfg->buckets_per_user > 1) {
+            LOG_ERROR("FATAL: TestCase 980 (Connection Cost) tracks one connection per thread; disable VirtualClientsPerThread and BucketsPerUser.");
+            return -1;
+        }
+        if (cfg->requests_per_thread <= 0) {
+            LOG_ERROR("FATAL: TestCase 980 (Connection Cost) runs RequestsPerThread requests per arm; RequestsPerThread must be > 0.");
+            return -1;
+        }
+    }
+
+    // 热点 Key 的每个版本写入内容各不相同, 读结果改由 ETag 判定
+    if (cfg->test_case == TEST_CASE_HOTKEY && cfg->enable_data_validation) {
+        LOG_WARN("TestCase 930 (Hot-Key) writes a distinct pattern per version; EnableDataValidation is ignored, reads are checked by ETag.");
+        cfg->enable_data_validation = 0;
+    }
+
+    return 0;
+}
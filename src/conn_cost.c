@@ -0,0 +1,262 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 建连开销压测 (TestCase=980)
+// 以 HEAD bucket 这类轻量请求为负载, 依次执行三组对照, 每组每线程 RequestsPerThread 个请求:
+//   persistent: 始终保持连接复用
+//   new:        每个请求结束后关闭连接 (keep_alive=false + forbid_reuse_tcp), 下一个请求重新握手
+//   periodic:   每 ConnCostReconnectEvery 个请求关闭一次连接
+// 组间全部 Worker 同步, TPS 与握手速率按各组自身的墙钟耗时计算。SDK 不暴露连接计数,
+// 握手次数按本线程的复用策略推算 (网络类错误视为连接已断开)。
+// 同一组内区分新建连接与复用连接的请求, 两者的时延差即单次建连 (TCP + TLS / 国密 TLS) 的开销。
+// ----------------------------------------------------------------------------
+
+static const char *g_arm_names[CONN_ARM_SLOTS] = { "persistent", "new", "periodic" };
+
+// 解析 "persistent,new,periodic" 形式的对照组列表, 含未知名称时返回 -1
+static int conn_parse_arms(const char *val) {
+    char temp[256];
+    snprintf(temp, sizeof(temp), "%s", val);
+    int mask = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *end = token + strlen(token);
+        while (end > token && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (*token == '\0') continue;
+        if (strcasecmp(token, "all") == 0) {
+            mask |= CONN_ARM_ALL;
+            continue;
+        }
+        int found = 0;
+        for (int a = 0; a < CONN_ARM_SLOTS; a++) {
+            if (strcasecmp(token, g_arm_names[a]) == 0) {
+                mask |= 1 << a;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) return -1;
+    }
+    return mask;
+}
+
+// 处理 ConnCost* 配置项: 1 已处理, 0 非本模块的 Key, -1 取值非法
+int conn_cost_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "ConnCostArms") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->conn_cost_arms = conn_parse_arms(val);
+        if (cfg->conn_cost_arms <= 0) {
+            printf("[Config Error] 'ConnCostArms' must list persistent / new / periodic (or all). Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "ConnCostReconnectEvery") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->conn_reconnect_every = atoi(val);
+        if (cfg->conn_reconnect_every < 2) {
+            printf("[Config Error] 'ConnCostReconnectEvery' must be >= 2. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+ConnCost *conn_cost_alloc(const Config *cfg) {
+    ConnCost *cc = (ConnCost *)calloc(1, sizeof(ConnCost));
+    if (!cc) return NULL;
+    cc->threads = (ConnCostThread *)calloc((size_t)cfg->threads, sizeof(ConnCostThread));
+    if (!cc->threads) {
+        free(cc);
+        return NULL;
+    }
+    phase_barrier_init(&cc->barrier, cfg->threads);
+    return cc;
+}
+
+void conn_cost_free(ConnCost *cc) {
+    if (!cc) return;
+    phase_barrier_destroy(&cc->barrier);
+    free(cc->threads);
+    free(cc);
+}
+
+// Worker 初始化失败时退出同步, 避免其余线程永久等待
+void conn_cost_leave(ConnCost *cc) {
+    phase_barrier_leave(&cc->barrier);
+}
+
+// arm 为 -1 时只同步起点, 不计时
+static void conn_cost_barrier(ConnCost *cc, int arm) {
+    if (phase_barrier_wait(&cc->barrier) && arm >= 0) cc->arm_ms[arm] += cc->barrier.elapsed_ms;
+}
+
+void conn_cost_worker_run(WorkerArgs *args, DetailLogState *dl) {
+    const Config *cfg = args->config;
+    ConnCost *cc = args->conn_cost;
+    ConnCostThread *ct = args->conn_cost_stats;
+    obs_http_request_option *ro = &args->req_tmpl.options.request_options;
+    const bool keep_alive = ro->keep_alive;
+    const bool forbid_reuse = ro->forbid_reuse_tcp;
+    unsigned int seed = (unsigned int)(time(NULL) ^ (long)pthread_self());
+    RetryState retry = { seed ^ 0x5bd1e995u, 0.0 };
+    int every = cfg->conn_reconnect_every;
+    int conn_open = 0;              // 推算的本线程连接状态
+
+    // 各组无论是否因停止信号提前结束, 全部线程都经过相同次数的同步点
+    conn_cost_barrier(cc, -1);
+    for (int arm = 0; arm < CONN_ARM_SLOTS; arm++) {
+        if (!(cfg->conn_cost_arms & (1 << arm))) continue;
+        for (long long i = 0; !worker_should_stop(args, i, cfg->requests_per_thread); i++) {
+            int close_after = (arm == CONN_ARM_NEW) || (arm == CONN_ARM_PERIODIC && i % every == every - 1);
+            ro->keep_alive = !close_after;
+            ro->forbid_reuse_tcp = close_after;
+
+            int fresh = !conn_open;
+            double latency_ms = 0;
+            obs_status status = worker_execute_op(args, dl, TEST_CASE_HEAD_BUCKET, args->effective_bucket, 0, NULL,
+                                                  &retry, &latency_ms);
+            size_class_record(&ct->ops[arm][fresh ? 0 : 1], status == OBS_STATUS_OK, 0, latency_ms);
+            if (fresh) ct->handshakes[arm]++;
+            conn_open = !close_after && !(status != OBS_STATUS_OK && infer_http_code(status) == 0);
+        }
+        conn_cost_barrier(cc, arm);
+    }
+    ro->keep_alive = keep_alive;
+    ro->forbid_reuse_tcp = forbid_reuse;
+}
+
+static void arms_to_string(int mask, char *out, size_t len) {
+    out[0] = '\0';
+    for (int a = 0; a < CONN_ARM_SLOTS; a++) {
+        if (!(mask & (1 << a))) continue;
+        size_t pos = strlen(out);
+        snprintf(out + pos, len - pos, "%s%s", pos ? "," : "", g_arm_names[a]);
+    }
+}
+
+void conn_cost_write_brief(FILE *fp, const Config *cfg) {
+    char arms[64];
+    arms_to_string(cfg->conn_cost_arms, arms, sizeof(arms));
+    fprintf(fp, "[ConnCost]\n");
+    fprintf(fp, "  Operation:         HEAD bucket, %d requests/thread per arm\n", cfg->requests_per_thread);
+    fprintf(fp, "  Arms:              %s", arms);
+    if (cfg->conn_cost_arms & (1 << CONN_ARM_PERIODIC)) fprintf(fp, " (periodic: reconnect every %d)", cfg->conn_reconnect_every);
+    fprintf(fp, "\n");
+    if (strcasecmp(cfg->protocol, "http") == 0) {
+        fprintf(fp, "  Handshake:         TCP only (http)\n");
+    } else if (cfg->gm_auth_mode[0]) {
+        fprintf(fp, "  Handshake:         TCP + GM TLS (GmAuthMode=%s)\n", cfg->gm_auth_mode);
+    } else {
+        fprintf(fp, "  Handshake:         TCP + TLS (https)\n");
+    }
+    fprintf(fp, "  Result:            see conncost.txt (per-arm handshakes/s and latency deltas)\n");
+}
+
+static void merge_cell(SizeClassStats *dst, const SizeClassStats *src) {
+    dst->success_count += src->success_count;
+    dst->fail_count += src->fail_count;
+    dst->bytes += src->bytes;
+    dst->total_latency_ms += src->total_latency_ms;
+    hist_merge(&dst->latency_hist, &src->latency_hist);
+}
+
+static double cell_avg(const SizeClassStats *o) {
+    long long reqs = o->success_count + o->fail_count;
+    return reqs > 0 ? o->total_latency_ms / reqs : 0.0;
+}
+
+// 时延对比以 persistent 组为基准, 单次建连开销取同一组内新建与复用连接请求的时延差
+void conn_cost_save_report(const Config *cfg, const ConnCost *cc, int count) {
+    SizeClassStats *merged = (SizeClassStats *)calloc(CONN_ARM_SLOTS * 3, sizeof(SizeClassStats));
+    if (!merged) return;
+    long long handshakes[CONN_ARM_SLOTS] = {0};
+    // merged[arm * 3 + 0] 新建连接, + 1 复用连接, + 2 合计
+    for (int i = 0; i < count; i++) {
+        for (int a = 0; a < CONN_ARM_SLOTS; a++) {
+            for (int k = 0; k < 2; k++) {
+                const SizeClassStats *src = &cc->threads[i].ops[a][k];
+                if (src->success_count + src->fail_count == 0) continue;
+                merge_cell(&merged[a * 3 + k], src);
+                merge_cell(&merged[a * 3 + 2], src);
+            }
+            handshakes[a] += cc->threads[i].handshakes[a];
+        }
+    }
+
+    const SizeClassStats *base = &merged[CONN_ARM_PERSISTENT * 3 + 2];
+    int has_base = base->success_count + base->fail_count > 0;
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/conncost.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        conn_cost_write_brief(fp, cfg);
+        fprintf(fp, "\n%-10s %10s %8s %9s %10s %10s %12s %10s %10s %10s %10s %11s %11s %11s\n", "Arm", "Requests", "Fail",
+                "Time(s)", "TPS", "Handshakes", "Handshake/s", "Avg(ms)", "P50(ms)", "P90(ms)", "P99(ms)", "dAvg(ms)",
+                "dP50(ms)", "dP99(ms)");
+    }
+
+    printf("\n--- Connection Cost ---\n");
+    for (int a = 0; a < CONN_ARM_SLOTS; a++) {
+        const SizeClassStats *t = &merged[a * 3 + 2];
+        long long reqs = t->success_count + t->fail_count;
+        if (reqs == 0) continue;
+        const LatencyHistogram *h = &t->latency_hist;
+        double arm_s = cc->arm_ms[a] / 1000.0;
+        double tps = arm_s > 0 ? reqs / arm_s : 0.0;
+        double hs_rate = arm_s > 0 ? handshakes[a] / arm_s : 0.0;
+        double d_avg = has_base ? cell_avg(t) - cell_avg(base) : 0.0;
+        double d_p50 = has_base ? hist_percentile(h, 50.0) - hist_percentile(&base->latency_hist, 50.0) : 0.0;
+        double d_p99 = has_base ? hist_percentile(h, 99.0) - hist_percentile(&base->latency_hist, 99.0) : 0.0;
+        if (fp) {
+            fprintf(fp, "%-10s %10lld %8lld %9.3f %10.2f %10lld %12.2f %10.2f %10.2f %10.2f %10.2f %+11.2f %+11.2f %+11.2f\n",
+                    g_arm_names[a], reqs, t->fail_count, arm_s, tps, handshakes[a], hs_rate, cell_avg(t),
+                    hist_percentile(h, 50.0), hist_percentile(h, 90.0), hist_percentile(h, 99.0), d_avg, d_p50, d_p99);
+        }
+        printf("%-10s TPS %10.2f | Handshake/s %10.2f | Avg %.2f (%+.2f) | P99 %.2f (%+.2f) ms\n", g_arm_names[a], tps,
+               hs_rate, cell_avg(t), d_avg, hist_percentile(h, 99.0), d_p99);
+    }
+
+    if (fp) {
+        fprintf(fp, "\n%-10s %-8s %10s %10s %10s %10s %10s\n", "Arm", "Conn", "Requests", "Avg(ms)", "P50(ms)", "P90(ms)",
+                "P99(ms)");
+        for (int a = 0; a < CONN_ARM_SLOTS; a++) {
+            for (int k = 0; k < 2; k++) {
+                const SizeClassStats *o = &merged[a * 3 + k];
+                long long reqs = o->success_count + o->fail_count;
+                if (reqs == 0) continue;
+                fprintf(fp, "%-10s %-8s %10lld %10.2f %10.2f %10.2f %10.2f\n", g_arm_names[a], k == 0 ? "new" : "reused",
+                        reqs, cell_avg(o), hist_percentile(&o->latency_hist, 50.0),
+                        hist_percentile(&o->latency_hist, 90.0), hist_percentile(&o->latency_hist, 99.0));
+            }
+        }
+    }
+
+    // 优先取 periodic 组 (同一负载下两类请求都有), 否则以 new 组对比 persistent 组的复用请求
+    const SizeClassStats *fresh = NULL, *reused = NULL;
+    const char *source = NULL;
+    const SizeClassStats *pf = &merged[CONN_ARM_PERIODIC * 3];
+    const SizeClassStats *nw = &merged[CONN_ARM_NEW * 3];
+    const SizeClassStats *pr = &merged[CONN_ARM_PERSISTENT * 3 + 1];
+    if (pf[0].success_count > 0 && pf[1].success_count > 0) {
+        fresh = &pf[0];
+        reused = &pf[1];
+        source = "periodic arm, new vs reused";
+    } else if (nw[0].success_count > 0 && pr->success_count > 0) {
+        fresh = &nw[0];
+        reused = pr;
+        source = "new arm vs persistent arm";
+    }
+    if (fresh) {
+        double cost_avg = cell_avg(fresh) - cell_avg(reused);
+        double cost_p50 = hist_percentile(&fresh->latency_hist, 50.0) - hist_percentile(&reused->latency_hist, 50.0);
+        if (fp) fprintf(fp, "\nConnection setup cost (%s): avg %.2f ms, P50 %.2f ms\n", source, cost_avg, cost_p50);
+        printf("Connection setup cost: avg %.2f ms, P50 %.2f ms (%s)\n", cost_avg, cost_p50, source);
+    }
+    if (fp) fclose(fp);
+    free(merged);
+}
@@ -0,0 +1,179 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 控制面压测 (TestCase=950)
+// 每次操作为一个桶生命周期: 创建唯一命名的临时桶 -> HEAD -> 按 ControlPlaneOps 依次写入并读回
+// 策略 / 生命周期 / CORS / 标签 / 多版本配置 -> 删除桶。各线程并行执行, 每类接口单独统计时延。
+// 桶名: <ControlPlaneBucketPrefix>-<运行标识>-<发起者编号>-<周期号>, 发起者编号在各 Agent 间唯一。
+// ----------------------------------------------------------------------------
+
+static const struct {
+    int test_case;
+    int group;                      // 0 表示每个周期必做 (建桶 / 删桶)
+    const char *name;
+} g_cp_ops[CP_OP_SLOTS] = {
+    { TEST_CASE_CREATE_BUCKET,  0,                  "CreateBucket" },
+    { TEST_CASE_HEAD_BUCKET,    CP_GROUP_HEAD,      "HeadBucket" },
+    { TEST_CASE_SET_POLICY,     CP_GROUP_POLICY,    "SetPolicy" },
+    { TEST_CASE_GET_POLICY,     CP_GROUP_POLICY,    "GetPolicy" },
+    { TEST_CASE_SET_LIFECYCLE,  CP_GROUP_LIFECYCLE, "SetLifecycle" },
+    { TEST_CASE_GET_LIFECYCLE,  CP_GROUP_LIFECYCLE, "GetLifecycle" },
+    { TEST_CASE_SET_CORS,       CP_GROUP_CORS,      "SetCORS" },
+    { TEST_CASE_GET_CORS,       CP_GROUP_CORS,      "GetCORS" },
+    { TEST_CASE_SET_TAGGING,    CP_GROUP_TAGGING,   "SetTagging" },
+    { TEST_CASE_GET_TAGGING,    CP_GROUP_TAGGING,   "GetTagging" },
+    { TEST_CASE_SET_VERSIONING, CP_GROUP_VERSIONING, "SetVersioning" },
+    { TEST_CASE_GET_VERSIONING, CP_GROUP_VERSIONING, "GetVersioning" },
+    { TEST_CASE_DELETE_BUCKET,  0,                  "DeleteBucket" },
+};
+
+static const struct {
+    const char *name;
+    int mask;
+} g_cp_groups[] = {
+    { "head", CP_GROUP_HEAD },
+    { "policy", CP_GROUP_POLICY },
+    { "lifecycle", CP_GROUP_LIFECYCLE },
+    { "cors", CP_GROUP_CORS },
+    { "tagging", CP_GROUP_TAGGING },
+    { "versioning", CP_GROUP_VERSIONING },
+    { "all", CP_GROUP_ALL },
+    { "none", 0 },
+};
+
+// 解析 "head,policy,..." 形式的配置组列表, 含未知名称时返回 -1
+int control_plane_parse_groups(const char *val) {
+    char temp[256];
+    snprintf(temp, sizeof(temp), "%s", val);
+    int mask = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *end = token + strlen(token);
+        while (end > token && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (*token == '\0') continue;
+
+        int found = 0;
+        for (size_t g = 0; g < sizeof(g_cp_groups) / sizeof(g_cp_groups[0]); g++) {
+            if (strcasecmp(token, g_cp_groups[g].name) == 0) {
+                mask |= g_cp_groups[g].mask;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) return -1;
+    }
+    return mask;
+}
+
+// 生成临时桶名, 返回完整长度 (>= len 表示被截断)
+int control_plane_bucket_name(const Config *cfg, int key_owner_id, long long cycle, char *out, size_t len) {
+    return snprintf(out, len, "%s-%05x-%d-%lld", cfg->cp_bucket_prefix, cfg->cp_run_tag, key_owner_id, cycle);
+}
+
+static obs_status cp_run(WorkerArgs *args, DetailLogState *dl, int slot, char *bucket, RetryState *retry_state) {
+    double latency_ms = 0;
+    obs_status status = worker_execute_op(args, dl, g_cp_ops[slot].test_case, bucket, 0, NULL, retry_state, &latency_ms);
+    size_class_record(&args->cp->ops[slot], status == OBS_STATUS_OK, 0, latency_ms);
+    return status;
+}
+
+void control_plane_run_cycle(WorkerArgs *args, DetailLogState *dl, int key_owner_id, long long cycle,
+                             RetryState *retry_state) {
+    const Config *cfg = args->config;
+    ControlPlaneThread *ct = args->cp;
+    char bucket[CP_BUCKET_NAME_MAX + 1];
+    if (control_plane_bucket_name(cfg, key_owner_id, cycle, bucket, sizeof(bucket)) >= (int)sizeof(bucket)) {
+        // 启动时已按计划的最大编号检查; 不限请求数时周期号可能继续增长, 截断的桶名会与其他周期冲突
+        LOG_ERROR("FATAL: control plane bucket name for client %d cycle %lld exceeds %d chars; shorten 'ControlPlaneBucketPrefix'.",
+                  key_owner_id, cycle, CP_BUCKET_NAME_MAX);
+        ct->aborted++;
+        g_graceful_stop = 1;
+        return;
+    }
+
+    // 临时桶不属于多桶路由范围, 周期结束后恢复本线程原来的桶
+    int saved_index = args->bucket_index;
+    args->bucket_index = BUCKET_INDEX_TEMP;
+    snprintf(args->effective_bucket, sizeof(args->effective_bucket), "%s", bucket);
+
+    obs_status status = cp_run(args, dl, CP_OP_CREATE, bucket, retry_state);
+    if (status != OBS_STATUS_OK && status != OBS_STATUS_BucketAlreadyOwnedByYou) {
+        ct->aborted++;
+    } else {
+        for (int k = CP_OP_CREATE + 1; k < CP_OP_DELETE && !g_graceful_stop; k++) {
+            if (cfg->cp_groups & g_cp_ops[k].group) cp_run(args, dl, k, bucket, retry_state);
+        }
+        // 收到中断信号也要删桶, 避免遗留临时桶
+        status = cp_run(args, dl, CP_OP_DELETE, bucket, retry_state);
+        if (status == OBS_STATUS_OK) {
+            ct->cycles++;
+        } else {
+            ct->leaked++;
+            LOG_WARN("Control plane: failed to delete bucket %s (%s), please remove it manually.", bucket,
+                     obs_get_status_name(status));
+        }
+    }
+
+    args->bucket_index = saved_index;
+    bucket_format_name(args->effective_bucket, sizeof(args->effective_bucket), args->bucket_base, saved_index);
+}
+
+void control_plane_save_report(const Config *cfg, const ControlPlaneThread *threads, int count, double elapsed_s) {
+    SizeClassStats ops[CP_OP_SLOTS];
+    memset(ops, 0, sizeof(ops));
+    long long cycles = 0, aborted = 0, leaked = 0;
+    for (int i = 0; i < count; i++) {
+        const ControlPlaneThread *ct = &threads[i];
+        cycles += ct->cycles;
+        aborted += ct->aborted;
+        leaked += ct->leaked;
+        for (int k = 0; k < CP_OP_SLOTS; k++) {
+            ops[k].success_count += ct->ops[k].success_count;
+            ops[k].fail_count += ct->ops[k].fail_count;
+            ops[k].total_latency_ms += ct->ops[k].total_latency_ms;
+            hist_merge(&ops[k].latency_hist, &ct->ops[k].latency_hist);
+        }
+    }
+
+    char groups[128] = "";
+    for (size_t g = 0; g < sizeof(g_cp_groups) / sizeof(g_cp_groups[0]); g++) {
+        // "all" / "none" 是组合别名, 只列出单个配置组
+        int mask = g_cp_groups[g].mask;
+        if (mask == 0 || (mask & (mask - 1)) != 0 || !(cfg->cp_groups & mask)) continue;
+        size_t len = strlen(groups);
+        snprintf(groups + len, sizeof(groups) - len, "%s%s", len ? "," : "", g_cp_groups[g].name);
+    }
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/controlplane.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "Ops:                 create,%s%sdelete\n", groups, groups[0] ? "," : "");
+        fprintf(fp, "Bucket Names:        %s-%05x-<client>-<cycle>\n", cfg->cp_bucket_prefix, cfg->cp_run_tag);
+        fprintf(fp, "Cycles:              %lld completed, %lld aborted (create failed)\n", cycles, aborted);
+        fprintf(fp, "Buckets Left Behind: %lld\n", leaked);
+        fprintf(fp, "\n%-14s %10s %8s %10s %10s %10s %10s %10s %10s\n", "Op", "Requests", "Fail", "TPS", "Avg(ms)",
+                "P50(ms)", "P90(ms)", "P99(ms)", "P99.9(ms)");
+    }
+
+    printf("\n--- Control Plane ---\n");
+    printf("Cycles:          %lld completed, %lld aborted, %lld buckets left behind\n", cycles, aborted, leaked);
+    for (int k = 0; k < CP_OP_SLOTS; k++) {
+        const SizeClassStats *o = &ops[k];
+        long long reqs = o->success_count + o->fail_count;
+        if (reqs == 0) continue;
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        if (fp) {
+            fprintf(fp, "%-14s %10lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", g_cp_ops[k].name, reqs,
+                    o->fail_count, tps, o->total_latency_ms / reqs, hist_percentile(&o->latency_hist, 50.0),
+                    hist_percentile(&o->latency_hist, 90.0), hist_percentile(&o->latency_hist, 99.0),
+                    hist_percentile(&o->latency_hist, 99.9));
+        }
+        printf("%-14s TPS %10.2f | Fail %lld | P50 %.2f | P99 %.2f ms\n", g_cp_ops[k].name, tps, o->fail_count,
+               hist_percentile(&o->latency_hist, 50.0), hist_percentile(&o->latency_hist, 99.0));
+    }
+    if (leaked > 0) LOG_WARN("Control plane: %lld temporary bucket(s) could not be deleted, see controlplane.txt", leaked);
+    if (fp) fclose(fp);
+}
@@ -0,0 +1,827 @@
+#include "bench.h"
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <endian.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// ----------------------------------------------------------------------------
+// 分布式压测: Coordinator / Agent 之间的 TCP 帧协议
+// 帧格式: [magic u32][type u32][length u32] + payload, 全部为网络字节序。
+//
+//   Agent                         Coordinator
+//     | -- HELLO(version,wire,token) -> |   (版本、统计帧长度或口令不符的连接直接断开, 不下发任何配置)
+//     | <----------- ASSIGN(idx,count) -|
+//     | <----------- CONFIG / USERS ----|
+//     | -- READY(threads,users) ------> |   (等待所有 Agent 就绪)
+//     | <----------- START(wall_ms) ----|
+//     | -- INTERVAL ... --------------> |   (每个监控周期一帧)
+//     | -- FINAL(elapsed, stats) -----> |   (包含完整时延直方图)
+// ----------------------------------------------------------------------------
+#define DIST_MAGIC              0x4F425342u   // "OBSB"
+// 任何帧布局变化 (含 STATS_WIRE_SIZE 增减字段) 都必须递增版本号
+#define DIST_PROTOCOL_VERSION   4
+#define DIST_TOKEN_ENV          "OBS_BENCH_DIST_TOKEN"
+#define DIST_MAX_PAYLOAD        (16 * 1024 * 1024)
+#define DIST_MONITOR_INTERVAL_S 3
+#define DIST_IO_TIMEOUT_S       10      // Coordinator 对单帧收发的超时, 防止静默连接卡住接入流程
+#define DIST_READY_TIMEOUT_S    300     // Agent 加载配置、换取凭证与预解析域名的时限
+
+enum {
+    DIST_MSG_HELLO = 1,
+    DIST_MSG_ASSIGN,
+    DIST_MSG_CONFIG,
+    DIST_MSG_USERS,
+    DIST_MSG_READY,
+    DIST_MSG_START,
+    DIST_MSG_INTERVAL,
+    DIST_MSG_FINAL,
+    DIST_MSG_STOP
+};
+
+// HELLO 同时携带该长度, 即使漏改版本号, 统计字段不一致的两端也会在握手时被拒绝而不是错位解析
+#define STATS_WIRE_SIZE ((size_t)(9 + 3 + 5 + 5 + 3 * (1 + HIST_BUCKET_COUNT)) * 8)
+
+typedef struct {
+    int fd;
+    int alive;
+    int ready;
+    int finished;
+    int threads;
+    int users;
+    char peer[64];
+    // 最近一次区间上报 (累计值)
+    double last_elapsed_s;
+    long long last_success;
+    long long last_fail;
+    long long last_bytes;
+    // 最终结果
+    double final_elapsed_s;
+    ThreadStats final_stats;
+} AgentSlot;
+
+// ----------------------------------------------------------------------------
+// 基础 I/O
+// ----------------------------------------------------------------------------
+static int write_all(int fd, const void *buf, size_t len) {
+    const char *p = (const char *)buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void *buf, size_t len) {
+    char *p = (char *)buf;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n == 0) return -1;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int send_frame(int fd, uint32_t type, const void *payload, uint32_t len) {
+    uint32_t hdr[3] = { htonl(DIST_MAGIC), htonl(type), htonl(len) };
+    if (write_all(fd, hdr, sizeof(hdr)) != 0) return -1;
+    if (len > 0 && write_all(fd, payload, len) != 0) return -1;
+    return 0;
+}
+
+// 读取一帧; payload 由调用者 free (长度为 0 时返回 NULL)
+static int recv_frame(int fd, uint32_t *type, char **payload, uint32_t *len) {
+    uint32_t hdr[3];
+    if (read_all(fd, hdr, sizeof(hdr)) != 0) return -1;
+    if (ntohl(hdr[0]) != DIST_MAGIC) {
+        LOG_ERROR("Distributed protocol error: bad frame magic 0x%08x", ntohl(hdr[0]));
+        return -1;
+    }
+    *type = ntohl(hdr[1]);
+    *len = ntohl(hdr[2]);
+    *payload = NULL;
+    if (*len > DIST_MAX_PAYLOAD) {
+        LOG_ERROR("Distributed protocol error: frame too large (%u bytes)", *len);
+        return -1;
+    }
+    if (*len > 0) {
+        *payload = (char *)malloc(*len + 1);
+        if (!*payload) return -1;
+        if (read_all(fd, *payload, *len) != 0) {
+            free(*payload);
+            *payload = NULL;
+            return -1;
+        }
+        (*payload)[*len] = '\0';
+    }
+    return 0;
+}
+
+// 接入口令: Coordinator 优先取 DistributedToken, Agent (无本地配置) 只读环境变量
+static const char *dist_token(const Config *cfg) {
+    if (cfg && cfg->distributed_token[0]) return cfg->distributed_token;
+    const char *env = getenv(DIST_TOKEN_ENV);
+    return env ? env : "";
+}
+
+// 比较耗时只与收到的长度有关, 不随首个不同字节的位置变化
+static int token_equal(const char *got, size_t got_len, const char *want) {
+    size_t want_len = strlen(want);
+    if (want_len == 0) return 0;
+    unsigned char diff = (unsigned char)(got_len != want_len);
+    for (size_t i = 0; i < got_len; i++) diff |= (unsigned char)(got[i] ^ want[i % want_len]);
+    return diff == 0;
+}
+
+static int expect_frame(int fd, uint32_t want_type, char **payload, uint32_t *len) {
+    uint32_t type = 0;
+    if (recv_frame(fd, &type, payload, len) != 0) return -1;
+    if (type != want_type) {
+        LOG_ERROR("Distributed protocol error: expected frame %u, got %u", want_type, type);
+        free(*payload);
+        *payload = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// 序列化 (大端 64 位)
+// ----------------------------------------------------------------------------
+static void put_u64(unsigned char *buf, size_t *off, uint64_t v) {
+    v = htobe64(v);
+    memcpy(buf + *off, &v, 8);
+    *off += 8;
+}
+
+static uint64_t get_u64(const unsigned char *buf, size_t *off) {
+    uint64_t v;
+    memcpy(&v, buf + *off, 8);
+    *off += 8;
+    return be64toh(v);
+}
+
+static void put_f64(unsigned char *buf, size_t *off, double d) {
+    uint64_t v;
+    memcpy(&v, &d, 8);
+    put_u64(buf, off, v);
+}
+
+static double get_f64(const unsigned char *buf, size_t *off) {
+    uint64_t v = get_u64(buf, off);
+    double d;
+    memcpy(&d, &v, 8);
+    return d;
+}
+
+static void put_hist(unsigned char *buf, size_t *off, const LatencyHistogram *h) {
+    put_u64(buf, off, (uint64_t)h->count);
+    for (int i = 0; i < HIST_BUCKET_COUNT; i++) put_u64(buf, off, (uint64_t)h->buckets[i]);
+}
+
+static void get_hist(const unsigned char *buf, size_t *off, LatencyHistogram *h) {
+    h->count = (long long)get_u64(buf, off);
+    for (int i = 0; i < HIST_BUCKET_COUNT; i++) h->buckets[i] = (long long)get_u64(buf, off);
+}
+
+static void serialize_stats(const ThreadStats *s, unsigned char *buf) {
+    size_t off = 0;
+    put_u64(buf, &off, (uint64_t)s->success_count);
+    put_u64(buf, &off, (uint64_t)s->fail_403_count);
+    put_u64(buf, &off, (uint64_t)s->fail_404_count);
+    put_u64(buf, &off, (uint64_t)s->fail_409_count);
+    put_u64(buf, &off, (uint64_t)s->fail_4xx_other_count);
+    put_u64(buf, &off, (uint64_t)s->fail_5xx_count);
+    put_u64(buf, &off, (uint64_t)s->fail_other_count);
+    put_u64(buf, &off, (uint64_t)s->fail_validation_count);
+    put_u64(buf, &off, (uint64_t)s->total_success_bytes);
+    put_f64(buf, &off, s->total_latency_ms);
+    put_f64(buf, &off, s->max_latency_ms);
+    put_f64(buf, &off, s->min_latency_ms);
+    put_u64(buf, &off, (uint64_t)s->throttled_ns);
+    put_u64(buf, &off, (uint64_t)s->throttled_count);
+    put_u64(buf, &off, (uint64_t)s->attempt_count);
+    put_u64(buf, &off, (uint64_t)s->retry_count);
+    put_u64(buf, &off, (uint64_t)s->retry_budget_exhausted);
+    put_u64(buf, &off, (uint64_t)s->interarrival_ns);
+    put_u64(buf, &off, (uint64_t)s->intended_interarrival_ns);
+    put_u64(buf, &off, (uint64_t)s->pacing_lag_ns);
+    put_u64(buf, &off, (uint64_t)s->pacing_late_count);
+    put_u64(buf, &off, (uint64_t)s->cpu_ns);
+    put_hist(buf, &off, &s->latency_hist);
+    put_hist(buf, &off, &s->first_attempt_hist);
+    put_hist(buf, &off, &s->interarrival_hist);
+}
+
+static void deserialize_stats(const unsigned char *buf, ThreadStats *s) {
+    size_t off = 0;
+    stats_init(s);
+    s->success_count         = (long long)get_u64(buf, &off);
+    s->fail_403_count        = (long long)get_u64(buf, &off);
+    s->fail_404_count        = (long long)get_u64(buf, &off);
+    s->fail_409_count        = (long long)get_u64(buf, &off);
+    s->fail_4xx_other_count  = (long long)get_u64(buf, &off);
+    s->fail_5xx_count        = (long long)get_u64(buf, &off);
+    s->fail_other_count      = (long long)get_u64(buf, &off);
+    s->fail_validation_count = (long long)get_u64(buf, &off);
+    s->total_success_bytes   = (long long)get_u64(buf, &off);
+    s->total_latency_ms      = get_f64(buf, &off);
+    s->max_latency_ms        = get_f64(buf, &off);
+    s->min_latency_ms        = get_f64(buf, &off);
+    s->throttled_ns          = (long long)get_u64(buf, &off);
+    s->throttled_count       = (long long)get_u64(buf, &off);
+    s->attempt_count         = (long long)get_u64(buf, &off);
+    s->retry_count           = (long long)get_u64(buf, &off);
+    s->retry_budget_exhausted = (long long)get_u64(buf, &off);
+    s->interarrival_ns       = (long long)get_u64(buf, &off);
+    s->intended_interarrival_ns = (long long)get_u64(buf, &off);
+    s->pacing_lag_ns         = (long long)get_u64(buf, &off);
+    s->pacing_late_count     = (long long)get_u64(buf, &off);
+    s->cpu_ns                = (long long)get_u64(buf, &off);
+    get_hist(buf, &off, &s->latency_hist);
+    get_hist(buf, &off, &s->first_attempt_hist);
+    get_hist(buf, &off, &s->interarrival_hist);
+}
+
+int agent_send_interval(int fd, double elapsed_s, long long success, long long fail, long long bytes) {
+    unsigned char buf[32];
+    size_t off = 0;
+    put_f64(buf, &off, elapsed_s);
+    put_u64(buf, &off, (uint64_t)success);
+    put_u64(buf, &off, (uint64_t)fail);
+    put_u64(buf, &off, (uint64_t)bytes);
+    return send_frame(fd, DIST_MSG_INTERVAL, buf, (uint32_t)off);
+}
+
+static double wall_clock_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static char *read_text_file(const char *path, size_t *out_len) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(fp);
+        return NULL;
+    }
+    char *buf = (char *)malloc((size_t)size + 1);
+    if (!buf) {
+        fclose(fp);
+        return NULL;
+    }
+    size_t n = fread(buf, 1, (size_t)size, fp);
+    buf[n] = '\0';
+    fclose(fp);
+    *out_len = n;
+    return buf;
+}
+
+static int write_text_file(const char *path, const char *data, size_t len) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    size_t n = len > 0 ? fwrite(data, 1, len, fp) : 0;
+    fclose(fp);
+    return n == len ? 0 : -1;
+}
+
+// ============================================================================
+// Coordinator
+// ============================================================================
+static int coordinator_listen(const Config *cfg) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)cfg->coordinator_port);
+    if (inet_pton(AF_INET, cfg->coordinator_bind, &addr.sin_addr) != 1) {
+        LOG_ERROR("Invalid CoordinatorBind address: %s", cfg->coordinator_bind);
+        close(fd);
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        LOG_ERROR("Coordinator failed to listen on %s:%d (%s)", cfg->coordinator_bind, cfg->coordinator_port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void set_io_timeout(int fd, int seconds) {
+    struct timeval tv = { seconds, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+// 等待 fd 可读直到 deadline_ms; 分段等待以便及时响应 Ctrl+C
+static int wait_readable(int fd, double deadline_ms) {
+    while (!g_graceful_stop) {
+        double left_ms = deadline_ms - wall_clock_ms();
+        if (left_ms <= 0) return 0;
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll(&pfd, 1, left_ms < 500 ? (int)left_ms + 1 : 500) > 0) return 1;
+    }
+    return 0;
+}
+
+static void coordinator_drop_agent(AgentSlot *a, const char *reason) {
+    if (a->fd >= 0) close(a->fd);
+    a->fd = -1;
+    if (a->alive && !a->finished) LOG_WARN("Agent %s dropped: %s", a->peer, reason);
+    a->alive = 0;
+}
+
+static void coordinator_print_interval(const Config *cfg, AgentSlot *agents, int n, double elapsed_s, FILE *rt_fp) {
+    long long success = 0, fail = 0, bytes = 0;
+    double agent_elapsed = 0;
+    int reporting = 0;
+    for (int i = 0; i < n; i++) {
+        if (agents[i].last_elapsed_s <= 0) continue;
+        reporting++;
+        success += agents[i].last_success;
+        fail += agents[i].last_fail;
+        bytes += agents[i].last_bytes;
+        if (agents[i].last_elapsed_s > agent_elapsed) agent_elapsed = agents[i].last_elapsed_s;
+    }
+    if (agent_elapsed <= 0) return;
+
+    long long total = success + fail;
+    double tps = total / agent_elapsed;
+    double bw = (bytes / 1024.0 / 1024.0) / agent_elapsed;
+    double success_rate = total > 0 ? ((double)success / total) * 100.0 : 0.0;
+    printf("[Coordinator] RunTime: %8.1fs | Agents: %d/%d | Cumul TPS: %10.2f | Cumul BW: %8.2f MB/s | Success Rate: %7.3f%% | Total Reqs: %lld\n",
+           elapsed_s, reporting, n, tps, bw, success_rate, total);
+    if (rt_fp) {
+        fprintf(rt_fp, "%.1f,%.2f,%.2f,%.2f,%.3f,%lld\n",
+                elapsed_s, cfg->run_seconds > 0 ? (elapsed_s / cfg->run_seconds) * 100.0 : 0.0,
+                tps, bw, success_rate, total);
+        fflush(rt_fp);
+    }
+}
+
+static void coordinator_handle_frame(AgentSlot *a) {
+    uint32_t type = 0, len = 0;
+    char *payload = NULL;
+    if (recv_frame(a->fd, &type, &payload, &len) != 0) {
+        coordinator_drop_agent(a, "connection closed");
+        return;
+    }
+
+    const unsigned char *buf = (const unsigned char *)payload;
+    size_t off = 0;
+    if (type == DIST_MSG_INTERVAL && len >= 32) {
+        a->last_elapsed_s = get_f64(buf, &off);
+        a->last_success = (long long)get_u64(buf, &off);
+        a->last_fail = (long long)get_u64(buf, &off);
+        a->last_bytes = (long long)get_u64(buf, &off);
+    } else if (type == DIST_MSG_FINAL && len >= 8 + STATS_WIRE_SIZE) {
+        a->final_elapsed_s = get_f64(buf, &off);
+        deserialize_stats(buf + off, &a->final_stats);
+        a->finished = 1;
+        LOG_INFO("Agent %s finished: %lld requests in %.2f s", a->peer,
+                 a->final_stats.success_count + stats_total_fail(&a->final_stats), a->final_elapsed_s);
+        close(a->fd);
+        a->fd = -1;
+        a->alive = 0;
+    } else {
+        LOG_WARN("Agent %s sent unexpected frame type %u (len %u)", a->peer, type, len);
+    }
+    free(payload);
+}
+
+static void coordinator_save_agent_report(const Config *cfg, const AgentSlot *agents, int n) {
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/agents.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (!fp) return;
+    fprintf(fp, "Agent,Peer,Threads,Finished,Duration(s),Requests,Success,TPS,BW(MB/s),P99(ms)\n");
+    for (int i = 0; i < n; i++) {
+        const ThreadStats *s = &agents[i].final_stats;
+        long long reqs = s->success_count + stats_total_fail(s);
+        double d = agents[i].final_elapsed_s;
+        fprintf(fp, "%d,%s,%d,%s,%.2f,%lld,%lld,%.2f,%.2f,%.2f\n", i, agents[i].peer, agents[i].threads,
+                agents[i].finished ? "yes" : "no", d, reqs, s->success_count,
+                d > 0 ? reqs / d : 0.0, d > 0 ? s->total_success_bytes / 1024.0 / 1024.0 / d : 0.0,
+                hist_percentile(&s->latency_hist, 99.0));
+    }
+    fclose(fp);
+}
+
+int run_coordinator(Config *cfg, const char *config_file) {
+    int n = cfg->distributed_agents;
+    // 接入的 Agent 会拿到全部 AK/SK, 不允许无口令运行
+    const char *token = dist_token(cfg);
+    if (token[0] == '\0') {
+        LOG_ERROR("FATAL: distributed mode requires a shared token; set DistributedToken or the %s environment variable.",
+                  DIST_TOKEN_ENV);
+        return 1;
+    }
+    size_t config_len = 0, users_len = 0;
+    char *config_text = read_text_file(config_file, &config_len);
+    if (!config_text) {
+        LOG_ERROR("Coordinator cannot read config file: %s", config_file);
+        return 1;
+    }
+
+    // 追加覆盖项: CLI 指定的 TestCase 随配置下发; Agent 端不得再次进入 Coordinator 模式;
+    // 随机生成的 SSE-C 密钥也要下发, 否则各 Agent 各自生成, 互相读不到对方写入的对象
+    char overrides[256];
+    int ov_len = snprintf(overrides, sizeof(overrides), "\nTestCase=%d\nDistributedAgents=0\n", cfg->test_case);
+    if (cfg->sse_c_key_generated) {
+        ov_len += snprintf(overrides + ov_len, sizeof(overrides) - ov_len, "SseCKey=%s\n", cfg->sse_c_key);
+    }
+    char *merged = (char *)realloc(config_text, config_len + ov_len + 1);
+    if (!merged) {
+        free(config_text);
+        return 1;
+    }
+    config_text = merged;
+    memcpy(config_text + config_len, overrides, ov_len + 1);
+    config_len += ov_len;
+
+    // STS 模式下由各 Agent 本地换取临时凭证, 不下发 users.dat
+    char *users_text = NULL;
+    if (!cfg->is_temporary_token) {
+        users_text = read_text_file("users.dat", &users_len);
+        if (!users_text) {
+            LOG_ERROR("Coordinator cannot read users.dat");
+            free(config_text);
+            return 1;
+        }
+    }
+
+    int listen_fd = coordinator_listen(cfg);
+    if (listen_fd < 0) {
+        free(config_text);
+        free(users_text);
+        return 1;
+    }
+
+    AgentSlot *agents = (AgentSlot *)calloc(n, sizeof(AgentSlot));
+    if (!agents) {
+        close(listen_fd);
+        free(config_text);
+        free(users_text);
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        agents[i].fd = -1;
+        stats_init(&agents[i].final_stats);
+    }
+
+    LOG_INFO("Coordinator listening on %s:%d, waiting for %d agents...", cfg->coordinator_bind, cfg->coordinator_port, n);
+
+    // --- 1. 接入 Agent 并下发配置 ---
+    int connected = 0;
+    while (connected < n && !g_graceful_stop) {
+        struct pollfd pfd = { listen_fd, POLLIN, 0 };
+        if (poll(&pfd, 1, 1000) <= 0) continue;
+
+        struct sockaddr_in peer;
+        socklen_t peer_len = sizeof(peer);
+        int fd = accept(listen_fd, (struct sockaddr *)&peer, &peer_len);
+        if (fd < 0) continue;
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        // 端口扫描、健康检查或卡住的 Agent 超时后丢弃, 不阻塞后续接入
+        set_io_timeout(fd, DIST_IO_TIMEOUT_S);
+
+        AgentSlot *a = &agents[connected];
+        snprintf(a->peer, sizeof(a->peer), "%s:%d", inet_ntoa(peer.sin_addr), ntohs(peer.sin_port));
+
+        char *payload = NULL;
+        uint32_t len = 0;
+        if (expect_frame(fd, DIST_MSG_HELLO, &payload, &len) != 0 || len < 8 ||
+            ntohl(((uint32_t *)payload)[0]) != DIST_PROTOCOL_VERSION || ntohl(((uint32_t *)payload)[1]) != STATS_WIRE_SIZE ||
+            !token_equal(payload + 8, len - 8, token)) {
+            LOG_WARN("Rejected agent %s: bad HELLO (protocol version, stats layout or token mismatch)", a->peer);
+            free(payload);
+            close(fd);
+            continue;
+        }
+        free(payload);
+
+        uint32_t assign[2] = { htonl((uint32_t)connected), htonl((uint32_t)n) };
+        if (send_frame(fd, DIST_MSG_ASSIGN, assign, sizeof(assign)) != 0 ||
+            send_frame(fd, DIST_MSG_CONFIG, config_text, (uint32_t)config_len) != 0 ||
+            send_frame(fd, DIST_MSG_USERS, users_text, (uint32_t)users_len) != 0) {
+            LOG_WARN("Failed to send config to agent %s", a->peer);
+            close(fd);
+            continue;
+        }
+
+        a->fd = fd;
+        a->alive = 1;
+        connected++;
+        LOG_INFO("Agent %d/%d connected from %s", connected, n, a->peer);
+    }
+    close(listen_fd);
+    free(config_text);
+    free(users_text);
+
+    // --- 2. 等待全部就绪 ---
+    int total_threads = 0;
+    double ready_deadline_ms = wall_clock_ms() + DIST_READY_TIMEOUT_S * 1000.0;
+    for (int i = 0; i < connected && !g_graceful_stop; i++) {
+        char *payload = NULL;
+        uint32_t len = 0;
+        if (!wait_readable(agents[i].fd, ready_deadline_ms)) {
+            if (!g_graceful_stop) coordinator_drop_agent(&agents[i], "READY timeout");
+            continue;
+        }
+        if (expect_frame(agents[i].fd, DIST_MSG_READY, &payload, &len) != 0 || len < 8) {
+            free(payload);
+            coordinator_drop_agent(&agents[i], "not ready");
+            continue;
+        }
+        agents[i].threads = (int)ntohl(((uint32_t *)payload)[0]);
+        agents[i].users = (int)ntohl(((uint32_t *)payload)[1]);
+        agents[i].ready = 1;
+        total_threads += agents[i].threads;
+        free(payload);
+    }
+
+    if (g_graceful_stop || total_threads == 0) {
+        LOG_ERROR("Distributed run aborted before start.");
+        for (int i = 0; i < n; i++) coordinator_drop_agent(&agents[i], "aborted");
+        free(agents);
+        return 1;
+    }
+
+    // --- 3. 同步起跑 ---
+    double start_wall_ms = wall_clock_ms() + cfg->distributed_start_delay_ms;
+    unsigned char start_buf[8];
+    size_t off = 0;
+    put_f64(start_buf, &off, start_wall_ms);
+    for (int i = 0; i < connected; i++) {
+        if (agents[i].alive && send_frame(agents[i].fd, DIST_MSG_START, start_buf, sizeof(start_buf)) != 0) {
+            coordinator_drop_agent(&agents[i], "start failed");
+        }
+    }
+    LOG_INFO("START broadcast to %d agents (%d threads total), T0 in %d ms", connected, total_threads, cfg->distributed_start_delay_ms);
+
+    // --- 4. 汇聚区间统计与最终结果 ---
+    char rt_filepath[512];
+    snprintf(rt_filepath, sizeof(rt_filepath), "%s/realtime.txt", cfg->task_log_dir);
+    FILE *rt_fp = fopen(rt_filepath, "w");
+    if (rt_fp) {
+        fprintf(rt_fp, "RunTime(s),Process(%%),Cumul_TPS,Cumul_BW(MB/s),Success_Rate(%%),Total_Reqs\n");
+        fflush(rt_fp);
+    }
+
+    struct pollfd *pfds = (struct pollfd *)calloc(connected > 0 ? connected : 1, sizeof(struct pollfd));
+    int *slot_of = (int *)calloc(connected > 0 ? connected : 1, sizeof(int));
+    // 比 Agent 的监控周期滞后半秒打印, 等待同一周期的区间帧全部到达
+    double next_print_ms = start_wall_ms + DIST_MONITOR_INTERVAL_S * 1000.0 + 500.0;
+    int stop_sent = 0;
+
+    while (pfds && slot_of) {
+        int nfds = 0;
+        for (int i = 0; i < connected; i++) {
+            if (!agents[i].alive) continue;
+            pfds[nfds].fd = agents[i].fd;
+            pfds[nfds].events = POLLIN;
+            pfds[nfds].revents = 0;
+            slot_of[nfds] = i;
+            nfds++;
+        }
+        if (nfds == 0) break;
+
+        if (g_graceful_stop && !stop_sent) {
+            for (int i = 0; i < connected; i++) {
+                if (agents[i].alive) send_frame(agents[i].fd, DIST_MSG_STOP, NULL, 0);
+            }
+            stop_sent = 1;
+        }
+
+        int ready = poll(pfds, nfds, 500);
+        for (int k = 0; ready > 0 && k < nfds; k++) {
+            if (pfds[k].revents & (POLLIN | POLLHUP | POLLERR)) coordinator_handle_frame(&agents[slot_of[k]]);
+        }
+
+        double now_ms = wall_clock_ms();
+        if (now_ms >= next_print_ms) {
+            coordinator_print_interval(cfg, agents, connected, (now_ms - start_wall_ms) / 1000.0, rt_fp);
+            next_print_ms += DIST_MONITOR_INTERVAL_S * 1000.0;
+        }
+    }
+    free(pfds);
+    free(slot_of);
+    if (rt_fp) fclose(rt_fp);
+
+    // --- 5. 合并直方图, 计算全局分位数 ---
+    ThreadStats total;
+    stats_init(&total);
+    double elapsed_s = 0;
+    int finished = 0;
+    for (int i = 0; i < connected; i++) {
+        if (!agents[i].finished) continue;
+        finished++;
+        stats_merge(&total, &agents[i].final_stats);
+        if (agents[i].final_elapsed_s > elapsed_s) elapsed_s = agents[i].final_elapsed_s;
+    }
+    if (finished < connected) LOG_WARN("Only %d/%d agents delivered final results; report covers those only.", finished, connected);
+
+    cfg->agent_count = connected;
+    cfg->threads = total_threads;
+    // 取第一个已就绪的 Agent (0 号可能在 READY 前被丢弃), 均未就绪时按本地 Users 配置
+    cfg->loaded_user_count = cfg->target_user_count;
+    for (int i = 0; i < connected; i++) {
+        if (agents[i].ready) {
+            cfg->loaded_user_count = agents[i].users;
+            break;
+        }
+    }
+
+    print_benchmark_result(&total, elapsed_s);
+    save_benchmark_report(cfg, &total, elapsed_s);
+    coordinator_save_agent_report(cfg, agents, connected);
+
+    free(agents);
+    return finished == connected ? 0 : 1;
+}
+
+// ============================================================================
+// Agent
+// ============================================================================
+typedef struct {
+    int fd;
+} AgentListenerArgs;
+
+// 发流期间监听 Coordinator 的 STOP 指令; Coordinator 关闭连接后退出
+static void *agent_listener_routine(void *arg) {
+    AgentListenerArgs *l = (AgentListenerArgs *)arg;
+    for (;;) {
+        uint32_t type = 0, len = 0;
+        char *payload = NULL;
+        if (recv_frame(l->fd, &type, &payload, &len) != 0) break;
+        free(payload);
+        if (type == DIST_MSG_STOP) {
+            LOG_WARN("Coordinator requested stop.");
+            g_graceful_stop = 1;
+        }
+    }
+    return NULL;
+}
+
+static int agent_connect(const char *addr) {
+    char host[256];
+    snprintf(host, sizeof(host), "%s", addr);
+    char *colon = strrchr(host, ':');
+    if (!colon) {
+        LOG_ERROR("Invalid coordinator address '%s' (expected host:port)", addr);
+        return -1;
+    }
+    *colon = '\0';
+    const char *port = colon + 1;
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, port, &hints, &res) != 0 || !res) {
+        LOG_ERROR("Cannot resolve coordinator address: %s", addr);
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    return fd;
+}
+
+int run_agent(Config *cfg, const char *coordinator_addr) {
+    LOG_INFO("--- OBS C SDK Benchmark Agent --- coordinator: %s", coordinator_addr);
+    const char *token = dist_token(NULL);
+    size_t token_len = strlen(token);
+    if (token_len == 0 || token_len >= sizeof(cfg->distributed_token)) {
+        LOG_ERROR("Agent requires the coordinator's token in the %s environment variable (1 ~ %d chars).", DIST_TOKEN_ENV,
+                  (int)sizeof(cfg->distributed_token) - 1);
+        return 1;
+    }
+    int fd = agent_connect(coordinator_addr);
+    if (fd < 0) {
+        LOG_ERROR("Failed to connect coordinator %s", coordinator_addr);
+        return 1;
+    }
+
+    int ret = 1;
+    char *payload = NULL;
+    uint32_t len = 0;
+    char config_path[512], users_path[512];
+    snprintf(config_path, sizeof(config_path), "%s/config.dat", cfg->task_log_dir);
+    snprintf(users_path, sizeof(users_path), "%s/users.dat", cfg->task_log_dir);
+
+    char hello[8 + sizeof(cfg->distributed_token)];
+    uint32_t head[2] = { htonl(DIST_PROTOCOL_VERSION), htonl((uint32_t)STATS_WIRE_SIZE) };
+    memcpy(hello, head, sizeof(head));
+    memcpy(hello + 8, token, token_len);
+    if (send_frame(fd, DIST_MSG_HELLO, hello, (uint32_t)(8 + token_len)) != 0) goto out;
+
+    if (expect_frame(fd, DIST_MSG_ASSIGN, &payload, &len) != 0 || len < 8) goto out;
+    int agent_index = (int)ntohl(((uint32_t *)payload)[0]);
+    int agent_count = (int)ntohl(((uint32_t *)payload)[1]);
+    free(payload);
+    payload = NULL;
+
+    if (expect_frame(fd, DIST_MSG_CONFIG, &payload, &len) != 0) goto out;
+    if (write_text_file(config_path, payload ? payload : "", len) != 0) goto out;
+    free(payload);
+    payload = NULL;
+
+    if (expect_frame(fd, DIST_MSG_USERS, &payload, &len) != 0) goto out;
+    if (write_text_file(users_path, payload ? payload : "", len) != 0) goto out;
+    free(payload);
+    payload = NULL;
+
+    if (load_config(config_path, cfg) != 0) goto out;
+    log_init(cfg->log_level);
+    mock_model_apply(cfg);
+    cfg->agent_index = agent_index;
+    cfg->agent_count = agent_count;
+    if (validate_test_case(cfg) != 0) goto out;
+    if (prepare_user_credentials(cfg, users_path) != 0) goto out;
+    // 各 Agent 在自己的网络环境中解析, 结果只作用于本节点
+    if (dns_pin_endpoints(cfg) != 0) goto out;
+
+    // 各 Agent 线程数一致, 按序号切分全局线程号, 对象 Key 空间互不重叠
+    cfg->thread_id_base = agent_index * cfg->threads;
+    LOG_INFO("Assigned agent %d/%d: %d threads, thread id range [%d, %d)", agent_index, agent_count,
+             cfg->threads, cfg->thread_id_base, cfg->thread_id_base + cfg->threads);
+
+    uint32_t ready[2] = { htonl((uint32_t)cfg->threads), htonl((uint32_t)cfg->loaded_user_count) };
+    if (send_frame(fd, DIST_MSG_READY, ready, sizeof(ready)) != 0) goto out;
+
+    if (expect_frame(fd, DIST_MSG_START, &payload, &len) != 0 || len < 8) goto out;
+    size_t off = 0;
+    double start_wall_ms = get_f64((const unsigned char *)payload, &off);
+    free(payload);
+    payload = NULL;
+
+    if (obs_initialize(OBS_INIT_ALL) != OBS_STATUS_OK) goto out;
+
+    AgentListenerArgs l_args = { fd };
+    pthread_t listener_tid;
+    int has_listener = (pthread_create(&listener_tid, NULL, agent_listener_routine, &l_args) == 0);
+
+    ThreadStats total;
+    double elapsed_s = 0;
+    if (run_local_benchmark(cfg, fd, start_wall_ms, &total, &elapsed_s) == 0) {
+        unsigned char *buf = (unsigned char *)malloc(8 + STATS_WIRE_SIZE);
+        if (buf) {
+            off = 0;
+            put_f64(buf, &off, elapsed_s);
+            serialize_stats(&total, buf + off);
+            if (send_frame(fd, DIST_MSG_FINAL, buf, (uint32_t)(8 + STATS_WIRE_SIZE)) == 0) ret = 0;
+            free(buf);
+        }
+        print_benchmark_result(&total, elapsed_s);
+        save_benchmark_report(cfg, &total, elapsed_s);
+    }
+
+    if (has_listener) {
+        // Coordinator 收到 FINAL 后关闭连接, 监听线程随之退出
+        if (ret != 0) shutdown(fd, SHUT_RDWR);
+        pthread_join(listener_tid, NULL);
+    }
+    obs_deinitialize();
+
+out:
+    free(payload);
+    if (ret != 0) LOG_ERROR("Agent session with coordinator %s failed.", coordinator_addr);
+    close(fd);
+    return ret;
+}
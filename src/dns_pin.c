@@ -0,0 +1,352 @@
+#include "bench.h"
+#include <strings.h>
+#include <netdb.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// ----------------------------------------------------------------------------
+// 域名预解析与 IP 固定 (DnsMode=resolve / static)
+// 启动时把 Endpoint (或 Endpoints 中的每个域名) 解析为 IP 列表, 用 "IP[:端口]" 替换接入点列表, 之后请求
+// 直接发往 IP, SDK 建连时不再查询 DNS; 多个 IP 按 EndpointPolicy 分配给各线程, 并按 IP 输出统计。
+// SDK 没有自定义解析的接口, 只能以 IP 作为 host_name, 因此要求路径方式访问桶 (PathStyle=true)。
+// 同时对每个域名计时解析 DnsProbeCount 次、对每个 IP 计时 TCP 建连, 报告 DNS 在建连阶段中的占比 (dns.txt)。
+// ----------------------------------------------------------------------------
+
+static const char *g_dns_modes[] = { "sdk", "resolve", "static" };
+
+typedef struct {
+    char host[128];
+    char port[16];                  // 为空时按协议使用默认端口
+    double lookup_ms[DNS_MAX_PROBES];
+    int lookups;                    // 成功的解析次数
+    int failures;
+    int first_ip;                   // 在固定后接入点列表中的下标范围
+    int ip_count;
+} DnsHost;
+
+typedef struct {
+    double sum_ms, min_ms, max_ms;
+    int ok, fail;
+} ConnectProbe;
+
+// 校验 "host:IP,host:IP,..." 格式 (IP 可为 IPv6, 按第一个 ':' 切分)
+static int check_static_hosts(const char *val) {
+    char temp[1024];
+    snprintf(temp, sizeof(temp), "%s", val);
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        if (*token == '\0') continue;
+        char *sep = strchr(token, ':');
+        if (!sep || sep == token) return -1;
+        char *ip = sep + 1;
+        char *end = ip + strlen(ip);
+        while (end > ip && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        unsigned char buf[sizeof(struct in6_addr)];
+        if (inet_pton(AF_INET, ip, buf) != 1 && inet_pton(AF_INET6, ip, buf) != 1) return -1;
+    }
+    return 0;
+}
+
+// 处理 Dns* 配置项: 1 已处理, 0 非本模块的 Key, -1 取值非法
+int dns_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "DnsMode") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->dns_mode = -1;
+        for (int i = 0; i < 3; i++) {
+            if (strcasecmp(val, g_dns_modes[i]) == 0) cfg->dns_mode = i;
+        }
+        if (cfg->dns_mode < 0) {
+            printf("[Config Error] 'DnsMode' must be sdk / resolve / static. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "DnsStaticHosts") == 0) {
+        if (strlen(val) >= sizeof(cfg->dns_static_hosts) || check_static_hosts(val) != 0) {
+            printf("[Config Error] 'DnsStaticHosts' must be host:IP pairs separated by ',' (max %zu chars). Invalid value: %s\n",
+                   sizeof(cfg->dns_static_hosts) - 1, val);
+            return -1;
+        }
+        strcpy(cfg->dns_static_hosts, val);
+        return 1;
+    }
+    if (strcmp(key, "DnsProbeCount") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->dns_probe_count = atoi(val);
+        if (cfg->dns_probe_count < 1 || cfg->dns_probe_count > DNS_MAX_PROBES) {
+            printf("[Config Error] 'DnsProbeCount' must be 1 ~ %d. Invalid value: %s\n", DNS_MAX_PROBES, val);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static double dns_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// "host", "host:port", "[v6]:port" 或裸 IPv6
+static void split_host_port(const char *endpoint, char *host, size_t host_len, char *port, size_t port_len) {
+    port[0] = '\0';
+    if (endpoint[0] == '[') {
+        const char *close = strchr(endpoint, ']');
+        size_t n = close ? (size_t)(close - endpoint - 1) : strlen(endpoint + 1);
+        snprintf(host, host_len, "%.*s", (int)n, endpoint + 1);
+        if (close && close[1] == ':') snprintf(port, port_len, "%s", close + 2);
+        return;
+    }
+    const char *colon = strchr(endpoint, ':');
+    if (colon && strchr(colon + 1, ':') == NULL) {
+        snprintf(host, host_len, "%.*s", (int)(colon - endpoint), endpoint);
+        snprintf(port, port_len, "%s", colon + 1);
+    } else {
+        snprintf(host, host_len, "%s", endpoint);
+    }
+}
+
+static void format_endpoint(char *out, size_t len, const char *ip, const char *port) {
+    int v6 = strchr(ip, ':') != NULL;
+    if (port[0]) snprintf(out, len, v6 ? "[%s]:%s" : "%s:%s", ip, port);
+    else snprintf(out, len, v6 ? "[%s]" : "%s", ip);
+}
+
+// 追加一个固定后的接入点, 本域名已有该地址或列表已满时返回 0。
+// 只在本域名范围内去重: 不同域名解析到同一 IP 时各自保留一项, 与未固定时的接入点列表保持一致
+static int add_pinned(char (*list)[256], char (*origin)[128], int *count, const char *ip, const DnsHost *dh) {
+    char ep[256];
+    format_endpoint(ep, sizeof(ep), ip, dh->port);
+    for (int i = dh->first_ip; i < *count; i++) {
+        if (strcmp(list[i], ep) == 0) return 0;
+    }
+    if (*count >= ENDPOINT_MAX) {
+        LOG_WARN("DNS: more than %d pinned addresses, %s (%s) is ignored.", ENDPOINT_MAX, ep, dh->host);
+        return 0;
+    }
+    strcpy(list[*count], ep);
+    snprintf(origin[*count], sizeof(origin[0]), "%s", dh->host);
+    (*count)++;
+    return 1;
+}
+
+// 计时解析 probe_count 次; keep_ips 非 0 时把最后一次成功的结果加入列表
+static void resolve_host(DnsHost *dh, int probe_count, int keep_ips, char (*list)[256], char (*origin)[128], int *count) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+
+    struct addrinfo *last = NULL;
+    for (int i = 0; i < probe_count; i++) {
+        struct addrinfo *res = NULL;
+        double t0 = dns_now_ms();
+        int rc = getaddrinfo(dh->host, NULL, &hints, &res);
+        double t1 = dns_now_ms();
+        if (rc != 0) {
+            dh->failures++;
+            if (i == 0) LOG_WARN("DNS: lookup of %s failed: %s", dh->host, gai_strerror(rc));
+            continue;
+        }
+        dh->lookup_ms[dh->lookups++] = t1 - t0;
+        if (last) freeaddrinfo(last);
+        last = res;
+    }
+    if (!last) return;
+
+    dh->first_ip = *count;
+    if (keep_ips) {
+        for (struct addrinfo *ai = last; ai; ai = ai->ai_next) {
+            char ip[INET6_ADDRSTRLEN];
+            const void *addr = ai->ai_family == AF_INET6 ? (const void *)&((struct sockaddr_in6 *)ai->ai_addr)->sin6_addr
+                                                         : (const void *)&((struct sockaddr_in *)ai->ai_addr)->sin_addr;
+            if (!inet_ntop(ai->ai_family, addr, ip, sizeof(ip))) continue;
+            dh->ip_count += add_pinned(list, origin, count, ip, dh);
+        }
+    }
+    freeaddrinfo(last);
+}
+
+static void static_host(DnsHost *dh, const char *table, char (*list)[256], char (*origin)[128], int *count) {
+    char temp[1024];
+    snprintf(temp, sizeof(temp), "%s", table);
+    dh->first_ip = *count;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *sep = strchr(token, ':');
+        if (!sep) continue;
+        *sep = '\0';
+        char *ip = sep + 1;
+        char *end = ip + strlen(ip);
+        while (end > ip && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (strcasecmp(token, dh->host) == 0) dh->ip_count += add_pinned(list, origin, count, ip, dh);
+    }
+}
+
+// 对一个 IP 做一次 TCP 建连 (超时为 ConnectTimeoutSec), 成功返回耗时 ms, 失败返回 -1
+static double tcp_connect_ms(const char *ip, int port, int timeout_sec) {
+    struct sockaddr_storage ss;
+    memset(&ss, 0, sizeof(ss));
+    socklen_t sl;
+    if (strchr(ip, ':')) {
+        struct sockaddr_in6 *a6 = (struct sockaddr_in6 *)&ss;
+        a6->sin6_family = AF_INET6;
+        a6->sin6_port = htons((uint16_t)port);
+        if (inet_pton(AF_INET6, ip, &a6->sin6_addr) != 1) return -1;
+        sl = sizeof(*a6);
+    } else {
+        struct sockaddr_in *a4 = (struct sockaddr_in *)&ss;
+        a4->sin_family = AF_INET;
+        a4->sin_port = htons((uint16_t)port);
+        if (inet_pton(AF_INET, ip, &a4->sin_addr) != 1) return -1;
+        sl = sizeof(*a4);
+    }
+
+    int fd = socket(ss.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    double t0 = dns_now_ms();
+    int rc = connect(fd, (struct sockaddr *)&ss, sl);
+    if (rc != 0 && errno == EINPROGRESS) {
+        struct pollfd pfd = { fd, POLLOUT, 0 };
+        int err = 0;
+        socklen_t el = sizeof(err);
+        rc = (poll(&pfd, 1, timeout_sec > 0 ? timeout_sec * 1000 : 10000) == 1 &&
+              getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &el) == 0 && err == 0) ? 0 : -1;
+    }
+    double t1 = dns_now_ms();
+    close(fd);
+    return rc == 0 ? t1 - t0 : -1;
+}
+
+static void write_report(const Config *cfg, const DnsHost *hosts, int host_count, char (*list)[256],
+                         const ConnectProbe *probes) {
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/dns.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (!fp) return;
+
+    fprintf(fp, "DnsMode:             %s (requests pinned to IP, SDK does no lookup per connection)\n",
+            g_dns_modes[cfg->dns_mode]);
+    fprintf(fp, "Probes:              %d lookup(s) per host, %d TCP connect(s) per IP\n", cfg->dns_probe_count,
+            cfg->dns_probe_count);
+    fprintf(fp, "\n%-32s %8s %8s %10s %10s %10s %10s %6s\n", "Host", "Lookups", "Failed", "First(ms)", "Min(ms)",
+            "Avg(ms)", "Max(ms)", "IPs");
+    for (int h = 0; h < host_count; h++) {
+        const DnsHost *dh = &hosts[h];
+        double sum = 0, mn = 0, mx = 0;
+        for (int i = 0; i < dh->lookups; i++) {
+            double v = dh->lookup_ms[i];
+            sum += v;
+            if (i == 0 || v < mn) mn = v;
+            if (v > mx) mx = v;
+        }
+        fprintf(fp, "%-32s %8d %8d %10.3f %10.3f %10.3f %10.3f %6d\n", dh->host, dh->lookups, dh->failures,
+                dh->lookups ? dh->lookup_ms[0] : 0.0, mn, dh->lookups ? sum / dh->lookups : 0.0, mx, dh->ip_count);
+    }
+
+    // 建连阶段 = DNS 解析 + TCP 建连 (不含 TLS); 固定 IP 后省去的正是前一部分
+    fprintf(fp, "\n%-40s %-32s %8s %10s %10s %10s %10s\n", "Pinned Address", "Host", "Failed", "TCP Avg", "TCP Max",
+            "DNS Avg", "DNS Share");
+    for (int h = 0; h < host_count; h++) {
+        const DnsHost *dh = &hosts[h];
+        double dns_avg = 0;
+        for (int i = 0; i < dh->lookups; i++) dns_avg += dh->lookup_ms[i];
+        if (dh->lookups) dns_avg /= dh->lookups;
+        for (int k = dh->first_ip; k < dh->first_ip + dh->ip_count; k++) {
+            const ConnectProbe *cp = &probes[k];
+            double tcp_avg = cp->ok ? cp->sum_ms / cp->ok : 0.0;
+            char share[16] = "-";
+            if (cp->ok && dns_avg + tcp_avg > 0) snprintf(share, sizeof(share), "%.1f%%", dns_avg * 100.0 / (dns_avg + tcp_avg));
+            fprintf(fp, "%-40s %-32s %8d %10.3f %10.3f %10.3f %10s\n", list[k], dh->host, cp->fail, tcp_avg,
+                    cp->max_ms, dns_avg, share);
+        }
+    }
+    fprintf(fp, "\n(ms; DNS Share = DNS Avg / (DNS Avg + TCP Avg), TLS handshake excluded)\n");
+    fclose(fp);
+}
+
+// 按 DnsMode 解析并替换接入点列表; 需在创建 Worker 之前、任务目录建立之后调用
+int dns_pin_endpoints(Config *cfg) {
+    if (cfg->dns_mode == DNS_MODE_SDK) return 0;
+    if (!cfg->path_style && strlen(cfg->gm_auth_mode) == 0) {
+        LOG_ERROR("DnsMode=%s sends requests to IP addresses and requires PathStyle=true (virtual-host bucket names cannot be pinned).",
+                  g_dns_modes[cfg->dns_mode]);
+        return -1;
+    }
+    if (cfg->dns_mode == DNS_MODE_STATIC && strlen(cfg->dns_static_hosts) == 0) {
+        LOG_ERROR("DnsMode=static requires 'DnsStaticHosts' (host:IP,host:IP,...).");
+        return -1;
+    }
+
+    int host_count = cfg->endpoint_count > 0 ? cfg->endpoint_count : 1;
+    DnsHost *hosts = (DnsHost *)calloc(host_count, sizeof(DnsHost));
+    char (*list)[256] = calloc(ENDPOINT_MAX, sizeof(*list));
+    char (*origin)[128] = calloc(ENDPOINT_MAX, sizeof(*origin));
+    ConnectProbe *probes = (ConnectProbe *)calloc(ENDPOINT_MAX, sizeof(ConnectProbe));
+    int ret = -1;
+    if (!hosts || !list || !origin || !probes) goto out;
+
+    int count = 0;
+    for (int h = 0; h < host_count; h++) {
+        DnsHost *dh = &hosts[h];
+        split_host_port(cfg->endpoint_count > 0 ? cfg->endpoints[h] : cfg->endpoint, dh->host, sizeof(dh->host),
+                        dh->port, sizeof(dh->port));
+        // 静态表模式同样计时解析, 只用于报告 DNS 开销, 解析失败不影响压测
+        resolve_host(dh, cfg->dns_probe_count, cfg->dns_mode == DNS_MODE_RESOLVE, list, origin, &count);
+        if (cfg->dns_mode == DNS_MODE_STATIC) static_host(dh, cfg->dns_static_hosts, list, origin, &count);
+        if (dh->ip_count == 0) {
+            LOG_ERROR("DNS: no address for %s (%s).", dh->host,
+                      cfg->dns_mode == DNS_MODE_STATIC ? "missing from DnsStaticHosts" : "lookup failed");
+            goto out;
+        }
+    }
+
+    int default_port = strcasecmp(cfg->protocol, "http") == 0 ? 80 : 443;
+    for (int h = 0; h < host_count; h++) {
+        const DnsHost *dh = &hosts[h];
+        int port = dh->port[0] ? atoi(dh->port) : default_port;
+        for (int k = dh->first_ip; k < dh->first_ip + dh->ip_count; k++) {
+            char ip[256], unused_port[16];
+            split_host_port(list[k], ip, sizeof(ip), unused_port, sizeof(unused_port));
+            ConnectProbe *cp = &probes[k];
+            for (int i = 0; i < cfg->dns_probe_count; i++) {
+                double ms = tcp_connect_ms(ip, port, cfg->connect_timeout_sec);
+                if (ms < 0) {
+                    cp->fail++;
+                    continue;
+                }
+                cp->sum_ms += ms;
+                if (cp->ok == 0 || ms < cp->min_ms) cp->min_ms = ms;
+                if (ms > cp->max_ms) cp->max_ms = ms;
+                cp->ok++;
+            }
+        }
+        double dns_avg = 0;
+        for (int i = 0; i < dh->lookups; i++) dns_avg += dh->lookup_ms[i];
+        LOG_INFO("DNS: %s -> %d pinned address(es), lookup avg %.3f ms over %d probe(s)", dh->host, dh->ip_count,
+                 dh->lookups ? dns_avg / dh->lookups : 0.0, dh->lookups);
+    }
+    write_report(cfg, hosts, host_count, list, probes);
+
+    memcpy(cfg->endpoints, list, sizeof(cfg->endpoints));
+    memcpy(cfg->endpoint_origin, origin, sizeof(cfg->endpoint_origin));
+    cfg->endpoint_count = count;
+    strcpy(cfg->endpoint, cfg->endpoints[0]);
+    ret = 0;
+
+out:
+    free(hosts);
+    free(list);
+    free(origin);
+    free(probes);
+    return ret;
+}
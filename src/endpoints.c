@@ -0,0 +1,213 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 多接入点负载均衡 (Endpoints=host1,host2,...)
+// 请求模板中的 host_name 指向当前接入点, 每次请求前按 EndpointPolicy 选择后只替换该指针:
+//   thread:     线程按编号轮流绑定一个接入点 (连接复用最好)
+//   roundrobin: 每线程逐请求轮转
+//   hash:       按 Key 的 FNV-1a 哈希, 同一 Key 的读写落在同一接入点
+//   p2c:        随机取两个接入点, 选本线程观测到的时延 EWMA 较低者; 失败 (5xx / 网络错误) 按连接超时计入,
+//               超过 ENDPOINT_STALE_MS 没有样本的接入点视为最优, 慢节点恢复后能重新分到流量
+// 每线程按接入点统计请求、错误与时延分布, 结束时合并, 用于找出慢接入点。
+// ----------------------------------------------------------------------------
+
+static const char *g_policy_names[] = { "thread", "roundrobin", "hash", "p2c" };
+
+static int endpoint_policy_from_string(const char *val) {
+    for (int i = 0; i < (int)(sizeof(g_policy_names) / sizeof(g_policy_names[0])); i++) {
+        if (strcasecmp(val, g_policy_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// 解析 "host1,host2:port,..." 形式的接入点列表, 返回个数, 非法时返回 -1
+static int parse_endpoint_list(Config *cfg, const char *val) {
+    char temp[ENDPOINT_MAX * 64];
+    if (strlen(val) >= sizeof(temp)) return -1;
+    strcpy(temp, val);
+    int n = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *end = token + strlen(token);
+        while (end > token && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (*token == '\0') continue;
+        if (n >= ENDPOINT_MAX || strlen(token) >= sizeof(cfg->endpoints[0])) return -1;
+        strcpy(cfg->endpoints[n++], token);
+    }
+    return n;
+}
+
+// 处理 Endpoint* 配置项 (Endpoint 本身在主流程处理): 1 已处理, 0 非本模块的 Key, -1 取值非法
+int endpoint_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "Endpoints") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->endpoint_count = parse_endpoint_list(cfg, val);
+        if (cfg->endpoint_count < 0) {
+            printf("[Config Error] 'Endpoints' accepts at most %d comma-separated hosts (each < 256 chars). Invalid value: %s\n",
+                   ENDPOINT_MAX, val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "EndpointPolicy") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->endpoint_policy = endpoint_policy_from_string(val);
+        if (cfg->endpoint_policy < 0) {
+            printf("[Config Error] 'EndpointPolicy' must be thread / roundrobin / hash / p2c. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "EndpointEwmaAlpha") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->endpoint_ewma_alpha = atof(val);
+        if (cfg->endpoint_ewma_alpha <= 0 || cfg->endpoint_ewma_alpha > 1) {
+            printf("[Config Error] 'EndpointEwmaAlpha' must be in (0, 1]. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static inline double coarse_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static inline double p2c_score(const EndpointStats *es, double now_ms) {
+    if (es->last_sample_ms == 0 || now_ms - es->last_sample_ms > ENDPOINT_STALE_MS) return 0.0;
+    return es->ewma_ms;
+}
+
+void endpoint_route(WorkerArgs *args, const char *key) {
+    const Config *cfg = args->config;
+    int n = cfg->endpoint_count;
+    int idx;
+    switch (cfg->endpoint_policy) {
+        case ENDPOINT_POLICY_ROUND_ROBIN:
+            idx = (int)((args->thread_id + args->endpoint_cursor++) % (unsigned int)n);
+            break;
+        case ENDPOINT_POLICY_HASH: {
+            uint64_t h = 1469598103934665603ULL;
+            for (const char *p = key; *p; p++) {
+                h ^= (unsigned char)*p;
+                h *= 1099511628211ULL;
+            }
+            idx = (int)(h % (uint64_t)n);
+            break;
+        }
+        case ENDPOINT_POLICY_P2C: {
+            int a = rand_r(&args->endpoint_seed) % n;
+            int b = rand_r(&args->endpoint_seed) % (n - 1);
+            if (b >= a) b++;
+            double now_ms = coarse_now_ms();
+            idx = p2c_score(&args->endpoint_stats[b], now_ms) < p2c_score(&args->endpoint_stats[a], now_ms) ? b : a;
+            break;
+        }
+        default:
+            idx = args->thread_id % n;
+            break;
+    }
+    args->endpoint_index = idx;
+    args->req_tmpl.options.bucket_options.host_name = (char *)cfg->endpoints[idx];
+}
+
+void endpoint_record(WorkerArgs *args, int ok, int http_code, long long bytes, double latency_ms) {
+    EndpointStats *es = &args->endpoint_stats[args->endpoint_index];
+    size_class_record(&es->io, ok, bytes, latency_ms);
+
+    // 404 / 409 等业务结果不反映接入点健康, 只有 5xx 与网络类错误按连接超时惩罚
+    double sample = latency_ms;
+    if (!ok && (http_code == 0 || http_code >= 500)) {
+        es->error_count++;
+        if (http_code == 503) es->throttled_count++;
+        double penalty_ms = args->config->connect_timeout_sec * 1000.0;
+        if (sample < penalty_ms) sample = penalty_ms;
+    }
+    double alpha = args->config->endpoint_ewma_alpha;
+    es->ewma_ms = es->last_sample_ms == 0 ? sample : alpha * sample + (1 - alpha) * es->ewma_ms;
+    es->last_sample_ms = coarse_now_ms();
+}
+
+void endpoint_write_brief(FILE *fp, const Config *cfg) {
+    if (cfg->endpoint_count <= 1) {
+        fprintf(fp, "  Endpoint:          %s", cfg->endpoint);
+        if (cfg->endpoint_origin[0][0]) fprintf(fp, " (pinned for %s)", cfg->endpoint_origin[0]);
+        fprintf(fp, "\n");
+        return;
+    }
+    fprintf(fp, "  Endpoints:         %d (policy %s", cfg->endpoint_count, g_policy_names[cfg->endpoint_policy]);
+    if (cfg->endpoint_policy == ENDPOINT_POLICY_P2C) fprintf(fp, ", EWMA alpha %.2f", cfg->endpoint_ewma_alpha);
+    fprintf(fp, ")\n");
+    for (int i = 0; i < cfg->endpoint_count; i++) {
+        fprintf(fp, "    [%d] %s", i, cfg->endpoints[i]);
+        if (cfg->endpoint_origin[i][0]) fprintf(fp, " (pinned for %s)", cfg->endpoint_origin[i]);
+        fprintf(fp, "\n");
+    }
+}
+
+void endpoint_save_report(const Config *cfg, const EndpointStats *stats, int threads, double elapsed_s) {
+    int n = cfg->endpoint_count;
+    EndpointStats *merged = (EndpointStats *)calloc(n, sizeof(EndpointStats));
+    int *sampled = (int *)calloc(n, sizeof(int));     // 有样本的线程数, EWMA 取其平均
+    if (!merged || !sampled) {
+        free(merged);
+        free(sampled);
+        return;
+    }
+    for (int i = 0; i < threads; i++) {
+        for (int e = 0; e < n; e++) {
+            const EndpointStats *src = &stats[(size_t)i * n + e];
+            EndpointStats *dst = &merged[e];
+            dst->io.success_count += src->io.success_count;
+            dst->io.fail_count += src->io.fail_count;
+            dst->io.bytes += src->io.bytes;
+            dst->io.total_latency_ms += src->io.total_latency_ms;
+            hist_merge(&dst->io.latency_hist, &src->io.latency_hist);
+            dst->throttled_count += src->throttled_count;
+            dst->error_count += src->error_count;
+            if (src->last_sample_ms > 0) {
+                dst->ewma_ms += src->ewma_ms;
+                sampled[e]++;
+            }
+        }
+    }
+
+    long long total = 0;
+    for (int e = 0; e < n; e++) total += merged[e].io.success_count + merged[e].io.fail_count;
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/endpoints.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        endpoint_write_brief(fp, cfg);
+        fprintf(fp, "\n%-32s %10s %8s %8s %8s %8s %10s %10s %10s %10s %10s %10s %10s\n", "Endpoint", "Requests", "Fail",
+                "Errors", "503", "Share", "TPS", "BW(MB/s)", "Avg(ms)", "P50(ms)", "P90(ms)", "P99(ms)", "EWMA(ms)");
+    }
+
+    printf("\n--- Endpoints (%s) ---\n", g_policy_names[cfg->endpoint_policy]);
+    for (int e = 0; e < n; e++) {
+        const EndpointStats *es = &merged[e];
+        const LatencyHistogram *h = &es->io.latency_hist;
+        long long reqs = es->io.success_count + es->io.fail_count;
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        double ewma = sampled[e] > 0 ? es->ewma_ms / sampled[e] : 0.0;
+        if (fp) {
+            fprintf(fp, "%-32s %10lld %8lld %8lld %8lld %7.2f%% %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                    cfg->endpoints[e], reqs, es->io.fail_count, es->error_count, es->throttled_count,
+                    total > 0 ? reqs * 100.0 / total : 0.0, tps,
+                    elapsed_s > 0 ? es->io.bytes / 1024.0 / 1024.0 / elapsed_s : 0.0,
+                    reqs > 0 ? es->io.total_latency_ms / reqs : 0.0, hist_percentile(h, 50.0),
+                    hist_percentile(h, 90.0), hist_percentile(h, 99.0), ewma);
+        }
+        printf("%-32s TPS %10.2f (%5.1f%%) | Err %lld | P50 %.2f | P99 %.2f ms\n", cfg->endpoints[e], tps,
+               total > 0 ? reqs * 100.0 / total : 0.0, es->error_count, hist_percentile(h, 50.0), hist_percentile(h, 99.0));
+    }
+    if (fp) fclose(fp);
+    free(sampled);
+    free(merged);
+}
@@ -0,0 +1,175 @@
+#include "bench.h"
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <limits.h>
+
+// ----------------------------------------------------------------------------
+// 协程 (ucontext) M:N 执行器
+// 每个 Worker 线程作为承载线程, 调度 VirtualClientsPerThread 个虚拟客户端。
+// 虚拟客户端只占用一个小栈 (mmap, 带保护页) 与少量状态, 凭证、pattern buffer、
+// 统计与明细日志均与承载线程共享, 因此 5 万个大部分时间空闲的客户端只需几十个 OS 线程。
+// 本 SDK 的对象接口没有非阻塞请求上下文, SDK 调用在承载线程上同步执行;
+// 思考时间、重试退避与限速等待均通过 sleep_until_ns 让出给同线程的其他客户端。
+// ----------------------------------------------------------------------------
+
+typedef struct VirtualClient {
+    ucontext_t ctx;
+    void *stack;                // mmap 区域起始 (含保护页)
+    size_t map_size;
+    long long wake_ns;
+    int client_id;              // 全局唯一, 参与 Key 命名
+    long long op_index;         // Key 游标
+    unsigned int seed;
+    RetryState retry_state;
+    PacingState pacing;
+    int done;
+} VirtualClient;
+
+typedef struct {
+    ucontext_t sched_ctx;
+    VirtualClient **heap;       // 按 wake_ns 排列的最小堆
+    int heap_size;
+    VirtualClient *current;
+    WorkerArgs *args;
+    DetailLogState *dl;
+    long long planned;
+} FiberCarrier;
+
+static __thread FiberCarrier *tls_carrier = NULL;
+
+static void heap_push(FiberCarrier *c, VirtualClient *vc) {
+    int i = c->heap_size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (c->heap[parent]->wake_ns <= vc->wake_ns) break;
+        c->heap[i] = c->heap[parent];
+        i = parent;
+    }
+    c->heap[i] = vc;
+}
+
+static VirtualClient *heap_pop(FiberCarrier *c) {
+    VirtualClient *top = c->heap[0];
+    VirtualClient *last = c->heap[--c->heap_size];
+    int i = 0;
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        long long m_wake = last->wake_ns;
+        if (l < c->heap_size && c->heap[l]->wake_ns < m_wake) { m = l; m_wake = c->heap[l]->wake_ns; }
+        if (r < c->heap_size && c->heap[r]->wake_ns < m_wake) m = r;
+        if (m == i) break;
+        c->heap[i] = c->heap[m];
+        i = m;
+    }
+    if (c->heap_size > 0) c->heap[i] = last;
+    return top;
+}
+
+// 当前线程正在运行协程时, 让出直到 deadline 并返回 1; 否则返回 0 由调用方阻塞睡眠
+int fiber_sleep_until(long long deadline_ns) {
+    FiberCarrier *c = tls_carrier;
+    if (!c || !c->current) return 0;
+    VirtualClient *vc = c->current;
+    vc->wake_ns = deadline_ns;
+    swapcontext(&vc->ctx, &c->sched_ctx);
+    return 1;
+}
+
+static void client_entry(void) {
+    FiberCarrier *c = tls_carrier;
+    VirtualClient *vc = c->current;
+    int paced = (c->args->config->think_time_dist != THINK_DIST_NONE);
+
+    while (!worker_should_stop(c->args, vc->op_index, c->planned)) {
+        if (paced) pacing_begin_op(c->args, &vc->pacing);
+        int done = worker_run_op(c->args, c->dl, vc->client_id, vc->op_index, &vc->seed, &vc->retry_state);
+        vc->op_index++;
+        if (paced) pacing_end_op(c->args, &vc->pacing, &vc->seed);
+        if (done) break;
+    }
+    vc->done = 1;
+    // uc_link 返回调度上下文
+}
+
+static int client_init(VirtualClient *vc, size_t stack_size, long long first_wake_ns) {
+    long page = sysconf(_SC_PAGESIZE);
+    vc->map_size = stack_size + page;
+    vc->stack = mmap(NULL, vc->map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (vc->stack == MAP_FAILED) {
+        vc->stack = NULL;
+        return -1;
+    }
+    // 栈向低地址增长, 最低一页作为保护页, 栈溢出直接 SIGSEGV 而不是踩坏相邻客户端
+    mprotect(vc->stack, page, PROT_NONE);
+
+    getcontext(&vc->ctx);
+    vc->ctx.uc_stack.ss_sp = (char *)vc->stack + page;
+    vc->ctx.uc_stack.ss_size = stack_size;
+    vc->ctx.uc_link = &tls_carrier->sched_ctx;
+    makecontext(&vc->ctx, client_entry, 0);
+    vc->wake_ns = first_wake_ns;
+    pacing_init(&vc->pacing, first_wake_ns);
+    return 0;
+}
+
+void fiber_carrier_run(WorkerArgs *args, DetailLogState *dl) {
+    const Config *cfg = args->config;
+    int n = cfg->virtual_clients_per_thread;
+    size_t stack_size = (size_t)cfg->fiber_stack_kb * 1024;
+
+    FiberCarrier carrier;
+    memset(&carrier, 0, sizeof(carrier));
+    carrier.args = args;
+    carrier.dl = dl;
+    carrier.planned = worker_planned_requests(cfg);
+    carrier.heap = (VirtualClient **)malloc(n * sizeof(VirtualClient *));
+    VirtualClient *clients = (VirtualClient *)calloc(n, sizeof(VirtualClient));
+    if (!carrier.heap || !clients) {
+        LOG_ERROR("Thread %d failed to allocate %d virtual clients", args->thread_id, n);
+        free(carrier.heap);
+        free(clients);
+        return;
+    }
+    tls_carrier = &carrier;
+
+    // 首次发起时间在一个思考周期内均匀打散, 避免所有客户端同时起跑
+    unsigned int seed = (unsigned int)(time(NULL) ^ (long)pthread_self());
+    long long now = monotonic_now_ns();
+    int ready = 0;
+    for (int i = 0; i < n; i++) {
+        VirtualClient *vc = &clients[i];
+        vc->client_id = args->thread_id * n + i;
+        vc->seed = seed ^ (unsigned int)(vc->client_id * 2654435761u);
+        vc->retry_state.seed = vc->seed ^ 0x5bd1e995u;
+        long long offset = cfg->think_time_dist != THINK_DIST_NONE ?
+            (long long)((rand_r(&seed) / ((double)RAND_MAX + 1.0)) * cfg->think_time_mean_ms * 1e6) : 0;
+        if (client_init(vc, stack_size, now + offset) != 0) {
+            LOG_WARN("Thread %d: failed to map fiber stack for client %d, running %d clients", args->thread_id, i, ready);
+            break;
+        }
+        heap_push(&carrier, vc);
+        ready++;
+    }
+
+    long long stop_ns = args->stop_timestamp_ms < 9e12 ? (long long)(args->stop_timestamp_ms * 1e6) : LLONG_MAX;
+    while (carrier.heap_size > 0) {
+        VirtualClient *vc = heap_pop(&carrier);
+        if (!g_graceful_stop) {
+            // 停止时间到达后所有客户端都应被唤醒, 以便检查退出条件
+            long long wake = vc->wake_ns < stop_ns ? vc->wake_ns : stop_ns;
+            sleep_until_ns(wake);
+        }
+        carrier.current = vc;
+        swapcontext(&carrier.sched_ctx, &vc->ctx);
+        carrier.current = NULL;
+        if (!vc->done) heap_push(&carrier, vc);
+    }
+
+    for (int i = 0; i < ready; i++) {
+        if (clients[i].stack) munmap(clients[i].stack, clients[i].map_size);
+    }
+    tls_carrier = NULL;
+    free(carrier.heap);
+    free(clients);
+}
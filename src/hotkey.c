@@ -0,0 +1,265 @@
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// 热点 Key 写竞争 (TestCase=930)
+// 全部线程对同一组 HotKeyCount 个 Key 按权重并发 PUT / GET / DELETE。热点集合为 1 时
+// 所有请求落在同一对象上, 逐步增大即可从完全竞争扫到无竞争。
+// 每次 PUT 从随机 pattern 偏移写入, 使每个版本的内容 (从而 ETag) 各不相同; 每个 Key
+// 记录最近几次写入的 ETag 与 [发起, 确认] 时间区间, GET 读到的 ETag 据此分类:
+// 最新 / 与读并发 / 并发写入中的另一方胜出 / 已被覆盖的旧版本 (违例) / 无法判断。
+// ----------------------------------------------------------------------------
+
+static const char *g_op_names[HOTKEY_OP_SLOTS] = { "PUT", "GET", "DELETE" };
+static const int g_op_cases[HOTKEY_OP_SLOTS] = { TEST_CASE_PUT, TEST_CASE_GET, TEST_CASE_DELETE };
+static const char *g_read_names[HOTKEY_READ_OUTCOMES] = {
+    "Latest", "In-flight write", "Concurrent winner", "Stale", "Unknown ETag"
+};
+
+int hotkey_set_init(HotKeySet *set, const Config *cfg) {
+    memset(set, 0, sizeof(HotKeySet));
+    // 未固定桶时每个用户写各自的桶, 竞争只发生在同一用户的线程之间
+    set->group_count = strlen(cfg->bucket_name_fixed) > 0 ? 1 : cfg->loaded_user_count;
+    set->key_count = cfg->hotkey_count;
+    set->thread_count = cfg->threads;
+
+    size_t n = (size_t)set->group_count * set->key_count;
+    set->keys = (HotKeyState *)aligned_alloc(64, n * sizeof(HotKeyState));
+    set->stats = (HotKeyThreadStats *)calloc(cfg->threads, sizeof(HotKeyThreadStats));
+    if (!set->keys || !set->stats) {
+        LOG_ERROR("Failed to allocate hot-key state (%d keys x %d groups).", set->key_count, set->group_count);
+        free(set->keys);
+        free(set->stats);
+        set->keys = NULL;
+        set->stats = NULL;
+        return -1;
+    }
+    memset(set->keys, 0, n * sizeof(HotKeyState));
+    for (size_t i = 0; i < n; i++) pthread_mutex_init(&set->keys[i].lock, NULL);
+    return 0;
+}
+
+void hotkey_set_release(HotKeySet *set) {
+    if (set->keys) {
+        size_t n = (size_t)set->group_count * set->key_count;
+        for (size_t i = 0; i < n; i++) pthread_mutex_destroy(&set->keys[i].lock);
+        free(set->keys);
+    }
+    free(set->stats);
+    set->keys = NULL;
+    set->stats = NULL;
+}
+
+// ETag -> 非零 tag (FNV-1a), 0 保留给 DELETE
+static uint64_t etag_tag(const char *etag) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const char *p = etag; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 1099511628211ULL;
+    }
+    return h ? h : 1;
+}
+
+static int pick_op(const Config *cfg, unsigned int *seed) {
+    int total = cfg->hotkey_weights[0] + cfg->hotkey_weights[1] + cfg->hotkey_weights[2];
+    int r = rand_r(seed) % total;
+    for (int k = 0; k < HOTKEY_OP_SLOTS; k++) {
+        if (r < cfg->hotkey_weights[k]) return k;
+        r -= cfg->hotkey_weights[k];
+    }
+    return HOTKEY_OP_GET;
+}
+
+static void push_version(HotKeyState *ks, uint64_t tag, long long start_ns, long long ack_ns) {
+    HotKeyVersion *v = &ks->history[ks->history_next];
+    v->tag = tag;
+    v->start_ns = start_ns;
+    v->ack_ns = ack_ns;
+    ks->history_next = (ks->history_next + 1) % HOTKEY_HISTORY;
+}
+
+// 按读到的 tag 与写入记录判定读结果 (调用方持有 ks->lock)
+static int classify_read(const HotKeyState *ks, uint64_t tag, long long start_ns, long long end_ns) {
+    const HotKeyVersion *latest = NULL;
+    for (int i = 0; i < HOTKEY_HISTORY; i++) {
+        const HotKeyVersion *v = &ks->history[i];
+        if (v->ack_ns == 0 || v->ack_ns > start_ns) continue;
+        if (!latest || v->ack_ns > latest->ack_ns) latest = v;
+    }
+    if (latest && latest->tag == tag) return HOTKEY_READ_LATEST;
+
+    int outcome = HOTKEY_READ_UNKNOWN;
+    for (int i = 0; i < HOTKEY_HISTORY; i++) {
+        const HotKeyVersion *v = &ks->history[i];
+        if (v->ack_ns == 0 || v->tag != tag) continue;
+        if (v->start_ns <= end_ns && v->ack_ns >= start_ns) return HOTKEY_READ_INFLIGHT;
+        if (!latest) continue;
+        // 与最后确认的写入存在时间重叠: 服务端可能以另一种顺序定序, 不算违例
+        if (v->ack_ns >= latest->start_ns) outcome = HOTKEY_READ_REORDERED;
+        else if (outcome == HOTKEY_READ_UNKNOWN) outcome = HOTKEY_READ_STALE;
+    }
+    return outcome;
+}
+
+void hotkey_run_op(WorkerArgs *args, DetailLogState *dl, unsigned int *seed, RetryState *retry_state) {
+    const Config *cfg = args->config;
+    HotKeyThreadStats *hs = args->hot_stats;
+    int idx = rand_r(seed) % cfg->hotkey_count;
+    int op = pick_op(cfg, seed);
+    HotKeyState *ks = &args->hot_keys[idx];
+
+    char key[MAX_KEY_LEN];
+    snprintf(key, sizeof(key), "%s-hot-%d", cfg->key_prefix, idx);
+    long long size = cfg->size_table ? size_dist_sample(cfg, ((uint64_t)rand_r(seed) << 32) ^ (uint64_t)rand_r(seed))
+                                     : cfg->object_size_max;
+
+    // 每个 PUT 版本从不同偏移写入, 保证 ETag 可区分
+    if (op == HOTKEY_OP_PUT) {
+        args->pattern_offset = (((long long)rand_r(seed) << 31) ^ rand_r(seed)) & args->pattern_mask;
+    }
+    args->last_etag[0] = '\0';
+    long long prev_bytes = args->stats.total_success_bytes;
+    double latency_ms = 0;
+    long long start_ns = monotonic_now_ns();
+    obs_status status = worker_execute_op(args, dl, g_op_cases[op], key, size, NULL, retry_state, &latency_ms);
+    long long end_ns = monotonic_now_ns();
+    args->pattern_offset = 0;
+
+    int ok = (status == OBS_STATUS_OK);
+    int http_code = ok ? 200 : infer_http_code(status);
+    int is_409 = (http_code == 409);
+    int is_503 = (status == OBS_STATUS_ServiceUnavailable || status == OBS_STATUS_SlowDown);
+    int not_found = (http_code == 404);
+
+    size_class_record(&hs->ops[op], ok, args->stats.total_success_bytes - prev_bytes, latency_ms);
+    if (is_409) hs->code_409[op]++;
+    if (is_503) hs->code_503[op]++;
+
+    pthread_mutex_lock(&ks->lock);
+    ks->ops++;
+    if (!ok) ks->fails++;
+    if (is_409) ks->code_409++;
+    if (is_503) ks->code_503++;
+    ks->total_latency_ms += latency_ms;
+    if (latency_ms > ks->max_latency_ms) ks->max_latency_ms = latency_ms;
+
+    if (op == HOTKEY_OP_PUT && ok) {
+        for (int i = 0; i < HOTKEY_HISTORY; i++) {
+            const HotKeyVersion *v = &ks->history[i];
+            if (v->tag != 0 && v->ack_ns > start_ns) {
+                ks->overlapping_puts++;
+                break;
+            }
+        }
+        push_version(ks, etag_tag(args->last_etag), start_ns, end_ns);
+    } else if (op == HOTKEY_OP_DELETE && (ok || not_found)) {
+        push_version(ks, 0, start_ns, end_ns);
+    } else if (op == HOTKEY_OP_GET && (ok || not_found)) {
+        int outcome = classify_read(ks, ok ? etag_tag(args->last_etag) : 0, start_ns, end_ns);
+        hs->reads[outcome]++;
+        if (outcome == HOTKEY_READ_STALE) ks->stale_reads++;
+    }
+    pthread_mutex_unlock(&ks->lock);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+#define HOTKEY_REPORT_TOP   16
+
+void hotkey_save_report(const Config *cfg, const HotKeySet *set, double elapsed_s) {
+    HotKeyThreadStats total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < set->thread_count; i++) {
+        const HotKeyThreadStats *s = &set->stats[i];
+        for (int k = 0; k < HOTKEY_OP_SLOTS; k++) {
+            total.ops[k].success_count += s->ops[k].success_count;
+            total.ops[k].fail_count += s->ops[k].fail_count;
+            total.ops[k].bytes += s->ops[k].bytes;
+            total.ops[k].total_latency_ms += s->ops[k].total_latency_ms;
+            hist_merge(&total.ops[k].latency_hist, &s->ops[k].latency_hist);
+            total.code_409[k] += s->code_409[k];
+            total.code_503[k] += s->code_503[k];
+        }
+        for (int r = 0; r < HOTKEY_READ_OUTCOMES; r++) total.reads[r] += s->reads[r];
+    }
+
+    // 按请求数取前 N 个 Key, 并统计各 Key 平均时延的分布
+    size_t n = (size_t)set->group_count * set->key_count;
+    int top[HOTKEY_REPORT_TOP];
+    int top_count = 0;
+    long long overlapping_puts = 0, reads = 0;
+    double *key_avg = (double *)malloc(n * sizeof(double));
+    size_t active = 0;
+    for (size_t i = 0; i < n; i++) {
+        const HotKeyState *ks = &set->keys[i];
+        overlapping_puts += ks->overlapping_puts;
+        if (ks->ops == 0) continue;
+        if (key_avg) key_avg[active] = ks->total_latency_ms / ks->ops;
+        active++;
+        int pos = top_count < HOTKEY_REPORT_TOP ? top_count++ : HOTKEY_REPORT_TOP;
+        while (pos > 0 && set->keys[top[pos - 1]].ops < ks->ops) {
+            if (pos < HOTKEY_REPORT_TOP) top[pos] = top[pos - 1];
+            pos--;
+        }
+        if (pos < HOTKEY_REPORT_TOP) top[pos] = (int)i;
+    }
+    for (int r = 0; r < HOTKEY_READ_OUTCOMES; r++) reads += total.reads[r];
+    if (key_avg && active > 0) qsort(key_avg, active, sizeof(double), cmp_double);
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/hotkey.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "HotKeys:             %d per bucket x %d bucket(s), %zu touched\n", set->key_count, set->group_count, active);
+        fprintf(fp, "Mix (PUT:GET:DELETE): %d:%d:%d\n", cfg->hotkey_weights[0], cfg->hotkey_weights[1], cfg->hotkey_weights[2]);
+        fprintf(fp, "\n%-8s %10s %8s %8s %8s %10s %10s %10s %10s %10s\n", "Op", "Requests", "Fail", "409", "503",
+                "TPS", "Avg(ms)", "P50(ms)", "P99(ms)", "P99.9(ms)");
+    }
+
+    printf("\n--- Hot-Key Contention ---\n");
+    printf("Hot Keys:        %d x %d bucket(s), mix PUT:GET:DELETE %d:%d:%d\n", set->key_count, set->group_count,
+           cfg->hotkey_weights[0], cfg->hotkey_weights[1], cfg->hotkey_weights[2]);
+    for (int k = 0; k < HOTKEY_OP_SLOTS; k++) {
+        const SizeClassStats *o = &total.ops[k];
+        long long reqs = o->success_count + o->fail_count;
+        if (reqs == 0) continue;
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        if (fp) {
+            fprintf(fp, "%-8s %10lld %8lld %8lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f\n", g_op_names[k], reqs,
+                    o->fail_count, total.code_409[k], total.code_503[k], tps, o->total_latency_ms / reqs,
+                    hist_percentile(&o->latency_hist, 50.0), hist_percentile(&o->latency_hist, 99.0),
+                    hist_percentile(&o->latency_hist, 99.9));
+        }
+        printf("%-8s TPS %10.2f | 409 %.2f%% | 503 %.2f%% | P50 %.2f | P99 %.2f ms\n", g_op_names[k], tps,
+               total.code_409[k] * 100.0 / reqs, total.code_503[k] * 100.0 / reqs,
+               hist_percentile(&o->latency_hist, 50.0), hist_percentile(&o->latency_hist, 99.0));
+    }
+
+    if (fp) {
+        fprintf(fp, "\n[Last-Writer-Wins] GET outcomes by ETag (%lld reads, %lld PUTs overlapped another PUT)\n", reads, overlapping_puts);
+        for (int r = 0; r < HOTKEY_READ_OUTCOMES; r++) {
+            fprintf(fp, "  %-20s %10lld (%.2f%%)\n", g_read_names[r], total.reads[r], reads > 0 ? total.reads[r] * 100.0 / reads : 0.0);
+        }
+        if (key_avg && active > 0) {
+            fprintf(fp, "\n[Per-Key Avg Latency] min %.2f | P50 %.2f | P99 %.2f | max %.2f ms\n", key_avg[0],
+                    key_avg[active / 2], key_avg[(size_t)((active - 1) * 0.99)], key_avg[active - 1]);
+        }
+        fprintf(fp, "\n%-24s %10s %8s %8s %8s %10s %10s %10s %8s\n", "Key (top by requests)", "Requests", "Fail",
+                "409", "503", "Avg(ms)", "Max(ms)", "OvlPUT", "Stale");
+        for (int t = 0; t < top_count; t++) {
+            const HotKeyState *ks = &set->keys[top[t]];
+            char name[128];
+            snprintf(name, sizeof(name), "[%d] %s-hot-%d", top[t] / set->key_count, cfg->key_prefix, top[t] % set->key_count);
+            fprintf(fp, "%-24s %10lld %8lld %8lld %8lld %10.2f %10.2f %10lld %8lld\n", name, ks->ops, ks->fails,
+                    ks->code_409, ks->code_503, ks->total_latency_ms / ks->ops, ks->max_latency_ms,
+                    ks->overlapping_puts, ks->stale_reads);
+        }
+        fclose(fp);
+    }
+    printf("GET by ETag:     latest %lld | in-flight %lld | concurrent %lld | stale %lld | unknown %lld\n",
+           total.reads[HOTKEY_READ_LATEST], total.reads[HOTKEY_READ_INFLIGHT], total.reads[HOTKEY_READ_REORDERED],
+           total.reads[HOTKEY_READ_STALE], total.reads[HOTKEY_READ_UNKNOWN]);
+    free(key_avg);
+}
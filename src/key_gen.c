@@ -0,0 +1,351 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 对象 Key 生成器
+// 每种命名方案对应一个模板, 线程启动时把模板中的常量部分 (KeyPrefix / 用户名 / 分隔符) 预编译为
+// 片段表, 请求时只按片段拼接常量并用查表编码写入发起者编号、对象序号、散列与目录层级, 不经过 snprintf。
+// 同一 (发起者编号, 对象序号) 在任何线程上生成的 Key 相同, GET / DELETE 据此定位此前 PUT 的对象。
+// ----------------------------------------------------------------------------
+
+#define KEY_SEG_LIT     0
+#define KEY_SEG_OWNER   1
+#define KEY_SEG_SEQ     2
+#define KEY_SEG_HASH    3
+#define KEY_SEG_TREE    4
+
+#define KEY_PAD_CHAR    'x'
+
+static const char *g_key_scheme_names[] = { "flat", "hashed", "tree", "fixed", "template" };
+
+// 内置方案的模板, 顺序与 KEY_SCHEME_* 一致; flat / hashed 与此前的 Key 格式完全相同
+static const char *g_key_scheme_templates[] = {
+    "{prefix}-{user}-{owner}-{seq}",
+    "{hash}-{prefix}-{user}-{owner}-{seq}",
+    "{prefix}/{tree}{user}-{owner}-{seq}",
+    "{prefix}-{user}-{owner:6}-{seq:12}",
+    NULL
+};
+
+// SplitMix64-based kernel: extremely fast, good avalanche properties.
+// Perfect for high-performance key prefix generation.
+static inline uint64_t fast_mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static const char g_hex_lookup[] = "0123456789abcdef";
+
+static const char g_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// 十进制编码, 不足 width 位时补零; 返回写入的字符数
+static inline int encode_u64(uint64_t v, int width, char *out) {
+    char tmp[20];
+    int n = 0;
+    while (v >= 100) {
+        const char *p = &g_digit_pairs[(v % 100) * 2];
+        v /= 100;
+        tmp[n++] = p[1];
+        tmp[n++] = p[0];
+    }
+    if (v >= 10) {
+        tmp[n++] = g_digit_pairs[v * 2 + 1];
+        tmp[n++] = g_digit_pairs[v * 2];
+    } else {
+        tmp[n++] = (char)('0' + v);
+    }
+    int len = 0;
+    for (int i = n; i < width; i++) out[len++] = '0';
+    while (n > 0) out[len++] = tmp[--n];
+    return len;
+}
+
+static inline int encode_i64(long long v, int width, char *out) {
+    if (v < 0) {
+        out[0] = '-';
+        return 1 + encode_u64((uint64_t)0 - (uint64_t)v, width > 1 ? width - 1 : 0, out + 1);
+    }
+    return encode_u64((uint64_t)v, width, out);
+}
+
+static int decimal_digits(uint64_t v) {
+    int n = 1;
+    while (v >= 10) { v /= 10; n++; }
+    return n;
+}
+
+int key_scheme_from_string(const char *s) {
+    for (int i = 0; i < (int)(sizeof(g_key_scheme_names) / sizeof(g_key_scheme_names[0])); i++) {
+        if (strcasecmp(s, g_key_scheme_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char *key_scheme_to_string(int scheme) {
+    if (scheme < 0 || scheme >= (int)(sizeof(g_key_scheme_names) / sizeof(g_key_scheme_names[0]))) return "unknown";
+    return g_key_scheme_names[scheme];
+}
+
+// 返回 1 已处理, 0 不是 Key 生成器的配置项, -1 取值非法 (已打印错误)
+int key_gen_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "KeyScheme") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->key_scheme = key_scheme_from_string(val);
+        if (cfg->key_scheme < 0) {
+            printf("[Config Error] 'KeyScheme' must be flat / hashed / tree / fixed / template. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "KeyTemplate") == 0) {
+        if (strlen(val) >= sizeof(cfg->key_template)) {
+            printf("[Config Error] 'KeyTemplate' is too long (max %zu chars).\n", sizeof(cfg->key_template) - 1);
+            return -1;
+        }
+        strcpy(cfg->key_template, val);
+        return 1;
+    }
+    if (strcmp(key, "KeyLength") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->key_length = atoi(val);
+        if (cfg->key_length < 0 || cfg->key_length > MAX_KEY_LEN - 1) {
+            printf("[Config Error] 'KeyLength' must be 0 ~ %d. Invalid value: %s\n", MAX_KEY_LEN - 1, val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "KeyTreeDepth") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->key_tree_depth = atoi(val);
+        if (cfg->key_tree_depth < 1 || cfg->key_tree_depth > KEY_TREE_MAX_DEPTH) {
+            printf("[Config Error] 'KeyTreeDepth' must be 1 ~ %d. Invalid value: %s\n", KEY_TREE_MAX_DEPTH, val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "KeyTreeFanout") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->key_tree_fanout = atoi(val);
+        if (cfg->key_tree_fanout < 2 || cfg->key_tree_fanout > 65536) {
+            printf("[Config Error] 'KeyTreeFanout' must be 2 ~ 65536. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static const char *scheme_template(const Config *cfg) {
+    if (cfg->key_scheme == KEY_SCHEME_TEMPLATE) return cfg->key_template;
+    return g_key_scheme_templates[cfg->key_scheme];
+}
+
+static int append_lit(KeyGen *kg, const char *s, size_t n) {
+    if (n == 0) return 0;
+    if (kg->lit_len + n >= sizeof(kg->lit)) return -1;
+    if (kg->seg_count > 0 && kg->segs[kg->seg_count - 1].type == KEY_SEG_LIT) {
+        kg->segs[kg->seg_count - 1].len += (unsigned short)n;
+    } else {
+        if (kg->seg_count >= KEY_GEN_MAX_SEGS) return -1;
+        KeySegment *seg = &kg->segs[kg->seg_count++];
+        seg->type = KEY_SEG_LIT;
+        seg->width = 0;
+        seg->off = (unsigned short)kg->lit_len;
+        seg->len = (unsigned short)n;
+    }
+    memcpy(kg->lit + kg->lit_len, s, n);
+    kg->lit_len += (int)n;
+    return 0;
+}
+
+static int append_field(KeyGen *kg, int type, int width) {
+    if (kg->seg_count >= KEY_GEN_MAX_SEGS) return -1;
+    KeySegment *seg = &kg->segs[kg->seg_count++];
+    seg->type = (unsigned char)type;
+    seg->width = (unsigned char)width;
+    seg->off = 0;
+    seg->len = 0;
+    return 0;
+}
+
+// 解析模板: {prefix} {user} 折叠为常量, {owner[:w]} {seq[:w]} 补零到 w 位, {hash[:n]} 取前 n 位 hex (缺省 32),
+// {tree} 展开为 KeyTreeDepth 级 "目录/"; "{{" / "}}" 为字面量花括号
+int key_gen_compile(KeyGen *kg, const Config *cfg, const char *username, char *err, size_t err_len) {
+    memset(kg, 0, sizeof(KeyGen));
+    kg->pad_to = cfg->key_length;
+    kg->tree_depth = cfg->key_tree_depth;
+    kg->tree_fanout = cfg->key_tree_fanout;
+    kg->tree_width = decimal_digits((uint64_t)(cfg->key_tree_fanout - 1));
+
+    const char *p = scheme_template(cfg);
+    if (!p || !*p) {
+        snprintf(err, err_len, "'KeyScheme=template' requires 'KeyTemplate'");
+        return -1;
+    }
+    int max_len = 0;
+    while (*p) {
+        if ((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}')) {
+            if (append_lit(kg, p, 1) != 0) goto too_long;
+            max_len++;
+            p += 2;
+            continue;
+        }
+        if (*p != '{') {
+            const char *q = p;
+            while (*q && *q != '{' && !(q[0] == '}' && q[1] == '}')) q++;
+            if (append_lit(kg, p, (size_t)(q - p)) != 0) goto too_long;
+            max_len += (int)(q - p);
+            p = q;
+            continue;
+        }
+        const char *close = strchr(p, '}');
+        if (!close) {
+            snprintf(err, err_len, "unterminated placeholder in key template: %s", p);
+            return -1;
+        }
+        char name[32];
+        size_t n = (size_t)(close - p - 1);
+        if (n == 0 || n >= sizeof(name)) {
+            snprintf(err, err_len, "invalid placeholder in key template: %.*s", (int)(close - p + 1), p);
+            return -1;
+        }
+        memcpy(name, p + 1, n);
+        name[n] = '\0';
+        int width = -1;
+        char *colon = strchr(name, ':');
+        if (colon) {
+            *colon = '\0';
+            char *end;
+            long w = strtol(colon + 1, &end, 10);
+            if (end == colon + 1 || *end != '\0' || w < 1 || w > 64) {
+                snprintf(err, err_len, "invalid width in placeholder {%s:%s}", name, colon + 1);
+                return -1;
+            }
+            width = (int)w;
+        }
+
+        int rc = 0;
+        if (strcmp(name, "prefix") == 0 && width < 0) {
+            rc = append_lit(kg, cfg->key_prefix, strlen(cfg->key_prefix));
+            max_len += (int)strlen(cfg->key_prefix);
+        } else if (strcmp(name, "user") == 0 && width < 0) {
+            rc = append_lit(kg, username, strlen(username));
+            max_len += (int)strlen(username);
+        } else if (strcmp(name, "owner") == 0) {
+            rc = append_field(kg, KEY_SEG_OWNER, width > 0 ? width : 0);
+            max_len += width > 11 ? width : 11;
+        } else if (strcmp(name, "seq") == 0) {
+            rc = append_field(kg, KEY_SEG_SEQ, width > 0 ? width : 0);
+            max_len += width > 20 ? width : 20;
+        } else if (strcmp(name, "hash") == 0) {
+            if (width > 32) {
+                snprintf(err, err_len, "{hash:n} supports at most 32 hex chars");
+                return -1;
+            }
+            rc = append_field(kg, KEY_SEG_HASH, width > 0 ? width : 32);
+            max_len += width > 0 ? width : 32;
+        } else if (strcmp(name, "tree") == 0 && width < 0) {
+            rc = append_field(kg, KEY_SEG_TREE, 0);
+            max_len += kg->tree_depth * (kg->tree_width + 1);
+        } else {
+            snprintf(err, err_len, "unknown placeholder {%s} (prefix/user/owner/seq/hash/tree)", name);
+            return -1;
+        }
+        if (rc != 0) goto too_long;
+        p = close + 1;
+    }
+    if (max_len > MAX_KEY_LEN - 1) goto too_long;
+    kg->max_len = max_len > kg->pad_to ? max_len : kg->pad_to;
+    return 0;
+
+too_long:
+    snprintf(err, err_len, "key template expands beyond %d chars or %d segments", MAX_KEY_LEN - 1, KEY_GEN_MAX_SEGS);
+    return -1;
+}
+
+// 返回 Key 长度; out 不足时截断
+int key_gen_format(const KeyGen *kg, int key_owner_id, long long object_seq_id, char *out, size_t len) {
+    char buf[MAX_KEY_LEN + 64];
+    char *dst = (kg->max_len < (int)len) ? out : buf;
+    int pos = 0;
+    // 与此前 hashed 格式相同的种子与混合方式, 已写入的对象在升级后仍可读取
+    uint64_t key_seed = ((uint64_t)key_owner_id << 32) ^ (uint64_t)object_seq_id;
+
+    for (int i = 0; i < kg->seg_count; i++) {
+        const KeySegment *seg = &kg->segs[i];
+        switch (seg->type) {
+            case KEY_SEG_LIT:
+                memcpy(dst + pos, kg->lit + seg->off, seg->len);
+                pos += seg->len;
+                break;
+            case KEY_SEG_OWNER:
+                pos += encode_i64(key_owner_id, seg->width, dst + pos);
+                break;
+            case KEY_SEG_SEQ:
+                pos += encode_i64(object_seq_id, seg->width, dst + pos);
+                break;
+            case KEY_SEG_HASH: {
+                uint64_t part1 = fast_mix64(key_seed + 0x9e3779b97f4a7c15ULL);
+                uint64_t part2 = fast_mix64(part1 + 0x9e3779b97f4a7c15ULL);
+                for (int k = 0; k < seg->width; k++) {
+                    uint64_t v = k < 16 ? part1 : part2;
+                    dst[pos + k] = g_hex_lookup[(v >> (60 - 4 * (k & 15))) & 0xf];
+                }
+                pos += seg->width;
+                break;
+            }
+            case KEY_SEG_TREE: {
+                // 每级目录由 Key 散列独立选取, 同一对象的路径固定, 各目录的对象数均匀
+                uint64_t h = key_seed;
+                for (int level = 0; level < kg->tree_depth; level++) {
+                    h = fast_mix64(h + 0x9e3779b97f4a7c15ULL);
+                    pos += encode_u64(h % (uint64_t)kg->tree_fanout, kg->tree_width, dst + pos);
+                    dst[pos++] = '/';
+                }
+                break;
+            }
+        }
+    }
+    if (pos < kg->pad_to) {
+        memset(dst + pos, KEY_PAD_CHAR, (size_t)(kg->pad_to - pos));
+        pos = kg->pad_to;
+    }
+
+    if (dst != out) {
+        if (len == 0) return pos;
+        size_t n = (size_t)pos < len - 1 ? (size_t)pos : len - 1;
+        memcpy(out, dst, n);
+        out[n] = '\0';
+        return (int)n;
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+// 未显式指定 KeyScheme 时按 ObjNamePatternHash 选择 flat / hashed; 以空用户名试编译检查模板
+int key_gen_validate(Config *cfg) {
+    if (cfg->key_scheme < 0) cfg->key_scheme = cfg->obj_name_pattern_hash ? KEY_SCHEME_HASHED : KEY_SCHEME_FLAT;
+
+    KeyGen kg;
+    char err[256];
+    if (key_gen_compile(&kg, cfg, "", err, sizeof(err)) != 0) {
+        printf("[Config Error] Invalid key naming: %s\n", err);
+        return -1;
+    }
+    return 0;
+}
+
+void key_gen_write_brief(FILE *fp, const Config *cfg) {
+    if (cfg->key_scheme == KEY_SCHEME_TEMPLATE) {
+        fprintf(fp, "  KeyScheme:         template (%s)\n", cfg->key_template);
+    } else if (cfg->key_scheme == KEY_SCHEME_TREE) {
+        fprintf(fp, "  KeyScheme:         tree (depth %d, fanout %d)\n", cfg->key_tree_depth, cfg->key_tree_fanout);
+    } else {
+        fprintf(fp, "  KeyScheme:         %s\n", key_scheme_to_string(cfg->key_scheme));
+    }
+    if (cfg->key_length > 0) fprintf(fp, "  KeyLength:         %d (padded with '%c')\n", cfg->key_length, KEY_PAD_CHAR);
+}
@@ -3,6 +3,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <time.h> 
 #include <ctype.h>
 #include <signal.h>
@@ -36,11 +37,13 @@ const char* log_level_to_string(LogLevel level) {
     }
 }
 
-void save_benchmark_report(Config *cfg, long long total, 
-                           long long success, long long fail, 
-                           long long f403, long long f404, long long f409, long long f4other,
-                           long long f5xx, long long fother, long long fvalidate,
-                           double tps, double throughput) {
+void save_benchmark_report(Config *cfg, const ThreadStats *total_stats, double actual_time_s) {
+    long long success = total_stats->success_count;
+    long long fail = stats_total_fail(total_stats);
+    long long total = success + fail;
+    double tps = (actual_time_s > 0) ? (total / actual_time_s) : 0.0;
+    double throughput = (actual_time_s > 0) ? (total_stats->total_success_bytes / 1024.0 / 1024.0 / actual_time_s) : 0.0;
+
     char filepath[512];
     snprintf(filepath, sizeof(filepath), "%s/brief.txt", cfg->task_log_dir);
 
@@ -61,15 +64,20 @@ void save_benchmark_report(Config *cfg, long long total,
     
     fprintf(fp, "---------------- Configuration ----------------\n");
     fprintf(fp, "[Environment]\n");
-    fprintf(fp, "  Endpoint:          %s\n", cfg->endpoint);
+    endpoint_write_brief(fp, cfg);
     fprintf(fp, "  LogLevel:          %s\n", log_level_to_string(cfg->log_level));
     fprintf(fp, "  Bucket(Fixed):     %s\n", cfg->bucket_name_fixed[0] ? cfg->bucket_name_fixed : "N/A");
     fprintf(fp, "  Bucket(Prefix):    %s\n", cfg->bucket_name_prefix[0] ? cfg->bucket_name_prefix : "N/A");
+    if (cfg->buckets_per_user > 1) {
+        fprintf(fp, "  BucketsPerUser:    %d (<bucket>-0 ~ <bucket>-%d, keys routed by hash, see buckets.txt)\n",
+                cfg->buckets_per_user, cfg->buckets_per_user - 1);
+    }
     fprintf(fp, "  STS Auth Mode:     %s\n", cfg->is_temporary_token ? "true" : "false");
     
     fprintf(fp, "[Network]\n");
     fprintf(fp, "  Protocol:          %s\n", cfg->protocol);
     fprintf(fp, "  KeepAlive:         %s\n", cfg->keep_alive ? "true" : "false");
+    if (cfg->path_style) fprintf(fp, "  PathStyle:         true\n");
     fprintf(fp, "  ConnectTimeout:    %d sec\n", cfg->connect_timeout_sec);
     fprintf(fp, "  RequestTimeout:    %d sec\n", cfg->request_timeout_sec);
     fprintf(fp, "  Gm Auth Mode:      %s\n", cfg->gm_auth_mode[0] ? cfg->gm_auth_mode : "Default");
@@ -81,13 +89,38 @@ void save_benchmark_report(Config *cfg, long long total,
     if (cfg->use_mix_mode) {
         fprintf(fp, "  TestMode:          Mixed Operations (900)\n");
         fprintf(fp, "  MixLoopCount:      %lld\n", cfg->mix_loop_count);
+    } else if (cfg->test_case == TEST_CASE_TRACE) {
+        fprintf(fp, "  TestMode:          Trace Replay (910)\n");
+    } else if (cfg->test_case == TEST_CASE_VISIBILITY) {
+        fprintf(fp, "  TestMode:          Read/List-after-Write Visibility (920)\n");
+    } else if (cfg->test_case == TEST_CASE_HOTKEY) {
+        fprintf(fp, "  TestMode:          Hot-Key Contention (930)\n");
+    } else if (cfg->test_case == TEST_CASE_CHURN) {
+        fprintf(fp, "  TestMode:          Steady-State Churn (940)\n");
+    } else if (cfg->test_case == TEST_CASE_CONTROL_PLANE) {
+        fprintf(fp, "  TestMode:          Control-Plane Bucket APIs (950)\n");
+    } else if (cfg->test_case == TEST_CASE_PFS_TREE) {
+        fprintf(fp, "  TestMode:          PFS Directory Tree (970)\n");
+    } else if (cfg->test_case == TEST_CASE_CONN_COST) {
+        fprintf(fp, "  TestMode:          Connection Cost (980)\n");
     } else {
         fprintf(fp, "  TestMode:          Standard TestCase (%d)\n", cfg->test_case);
     }
     fprintf(fp, "  Reqs/Thread:       %d\n", cfg->requests_per_thread);
+    if (cfg->sse_mode == SSE_MODE_KMS) {
+        fprintf(fp, "  Encryption:        sse-kms (key: %s)\n", cfg->sse_kms_key_id[0] ? cfg->sse_kms_key_id : "default");
+    } else if (cfg->sse_mode == SSE_MODE_C) {
+        fprintf(fp, "  Encryption:        sse-c (AES256, %s)\n", cfg->sse_c_key_generated ? "key generated for this run" : "key from SseCKey");
+    } else {
+        fprintf(fp, "  Encryption:        none\n");
+    }
+    mock_model_write_brief(fp, cfg);
 
     fprintf(fp, "[ObjectSettings]\n");
-    if (cfg->is_dynamic_size) {
+    if (cfg->size_table && cfg->object_size_dist != SIZE_DIST_UNIFORM) {
+        fprintf(fp, "  ObjectSize:        %s distribution (%d buckets, mean %.0f bytes, max %lld bytes)\n",
+                size_dist_to_string(cfg->object_size_dist), cfg->size_table->n, cfg->size_table->mean, cfg->size_table->max);
+    } else if (cfg->is_dynamic_size) {
         fprintf(fp, "  ObjectSize:        %lld ~ %lld bytes (Dynamic)\n", cfg->object_size_min, cfg->object_size_max);
     } else {
         fprintf(fp, "  ObjectSize:        %lld bytes\n", cfg->object_size_max);
@@ -95,7 +128,7 @@ void save_benchmark_report(Config *cfg, long long total,
     fprintf(fp, "  PartSize:          %lld bytes\n", cfg->part_size);
     fprintf(fp, "  Parts/Upload:      %d\n", cfg->parts_for_each_upload_id);
     fprintf(fp, "  KeyPrefix:         %s\n", cfg->key_prefix);
-    fprintf(fp, "  KeyHashPrefix:     %s\n", cfg->obj_name_pattern_hash ? "true" : "false");
+    key_gen_write_brief(fp, cfg);
 
     fprintf(fp, "[Resumable & Validation]\n");
     fprintf(fp, "  EnableCheckpoint:  %s\n", cfg->enable_checkpoint ? "true" : "false");
@@ -106,6 +139,110 @@ void save_benchmark_report(Config *cfg, long long total,
     fprintf(fp, "[Logging]\n");
     fprintf(fp, "  DetailLog:         %s\n", cfg->enable_detail_log ? "true" : "false");
 
+    if (rate_limit_enabled(cfg)) {
+        fprintf(fp, "[RateLimit]\n");
+        fprintf(fp, "  Global:            %.0f TPS / %.2f MB/s\n", cfg->rate_limit_tps, cfg->rate_limit_mbps);
+        fprintf(fp, "  PerUser:           %.0f TPS / %.2f MB/s\n", cfg->user_rate_limit_tps, cfg->user_rate_limit_mbps);
+        fprintf(fp, "  PerThread:         %.0f TPS / %.2f MB/s\n", cfg->thread_rate_limit_tps, cfg->thread_rate_limit_mbps);
+        fprintf(fp, "  BurstWindow:       %.1f ms\n", cfg->rate_limit_burst_ms);
+    }
+
+    if (cfg->affinity_mode != AFFINITY_MODE_NONE) {
+        fprintf(fp, "[Affinity]\n");
+        fprintf(fp, "  Mode:              %s\n", affinity_mode_to_string(cfg->affinity_mode));
+        if (cfg->affinity_mode == AFFINITY_MODE_CPUS) fprintf(fp, "  CpuList:           %s\n", cfg->affinity_cpu_list);
+        else fprintf(fp, "  NumaNodes:         %s\n", cfg->affinity_numa_nodes[0] ? cfg->affinity_numa_nodes : "all");
+        fprintf(fp, "  ServiceCpus:       %s\n", cfg->affinity_service_cpus[0] ? cfg->affinity_service_cpus : "unpinned");
+        fprintf(fp, "  Placement:         see placement.txt (per-thread CPU / per-node throughput)\n");
+    }
+
+    if (cfg->virtual_clients_per_thread > 0) {
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        fprintf(fp, "[VirtualClients]\n");
+        fprintf(fp, "  Clients/Thread:    %d\n", cfg->virtual_clients_per_thread);
+        fprintf(fp, "  Total Clients:     %lld\n", (long long)cfg->threads * cfg->virtual_clients_per_thread);
+        fprintf(fp, "  FiberStack:        %d KB\n", cfg->fiber_stack_kb);
+        fprintf(fp, "  Peak RSS:          %.1f MB\n", ru.ru_maxrss / 1024.0);
+    }
+
+    if (cfg->think_time_dist != THINK_DIST_NONE) {
+        fprintf(fp, "[Pacing]\n");
+        fprintf(fp, "  Mode:              %s\n", cfg->pacing_mode == PACING_MODE_ARRIVAL ? "arrival" : "think");
+        fprintf(fp, "  Distribution:      %s\n", think_dist_to_string(cfg->think_time_dist));
+        fprintf(fp, "  Mean:              %.2f ms\n", cfg->think_time_mean_ms);
+        if (cfg->think_time_dist == THINK_DIST_LOGNORMAL) fprintf(fp, "  Stddev:            %.2f ms\n", cfg->think_time_stddev_ms);
+        if (cfg->think_time_dist == THINK_DIST_EMPIRICAL) fprintf(fp, "  File:              %s (%d points)\n", cfg->think_time_file, cfg->think_empirical_count);
+    }
+
+    if (cfg->test_case == TEST_CASE_TRACE) {
+        fprintf(fp, "[Trace]\n");
+        fprintf(fp, "  TraceFile:         %s\n", cfg->trace_file);
+        fprintf(fp, "  Speedup:           x%.2f\n", cfg->trace_speedup);
+        fprintf(fp, "  QueueDepth:        %d/worker\n", cfg->trace_queue_depth);
+        fprintf(fp, "  Replay Result:     see trace.txt (schedule lag / per-op result)\n");
+    }
+
+    if (cfg->test_case == TEST_CASE_VISIBILITY) {
+        fprintf(fp, "[Visibility]\n");
+        fprintf(fp, "  Groups/User:       %d (1 writer + %d readers)\n",
+                cfg->threads_per_user / (cfg->visibility_readers + 1), cfg->visibility_readers);
+        fprintf(fp, "  ReadOp:            %s%s\n", cfg->visibility_read_head ? "HEAD" : "GET (content check)",
+                cfg->visibility_check_list ? " + LIST" : "");
+        fprintf(fp, "  PollInterval:      %.1f ms\n", cfg->visibility_poll_ms);
+        fprintf(fp, "  Timeout:           %.0f ms\n", cfg->visibility_timeout_ms);
+        fprintf(fp, "  Result:            see visibility.txt (latency histogram / violations)\n");
+    }
+
+    if (cfg->test_case == TEST_CASE_HOTKEY) {
+        fprintf(fp, "[HotKey]\n");
+        fprintf(fp, "  HotKeyCount:       %d\n", cfg->hotkey_count);
+        fprintf(fp, "  Mix:               PUT %d : GET %d : DELETE %d\n", cfg->hotkey_weights[HOTKEY_OP_PUT],
+                cfg->hotkey_weights[HOTKEY_OP_GET], cfg->hotkey_weights[HOTKEY_OP_DELETE]);
+        fprintf(fp, "  Result:            see hotkey.txt (per-key latency / 409 / 503 / ETag outcomes)\n");
+    }
+
+    if (cfg->test_case == TEST_CASE_CHURN) {
+        fprintf(fp, "[Churn]\n");
+        fprintf(fp, "  WorkingSet:        %lld objects/user\n", cfg->churn_working_set);
+        fprintf(fp, "  Mix:               CREATE %d : OVERWRITE %d : READ %d : DELETE %d\n", cfg->churn_weights[CHURN_OP_CREATE],
+                cfg->churn_weights[CHURN_OP_OVERWRITE], cfg->churn_weights[CHURN_OP_READ], cfg->churn_weights[CHURN_OP_DELETE]);
+        fprintf(fp, "  Result:            see churn.txt (live objects / per-op result)\n");
+    }
+
+    if (cfg->test_case == TEST_CASE_CONTROL_PLANE) {
+        fprintf(fp, "[ControlPlane]\n");
+        fprintf(fp, "  BucketPrefix:      %s\n", cfg->cp_bucket_prefix);
+        fprintf(fp, "  ConfigGroups:      0x%02x (head/policy/lifecycle/cors/tagging/versioning)\n", cfg->cp_groups);
+        fprintf(fp, "  Result:            see controlplane.txt (per-API latency)\n");
+    }
+
+    if (cfg->test_case == TEST_CASE_PFS_TREE) pfs_tree_write_brief(fp, cfg);
+    if (cfg->test_case == TEST_CASE_CONN_COST) conn_cost_write_brief(fp, cfg);
+
+    if (cfg->aimd_enable) {
+        fprintf(fp, "[AIMD]\n");
+        fprintf(fp, "  InitialTps/User:   %.1f\n", cfg->aimd_initial_tps);
+        fprintf(fp, "  Increase:          +%.1f TPS per %.0f ms window\n", cfg->aimd_increase_tps, cfg->aimd_window_ms);
+        fprintf(fp, "  DecreaseFactor:    %.2f\n", cfg->aimd_decrease_factor);
+        fprintf(fp, "  Range:             %.1f ~ %.1f TPS (0 = unbounded)\n", cfg->aimd_min_tps, cfg->aimd_max_tps);
+        fprintf(fp, "  Converged Result:  see aimd.txt / aimd.csv\n");
+    }
+
+    fprintf(fp, "[Retry]\n");
+    fprintf(fp, "  MaxAttempts:       %d\n", cfg->retry_max_attempts);
+    fprintf(fp, "  Backoff:           base %.0f ms, cap %.0f ms, jitter %s\n",
+            cfg->retry_base_delay_ms, cfg->retry_max_delay_ms, retry_jitter_to_string(cfg->retry_jitter));
+    if (cfg->retry_max_attempts > 1) {
+        fprintf(fp, "  RetryBudget:       ratio %.2f, burst %d\n", cfg->retry_budget_ratio, cfg->retry_budget_min);
+    }
+
+    if (cfg->agent_count > 1) {
+        fprintf(fp, "[Distributed]\n");
+        fprintf(fp, "  Agents:            %d\n", cfg->agent_count);
+        fprintf(fp, "  Threads/Agent:     %d\n", cfg->threads / cfg->agent_count);
+    }
+
     if (strlen(cfg->gm_auth_mode) > 0) {
         fprintf(fp, "[SecurityPaths]\n");
         if (cfg->server_cert_path[0]) fprintf(fp, "  ServerCert:        %s\n", cfg->server_cert_path);
@@ -119,17 +256,81 @@ void save_benchmark_report(Config *cfg, long long total,
     fprintf(fp, "Total Requests:      %lld\n", total);
     fprintf(fp, "Success:             %lld\n", success);
     fprintf(fp, "Failed:              %lld\n", fail);
-    fprintf(fp, "  |- 403 (Forbidden):  %lld\n", f403);
-    fprintf(fp, "  |- 404 (NotFound):   %lld\n", f404);
-    fprintf(fp, "  |- 409 (Conflict):   %lld\n", f409);
-    fprintf(fp, "  |- 4xx (Other):      %lld\n", f4other);
-    fprintf(fp, "  |- 5xx (Server):     %lld\n", f5xx);
-    fprintf(fp, "  |- Other (Net/SDK):  %lld\n", fother);
-    fprintf(fp, "  |- Internal Validation Fail: %lld\n", fvalidate);
+    fprintf(fp, "  |- 403 (Forbidden):  %lld\n", total_stats->fail_403_count);
+    fprintf(fp, "  |- 404 (NotFound):   %lld\n", total_stats->fail_404_count);
+    fprintf(fp, "  |- 409 (Conflict):   %lld\n", total_stats->fail_409_count);
+    fprintf(fp, "  |- 4xx (Other):      %lld\n", total_stats->fail_4xx_other_count);
+    fprintf(fp, "  |- 5xx (Server):     %lld\n", total_stats->fail_5xx_count);
+    fprintf(fp, "  |- Other (Net/SDK):  %lld\n", total_stats->fail_other_count);
+    fprintf(fp, "  |- Internal Validation Fail: %lld\n", total_stats->fail_validation_count);
     
     fprintf(fp, "\nPerformance:\n");
     fprintf(fp, "  Final TPS:           %.2f\n", tps);
     fprintf(fp, "  Final Throughput:    %.2f MB/s\n", throughput);
+    if (rate_limit_enabled(cfg)) {
+        double thread_time_s = actual_time_s * cfg->threads;
+        fprintf(fp, "  Throttled Requests:  %lld\n", total_stats->throttled_count);
+        fprintf(fp, "  Throttled Time:      %.2f thread-s (%.2f%% of thread time)\n",
+                total_stats->throttled_ns / 1e9,
+                thread_time_s > 0 ? (total_stats->throttled_ns / 1e9) / thread_time_s * 100.0 : 0.0);
+    }
+
+    if (total_stats->cpu_ns > 0) {
+        double thread_time_s = actual_time_s * cfg->threads;
+        fprintf(fp, "\nClient Overhead:\n");
+        fprintf(fp, "  Worker CPU:          %.3f s (%.2f%% of thread time)\n", total_stats->cpu_ns / 1e9,
+                thread_time_s > 0 ? (total_stats->cpu_ns / 1e9) / thread_time_s * 100.0 : 0.0);
+        fprintf(fp, "  CPU/Request:         %.0f ns\n", total > 0 ? (double)total_stats->cpu_ns / total : 0.0);
+        if (total_stats->attempt_count > total) {
+            fprintf(fp, "  CPU/Attempt:         %.0f ns\n", (double)total_stats->cpu_ns / total_stats->attempt_count);
+        }
+        if (cfg->agent_count <= 1) {
+            // 进程级 CPU 另含监控线程与 SDK 内部线程
+            struct rusage ru;
+            getrusage(RUSAGE_SELF, &ru);
+            double proc_s = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+            fprintf(fp, "  Process CPU:         %.2f s (user %.2f + sys %.2f), %.0f ns/request\n", proc_s,
+                    ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6, ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6,
+                    total > 0 ? proc_s * 1e9 / total : 0.0);
+        }
+    }
+
+    if (cfg->retry_max_attempts > 1) {
+        const LatencyHistogram *fh = &total_stats->first_attempt_hist;
+        fprintf(fp, "\nRetry:\n");
+        fprintf(fp, "  Logical Ops:         %lld\n", total);
+        fprintf(fp, "  Attempts:            %lld\n", total_stats->attempt_count);
+        fprintf(fp, "  Retries:             %lld\n", total_stats->retry_count);
+        fprintf(fp, "  Amplification:       %.3f attempts/op\n", total > 0 ? (double)total_stats->attempt_count / total : 0.0);
+        fprintf(fp, "  Budget Exhausted:    %lld\n", total_stats->retry_budget_exhausted);
+        fprintf(fp, "  First-Attempt (ms):  P50 %.2f | P90 %.2f | P99 %.2f | P99.9 %.2f\n",
+                hist_percentile(fh, 50.0), hist_percentile(fh, 90.0), hist_percentile(fh, 99.0), hist_percentile(fh, 99.9));
+    }
+
+    if (cfg->think_time_dist != THINK_DIST_NONE) {
+        const LatencyHistogram *ia = &total_stats->interarrival_hist;
+        fprintf(fp, "\nPacing (per client):\n");
+        fprintf(fp, "  Intervals:           %lld\n", ia->count);
+        fprintf(fp, "  Intended Mean Gap:   %.2f ms\n", ia->count > 0 ? total_stats->intended_interarrival_ns / 1e6 / ia->count : 0.0);
+        fprintf(fp, "  Achieved Mean Gap:   %.2f ms\n", ia->count > 0 ? total_stats->interarrival_ns / 1e6 / ia->count : 0.0);
+        fprintf(fp, "  Achieved Gap (ms):   P50 %.2f | P90 %.2f | P99 %.2f | P99.9 %.2f\n",
+                hist_percentile(ia, 50.0), hist_percentile(ia, 90.0), hist_percentile(ia, 99.0), hist_percentile(ia, 99.9));
+        fprintf(fp, "  Avg Schedule Lag:    %.3f ms\n", ia->count > 0 ? total_stats->pacing_lag_ns / 1e6 / ia->count : 0.0);
+        if (cfg->pacing_mode == PACING_MODE_ARRIVAL) {
+            fprintf(fp, "  Late Starts:         %lld (%.2f%%)\n", total_stats->pacing_late_count,
+                    ia->count > 0 ? total_stats->pacing_late_count * 100.0 / ia->count : 0.0);
+        }
+    }
+
+    const LatencyHistogram *h = &total_stats->latency_hist;
+    fprintf(fp, "\nLatency (ms, end-to-end incl. retries):\n");
+    fprintf(fp, "  Avg:                 %.2f\n", h->count > 0 ? total_stats->total_latency_ms / h->count : 0.0);
+    fprintf(fp, "  Min:                 %.2f\n", total_stats->min_latency_ms > 0 ? total_stats->min_latency_ms : 0.0);
+    fprintf(fp, "  P50:                 %.2f\n", hist_percentile(h, 50.0));
+    fprintf(fp, "  P90:                 %.2f\n", hist_percentile(h, 90.0));
+    fprintf(fp, "  P99:                 %.2f\n", hist_percentile(h, 99.0));
+    fprintf(fp, "  P99.9:               %.2f\n", hist_percentile(h, 99.9));
+    fprintf(fp, "  Max:                 %.2f\n", total_stats->max_latency_ms);
     fprintf(fp, "===========================================\n");
 
     fclose(fp);
@@ -150,6 +351,10 @@ typedef struct {
     int interval_sec;
     volatile int stop_flag;
     char task_log_dir[256]; 
+    int agent_fd;           // Agent 模式下向 Coordinator 回传区间统计, 单机模式为 -1
+    AimdController *aimd;   // AIMD 速率采样, 未开启时为 NULL
+    int aimd_count;
+    TraceReplay *trace;     // 回放模式下按已读取的 trace 字节计算进度
 } MonitorArgs;
 
 void *monitor_routine(void *arg) {
@@ -184,6 +389,14 @@ void *monitor_routine(void *arg) {
         long long current_total = current_success + current_fail;
         gettimeofday(&curr_tv, NULL);
         double total_elapsed_s = (curr_tv.tv_sec - start_tv.tv_sec) + (curr_tv.tv_usec - start_tv.tv_usec) / 1000000.0;
+
+        if (m_args->aimd) aimd_sample(m_args->aimd, m_args->aimd_count, total_elapsed_s);
+
+        if (m_args->agent_fd >= 0) {
+            if (agent_send_interval(m_args->agent_fd, total_elapsed_s, current_success, current_fail, current_bytes) != 0) {
+                LOG_WARN("Failed to stream interval stats to coordinator.");
+            }
+        }
         
         if (total_elapsed_s > 0) {
             double cumul_tps = current_total / total_elapsed_s;
@@ -195,14 +408,18 @@ void *monitor_routine(void *arg) {
             
             if (cfg->run_seconds > 0) {
                 progress_pct = (total_elapsed_s / cfg->run_seconds) * 100.0;
+            } else if (m_args->trace) {
+                progress_pct = trace_progress(m_args->trace);
             } else {
                 long long reqs_per_op = cfg->requests_per_thread > 0 ? cfg->requests_per_thread : 1;
                 long long expected_total_reqs = 0;
                 
+                // 协程模式下 RequestsPerThread 针对每个虚拟客户端
+                long long clients = (long long)cfg->threads * (cfg->virtual_clients_per_thread > 0 ? cfg->virtual_clients_per_thread : 1);
                 if (cfg->use_mix_mode) {
-                    expected_total_reqs = (long long)cfg->threads * cfg->mix_op_count * cfg->mix_loop_count * reqs_per_op;
+                    expected_total_reqs = clients * cfg->mix_op_count * cfg->mix_loop_count * reqs_per_op;
                 } else if (cfg->requests_per_thread > 0) {
-                    expected_total_reqs = (long long)cfg->threads * reqs_per_op;
+                    expected_total_reqs = clients * reqs_per_op;
                 }
                 
                 if (expected_total_reqs > 0) {
@@ -233,121 +450,292 @@ void *monitor_routine(void *arg) {
     return NULL;
 }
 
-int main(int argc, char **argv) {
-    signal(SIGPIPE, SIG_IGN);
-    signal(SIGINT, handle_sigint);
+void print_benchmark_result(const ThreadStats *total, double actual_time_s) {
+    long long total_fail = stats_total_fail(total);
+    long long total_reqs = total->success_count + total_fail;
+    double tps = (actual_time_s > 0) ? (total_reqs / actual_time_s) : 0.0;
+    double throughput_mb = (actual_time_s > 0) ? (total->total_success_bytes / 1024.0 / 1024.0 / actual_time_s) : 0.0;
 
-    struct stat st = {0};
-    if (stat("logs", &st) == -1) mkdir("logs", 0755);
-    if (stat("upload_checkpoint", &st) == -1) mkdir("upload_checkpoint", 0755);
-    
-    initialize_break_point_lock();
-    
-    time_t now = time(NULL);
-    struct tm t_res;
-    struct tm *t = localtime_r(&now, &t_res);
-    Config cfg;
-    memset(&cfg, 0, sizeof(Config));
-    
-    if (t) {
-        snprintf(cfg.task_log_dir, sizeof(cfg.task_log_dir), "logs/task_%04d%02d%02d_%02d%02d%02d",
-                 t->tm_year + 1900, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
-    } else {
-        snprintf(cfg.task_log_dir, sizeof(cfg.task_log_dir), "logs/task_UNKNOWN");
+    if (g_graceful_stop) {
+        printf("\n[WARN] Benchmark interrupted by user (Graceful Stop).\n");
     }
-             
-    if (stat(cfg.task_log_dir, &st) == -1) mkdir(cfg.task_log_dir, 0755);
 
-    const char *config_file = "config.dat";
-    int cli_test_case = 0;
-    if (argc > 1) {
-        if (isdigit(argv[1][0])) cli_test_case = atoi(argv[1]);
-        else config_file = argv[1];
+    printf("\n--- Test Result ---\n");
+    printf("Actual Duration: %.2f s\n", actual_time_s);
+    printf("Total Requests:  %lld\n", total_reqs);
+    printf("Success:         %lld\n", total->success_count);
+    printf("Failed:          %lld\n", total_fail);
+    printf("  |- 403 (Forbidden):  %lld\n", total->fail_403_count);
+    printf("  |- 404 (NotFound):   %lld\n", total->fail_404_count);
+    printf("  |- 409 (Conflict):   %lld\n", total->fail_409_count);
+    printf("  |- 4xx (Other):      %lld\n", total->fail_4xx_other_count);
+    printf("  |- 5xx (Server):     %lld\n", total->fail_5xx_count);
+    printf("  |- Other (Net/SDK):  %lld\n", total->fail_other_count);
+    printf("  |- Internal Validation Fail: %lld\n", total->fail_validation_count);
+    
+    printf("TPS:             %.2f\n", tps);
+    printf("Throughput:      %.2f MB/s\n", throughput_mb);
+    if (total->retry_count > 0) {
+        printf("Retries:         %lld (amplification %.3f attempts/op, budget exhausted %lld)\n", total->retry_count,
+               total_reqs > 0 ? (double)total->attempt_count / total_reqs : 0.0, total->retry_budget_exhausted);
+        printf("First-Attempt:   P50 %.2f | P99 %.2f ms\n",
+               hist_percentile(&total->first_attempt_hist, 50.0), hist_percentile(&total->first_attempt_hist, 99.0));
     }
-
-    if (load_config(config_file, &cfg) != 0) return 1;
-
-    if (cli_test_case > 0) {
-        cfg.test_case = cli_test_case;
-        if (cli_test_case == TEST_CASE_MIX && cfg.mix_op_count > 0) cfg.use_mix_mode = 1;
-        else cfg.use_mix_mode = 0;
+    if (total->interarrival_hist.count > 0) {
+        long long n = total->interarrival_hist.count;
+        printf("Pacing:          gap intended %.2f ms / achieved %.2f ms, lag %.3f ms, late %lld\n",
+               total->intended_interarrival_ns / 1e6 / n, total->interarrival_ns / 1e6 / n,
+               total->pacing_lag_ns / 1e6 / n, total->pacing_late_count);
     }
-
-    log_init(cfg.log_level);
-    LOG_INFO("--- OBS C SDK Benchmark Tool ---");
-    LOG_INFO("Task Output Dir: %s", cfg.task_log_dir);
-
-    // ==========================================================
-    // [强校验拦截]: 如果是多段上传，必须显式配置 PartsForEachUploadID
-    // ==========================================================
-    if (cfg.test_case == TEST_CASE_MULTIPART) {
-        if (cfg.parts_for_each_upload_id <= 0) {
-            LOG_ERROR("FATAL: TestCase 216 (Multipart Upload) requires 'PartsForEachUploadID' to be explicitly set in config.dat (valid range: 1~10000).");
-            return 1;
-        }
+    if (total->throttled_count > 0) {
+        printf("Throttled:       %lld requests, %.2f thread-s waiting\n", total->throttled_count, total->throttled_ns / 1e9);
     }
+    if (total->cpu_ns > 0 && total_reqs > 0) {
+        printf("Client CPU:      %.0f ns/request (worker threads, %.3f s total)\n",
+               (double)total->cpu_ns / total_reqs, total->cpu_ns / 1e9);
+    }
+    printf("Latency(ms):     P50 %.2f | P90 %.2f | P99 %.2f | P99.9 %.2f | Max %.2f\n",
+           hist_percentile(&total->latency_hist, 50.0), hist_percentile(&total->latency_hist, 90.0),
+           hist_percentile(&total->latency_hist, 99.0), hist_percentile(&total->latency_hist, 99.9),
+           total->max_latency_ms);
+}
 
-    // ==========================================================
-    // [前置阶段]: 拦截生成凭证
-    // ==========================================================
-    if (cfg.is_temporary_token) {
-        LOG_INFO("IsTemporaryToken enabled. Fetching STS tokens for %d users...", cfg.target_user_count);
+// ==========================================================
+// 凭证加载: STS 模式下先调用脚本生成临时凭证, 否则读取 users_file
+// ==========================================================
+int prepare_user_credentials(Config *cfg, const char *users_file) {
+    if (cfg->is_temporary_token) {
+        LOG_INFO("IsTemporaryToken enabled. Fetching STS tokens for %d users...", cfg->target_user_count);
 
         char cmd[256];
-        snprintf(cmd, sizeof(cmd), "python3 generate_temp_ak_sk.py %d", cfg.target_user_count);
+        snprintf(cmd, sizeof(cmd), "python3 generate_temp_ak_sk.py %d", cfg->target_user_count);
 
         if (system(cmd) != 0) {
             LOG_ERROR("FATAL: Failed to generate temporary credentials. (Command: %s)", cmd);
-            return 1;
+            return -1;
         }
         
-        if (load_users_file("temptoken.dat", &cfg, 1) < 0) return 1;
+        if (load_users_file("temptoken.dat", cfg, 1) < 0) return -1;
     } else {
-        if (load_users_file("users.dat", &cfg, 0) < 0) return 1;
+        if (load_users_file(users_file, cfg, 0) < 0) return -1;
     }
 
-    if (cfg.threads_per_user <= 0) cfg.threads_per_user = 1;
-    cfg.threads = cfg.loaded_user_count * cfg.threads_per_user;
-        
-    printf("[Config] Multi-User Mode: %d Users Loaded. %d Threads/User. Total Threads: %d\n", 
-           cfg.loaded_user_count, cfg.threads_per_user, cfg.threads);
-
-    if (cfg.enable_data_validation) printf("[Config] Data Validation: ENABLED\n");
-    if (cfg.enable_detail_log) printf("[Config] Detail Request Log: ENABLED\n");
+    if (cfg->threads_per_user <= 0) cfg->threads_per_user = 1;
+    cfg->threads = cfg->loaded_user_count * cfg->threads_per_user;
+    return 0;
+}
 
-    obs_status status = obs_initialize(OBS_INIT_ALL);
-    if (status != OBS_STATUS_OK) return -1;
+// ==========================================================
+// 本地发流: 创建 Worker 与 Monitor 线程, 结束后聚合统计
+// start_wall_ms > 0 时阻塞至该墙上时间再起跑 (分布式同步起跑)
+// ==========================================================
+int run_local_benchmark(Config *cfg, int agent_fd, double start_wall_ms, ThreadStats *out_total, double *out_elapsed_s) {
+    if (start_wall_ms > 0) {
+        struct timeval tv_now;
+        gettimeofday(&tv_now, NULL);
+        double wait_ms = start_wall_ms - (tv_now.tv_sec * 1000.0 + tv_now.tv_usec / 1000.0);
+        if (wait_ms > 0) {
+            LOG_INFO("Waiting %.0f ms for synchronized start...", wait_ms);
+            usleep((useconds_t)(wait_ms * 1000.0));
+        } else {
+            LOG_WARN("Synchronized start time already passed by %.0f ms (check NTP sync).", -wait_ms);
+        }
+    }
 
     double current_ms = 0; 
     struct timespec ts_now;
     clock_gettime(CLOCK_MONOTONIC_COARSE, &ts_now);
     current_ms = ts_now.tv_sec * 1000.0 + ts_now.tv_nsec / 1000000.0;
-    double stop_ms = (cfg.run_seconds > 0) ? (current_ms + cfg.run_seconds * 1000.0) : 1e15; 
+    double stop_ms = (cfg->run_seconds > 0) ? (current_ms + cfg->run_seconds * 1000.0) : 1e15; 
+
+    pthread_t *tids = (pthread_t *)malloc(cfg->threads * sizeof(pthread_t));
+    // WorkerArgs 内含按缓存行对齐的令牌桶, 需对齐分配
+    WorkerArgs *t_args = (WorkerArgs *)aligned_alloc(64, cfg->threads * sizeof(WorkerArgs));
+
+    // 以下资源在失败路径与正常结束时统一于 out 处释放
+    int ret = -1;
+    TokenBucket *user_buckets = NULL;
+    AimdController *aimd_ctrls = NULL;
+    SizeClassStats *size_stats = NULL;
+    TraceReplay *trace = NULL;
+    VisibilityChannel *vis_channels = NULL;
+    VisibilityStats *vis_stats = NULL;
+    HotKeySet *hotkeys = NULL;
+    ChurnThread *churn = NULL;
+    ControlPlaneThread *cp = NULL;
+    PfsTree *pfs = NULL;
+    ConnCost *conn_cost = NULL;
+    BucketStats *bucket_stats = NULL;
+    EndpointStats *endpoint_stats = NULL;
+    AffinityPlan *plan = NULL;
+    int vis_group = cfg->visibility_readers + 1;
+    int vis_channel_count = cfg->loaded_user_count * (cfg->threads_per_user / vis_group);
+
+    if (!tids || !t_args) {
+        LOG_ERROR("Failed to allocate worker contexts for %d threads", cfg->threads);
+        goto out;
+    }
+    memset(t_args, 0, cfg->threads * sizeof(WorkerArgs));
+
+    // 限速桶: 全局与每用户的配额在各 Agent 之间均分
+    int rl_on = rate_limit_enabled(cfg);
+    double rl_share = cfg->agent_count > 1 ? 1.0 / cfg->agent_count : 1.0;
+    TokenBucket global_req_bucket, global_bytes_bucket;
+    if (rl_on) {
+        token_bucket_init(&global_req_bucket, cfg->rate_limit_tps * rl_share, cfg->rate_limit_burst_ms);
+        token_bucket_init(&global_bytes_bucket, cfg->rate_limit_mbps * 1024 * 1024 * rl_share, cfg->rate_limit_burst_ms);
+        user_buckets = (TokenBucket *)aligned_alloc(64, cfg->loaded_user_count * 2 * sizeof(TokenBucket));
+        if (!user_buckets) goto out;
+        for (int u = 0; u < cfg->loaded_user_count; u++) {
+            // AIMD 接管用户请求桶, 初始速率同样在各 Agent 之间均分
+            double user_tps = cfg->aimd_enable ? cfg->aimd_initial_tps : cfg->user_rate_limit_tps;
+            token_bucket_init(&user_buckets[u * 2], user_tps * rl_share, cfg->rate_limit_burst_ms);
+            token_bucket_init(&user_buckets[u * 2 + 1], cfg->user_rate_limit_mbps * 1024 * 1024 * rl_share, cfg->rate_limit_burst_ms);
+        }
+        LOG_INFO("Rate limiting enabled (global %.0f TPS / %.2f MB/s, user %.0f TPS / %.2f MB/s, thread %.0f TPS / %.2f MB/s)",
+                 cfg->rate_limit_tps * rl_share, cfg->rate_limit_mbps * rl_share,
+                 cfg->user_rate_limit_tps * rl_share, cfg->user_rate_limit_mbps * rl_share,
+                 cfg->thread_rate_limit_tps, cfg->thread_rate_limit_mbps);
+    }
+
+    if (cfg->aimd_enable) {
+        aimd_ctrls = (AimdController *)aligned_alloc(64, cfg->loaded_user_count * sizeof(AimdController));
+        if (!aimd_ctrls) goto out;
+        for (int u = 0; u < cfg->loaded_user_count; u++) {
+            aimd_init(&aimd_ctrls[u], &user_buckets[u * 2], cfg, cfg->user_list[u].username, rl_share);
+        }
+        LOG_INFO("AIMD throttle enabled (initial %.1f TPS/user, +%.1f per %.0f ms, x%.2f on SlowDown/503, min %.1f, max %.1f TPS/user)",
+                 cfg->aimd_initial_tps * rl_share, cfg->aimd_increase_tps, cfg->aimd_window_ms, cfg->aimd_decrease_factor,
+                 cfg->aimd_min_tps * rl_share, cfg->aimd_max_tps * rl_share);
+    }
+
+    RetryBudget retry_budget;
+    retry_budget_init(&retry_budget, cfg);
+
+    // 按对象大小档位统计, 每线程一组
+    int size_class_slots = cfg->size_class_count + 1;
+    if (cfg->size_table) {
+        size_stats = (SizeClassStats *)calloc((size_t)cfg->threads * size_class_slots, sizeof(SizeClassStats));
+        if (!size_stats) LOG_WARN("Failed to allocate per-size-class stats, size class report disabled.");
+    }
+
+    // 可见性探测: 每用户的线程按 (1 写者 + N 读者) 分组, 每组一个通道
+    if (cfg->test_case == TEST_CASE_VISIBILITY) {
+        vis_channels = (VisibilityChannel *)calloc(vis_channel_count, sizeof(VisibilityChannel));
+        vis_stats = (VisibilityStats *)calloc(cfg->threads, sizeof(VisibilityStats));
+        if (!vis_channels || !vis_stats) {
+            LOG_ERROR("Failed to allocate visibility probe state.");
+            free(vis_channels);
+            vis_channels = NULL;
+            goto out;
+        }
+        for (int i = 0; i < vis_channel_count; i++) visibility_channel_init(&vis_channels[i], cfg->visibility_readers);
+    }
 
-    pthread_t *tids = (pthread_t *)malloc(cfg.threads * sizeof(pthread_t));
-    WorkerArgs *t_args = (WorkerArgs *)calloc(cfg.threads, sizeof(WorkerArgs));
+    // 热点 Key 竞争: 同一桶内全部线程共享各 Key 的状态
+    if (cfg->test_case == TEST_CASE_HOTKEY) {
+        hotkeys = (HotKeySet *)malloc(sizeof(HotKeySet));
+        if (!hotkeys || hotkey_set_init(hotkeys, cfg) != 0) {
+            free(hotkeys);
+            hotkeys = NULL;
+            goto out;
+        }
+    }
+
+    // 多桶路由: 每线程按桶统计
+    if (cfg->buckets_per_user > 1) {
+        bucket_stats = (BucketStats *)calloc((size_t)cfg->threads * cfg->buckets_per_user, sizeof(BucketStats));
+        if (!bucket_stats) {
+            LOG_ERROR("Failed to allocate per-bucket stats (%d buckets/user).", cfg->buckets_per_user);
+            goto out;
+        }
+    }
+
+    // 多接入点: 每线程按接入点统计, P2C 的时延 EWMA 也记录在其中
+    if (cfg->endpoint_count > 1) {
+        endpoint_stats = (EndpointStats *)calloc((size_t)cfg->threads * cfg->endpoint_count, sizeof(EndpointStats));
+        if (!endpoint_stats) {
+            LOG_ERROR("Failed to allocate per-endpoint stats (%d endpoints).", cfg->endpoint_count);
+            goto out;
+        }
+    }
+
+    // 稳态对象流转: 每线程一段槽位
+    if (cfg->test_case == TEST_CASE_CHURN) {
+        churn = churn_alloc(cfg);
+        if (!churn) {
+            LOG_ERROR("Failed to allocate churn slot tables (%lld slots per user).", cfg->churn_working_set);
+            goto out;
+        }
+    }
+
+    // 控制面压测: 每线程按接口统计, 桶名带本次运行标识
+    if (cfg->test_case == TEST_CASE_CONTROL_PLANE) {
+        cp = (ControlPlaneThread *)calloc(cfg->threads, sizeof(ControlPlaneThread));
+        if (!cp) {
+            LOG_ERROR("Failed to allocate control-plane stats for %d threads.", cfg->threads);
+            goto out;
+        }
+        cfg->cp_run_tag = (unsigned int)time(NULL) & 0xfffff;
+    }
+
+    // 目录树压测: 全部线程共享逐层同步点, 统计按 [线程][阶段][层级]
+    if (cfg->test_case == TEST_CASE_PFS_TREE) {
+        pfs = pfs_tree_alloc(cfg);
+        if (!pfs) {
+            LOG_ERROR("Failed to allocate directory-tree stats for %d threads.", cfg->threads);
+            goto out;
+        }
+    }
+
+    // 建连开销压测: 各对照组之间全部线程同步
+    if (cfg->test_case == TEST_CASE_CONN_COST) {
+        conn_cost = conn_cost_alloc(cfg);
+        if (!conn_cost) {
+            LOG_ERROR("Failed to allocate connection-cost stats for %d threads.", cfg->threads);
+            goto out;
+        }
+    }
+
+    // 流量回放: 读取线程在 Worker 之后启动
+    if (cfg->test_case == TEST_CASE_TRACE) {
+        trace = (TraceReplay *)malloc(sizeof(TraceReplay));
+        if (!trace || trace_replay_init(trace, cfg, stop_ms) != 0) {
+            free(trace);
+            trace = NULL;
+            goto out;
+        }
+    }
+
+    // 线程放置: Worker 创建时即绑定, pattern buffer 在线程内首次写入从而分配在本地节点
+    if (cfg->affinity_mode != AFFINITY_MODE_NONE || strlen(cfg->affinity_service_cpus) > 0) {
+        plan = (AffinityPlan *)malloc(sizeof(AffinityPlan));
+        if (!plan || affinity_plan_init(plan, cfg) != 0) goto out;
+        LOG_INFO("Thread placement: mode %s, %d NUMA node(s) detected",
+                 affinity_mode_to_string(plan->mode), plan->node_count);
+    }
 
     struct timeval main_start_tv, main_end_tv;
     gettimeofday(&main_start_tv, NULL);
 
     int global_thread_idx = 0;
-    for (int u = 0; u < cfg.loaded_user_count; u++) {
-        UserCredential *curr_user = &cfg.user_list[u];
+    for (int u = 0; u < cfg->loaded_user_count; u++) {
+        UserCredential *curr_user = &cfg->user_list[u];
         
         char target_bucket[256]; 
         memset(target_bucket, 0, sizeof(target_bucket));
 
-        if (strlen(cfg.bucket_name_fixed) > 0) {
-            strcpy(target_bucket, cfg.bucket_name_fixed);
+        if (strlen(cfg->bucket_name_fixed) > 0) {
+            strcpy(target_bucket, cfg->bucket_name_fixed);
         } else {
             char ak_lower[128] = {0};
             if (strlen(curr_user->original_ak) > 0) {
                 str_tolower(ak_lower, curr_user->original_ak);
             }
 
-            if (strlen(cfg.bucket_name_prefix) > 0) {
-                if (strlen(ak_lower) > 0) snprintf(target_bucket, sizeof(target_bucket), "%s.%s", ak_lower, cfg.bucket_name_prefix);
-                else snprintf(target_bucket, sizeof(target_bucket), "%s", cfg.bucket_name_prefix);
+            if (strlen(cfg->bucket_name_prefix) > 0) {
+                if (strlen(ak_lower) > 0) snprintf(target_bucket, sizeof(target_bucket), "%s.%s", ak_lower, cfg->bucket_name_prefix);
+                else snprintf(target_bucket, sizeof(target_bucket), "%s", cfg->bucket_name_prefix);
             } else if (strlen(ak_lower) > 0) {
                 snprintf(target_bucket, sizeof(target_bucket), "%s", ak_lower);
             } else {
@@ -355,105 +743,308 @@ int main(int argc, char **argv) {
             }
         }
         
-        for (int t_idx = 0; t_idx < cfg.threads_per_user; t_idx++) {
-            if (global_thread_idx >= cfg.threads) break;
+        for (int t_idx = 0; t_idx < cfg->threads_per_user; t_idx++) {
+            if (global_thread_idx >= cfg->threads) break;
             WorkerArgs *args = &t_args[global_thread_idx];
-            args->thread_id = global_thread_idx;
-            args->config = &cfg;
+            args->thread_id = cfg->thread_id_base + global_thread_idx;
+            args->config = cfg;
             args->stop_timestamp_ms = stop_ms;
+            stats_init(&args->stats);
+            args->retry_budget = &retry_budget;
             strcpy(args->effective_ak, curr_user->ak);
             strcpy(args->effective_sk, curr_user->sk);
             strcpy(args->effective_bucket, target_bucket);
+            snprintf(args->bucket_base, sizeof(args->bucket_base), "%s", target_bucket);
+            args->bucket_index = -1;
+            args->user_thread_idx = t_idx;
+            if (bucket_stats) args->bucket_stats = &bucket_stats[(size_t)global_thread_idx * cfg->buckets_per_user];
+            if (endpoint_stats) {
+                args->endpoint_stats = &endpoint_stats[(size_t)global_thread_idx * cfg->endpoint_count];
+                args->endpoint_seed = (unsigned int)time(NULL) ^ (unsigned int)(args->thread_id * 2654435761u);
+            }
             strcpy(args->username, curr_user->username);
             
-            if (cfg.is_temporary_token) {
+            if (cfg->is_temporary_token) {
                 strcpy(args->effective_token, curr_user->security_token);
             } else {
                 memset(args->effective_token, 0, sizeof(args->effective_token));
             }
 
-            pthread_create(&tids[global_thread_idx], NULL, worker_routine, args);
+            if (rl_on) {
+                RateLimitContext *rl = &args->rate_limit;
+                rl->active = 1;
+                token_bucket_init(&rl->thread_req, cfg->thread_rate_limit_tps, cfg->rate_limit_burst_ms);
+                token_bucket_init(&rl->thread_bytes, cfg->thread_rate_limit_mbps * 1024 * 1024, cfg->rate_limit_burst_ms);
+                rl->user_req = user_buckets[u * 2].enabled ? &user_buckets[u * 2] : NULL;
+                rl->user_bytes = user_buckets[u * 2 + 1].enabled ? &user_buckets[u * 2 + 1] : NULL;
+                rl->global_req = global_req_bucket.enabled ? &global_req_bucket : NULL;
+                rl->global_bytes = global_bytes_bucket.enabled ? &global_bytes_bucket : NULL;
+            }
+            if (aimd_ctrls) args->aimd = &aimd_ctrls[u];
+            if (size_stats) args->size_classes = &size_stats[(size_t)global_thread_idx * size_class_slots];
+            if (trace) {
+                args->trace_queue = &trace->queues[global_thread_idx];
+                args->trace_stats = &trace->stats[global_thread_idx];
+            }
+            if (hotkeys) {
+                args->hot_keys = &hotkeys->keys[(size_t)(hotkeys->group_count > 1 ? u : 0) * hotkeys->key_count];
+                args->hot_stats = &hotkeys->stats[global_thread_idx];
+            }
+            if (churn) args->churn = &churn[global_thread_idx];
+            if (cp) args->cp = &cp[global_thread_idx];
+            if (pfs) {
+                args->pfs = pfs;
+                args->pfs_cells = &pfs->cells[(size_t)global_thread_idx * PFS_PHASE_SLOTS * pfs->levels];
+            }
+            if (conn_cost) {
+                args->conn_cost = conn_cost;
+                args->conn_cost_stats = &conn_cost->threads[global_thread_idx];
+            }
+            if (vis_channels) {
+                args->vis_channel = &vis_channels[u * (cfg->threads_per_user / vis_group) + t_idx / vis_group];
+                args->vis_stats = &vis_stats[global_thread_idx];
+                args->vis_reader = (t_idx % vis_group) != 0;
+            }
+
+            cpu_set_t worker_set;
+            int pinned = plan ? affinity_worker_cpuset(plan, global_thread_idx, &worker_set, &args->cpu, &args->numa_node) : 0;
+            if (!pinned) args->cpu = args->numa_node = -1;
+            affinity_thread_create(&tids[global_thread_idx], pinned ? &worker_set : NULL, worker_routine, args);
             global_thread_idx++;
         }
     }
     
     MonitorArgs m_args;
     m_args.t_args = t_args;
-    m_args.thread_count = cfg.threads;
+    m_args.thread_count = cfg->threads;
     m_args.interval_sec = 3; 
     m_args.stop_flag = 0;
-    strcpy(m_args.task_log_dir, cfg.task_log_dir); 
+    m_args.agent_fd = agent_fd;
+    m_args.aimd = aimd_ctrls;
+    m_args.aimd_count = aimd_ctrls ? cfg->loaded_user_count : 0;
+    m_args.trace = trace;
+    strcpy(m_args.task_log_dir, cfg->task_log_dir); 
     
     pthread_t monitor_tid;
-    pthread_create(&monitor_tid, NULL, monitor_routine, &m_args);
+    cpu_set_t service_set;
+    int service_pinned = plan ? affinity_service_cpuset(plan, &service_set) : 0;
+    affinity_thread_create(&monitor_tid, service_pinned ? &service_set : NULL, monitor_routine, &m_args);
 
-    for (int i = 0; i < cfg.threads; i++) pthread_join(tids[i], NULL);
+    pthread_t trace_tid;
+    if (trace) affinity_thread_create(&trace_tid, service_pinned ? &service_set : NULL, trace_reader_routine, trace);
+
+    for (int i = 0; i < cfg->threads; i++) pthread_join(tids[i], NULL);
+    if (trace) pthread_join(trace_tid, NULL);
 
     m_args.stop_flag = 1;
     pthread_join(monitor_tid, NULL);
 
     gettimeofday(&main_end_tv, NULL);
-    double actual_time_s = (main_end_tv.tv_sec - main_start_tv.tv_sec) + (main_end_tv.tv_usec - main_start_tv.tv_usec) / 1000000.0;
+    *out_elapsed_s = (main_end_tv.tv_sec - main_start_tv.tv_sec) + (main_end_tv.tv_usec - main_start_tv.tv_usec) / 1000000.0;
 
-    long long total_success = 0, t_403=0, t_404=0, t_409=0, t_4xx=0, t_5xx=0, t_other=0, t_val=0, total_bytes=0;
+    stats_init(out_total);
+    for (int i = 0; i < cfg->threads; i++) stats_merge(out_total, &t_args[i].stats);
 
-    for (int i = 0; i < cfg.threads; i++) {
-        total_success += t_args[i].stats.success_count;
-        total_bytes += t_args[i].stats.total_success_bytes;
-        t_403 += t_args[i].stats.fail_403_count;
-        t_404 += t_args[i].stats.fail_404_count;
-        t_409 += t_args[i].stats.fail_409_count;
-        t_4xx += t_args[i].stats.fail_4xx_other_count;
-        t_5xx += t_args[i].stats.fail_5xx_count;
-        t_other += t_args[i].stats.fail_other_count;
-        t_val += t_args[i].stats.fail_validation_count; 
+    if (size_stats) {
+        for (int i = 1; i < cfg->threads; i++) {
+            for (int k = 0; k < size_class_slots; k++) {
+                SizeClassStats *dst = &size_stats[k];
+                const SizeClassStats *src = &size_stats[(size_t)i * size_class_slots + k];
+                dst->success_count += src->success_count;
+                dst->fail_count += src->fail_count;
+                dst->bytes += src->bytes;
+                dst->total_latency_ms += src->total_latency_ms;
+                hist_merge(&dst->latency_hist, &src->latency_hist);
+            }
+        }
+        size_class_save_report(cfg, size_stats, *out_elapsed_s);
     }
-    
-    long long total_fail = t_403 + t_404 + t_409 + t_4xx + t_5xx + t_other + t_val;
-    long long total_reqs = total_success + total_fail;
-    double tps = (actual_time_s > 0) ? (total_reqs / actual_time_s) : 0.0;
-    double throughput_mb = (total_bytes) / 1024.0 / 1024.0 / actual_time_s;
 
-    if (g_graceful_stop) {
-        printf("\n[WARN] Benchmark interrupted by user (Graceful Stop).\n");
+    if (vis_channels) visibility_save_report(cfg, vis_stats, cfg->threads);
+    if (hotkeys) hotkey_save_report(cfg, hotkeys, *out_elapsed_s);
+    if (churn) churn_save_report(cfg, churn, cfg->threads, *out_elapsed_s);
+    if (cp) control_plane_save_report(cfg, cp, cfg->threads, *out_elapsed_s);
+    if (pfs) pfs_tree_save_report(cfg, pfs, cfg->threads);
+    if (conn_cost) conn_cost_save_report(cfg, conn_cost, cfg->threads);
+    if (bucket_stats) bucket_save_report(cfg, t_args, *out_elapsed_s);
+    if (endpoint_stats) endpoint_save_report(cfg, endpoint_stats, cfg->threads, *out_elapsed_s);
+    if (trace) trace_save_report(trace, *out_elapsed_s);
+    if (plan && plan->mode != AFFINITY_MODE_NONE) affinity_save_report(cfg, plan, t_args, cfg->threads, *out_elapsed_s);
+
+    if (aimd_ctrls) {
+        // 补一个结束时刻的采样, 保证短时压测也能计算收敛值
+        aimd_sample(aimd_ctrls, cfg->loaded_user_count, *out_elapsed_s);
+        aimd_save_report(cfg, aimd_ctrls, cfg->loaded_user_count);
     }
+    ret = 0;
 
-    printf("\n--- Test Result ---\n");
-    printf("Actual Duration: %.2f s\n", actual_time_s);
-    printf("Total Requests:  %lld\n", total_reqs);
-    printf("Success:         %lld\n", total_success);
-    printf("Failed:          %lld\n", total_fail);
-    printf("  |- 403 (Forbidden):  %lld\n", t_403);
-    printf("  |- 404 (NotFound):   %lld\n", t_404);
-    printf("  |- 409 (Conflict):   %lld\n", t_409);
-    printf("  |- 4xx (Other):      %lld\n", t_4xx);
-    printf("  |- 5xx (Server):     %lld\n", t_5xx);
-    printf("  |- Other (Net/SDK):  %lld\n", t_other);
-    printf("  |- Internal Validation Fail: %lld\n", t_val);
+out:
+    if (hotkeys) {
+        hotkey_set_release(hotkeys);
+        free(hotkeys);
+    }
+    if (vis_channels) {
+        for (int i = 0; i < vis_channel_count; i++) visibility_channel_destroy(&vis_channels[i]);
+        free(vis_channels);
+    }
+    free(vis_stats);
+    churn_free(churn, cfg->threads);
+    free(cp);
+    pfs_tree_free(pfs);
+    conn_cost_free(conn_cost);
+    free(bucket_stats);
+    free(endpoint_stats);
+    if (trace) {
+        trace_replay_release(trace);
+        free(trace);
+    }
+    free(plan);
+    if (aimd_ctrls) {
+        for (int u = 0; u < cfg->loaded_user_count; u++) aimd_release(&aimd_ctrls[u]);
+        free(aimd_ctrls);
+    }
+    free(size_stats);
+    free(tids); 
+    free(t_args);
+    free(user_buckets);
+    return ret;
+}
+
+static void release_config(Config *cfg) {
+    size_dist_free(cfg->size_table);
+    cfg->size_table = NULL;
+    free(cfg->think_empirical_values);
+    free(cfg->think_empirical_cdf);
+    cfg->think_empirical_values = cfg->think_empirical_cdf = NULL;
+    if (cfg->user_list) {
+        free(cfg->user_list);
+        cfg->user_list = NULL;
+    }
+    for (int i = 0; i < cfg->range_count; i++) {
+        if (cfg->range_options[i]) {
+            free(cfg->range_options[i]);
+            cfg->range_options[i] = NULL;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, handle_sigint);
+
+    struct stat st = {0};
+    if (stat("logs", &st) == -1) mkdir("logs", 0755);
+    if (stat("upload_checkpoint", &st) == -1) mkdir("upload_checkpoint", 0755);
     
-    printf("TPS:             %.2f\n", tps);
-    printf("Throughput:      %.2f MB/s\n", throughput_mb);
+    initialize_break_point_lock();
+    
+    time_t now = time(NULL);
+    struct tm t_res;
+    struct tm *t = localtime_r(&now, &t_res);
+    Config cfg;
+    memset(&cfg, 0, sizeof(Config));
+    
+    if (t) {
+        snprintf(cfg.task_log_dir, sizeof(cfg.task_log_dir), "logs/task_%04d%02d%02d_%02d%02d%02d",
+                 t->tm_year + 1900, t->tm_mon + 1, t->tm_mday, t->tm_hour, t->tm_min, t->tm_sec);
+    } else {
+        snprintf(cfg.task_log_dir, sizeof(cfg.task_log_dir), "logs/task_UNKNOWN");
+    }
+             
+    if (stat(cfg.task_log_dir, &st) == -1) mkdir(cfg.task_log_dir, 0755);
 
-    save_benchmark_report(&cfg, total_reqs, total_success, total_fail, 
-                          t_403, t_404, t_409, t_4xx, t_5xx, t_other, t_val,
-                          tps, throughput_mb);
+    // Agent 模式: 配置与用户列表均由 Coordinator 下发
+    if (argc > 2 && strcmp(argv[1], "--agent") == 0) {
+        int ret = run_agent(&cfg, argv[2]);
+        release_config(&cfg);
+        deinitialize_break_point_lock();
+        return ret;
+    }
 
-    free(tids); 
-    free(t_args);
+    // 工具模式: CSV trace 转换为可 mmap 回放的二进制格式
+    if (argc > 3 && strcmp(argv[1], "--trace-convert") == 0) {
+        double unit_us = 1e6;
+        if (argc > 4 && strcmp(argv[4], "ms") == 0) unit_us = 1e3;
+        else if (argc > 4 && strcmp(argv[4], "us") == 0) unit_us = 1.0;
+        return trace_convert(argv[2], argv[3], unit_us) == 0 ? 0 : 1;
+    }
+
+    // 工具模式: 热路径微基准, 结果写入 JSON 并与基线比较 (make bench)
+    if (argc > 2 && strcmp(argv[1], "--microbench") == 0) {
+        const char *baseline = argc > 3 ? argv[3] : NULL;
+        double threshold_pct = argc > 4 ? atof(argv[4]) : 10.0;
+        int duration_ms = argc > 5 ? atoi(argv[5]) : 300;
+        return microbench_run(argv[2], baseline, threshold_pct, duration_ms) == 0 ? 0 : 1;
+    }
 
-    if (cfg.user_list) {
-        free(cfg.user_list);
-        cfg.user_list = NULL;
+    const char *config_file = "config.dat";
+    int cli_test_case = 0;
+    if (argc > 1) {
+        if (isdigit(argv[1][0])) cli_test_case = atoi(argv[1]);
+        else config_file = argv[1];
     }
-    for (int i = 0; i < cfg.range_count; i++) {
-        if (cfg.range_options[i]) {
-            free(cfg.range_options[i]);
-            cfg.range_options[i] = NULL;
+
+    if (load_config(config_file, &cfg) != 0) return 1;
+
+    if (cli_test_case > 0) {
+        cfg.test_case = cli_test_case;
+        if (cli_test_case == TEST_CASE_MIX && cfg.mix_op_count > 0) cfg.use_mix_mode = 1;
+        else cfg.use_mix_mode = 0;
+    }
+
+    log_init(cfg.log_level);
+    LOG_INFO("--- OBS C SDK Benchmark Tool ---");
+    mock_model_apply(&cfg);
+    LOG_INFO("Task Output Dir: %s", cfg.task_log_dir);
+
+    if (validate_test_case(&cfg) != 0) return 1;
+
+    if (cfg.sse_mode != SSE_MODE_NONE) {
+        LOG_INFO("Server-side encryption: %s%s", sse_mode_to_string(cfg.sse_mode),
+                 cfg.sse_c_key_generated ? " (key generated for this run, objects are unreadable afterwards without it)" : "");
+        if (cfg.sse_mode == SSE_MODE_C && strcasecmp(cfg.protocol, "https") != 0) {
+            LOG_WARN("SSE-C over plain HTTP is rejected by most servers; set Protocol=https.");
         }
     }
 
+    // ==========================================================
+    // [分布式]: Coordinator 只负责下发配置、同步起跑与合并结果, 本身不发流
+    // ==========================================================
+    if (cfg.distributed_agents > 0) {
+        int ret = run_coordinator(&cfg, config_file);
+        release_config(&cfg);
+        deinitialize_break_point_lock();
+        return ret;
+    }
+
+    // ==========================================================
+    // [前置阶段]: 拦截生成凭证
+    // ==========================================================
+    if (prepare_user_credentials(&cfg, "users.dat") != 0) return 1;
+    if (dns_pin_endpoints(&cfg) != 0) return 1;
+        
+    printf("[Config] Multi-User Mode: %d Users Loaded. %d Threads/User. Total Threads: %d\n", 
+           cfg.loaded_user_count, cfg.threads_per_user, cfg.threads);
+
+    if (cfg.enable_data_validation) printf("[Config] Data Validation: ENABLED\n");
+    if (cfg.enable_detail_log) printf("[Config] Detail Request Log: ENABLED\n");
+
+    obs_status status = obs_initialize(OBS_INIT_ALL);
+    if (status != OBS_STATUS_OK) return -1;
+
+    ThreadStats total_stats;
+    double actual_time_s = 0;
+    if (run_local_benchmark(&cfg, -1, 0, &total_stats, &actual_time_s) != 0) {
+        obs_deinitialize();
+        return 1;
+    }
+
+    print_benchmark_result(&total_stats, actual_time_s);
+    save_benchmark_report(&cfg, &total_stats, actual_time_s);
+
+    release_config(&cfg);
+
     obs_deinitialize();
     deinitialize_break_point_lock();
     return 0;
 }
-
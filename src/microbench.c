@@ -0,0 +1,431 @@
+#include "bench.h"
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// ----------------------------------------------------------------------------
+// 工具自身开销微基准 (--microbench, 由 make bench 调用)
+// 对热路径组件 (各命名方案的 Key 生成 / adapter_setup_options / 数据回调 / 统计 / 明细日志) 与 Mock SDK 下的端到端请求
+// 循环分别定时运行, 输出 ns/op、instructions/op (perf_event_open 可用时) 与 allocations/op (make bench 构建时)
+// 到 JSON 文件; 给定基线文件时逐项比较, 任一项退化超过阈值则返回失败。
+// 每项运行 MICROBENCH_REPEATS 轮取最好的一轮, 降低调度与频率波动的影响。
+// ----------------------------------------------------------------------------
+
+#define MICROBENCH_REPEATS      3
+#define MICROBENCH_BATCH_NS     (10 * 1000000LL)    // 每批迭代的目标耗时, 计时开销相对可忽略
+#define MICROBENCH_GET_KEY      "microbench-get-object"
+
+#ifdef MICROBENCH_ALLOC_HOOK
+// make bench 专用构建: 接管 malloc 系列并按线程计数, libc 内部 (fopen / strdup 等) 的分配同样计入
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static __thread long long t_alloc_count = 0;
+
+void *malloc(size_t size) {
+    t_alloc_count++;
+    return __libc_malloc(size);
+}
+void *calloc(size_t n, size_t size) {
+    t_alloc_count++;
+    return __libc_calloc(n, size);
+}
+void *realloc(void *ptr, size_t size) {
+    t_alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+#define ALLOC_COUNTED   1
+#define ALLOC_COUNT()   t_alloc_count
+#else
+#define ALLOC_COUNTED   0
+#define ALLOC_COUNT()   0LL
+#endif
+
+typedef struct {
+    Config cfg;
+    WorkerArgs args;
+    DetailLogState dl;
+    RetryState retry;
+    unsigned int seed;
+    long long seq;
+    char key[MAX_KEY_LEN];
+    char req_id[64];
+    KeyGen key_gens[KEY_SCHEME_TEMPLATE];   // 各内置命名方案, 以 KEY_SCHEME_* 为下标
+    volatile double sink;           // 防止结果被优化掉
+} MicroEnv;
+
+typedef struct {
+    const char *name;
+    void (*run)(MicroEnv *env, long long iters);
+} MicroCase;
+
+typedef struct {
+    long long ops;
+    double ns_per_op;
+    double instr_per_op;            // < 0 表示不可用
+    double allocs_per_op;           // < 0 表示不可用
+} MicroResult;
+
+static long long micro_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ----------------------------------------------------------------------------
+// 测试项
+// ----------------------------------------------------------------------------
+static void run_key_case(MicroEnv *env, long long iters, int scheme) {
+    KeyGen *kg = &env->key_gens[scheme];
+    for (long long i = 0; i < iters; i++) {
+        key_gen_format(kg, 1, env->seq++, env->key, sizeof(env->key));
+        env->sink += env->key[0];
+    }
+}
+
+static void case_key_hash(MicroEnv *env, long long iters) { run_key_case(env, iters, KEY_SCHEME_HASHED); }
+static void case_key_plain(MicroEnv *env, long long iters) { run_key_case(env, iters, KEY_SCHEME_FLAT); }
+static void case_key_tree(MicroEnv *env, long long iters) { run_key_case(env, iters, KEY_SCHEME_TREE); }
+static void case_key_fixed(MicroEnv *env, long long iters) { run_key_case(env, iters, KEY_SCHEME_FIXED); }
+
+static void case_setup_options(MicroEnv *env, long long iters) {
+    obs_options option;
+    for (long long i = 0; i < iters; i++) {
+        adapter_setup_options(&option, &env->args);
+        env->sink += option.request_options.connect_time;
+    }
+}
+
+static void case_stats_record(MicroEnv *env, long long iters) {
+    for (long long i = 0; i < iters; i++) {
+        stats_record_latency(&env->args.stats, (double)(env->seq++ & 1023) * 0.37);
+    }
+}
+
+static void case_detail_log(MicroEnv *env, long long iters) {
+    for (long long i = 0; i < iters; i++) {
+        detail_log_record(&env->args, &env->dl, 1700000000.123, TEST_CASE_PUT, env->key, 1.23, OBS_STATUS_OK, 200, 4096,
+                          "MockReqId-PutObject-9999");
+    }
+    // 写入 /dev/null, 不触发按行数切换文件
+    env->dl.total_written_rows = 0;
+}
+
+#ifdef MOCK_SDK_MODE
+static void case_put(MicroEnv *env, long long iters, long long size) {
+    for (long long i = 0; i < iters; i++) {
+        worker_format_key(&env->args, 1, env->seq++, env->key, sizeof(env->key));
+        run_put_benchmark(&env->args, env->key, size, env->req_id);
+    }
+}
+
+static void case_put_4k(MicroEnv *env, long long iters) { case_put(env, iters, 4096); }
+static void case_put_1m(MicroEnv *env, long long iters) { case_put(env, iters, 1024 * 1024); }
+
+// 有状态 Mock 存储返回写入的 pattern 数据, 使 GET 回调走完整的内容校验
+static void case_get_1m_validate(MicroEnv *env, long long iters) {
+    mock_sdk_set_store(1);
+    env->cfg.enable_data_validation = 1;
+    for (long long i = 0; i < iters; i++) {
+        run_get_benchmark(&env->args, MICROBENCH_GET_KEY, NULL, env->req_id);
+    }
+    env->cfg.enable_data_validation = 0;
+    mock_sdk_set_store(0);
+}
+
+// 端到端: Key 生成 + 请求 + 重试判定 + 统计 + 明细日志, 与 Worker 循环中的单次操作一致
+static void case_e2e_put_4k(MicroEnv *env, long long iters) {
+    for (long long i = 0; i < iters; i++) {
+        worker_run_op(&env->args, &env->dl, 1, env->seq++, &env->seed, &env->retry);
+    }
+    env->dl.total_written_rows = 0;
+}
+#endif
+
+static const MicroCase g_cases[] = {
+    { "key_format_hash",    case_key_hash },
+    { "key_format_plain",   case_key_plain },
+    { "key_format_tree",    case_key_tree },
+    { "key_format_fixed",   case_key_fixed },
+    { "setup_options",      case_setup_options },
+    { "stats_record",       case_stats_record },
+    { "detail_log_record",  case_detail_log },
+#ifdef MOCK_SDK_MODE
+    { "mock_put_4k",        case_put_4k },
+    { "mock_put_1m",        case_put_1m },
+    { "mock_get_1m_validate", case_get_1m_validate },
+    { "e2e_put_4k",         case_e2e_put_4k },
+#endif
+};
+
+// ----------------------------------------------------------------------------
+// 运行环境: 与 Worker 相同的 Config 缺省值 / pattern buffer / 明细日志缓冲
+// ----------------------------------------------------------------------------
+static int micro_env_init(MicroEnv *env) {
+    memset(env, 0, sizeof(*env));
+    char path[] = "/tmp/obs_microbench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        printf("Error: Cannot create temporary config file for microbench.\n");
+        return -1;
+    }
+    static const char conf[] =
+        "Users=1\nEndpoint=127.0.0.1\nProtocol=http\nTestCase=201\nObjectSize=4096\nKeyPrefix=obj\n"
+        "ObjNamePatternHash=true\nRequestsPerThread=0\nEnableDataValidation=false\nEnableDetailLog=false\n";
+    int ok = write(fd, conf, sizeof(conf) - 1) == (ssize_t)(sizeof(conf) - 1);
+    close(fd);
+    if (!ok || load_config(path, &env->cfg) != 0) {
+        unlink(path);
+        return -1;
+    }
+    unlink(path);
+
+    WorkerArgs *args = &env->args;
+    args->thread_id = 0;
+    args->config = &env->cfg;
+    args->stop_timestamp_ms = 1e18;
+    args->bucket_index = -1;
+    snprintf(args->username, sizeof(args->username), "microbench");
+    snprintf(args->effective_bucket, sizeof(args->effective_bucket), "microbench-bucket");
+    snprintf(args->effective_ak, sizeof(args->effective_ak), "microbench-ak");
+    snprintf(args->effective_sk, sizeof(args->effective_sk), "microbench-sk");
+    stats_init(&args->stats);
+    if (worker_setup(args, &env->dl) != 0) return -1;
+
+    env->dl.detail_fp = fopen("/dev/null", "w");
+    env->dl.batch_buffer = (ReqRecord *)malloc(sizeof(ReqRecord) * BATCH_SIZE);
+    if (!env->dl.detail_fp || !env->dl.batch_buffer) {
+        printf("Error: Cannot set up the detail log buffer for microbench.\n");
+        return -1;
+    }
+    env->retry.seed = 1;
+    env->seed = 1;
+    for (int scheme = 0; scheme < KEY_SCHEME_TEMPLATE; scheme++) {
+        Config kcfg = env->cfg;
+        char err[256];
+        kcfg.key_scheme = scheme;
+        if (key_gen_compile(&env->key_gens[scheme], &kcfg, args->username, err, sizeof(err)) != 0) {
+            printf("Error: Cannot compile key scheme %s: %s\n", key_scheme_to_string(scheme), err);
+            return -1;
+        }
+    }
+    worker_format_key(args, 1, 0, env->key, sizeof(env->key));
+
+#ifdef MOCK_SDK_MODE
+    mock_sdk_set_store(1);
+    obs_status st = run_put_benchmark(args, MICROBENCH_GET_KEY, 1024 * 1024, env->req_id);
+    mock_sdk_set_store(0);
+    if (st != OBS_STATUS_OK) {
+        printf("Error: Cannot prepare the GET object in the mock store (%s).\n", obs_get_status_name(st));
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+static int perf_open_instructions(void) {
+    struct perf_event_attr pe;
+    memset(&pe, 0, sizeof(pe));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(pe);
+    pe.config = PERF_COUNT_HW_INSTRUCTIONS;
+    pe.disabled = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+}
+
+static void micro_measure(MicroEnv *env, const MicroCase *mc, int perf_fd, int duration_ms, MicroResult *out) {
+    // 预热, 同时确定每批的迭代数
+    long long batch = 1;
+    for (;;) {
+        long long t0 = micro_now_ns();
+        mc->run(env, batch);
+        if (micro_now_ns() - t0 >= MICROBENCH_BATCH_NS || batch >= (1LL << 30)) break;
+        batch *= 2;
+    }
+
+    long long round_ns = (long long)duration_ms * 1000000LL / MICROBENCH_REPEATS;
+    out->ns_per_op = -1;
+    out->instr_per_op = -1;
+    out->allocs_per_op = -1;
+    out->ops = 0;
+    for (int r = 0; r < MICROBENCH_REPEATS; r++) {
+        long long ops = 0, instr = 0;
+        long long allocs0 = ALLOC_COUNT();
+        if (perf_fd >= 0) {
+            ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        long long t0 = micro_now_ns(), elapsed;
+        do {
+            mc->run(env, batch);
+            ops += batch;
+            elapsed = micro_now_ns() - t0;
+        } while (elapsed < round_ns && !g_graceful_stop);
+        if (perf_fd >= 0) {
+            ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(perf_fd, &instr, sizeof(instr)) != sizeof(instr)) instr = -1;
+        }
+        long long allocs = ALLOC_COUNT() - allocs0;
+
+        out->ops += ops;
+        double ns = (double)elapsed / ops;
+        if (out->ns_per_op < 0 || ns < out->ns_per_op) out->ns_per_op = ns;
+        if (perf_fd >= 0 && instr >= 0) {
+            double ipo = (double)instr / ops;
+            if (out->instr_per_op < 0 || ipo < out->instr_per_op) out->instr_per_op = ipo;
+        }
+        if (ALLOC_COUNTED) out->allocs_per_op = (double)allocs / ops;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 结果输出与基线比较
+// ----------------------------------------------------------------------------
+static char *read_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = (len >= 0) ? (char *)malloc(len + 1) : NULL;
+    if (buf) {
+        size_t n = fread(buf, 1, len, fp);
+        buf[n] = '\0';
+    }
+    fclose(fp);
+    return buf;
+}
+
+// 在 microbench 自己输出的 JSON 中查找某一项的字段, null 或缺失时返回 0
+static int baseline_value(const char *json, const char *name, const char *field, double *out) {
+    char pat[128];
+    snprintf(pat, sizeof(pat), "\"name\": \"%s\"", name);
+    const char *entry = strstr(json, pat);
+    if (!entry) return 0;
+    const char *entry_end = strchr(entry, '}');
+    snprintf(pat, sizeof(pat), "\"%s\":", field);
+    const char *f = strstr(entry, pat);
+    if (!f || (entry_end && f > entry_end)) return 0;
+    f += strlen(pat);
+    while (*f == ' ') f++;
+    if (strncmp(f, "null", 4) == 0) return 0;
+    char *end;
+    *out = strtod(f, &end);
+    return end != f;
+}
+
+static void json_number(FILE *fp, double v, int precision) {
+    if (v < 0) fprintf(fp, "null");
+    else fprintf(fp, "%.*f", precision, v);
+}
+
+static int write_results(const char *path, const MicroResult *res, int count, int duration_ms, int perf_ok) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        printf("Error: Cannot write microbench results to %s\n", path);
+        return -1;
+    }
+#ifdef MOCK_SDK_MODE
+    const char *build = "mock";
+#else
+    const char *build = "real";
+#endif
+    fprintf(fp, "{\n  \"build\": \"%s\",\n  \"duration_ms\": %d,\n  \"repeats\": %d,\n", build, duration_ms,
+            MICROBENCH_REPEATS);
+    fprintf(fp, "  \"perf_instructions\": %s,\n  \"alloc_counting\": %s,\n  \"cases\": [\n", perf_ok ? "true" : "false",
+            ALLOC_COUNTED ? "true" : "false");
+    for (int i = 0; i < count; i++) {
+        fprintf(fp, "    { \"name\": \"%s\", \"ops\": %lld, \"ns_per_op\": ", g_cases[i].name, res[i].ops);
+        json_number(fp, res[i].ns_per_op, 3);
+        fprintf(fp, ", \"instructions_per_op\": ");
+        json_number(fp, res[i].instr_per_op, 1);
+        fprintf(fp, ", \"allocs_per_op\": ");
+        json_number(fp, res[i].allocs_per_op, 4);
+        fprintf(fp, " }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    return 0;
+}
+
+// 有指令数时以 instructions/op 判定 (不受频率与调度影响), 否则以 ns/op 判定; allocations/op 为确定值, 增加即判定退化
+static int compare_case(const char *baseline, const char *name, const MicroResult *r, double threshold_pct,
+                        char *verdict, size_t len) {
+    double base_ns = 0, base_instr = 0, base_allocs = 0;
+    if (!baseline_value(baseline, name, "ns_per_op", &base_ns)) {
+        snprintf(verdict, len, "(new)");
+        return 0;
+    }
+    int regressed = 0;
+    const char *metric = "ns/op";
+    double cur = r->ns_per_op, base = base_ns;
+    if (r->instr_per_op >= 0 && baseline_value(baseline, name, "instructions_per_op", &base_instr)) {
+        metric = "instr/op";
+        cur = r->instr_per_op;
+        base = base_instr;
+    }
+    double delta = base > 0 ? (cur - base) / base * 100.0 : 0;
+    if (delta > threshold_pct) regressed = 1;
+    size_t off = (size_t)snprintf(verdict, len, "%+.1f%% %s", delta, metric);
+
+    if (r->allocs_per_op >= 0 && baseline_value(baseline, name, "allocs_per_op", &base_allocs) &&
+        r->allocs_per_op > base_allocs + 0.01) {
+        regressed = 1;
+        if (off < len) {
+            off += (size_t)snprintf(verdict + off, len - off, ", allocs %.2f -> %.2f", base_allocs, r->allocs_per_op);
+        }
+    }
+    if (regressed && off < len) snprintf(verdict + off, len - off, "  REGRESSION");
+    return regressed;
+}
+
+// 返回 0 通过, 1 存在退化, -1 运行失败; baseline_file 为 NULL 或 "-" 时只输出结果
+int microbench_run(const char *out_file, const char *baseline_file, double threshold_pct, int duration_ms) {
+    if (duration_ms < MICROBENCH_REPEATS) duration_ms = MICROBENCH_REPEATS;
+    MicroEnv *env = (MicroEnv *)calloc(1, sizeof(MicroEnv));
+    if (!env || micro_env_init(env) != 0) {
+        free(env);
+        return -1;
+    }
+
+    int perf_fd = perf_open_instructions();
+    char *baseline = NULL;
+    if (baseline_file && strcmp(baseline_file, "-") != 0) {
+        baseline = read_file(baseline_file);
+        if (!baseline) printf("[Microbench] Baseline %s not found, results are recorded without comparison.\n", baseline_file);
+    }
+
+    int count = (int)(sizeof(g_cases) / sizeof(g_cases[0]));
+    MicroResult res[sizeof(g_cases) / sizeof(g_cases[0])];
+    printf("[Microbench] %d ms per case, best of %d rounds, instructions: %s, allocations: %s\n", duration_ms,
+           MICROBENCH_REPEATS, perf_fd >= 0 ? "perf_event_open" : "unavailable",
+           ALLOC_COUNTED ? "counted" : "not counted (use make bench)");
+    printf("%-22s %12s %12s %10s   %s\n", "Case", "ns/op", "instr/op", "allocs/op", baseline ? "vs baseline" : "");
+
+    int regressions = 0;
+    for (int i = 0; i < count && !g_graceful_stop; i++) {
+        micro_measure(env, &g_cases[i], perf_fd, duration_ms, &res[i]);
+        char instr[32] = "-", allocs[32] = "-", verdict[160] = "";
+        if (res[i].instr_per_op >= 0) snprintf(instr, sizeof(instr), "%.1f", res[i].instr_per_op);
+        if (res[i].allocs_per_op >= 0) snprintf(allocs, sizeof(allocs), "%.2f", res[i].allocs_per_op);
+        if (baseline) regressions += compare_case(baseline, g_cases[i].name, &res[i], threshold_pct, verdict, sizeof(verdict));
+        printf("%-22s %12.1f %12s %10s   %s\n", g_cases[i].name, res[i].ns_per_op, instr, allocs, verdict);
+    }
+    if (perf_fd >= 0) close(perf_fd);
+
+    int ret = g_graceful_stop ? -1 : write_results(out_file, res, count, duration_ms, perf_fd >= 0);
+    if (ret == 0) printf("[Microbench] Results written to %s\n", out_file);
+    if (ret == 0 && regressions > 0) {
+        printf("[Microbench] %d case(s) regressed by more than %.1f%% against %s\n", regressions, threshold_pct, baseline_file);
+        ret = 1;
+    }
+
+    worker_teardown(&env->args, &env->dl);
+    free(baseline);
+    free(env);
+    return ret;
+}
@@ -0,0 +1,254 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// Mock SDK 时延 / 带宽 / 故障模型与有状态存储
+// config.dat 中的 Mock* 配置在 Mock 版本启动时交给 mock_sdk_set_model / mock_sdk_set_store, 使 Mock
+// 也能覆盖超时、错误分类、重试、尾延迟统计与数据校验等路径; 真实 SDK 版本忽略这些配置。
+// ----------------------------------------------------------------------------
+
+// 顺序与 mock_eSDKOBS.h 中的 MOCK_SDK_OP_* 一致
+static const char *g_mock_op_names[MOCK_OP_SLOTS] = {
+    "put", "get", "head", "delete", "list", "copy", "multipart", "resumable", "bucket"
+};
+
+#ifdef MOCK_SDK_MODE
+typedef char mock_op_slots_match[(MOCK_OP_SLOTS == MOCK_SDK_OP_SLOTS) ? 1 : -1];
+#endif
+
+// "10" 作用于全部操作; "put:20,get:8,*:5" 逐项指定, '*' 为其余操作的缺省值
+static int parse_latency(Config *cfg, const char *val) {
+    char temp[512];
+    snprintf(temp, sizeof(temp), "%s", val);
+    char *end;
+    double all = strtod(temp, &end);
+    if (end != temp && *end == '\0') {
+        if (all < 0) return -1;
+        for (int k = 0; k < MOCK_OP_SLOTS; k++) cfg->mock_latency_ms[k] = all;
+        return 0;
+    }
+
+    double ms[MOCK_OP_SLOTS];
+    int set[MOCK_OP_SLOTS] = {0};
+    double fallback = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *colon = strchr(token, ':');
+        if (!colon) return -1;
+        *colon = '\0';
+        char *name_end = colon;
+        while (name_end > token && (name_end[-1] == ' ' || name_end[-1] == '\t')) *--name_end = '\0';
+        double v = strtod(colon + 1, &end);
+        while (*end == ' ' || *end == '\t') end++;
+        if (end == colon + 1 || *end != '\0' || v < 0) return -1;
+
+        if (strcmp(token, "*") == 0) {
+            fallback = v;
+            continue;
+        }
+        int found = 0;
+        for (int k = 0; k < MOCK_OP_SLOTS; k++) {
+            if (strcasecmp(token, g_mock_op_names[k]) == 0) {
+                ms[k] = v;
+                set[k] = 1;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) return -1;
+    }
+    for (int k = 0; k < MOCK_OP_SLOTS; k++) cfg->mock_latency_ms[k] = set[k] ? ms[k] : fallback;
+    return 0;
+}
+
+static double *rate_field(Config *cfg, const char *key) {
+    if (strcmp(key, "MockConnFailRate") == 0) return &cfg->mock_conn_fail_rate;
+    if (strcmp(key, "MockSlowDownRate") == 0) return &cfg->mock_slow_down_rate;
+    if (strcmp(key, "MockFail403Rate") == 0) return &cfg->mock_fail_403_rate;
+    if (strcmp(key, "MockFail404Rate") == 0) return &cfg->mock_fail_404_rate;
+    if (strcmp(key, "MockFail409Rate") == 0) return &cfg->mock_fail_409_rate;
+    if (strcmp(key, "MockTruncateRate") == 0) return &cfg->mock_truncate_rate;
+    if (strcmp(key, "MockCorruptRate") == 0) return &cfg->mock_corrupt_rate;
+    return NULL;
+}
+
+// 返回 1 已处理, 0 不是 Mock 模型的配置项, -1 取值非法 (已打印错误)
+int mock_model_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "MockStore") == 0) {
+        cfg->mock_store = (strcasecmp(val, "true") == 0 || strcmp(val, "1") == 0);
+        return 1;
+    }
+    if (strlen(val) == 0) return rate_field(cfg, key) || strncmp(key, "MockLatency", 11) == 0 ||
+                                  strcmp(key, "MockBandwidthMBps") == 0 || strcmp(key, "MockConnectMs") == 0;
+
+    if (strcmp(key, "MockLatencyDistribution") == 0) {
+        cfg->mock_latency_dist = think_dist_from_string(val);
+        if (cfg->mock_latency_dist < 0 || cfg->mock_latency_dist == THINK_DIST_EMPIRICAL) {
+            printf("[Config Error] Unknown 'MockLatencyDistribution': %s (constant/exponential/lognormal/none)\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "MockLatencyMs") == 0) {
+        if (parse_latency(cfg, val) != 0) {
+            printf("[Config Error] 'MockLatencyMs' expects a number or a list like put:20,get:8,*:5 (ops: put,get,head,"
+                   "delete,list,copy,multipart,resumable,bucket). Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "MockLatencyCv") == 0) {
+        cfg->mock_latency_cv = atof(val);
+        if (cfg->mock_latency_cv <= 0) {
+            printf("[Config Error] 'MockLatencyCv' must be > 0. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "MockBandwidthMBps") == 0) {
+        cfg->mock_bandwidth_mbps = atof(val);
+        if (cfg->mock_bandwidth_mbps < 0) {
+            printf("[Config Error] 'MockBandwidthMBps' must be >= 0. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "MockConnectMs") == 0) {
+        cfg->mock_connect_ms = atof(val);
+        if (cfg->mock_connect_ms < 0) {
+            printf("[Config Error] 'MockConnectMs' must be >= 0. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    double *rate = rate_field(cfg, key);
+    if (!rate) return 0;
+    *rate = atof(val);
+    if (*rate < 0 || *rate > 1) {
+        printf("[Config Error] '%s' is a probability in [0, 1]. Invalid value: %s\n", key, val);
+        return -1;
+    }
+    return 1;
+}
+
+int mock_model_validate(const Config *cfg) {
+    double faults = cfg->mock_conn_fail_rate + cfg->mock_slow_down_rate + cfg->mock_fail_403_rate +
+                    cfg->mock_fail_404_rate + cfg->mock_fail_409_rate;
+    if (faults > 1.0 + 1e-9) {
+        printf("[Config Error] MockConnFailRate + MockSlowDownRate + MockFail403/404/409Rate must be <= 1 (got %.4f).\n", faults);
+        return -1;
+    }
+    if (cfg->mock_latency_dist != THINK_DIST_NONE) {
+        double max_ms = 0;
+        for (int k = 0; k < MOCK_OP_SLOTS; k++) {
+            if (cfg->mock_latency_ms[k] > max_ms) max_ms = cfg->mock_latency_ms[k];
+        }
+        if (max_ms <= 0) {
+            printf("[Config Error] 'MockLatencyMs' must be > 0 when MockLatencyDistribution is set.\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int mock_model_enabled(const Config *cfg) {
+    return cfg->mock_latency_dist != THINK_DIST_NONE || cfg->mock_bandwidth_mbps > 0 || cfg->mock_connect_ms > 0 ||
+           cfg->mock_conn_fail_rate > 0 ||
+           cfg->mock_slow_down_rate > 0 || cfg->mock_fail_403_rate > 0 || cfg->mock_fail_404_rate > 0 ||
+           cfg->mock_fail_409_rate > 0 || cfg->mock_truncate_rate > 0 || cfg->mock_corrupt_rate > 0;
+}
+
+static void format_latency(const Config *cfg, char *out, size_t len) {
+    if (cfg->mock_latency_dist == THINK_DIST_NONE) {
+        snprintf(out, len, "none");
+        return;
+    }
+    size_t off = (size_t)snprintf(out, len, "%s", think_dist_to_string(cfg->mock_latency_dist));
+    if (cfg->mock_latency_dist == THINK_DIST_LOGNORMAL && off < len) {
+        off += (size_t)snprintf(out + off, len - off, " cv=%.2f", cfg->mock_latency_cv);
+    }
+    for (int k = 0; k < MOCK_OP_SLOTS && off < len; k++) {
+        off += (size_t)snprintf(out + off, len - off, "%s%s:%.1f", k == 0 ? " (ms " : ",", g_mock_op_names[k],
+                                cfg->mock_latency_ms[k]);
+    }
+    if (off < len) snprintf(out + off, len - off, ")");
+}
+
+#ifdef MOCK_SDK_MODE
+// 只列出非零的故障概率, 全部为零时输出 "none"
+static void format_faults(const Config *cfg, char *out, size_t len) {
+    const struct {
+        const char *name;
+        double rate;
+    } faults[] = {
+        { "conn", cfg->mock_conn_fail_rate }, { "503", cfg->mock_slow_down_rate }, { "403", cfg->mock_fail_403_rate },
+        { "404", cfg->mock_fail_404_rate }, { "409", cfg->mock_fail_409_rate }, { "truncate", cfg->mock_truncate_rate },
+        { "corrupt", cfg->mock_corrupt_rate },
+    };
+    size_t off = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < sizeof(faults) / sizeof(faults[0]) && off < len; i++) {
+        if (faults[i].rate <= 0) continue;
+        off += (size_t)snprintf(out + off, len - off, "%s%s %.4f", off ? ", " : "", faults[i].name, faults[i].rate);
+    }
+    if (off == 0) snprintf(out, len, "none");
+}
+#endif
+
+void mock_model_write_brief(FILE *fp, const Config *cfg) {
+    if (!mock_model_enabled(cfg) && !cfg->mock_store) return;
+    char latency[512];
+    format_latency(cfg, latency, sizeof(latency));
+    fprintf(fp, "[MockModel]\n");
+    fprintf(fp, "  Store:             %s\n", cfg->mock_store ? "stateful (in-memory)" : "virtual objects");
+    fprintf(fp, "  Latency:           %s\n", latency);
+    if (cfg->mock_bandwidth_mbps > 0) fprintf(fp, "  Bandwidth:         %.2f MB/s per connection\n", cfg->mock_bandwidth_mbps);
+    else fprintf(fp, "  Bandwidth:         unlimited\n");
+    if (cfg->mock_connect_ms > 0) fprintf(fp, "  Connect:           %.2f ms per new connection\n", cfg->mock_connect_ms);
+    fprintf(fp, "  Faults:            conn %.4f, 503 %.4f, 403 %.4f, 404 %.4f, 409 %.4f\n", cfg->mock_conn_fail_rate,
+            cfg->mock_slow_down_rate, cfg->mock_fail_403_rate, cfg->mock_fail_404_rate, cfg->mock_fail_409_rate);
+    fprintf(fp, "  Data Faults:       truncate %.4f, corrupt %.4f\n", cfg->mock_truncate_rate, cfg->mock_corrupt_rate);
+}
+
+void mock_model_apply(const Config *cfg) {
+    if (!mock_model_enabled(cfg) && !cfg->mock_store) return;
+#ifdef MOCK_SDK_MODE
+    mock_sdk_set_store(cfg->mock_store);
+    if (cfg->mock_store) LOG_INFO("Mock SDK store: stateful, objects are kept in memory for the whole run");
+    if (!mock_model_enabled(cfg)) return;
+
+    static const mock_sdk_latency_dist dist_map[] = {
+        [THINK_DIST_NONE] = MOCK_SDK_LATENCY_NONE,
+        [THINK_DIST_CONSTANT] = MOCK_SDK_LATENCY_CONSTANT,
+        [THINK_DIST_EXPONENTIAL] = MOCK_SDK_LATENCY_EXPONENTIAL,
+        [THINK_DIST_LOGNORMAL] = MOCK_SDK_LATENCY_LOGNORMAL,
+    };
+    mock_sdk_model model;
+    memset(&model, 0, sizeof(model));
+    model.latency_dist = dist_map[cfg->mock_latency_dist];
+    for (int k = 0; k < MOCK_OP_SLOTS; k++) model.latency_ms[k] = cfg->mock_latency_ms[k];
+    model.latency_cv = cfg->mock_latency_cv;
+    model.bandwidth_mbps = cfg->mock_bandwidth_mbps;
+    model.connect_ms = cfg->mock_connect_ms;
+    model.conn_fail_rate = cfg->mock_conn_fail_rate;
+    model.slow_down_rate = cfg->mock_slow_down_rate;
+    model.fail_403_rate = cfg->mock_fail_403_rate;
+    model.fail_404_rate = cfg->mock_fail_404_rate;
+    model.fail_409_rate = cfg->mock_fail_409_rate;
+    model.truncate_rate = cfg->mock_truncate_rate;
+    model.corrupt_rate = cfg->mock_corrupt_rate;
+    mock_sdk_set_model(&model);
+
+    char latency[512], bandwidth[64], connect[64], faults[256];
+    format_latency(cfg, latency, sizeof(latency));
+    format_faults(cfg, faults, sizeof(faults));
+    if (cfg->mock_bandwidth_mbps > 0) snprintf(bandwidth, sizeof(bandwidth), "%.2f MB/s per connection", cfg->mock_bandwidth_mbps);
+    else snprintf(bandwidth, sizeof(bandwidth), "unlimited");
+    if (cfg->mock_connect_ms > 0) snprintf(connect, sizeof(connect), "%.2f ms per new connection", cfg->mock_connect_ms);
+    else snprintf(connect, sizeof(connect), "none");
+    LOG_INFO("Mock SDK model: latency %s, bandwidth %s, connect %s, faults %s", latency, bandwidth, connect, faults);
+#else
+    LOG_WARN("Mock* settings only take effect in the mock build (make mock); ignored by the real SDK.");
+#endif
+}
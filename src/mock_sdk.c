@@ -2,22 +2,512 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
 
 static long long mock_put_calls = 0;
 static long long mock_get_calls = 0;
 static long long mock_del_calls = 0;
 static long long mock_list_calls = 0;
+static long long mock_head_calls = 0;
 static long long mock_init_calls = 0;
 static long long mock_part_calls = 0;
 static long long mock_complete_calls = 0;
 static long long mock_upload_file_calls = 0;
+static long long mock_copy_calls = 0;
+static long long mock_rename_calls = 0;
 
 // 定义虚拟对象大小 100MB
 #define MOCK_VIRTUAL_OBJECT_SIZE (100 * 1024 * 1024)
 
+// ----------------------------------------------------------------------------
+// 时延 / 带宽 / 故障注入模型 (mock_sdk_set_model 设置, 默认关闭: 立即返回成功)
+// 每次调用先按概率抽取故障, 再等待一个首字节时延; 传输数据时按单连接带宽上限限速。
+// 总耗时超过 request_options.max_connected_time 时与真实 SDK 一样以 RequestTimeout 结束。
+// ----------------------------------------------------------------------------
+static mock_sdk_model g_model;
+static int g_model_enabled = 0;
+static __thread unsigned int t_seed = 0;
+static __thread int t_conn_open = 0;    // 本线程是否持有可复用的连接 (connect_ms > 0 时生效)
+
+typedef struct {
+    long long start_ns;
+    long long deadline_ns;          // 0 = 不限
+    long long data_start_ns;        // 首字节时刻, 带宽限速从此开始计时
+    int truncate;                   // 本次响应 / 上传在中途截断
+    int corrupt;                    // 本次响应损坏一个字节
+} mock_call;
+
+void mock_sdk_set_model(const mock_sdk_model *model) {
+    g_model = *model;
+    g_model_enabled = (model->latency_dist != MOCK_SDK_LATENCY_NONE || model->bandwidth_mbps > 0 || model->connect_ms > 0 ||
+                       model->conn_fail_rate > 0 || model->slow_down_rate > 0 || model->fail_403_rate > 0 ||
+                       model->fail_404_rate > 0 || model->fail_409_rate > 0 || model->truncate_rate > 0 ||
+                       model->corrupt_rate > 0);
+}
+
+static long long mock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void mock_sleep_until(long long target_ns) {
+    struct timespec ts = { (time_t)(target_ns / 1000000000LL), (long)(target_ns % 1000000000LL) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+}
+
+static double mock_rand(void) {
+    if (t_seed == 0) t_seed = (unsigned int)(mock_now_ns() ^ (long long)(uintptr_t)pthread_self()) | 1u;
+    return (rand_r(&t_seed) + 0.5) / ((double)RAND_MAX + 1.0);
+}
+
+static double mock_sample_latency_ms(int op) {
+    double mean = g_model.latency_ms[op];
+    if (mean <= 0) return 0;
+    switch (g_model.latency_dist) {
+        case MOCK_SDK_LATENCY_CONSTANT:
+            return mean;
+        case MOCK_SDK_LATENCY_EXPONENTIAL:
+            return -mean * log(mock_rand());
+        case MOCK_SDK_LATENCY_LOGNORMAL: {
+            double sigma2 = log(1.0 + g_model.latency_cv * g_model.latency_cv);
+            double z = sqrt(-2.0 * log(mock_rand())) * cos(2.0 * M_PI * mock_rand());
+            return exp(log(mean) - sigma2 / 2.0 + sqrt(sigma2) * z);
+        }
+        default:
+            return 0;
+    }
+}
+
+// 等待到 target_ns; 超过请求超时则等到超时时刻并返回 RequestTimeout
+static obs_status mock_wait(const mock_call *mc, long long target_ns) {
+    if (mc->deadline_ns > 0 && target_ns > mc->deadline_ns) {
+        mock_sleep_until(mc->deadline_ns);
+        return OBS_STATUS_RequestTimeout;
+    }
+    mock_sleep_until(target_ns);
+    return OBS_STATUS_OK;
+}
+
+static obs_status mock_call_begin(mock_call *mc, const obs_options *options, int op) {
+    memset(mc, 0, sizeof(*mc));
+    if (!g_model_enabled) return OBS_STATUS_OK;
+
+    mc->start_ns = mock_now_ns();
+    if (options && options->request_options.max_connected_time > 0) {
+        mc->deadline_ns = mc->start_ns + (long long)options->request_options.max_connected_time * 1000000LL;
+    }
+
+    // 没有可复用的连接时先付出建连耗时; 不保持连接或禁止复用的请求结束后连接关闭
+    long long ready_ns = mc->start_ns;
+    if (g_model.connect_ms > 0) {
+        int reuse = t_conn_open;
+        t_conn_open = options && options->request_options.keep_alive && !options->request_options.forbid_reuse_tcp;
+        if (!reuse) {
+            ready_ns += (long long)(g_model.connect_ms * 1000000.0);
+            obs_status st = mock_wait(mc, ready_ns);
+            if (st != OBS_STATUS_OK) {
+                t_conn_open = 0;
+                return st;
+            }
+        }
+    }
+
+    double r = mock_rand();
+    if ((r -= g_model.conn_fail_rate) < 0) {
+        t_conn_open = 0;
+        return OBS_STATUS_ConnectionFailed;
+    }
+
+    obs_status fault = OBS_STATUS_OK;
+    if ((r -= g_model.slow_down_rate) < 0) fault = OBS_STATUS_SlowDown;
+    else if ((r -= g_model.fail_403_rate) < 0) fault = OBS_STATUS_AccessDenied;
+    else if ((r -= g_model.fail_404_rate) < 0) fault = (op == MOCK_SDK_OP_BUCKET) ? OBS_STATUS_NoSuchBucket : OBS_STATUS_NoSuchKey;
+    else if ((r -= g_model.fail_409_rate) < 0) fault = (op == MOCK_SDK_OP_BUCKET) ? OBS_STATUS_BucketAlreadyExists : OBS_STATUS_HttpErrorConflict;
+    if (fault == OBS_STATUS_OK) {
+        mc->truncate = mock_rand() < g_model.truncate_rate;
+        mc->corrupt = mock_rand() < g_model.corrupt_rate;
+    }
+
+    obs_status st = mock_wait(mc, ready_ns + (long long)(mock_sample_latency_ms(op) * 1000000.0));
+    mc->data_start_ns = mock_now_ns();
+    return st != OBS_STATUS_OK ? st : fault;
+}
+
+// 已传输 bytes 字节后按带宽上限限速
+static obs_status mock_call_pace(const mock_call *mc, uint64_t bytes) {
+    if (!g_model_enabled || g_model.bandwidth_mbps <= 0) return OBS_STATUS_OK;
+    return mock_wait(mc, mc->data_start_ns + (long long)(bytes / (g_model.bandwidth_mbps * 1024.0 * 1024.0) * 1e9));
+}
+
+// 以错误结束调用; 服务端返回的错误与真实 SDK 一样带 Request ID, 连接失败与超时没有
+static void mock_fail(obs_response_handler *handler, obs_status st, void *callback_data) {
+    if (st != OBS_STATUS_ConnectionFailed && st != OBS_STATUS_RequestTimeout && handler->properties_callback) {
+        obs_response_properties props;
+        memset(&props, 0, sizeof(props));
+        props.request_id = "MockReqId-Error-5555";
+        handler->properties_callback(&props, callback_data);
+    }
+    if (handler->complete_callback) handler->complete_callback(st, NULL, callback_data);
+}
+
+// 只有响应、没有数据传输的接口
+static obs_status mock_simple_call(const obs_options *options, int op, obs_response_handler *handler, void *callback_data) {
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, op);
+    if (st != OBS_STATUS_OK) mock_fail(handler, st, callback_data);
+    return st;
+}
+
+// ----------------------------------------------------------------------------
+// 有状态模式 (mock_sdk_set_store 开启): 对象读写 mock_store.c 中的内存存储, 不再是固定内容的虚拟对象
+// ----------------------------------------------------------------------------
+static int g_store_enabled = 0;
+
+void mock_sdk_set_store(int enabled) { g_store_enabled = enabled; }
+
+static const char *mock_bucket(const obs_options *options) {
+    return (options && options->bucket_options.bucket_name) ? options->bucket_options.bucket_name : "";
+}
+
+static void mock_send_props(obs_response_handler *handler, const char *etag, uint64_t length, const char *request_id,
+                            void *callback_data) {
+    if (!handler->properties_callback) return;
+    obs_response_properties props;
+    memset(&props, 0, sizeof(props));
+    props.etag = etag;
+    props.content_length = length;
+    props.request_id = request_id;
+    handler->properties_callback(&props, callback_data);
+}
+
+// 通过数据回调收取 content_length 字节的请求体, 截断 / 超时时丢弃已收数据
+static obs_status mock_collect_body(mock_call *mc, uint64_t content_length, obs_put_object_data_callback *data_cb,
+                                    void *callback_data, mock_object **out) {
+    mock_writer w;
+    mock_writer_init(&w);
+    char buf[16384];
+    obs_status st = OBS_STATUS_OK;
+    uint64_t received = 0;
+    uint64_t cut = mc->truncate ? (uint64_t)(content_length * mock_rand()) : content_length;
+    while (data_cb && received < content_length && st == OBS_STATUS_OK) {
+        if (received >= cut) {
+            st = OBS_STATUS_ConnectionFailed;
+            break;
+        }
+        int to_read = (content_length - received > sizeof(buf)) ? (int)sizeof(buf) : (int)(content_length - received);
+        int read = data_cb(to_read, buf, callback_data);
+        if (read <= 0) break;
+        if (mock_writer_append(&w, buf, read) != 0) st = OBS_STATUS_OutOfMemory;
+        received += read;
+        if (st == OBS_STATUS_OK) st = mock_call_pace(mc, received);
+    }
+    if (st != OBS_STATUS_OK) {
+        mock_writer_abort(&w);
+        return st;
+    }
+    *out = mock_writer_finish(&w);
+    return *out ? OBS_STATUS_OK : OBS_STATUS_OutOfMemory;
+}
+
+static void store_put_object(const obs_options *options, const char *key, uint64_t content_length,
+                             obs_put_object_handler *handler, void *callback_data) {
+    mock_call mc;
+    mock_object *obj = NULL;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_PUT);
+    if (st == OBS_STATUS_OK) {
+        st = mock_collect_body(&mc, content_length, handler->put_object_data_callback, callback_data, &obj);
+    }
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
+    char etag[48];
+    snprintf(etag, sizeof(etag), "%s", mock_object_etag(obj));
+    mock_store_put(mock_bucket(options), key, obj);
+    mock_send_props(&handler->response_handler, etag, 0, "MockReqId-PutObject-9999", callback_data);
+    if (handler->response_handler.complete_callback) {
+        handler->response_handler.complete_callback(OBS_STATUS_OK, NULL, callback_data);
+    }
+}
+
+static void store_get_object(const obs_options *options, const char *key, const obs_get_conditions *get_conditions,
+                             obs_get_object_handler *handler, void *callback_data) {
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_GET);
+    mock_object *obj = NULL;
+    if (st == OBS_STATUS_OK && !(obj = mock_store_get(mock_bucket(options), key))) st = OBS_STATUS_NoSuchKey;
+    uint64_t size = obj ? mock_object_size(obj) : 0;
+    uint64_t start = get_conditions ? get_conditions->start_byte : 0;
+    if (st == OBS_STATUS_OK && start > 0 && start >= size) st = OBS_STATUS_InvalidRange;
+    if (st != OBS_STATUS_OK) {
+        mock_object_unref(obj);
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
+    uint64_t length = size - start;
+    if (get_conditions && get_conditions->byte_count > 0 && get_conditions->byte_count < length) {
+        length = get_conditions->byte_count;
+    }
+    mock_send_props(&handler->response_handler, mock_object_etag(obj), length, "MockReqId-GetObject-8888", callback_data);
+
+    // 截断 / 损坏与虚拟对象模式一致: 声明的长度不变, 由调用方核对长度与内容
+    uint64_t total = mc.truncate ? (uint64_t)(length * mock_rand()) : length;
+    uint64_t corrupt_at = mc.corrupt ? (uint64_t)(total * mock_rand()) : UINT64_MAX;
+    uint64_t sent = 0;
+    char tmp[16384];
+    while (handler->get_object_data_callback && sent < total && st == OBS_STATUS_OK) {
+        uint64_t avail = 0;
+        const char *data = mock_object_read(obj, start + sent, &avail);
+        if (avail > total - sent) avail = total - sent;
+        int chunk_size = avail > sizeof(tmp) ? (int)sizeof(tmp) : (int)avail;
+        if (corrupt_at >= sent && corrupt_at < sent + chunk_size) {
+            memcpy(tmp, data, chunk_size);
+            tmp[corrupt_at - sent] ^= 0x5a;
+            data = tmp;
+        }
+        handler->get_object_data_callback(chunk_size, (char *)data, callback_data);
+        sent += chunk_size;
+        st = mock_call_pace(&mc, sent);
+    }
+    mock_object_unref(obj);
+    if (handler->response_handler.complete_callback) {
+        handler->response_handler.complete_callback(st, NULL, callback_data);
+    }
+}
+
+static void store_head_object(const obs_options *options, const char *key, obs_response_handler *handler,
+                              void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_HEAD, handler, callback_data) != OBS_STATUS_OK) return;
+    mock_object *obj = mock_store_get(mock_bucket(options), key);
+    if (!obj) {
+        mock_fail(handler, OBS_STATUS_NoSuchKey, callback_data);
+        return;
+    }
+    mock_send_props(handler, mock_object_etag(obj), mock_object_size(obj), "MockReqId-HeadObject-6666", callback_data);
+    mock_object_unref(obj);
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+
+static void store_copy_object(const obs_options *options, const char *key, obs_copy_destination_object_info *object_info,
+                              obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_COPY, handler, callback_data) != OBS_STATUS_OK) return;
+    mock_object *src = mock_store_get(mock_bucket(options), key);
+    if (!src) {
+        mock_fail(handler, OBS_STATUS_NoSuchKey, callback_data);
+        return;
+    }
+    mock_object *obj = mock_object_copy(src);
+    mock_object_unref(src);
+    if (!obj) {
+        mock_fail(handler, OBS_STATUS_OutOfMemory, callback_data);
+        return;
+    }
+    const char *dest_bucket = (object_info && object_info->destination_bucket) ? object_info->destination_bucket
+                                                                                 : mock_bucket(options);
+    const char *dest_key = (object_info && object_info->destination_key) ? object_info->destination_key : key;
+    if (object_info && object_info->etag_return && object_info->etag_return_size > 0) {
+        snprintf(object_info->etag_return, object_info->etag_return_size, "%s", mock_object_etag(obj));
+    }
+    if (object_info && object_info->last_modified_return) *object_info->last_modified_return = mock_object_mtime(obj);
+    mock_store_put(dest_bucket, dest_key, obj);
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+
+// 带 delimiter 时, prefix 之后含 delimiter 的 Key 折叠为 CommonPrefix, 与 Key 合计不超过 maxkeys 条
+static void store_list_objects(const obs_options *options, const char *prefix, const char *marker,
+                               const char *delimiter, int maxkeys, obs_list_objects_handler *handler,
+                               void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_LIST, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
+    if (maxkeys <= 0 || maxkeys > 1000) maxkeys = 1000;
+    int rollup = delimiter && delimiter[0];
+    int count = 0, truncated = 0;
+    mock_list_item *items = mock_store_list(mock_bucket(options), prefix, marker, rollup ? 0 : maxkeys, &count, &truncated);
+    obs_list_objects_content *contents = (obs_list_objects_content *)calloc(count > 0 ? count : 1, sizeof(*contents));
+    const char **prefixes = (const char **)calloc(count > 0 ? count : 1, sizeof(char *));
+    if (!contents || !prefixes) {
+        free(contents);
+        free(prefixes);
+        mock_store_list_free(items, count);
+        mock_fail(&handler->response_handler, OBS_STATUS_OutOfMemory, callback_data);
+        return;
+    }
+    size_t plen = prefix ? strlen(prefix) : 0;
+    size_t mlen = marker ? strlen(marker) : 0;
+    int rolled_up_marker = rollup && mlen > 0 && strcmp(marker + mlen - strlen(delimiter), delimiter) == 0;
+    int n_contents = 0, n_prefixes = 0;
+    const char *next_marker = NULL;
+    for (int i = 0; i < count; i++) {
+        const char *k = items[i].key;
+        // 上一页以 CommonPrefix 结束时跳过该前缀下的其余 Key
+        if (rolled_up_marker && strncmp(k, marker, mlen) == 0) continue;
+        char *d = rollup ? strstr(k + plen, delimiter) : NULL;
+        if (d) {
+            *(d + strlen(delimiter)) = '\0';        // 原地截断为公共前缀, 由 mock_store_list_free 释放
+            if (n_prefixes > 0 && strcmp(prefixes[n_prefixes - 1], k) == 0) continue;
+        }
+        if (n_contents + n_prefixes >= maxkeys) {
+            truncated = 1;
+            break;
+        }
+        if (d) {
+            prefixes[n_prefixes++] = k;
+        } else {
+            obs_list_objects_content *c = &contents[n_contents++];
+            c->key = k;
+            c->etag = mock_object_etag(items[i].obj);
+            c->size = mock_object_size(items[i].obj);
+            c->last_modified = mock_object_mtime(items[i].obj);
+            c->owner_id = "mock-owner";
+            c->owner_display_name = "mock-owner";
+            c->storage_class = "STANDARD";
+        }
+        next_marker = k;
+    }
+    obs_status st = OBS_STATUS_OK;
+    if (handler->list_Objects_callback) {
+        st = handler->list_Objects_callback(truncated, truncated ? next_marker : NULL, n_contents, contents, n_prefixes,
+                                            prefixes, callback_data);
+    }
+    free(contents);
+    free(prefixes);
+    mock_store_list_free(items, count);
+    if (handler->response_handler.complete_callback) {
+        handler->response_handler.complete_callback(st, NULL, callback_data);
+    }
+}
+
+static void store_initiate_upload(const obs_options *options, const char *key, int upload_id_return_size,
+                                  char *upload_id_return, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_MULTIPART, handler, callback_data) != OBS_STATUS_OK) return;
+    char upload_id[64];
+    if (mock_store_upload_begin(mock_bucket(options), key, upload_id, sizeof(upload_id)) != 0) {
+        mock_fail(handler, OBS_STATUS_OutOfMemory, callback_data);
+        return;
+    }
+    if (upload_id_return && upload_id_return_size > 0) snprintf(upload_id_return, upload_id_return_size, "%s", upload_id);
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+
+static void store_upload_part(const obs_options *options, obs_upload_part_info *part_info, uint64_t content_length,
+                              obs_upload_handler *handler, void *callback_data) {
+    mock_call mc;
+    mock_object *part = NULL;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_MULTIPART);
+    if (st == OBS_STATUS_OK) {
+        st = mock_collect_body(&mc, content_length, handler->upload_data_callback, callback_data, &part);
+    }
+    char etag[48] = "";
+    if (st == OBS_STATUS_OK) {
+        snprintf(etag, sizeof(etag), "%s", mock_object_etag(part));
+        st = mock_store_upload_part(part_info ? part_info->upload_id : NULL, part_info ? (int)part_info->part_number : 0,
+                                    part);
+    }
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
+    mock_send_props(&handler->response_handler, etag, 0, "MockReqId-UploadPart-7777", callback_data);
+    if (handler->response_handler.complete_callback) {
+        handler->response_handler.complete_callback(OBS_STATUS_OK, NULL, callback_data);
+    }
+}
+
+static void store_complete_upload(const obs_options *options, const char *key, const char *upload_id,
+                                  unsigned int part_count, const obs_complete_upload_Info *parts_info,
+                                  obs_complete_multi_part_upload_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_MULTIPART, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
+    unsigned int *numbers = (unsigned int *)malloc((part_count > 0 ? part_count : 1) * sizeof(unsigned int));
+    obs_status st = numbers ? OBS_STATUS_OK : OBS_STATUS_OutOfMemory;
+    char etag[48] = "";
+    if (st == OBS_STATUS_OK) {
+        for (unsigned int i = 0; i < part_count; i++) numbers[i] = parts_info ? parts_info[i].part_number : i + 1;
+        st = mock_store_upload_complete(upload_id, numbers, (int)part_count, etag, sizeof(etag));
+    }
+    free(numbers);
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
+    mock_send_props(&handler->response_handler, etag, 0, "MockReqId-CompleteUpload-4444", callback_data);
+    if (handler->complete_multipart_upload_callback) {
+        handler->complete_multipart_upload_callback(NULL, mock_bucket(options), key, etag, callback_data);
+    }
+    if (handler->response_handler.complete_callback) {
+        handler->response_handler.complete_callback(OBS_STATUS_OK, NULL, callback_data);
+    }
+}
+
+// 断点续传上传: 读取本地文件整体写入存储 (不模拟分段与断点文件)
+static obs_status store_upload_file(const obs_options *options, const char *key,
+                                    const obs_upload_file_configuration *config) {
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_RESUMABLE);
+    if (st != OBS_STATUS_OK) return st;
+    FILE *fp = (config && config->upload_file) ? fopen(config->upload_file, "rb") : NULL;
+    if (!fp) return OBS_STATUS_OpenFileFailed;
+    mock_writer w;
+    mock_writer_init(&w);
+    char buf[16384];
+    size_t n;
+    uint64_t total = 0;
+    while (st == OBS_STATUS_OK && (n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        if (mock_writer_append(&w, buf, n) != 0) st = OBS_STATUS_OutOfMemory;
+        total += n;
+        if (st == OBS_STATUS_OK) st = mock_call_pace(&mc, total);
+    }
+    fclose(fp);
+    if (st != OBS_STATUS_OK) {
+        mock_writer_abort(&w);
+        return st;
+    }
+    mock_object *obj = mock_writer_finish(&w);
+    if (!obj) return OBS_STATUS_OutOfMemory;
+    mock_store_put(mock_bucket(options), key, obj);
+    return OBS_STATUS_OK;
+}
+
 obs_status obs_initialize(int flags) { return OBS_STATUS_OK; }
 void obs_deinitialize() {}
-const char* obs_get_status_name(obs_status status) { return "OK"; }
+const char* obs_get_status_name(obs_status status) {
+    switch (status) {
+        case OBS_STATUS_OK:                     return "OK";
+        case OBS_STATUS_InternalError:          return "InternalError";
+        case OBS_STATUS_ConnectionFailed:       return "ConnectionFailed";
+        case OBS_STATUS_RequestTimeout:         return "RequestTimeout";
+        case OBS_STATUS_SlowDown:               return "SlowDown";
+        case OBS_STATUS_AccessDenied:           return "AccessDenied";
+        case OBS_STATUS_NoSuchKey:              return "NoSuchKey";
+        case OBS_STATUS_NoSuchBucket:           return "NoSuchBucket";
+        case OBS_STATUS_BucketAlreadyExists:    return "BucketAlreadyExists";
+        case OBS_STATUS_HttpErrorConflict:      return "HttpErrorConflict";
+        case OBS_STATUS_InvalidRange:           return "InvalidRange";
+        case OBS_STATUS_NoSuchUpload:           return "NoSuchUpload";
+        case OBS_STATUS_InvalidPart:            return "InvalidPart";
+        case OBS_STATUS_InvalidPartOrder:       return "InvalidPartOrder";
+        case OBS_STATUS_OpenFileFailed:         return "OpenFileFailed";
+        case OBS_STATUS_OutOfMemory:            return "OutOfMemory";
+        default:                                return "MockError";
+    }
+}
+int obs_status_is_retryable(obs_status status) {
+    switch (status) {
+        case OBS_STATUS_NameLookupError:
+        case OBS_STATUS_FailedToConnect:
+        case OBS_STATUS_ConnectionFailed:
+        case OBS_STATUS_InternalError:
+        case OBS_STATUS_AbortedByCallback:
+        case OBS_STATUS_RequestTimeout:
+        case OBS_STATUS_ServiceUnavailable:
+        case OBS_STATUS_SlowDown:
+            return 1;
+        default:
+            return 0;
+    }
+}
 void init_obs_options(obs_options *options) { if(options) memset(options, 0, sizeof(obs_options)); }
 void init_put_properties(obs_put_properties *options) { if(options) memset(options, 0, sizeof(obs_put_properties)); }
 void init_get_properties(obs_get_conditions *options) { if(options) memset(options, 0, sizeof(obs_get_conditions)); }
@@ -28,17 +518,33 @@ void put_object(const obs_options *options, char *key, uint64_t content_length,
                 obs_put_object_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_put_calls, 1);
-    
-    if (handler->put_object_data_callback) {
+    if (g_store_enabled) {
+        store_put_object(options, key, content_length, handler, callback_data);
+        return;
+    }
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_PUT);
+    if (st == OBS_STATUS_OK && handler->put_object_data_callback) {
         char buf[8192];
         uint64_t remaining = content_length;
-        while (remaining > 0) {
+        // 上传截断: 只发送一部分请求体后连接中断
+        uint64_t cut = mc.truncate ? (uint64_t)(content_length * mock_rand()) : content_length;
+        while (remaining > 0 && st == OBS_STATUS_OK) {
+            if (content_length - remaining >= cut) {
+                st = OBS_STATUS_ConnectionFailed;
+                break;
+            }
             int to_read = (remaining > sizeof(buf)) ? sizeof(buf) : (int)remaining;
             int read = handler->put_object_data_callback(to_read, buf, callback_data);
             if (read <= 0) break;
             remaining -= read;
+            st = mock_call_pace(&mc, content_length - remaining);
         }
     }
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
     if (handler->response_handler.properties_callback) {
         obs_response_properties props;
         memset(&props, 0, sizeof(props));
@@ -58,7 +564,16 @@ void get_object(const obs_options *options, obs_object_info *object_info,
                 obs_get_object_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_get_calls, 1);
-    
+    if (g_store_enabled) {
+        store_get_object(options, object_info ? object_info->key : NULL, get_conditions, handler, callback_data);
+        return;
+    }
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_GET);
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
     // Range 下载逻辑模拟
     uint64_t start = 0;
     uint64_t length_to_send = 8192; // 默认大小
@@ -94,16 +609,46 @@ void get_object(const obs_options *options, obs_object_info *object_info,
     if (handler->get_object_data_callback && length_to_send > 0) {
         char buf[8192];
         memset(buf, 'A', sizeof(buf));
-        
-        uint64_t remaining = length_to_send;
-        while (remaining > 0) {
-            int chunk_size = (remaining > sizeof(buf)) ? sizeof(buf) : (int)remaining;
+
+        // 响应体截断: 声明的长度不变, 只发送一部分后正常结束, 由调用方核对长度
+        uint64_t total = mc.truncate ? (uint64_t)(length_to_send * mock_rand()) : length_to_send;
+        uint64_t corrupt_at = mc.corrupt ? (uint64_t)(total * mock_rand()) : UINT64_MAX;
+        uint64_t sent = 0;
+        while (sent < total && st == OBS_STATUS_OK) {
+            int chunk_size = (total - sent > sizeof(buf)) ? sizeof(buf) : (int)(total - sent);
+            int flip = (corrupt_at >= sent && corrupt_at < sent + chunk_size) ? (int)(corrupt_at - sent) : -1;
+            if (flip >= 0) buf[flip] ^= 0x5a;
             handler->get_object_data_callback(chunk_size, buf, callback_data);
-            remaining -= chunk_size;
+            if (flip >= 0) buf[flip] ^= 0x5a;
+            sent += chunk_size;
+            st = mock_call_pace(&mc, sent);
         }
     }
     if (handler->response_handler.complete_callback) {
-        handler->response_handler.complete_callback(OBS_STATUS_OK, NULL, callback_data);
+        handler->response_handler.complete_callback(st, NULL, callback_data);
+    }
+}
+
+void get_object_metadata(const obs_options *options, obs_object_info *object_info,
+                         server_side_encryption_params *encryption_params,
+                         obs_response_handler *handler, void *callback_data)
+{
+    __sync_fetch_and_add(&mock_head_calls, 1);
+    if (g_store_enabled) {
+        store_head_object(options, object_info ? object_info->key : NULL, handler, callback_data);
+        return;
+    }
+    if (mock_simple_call(options, MOCK_SDK_OP_HEAD, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->properties_callback) {
+        obs_response_properties props;
+        memset(&props, 0, sizeof(props));
+        props.etag = "mock-etag-download";
+        props.content_length = 1024 * 1024;
+        props.request_id = "MockReqId-HeadObject-6666";
+        handler->properties_callback(&props, callback_data);
+    }
+    if (handler->complete_callback) {
+        handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
     }
 }
 
@@ -111,16 +656,60 @@ void delete_object(const obs_options *options, obs_object_info *object_info,
                    obs_response_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_del_calls, 1);
+    if (mock_simple_call(options, MOCK_SDK_OP_DELETE, handler, callback_data) != OBS_STATUS_OK) return;
+    if (g_store_enabled) mock_store_put(mock_bucket(options), object_info ? object_info->key : NULL, NULL);
     if (handler->complete_callback) {
         handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
     }
 }
 
+void copy_object(const obs_options *options, char *key, const char *version_id, obs_copy_destination_object_info *object_info,
+                 unsigned int is_copy, obs_put_properties *put_properties, server_side_encryption_params *encryption_params,
+                 obs_response_handler *handler, void *callback_data)
+{
+    __sync_fetch_and_add(&mock_copy_calls, 1);
+    if (g_store_enabled) {
+        store_copy_object(options, key, object_info, handler, callback_data);
+        return;
+    }
+    if (mock_simple_call(options, MOCK_SDK_OP_COPY, handler, callback_data) != OBS_STATUS_OK) return;
+    if (object_info && object_info->etag_return && object_info->etag_return_size > 0) {
+        snprintf(object_info->etag_return, object_info->etag_return_size, "\"mock-etag-copy\"");
+    }
+    if (handler->complete_callback) {
+        handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+    }
+}
+
+// 重命名按 COPY 的时延模型; 有状态模式下对象移到新 Key, 源 Key 不存在时返回 NoSuchKey
+void rename_object(const obs_options *options, char *key, char *new_object_name,
+                   obs_response_handler *handler, void *callback_data)
+{
+    __sync_fetch_and_add(&mock_rename_calls, 1);
+    if (mock_simple_call(options, MOCK_SDK_OP_COPY, handler, callback_data) != OBS_STATUS_OK) return;
+    if (g_store_enabled) {
+        mock_object *obj = mock_store_get(mock_bucket(options), key);
+        if (!obj) {
+            mock_fail(handler, OBS_STATUS_NoSuchKey, callback_data);
+            return;
+        }
+        mock_store_put(mock_bucket(options), new_object_name, obj);   // 引用转交给新 Key
+        mock_store_put(mock_bucket(options), key, NULL);
+    }
+    mock_send_props(handler, NULL, 0, "MockReqId-RenameObject-8888", callback_data);
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+
 void list_bucket_objects(const obs_options *options, const char *prefix, const char *marker, 
                          const char *delimiter, int maxkeys, 
                          obs_list_objects_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_list_calls, 1);
+    if (g_store_enabled) {
+        store_list_objects(options, prefix, marker, delimiter, maxkeys, handler, callback_data);
+        return;
+    }
+    if (mock_simple_call(options, MOCK_SDK_OP_LIST, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
     if (handler->list_Objects_callback) {
         obs_list_objects_content content;
         memset(&content, 0, sizeof(content));
@@ -141,6 +730,11 @@ void initiate_multi_part_upload(const obs_options *options, char *key,
                                 obs_response_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_init_calls, 1);
+    if (g_store_enabled) {
+        store_initiate_upload(options, key, upload_id_return_size, upload_id_return, handler, callback_data);
+        return;
+    }
+    if (mock_simple_call(options, MOCK_SDK_OP_MULTIPART, handler, callback_data) != OBS_STATUS_OK) return;
     if (upload_id_return) snprintf(upload_id_return, upload_id_return_size, "mock-upload-id");
     if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
 }
@@ -151,16 +745,32 @@ void upload_part(const obs_options *options, char *key, obs_upload_part_info *pa
                  obs_upload_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_part_calls, 1);
-    if (handler->upload_data_callback) {
+    if (g_store_enabled) {
+        store_upload_part(options, part_info, content_length, handler, callback_data);
+        return;
+    }
+    mock_call mc;
+    obs_status st = mock_call_begin(&mc, options, MOCK_SDK_OP_MULTIPART);
+    if (st == OBS_STATUS_OK && handler->upload_data_callback) {
         char buf[8192];
         uint64_t remaining = content_length;
-        while (remaining > 0) {
+        uint64_t cut = mc.truncate ? (uint64_t)(content_length * mock_rand()) : content_length;
+        while (remaining > 0 && st == OBS_STATUS_OK) {
+            if (content_length - remaining >= cut) {
+                st = OBS_STATUS_ConnectionFailed;
+                break;
+            }
             int to_read = (remaining > sizeof(buf)) ? sizeof(buf) : (int)remaining;
             int read = handler->upload_data_callback(to_read, buf, callback_data);
             if (read <= 0) break;
             remaining -= read;
+            st = mock_call_pace(&mc, content_length - remaining);
         }
     }
+    if (st != OBS_STATUS_OK) {
+        mock_fail(&handler->response_handler, st, callback_data);
+        return;
+    }
     if (handler->response_handler.properties_callback) {
         obs_response_properties props;
         memset(&props, 0, sizeof(props));
@@ -182,6 +792,11 @@ void complete_multi_part_upload(const obs_options *options, char *key, char *upl
                                 obs_complete_multi_part_upload_handler *handler, void *callback_data)
 {
     __sync_fetch_and_add(&mock_complete_calls, 1);
+    if (g_store_enabled) {
+        store_complete_upload(options, key, upload_id, part_count, parts_info, handler, callback_data);
+        return;
+    }
+    if (mock_simple_call(options, MOCK_SDK_OP_MULTIPART, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
     if (handler->response_handler.complete_callback) {
         handler->response_handler.complete_callback(OBS_STATUS_OK, NULL, callback_data);
     }
@@ -194,8 +809,15 @@ void upload_file(const obs_options *options, char *key, server_side_encryption_p
                  void *callback_data)
 {
     __sync_fetch_and_add(&mock_upload_file_calls, 1);
+    obs_status st;
+    if (g_store_enabled) {
+        st = store_upload_file(options, key, upload_file_config);
+    } else {
+        mock_call mc;
+        st = mock_call_begin(&mc, options, MOCK_SDK_OP_RESUMABLE);
+    }
     if (handler->upload_file_callback) {
-        handler->upload_file_callback(OBS_STATUS_OK, "Mock Success", 0, NULL, callback_data);
+        handler->upload_file_callback(st, st == OBS_STATUS_OK ? "Mock Success" : (char *)obs_get_status_name(st), 0, NULL, callback_data);
     }
 }
 
@@ -203,8 +825,70 @@ void initialize_break_point_lock() {}
 void deinitialize_break_point_lock() {}
 
 void create_bucket(const obs_options *options, obs_canned_acl canned_acl, const char *location_constraint, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
     if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
 }
 void delete_bucket(const obs_options *options, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+
+// 桶配置类接口: 回填固定内容后返回成功 (同样经过时延 / 故障模型)
+void obs_head_bucket(const obs_options *options, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void set_bucket_policy(const obs_options *options, const char *policy, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void get_bucket_policy(const obs_options *options, int policy_return_size, char *policy_return,
+                       obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (policy_return && policy_return_size > 0) snprintf(policy_return, policy_return_size, "{\"Statement\":[]}");
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void set_bucket_version_configuration(const obs_options *options, const char *version_status,
+                                      obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
     if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
 }
+void get_bucket_version_configuration(const obs_options *options, int status_return_size, char *status_return,
+                                      obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (status_return && status_return_size > 0) snprintf(status_return, status_return_size, "%s", OBS_VERSION_STATUS_ENABLED);
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void set_bucket_tagging(const obs_options *options, obs_name_value *tagging_list, unsigned int number,
+                        obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void get_bucket_tagging(const obs_options *options, obs_get_bucket_tagging_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
+    obs_status st = OBS_STATUS_OK;
+    if (handler->get_bucket_tagging_callback) st = handler->get_bucket_tagging_callback(0, NULL, callback_data);
+    if (handler->response_handler.complete_callback) handler->response_handler.complete_callback(st, NULL, callback_data);
+}
+void set_bucket_lifecycle_configuration(const obs_options *options, obs_lifecycle_conf *bucket_lifecycle_conf,
+                                        unsigned int blcc_number, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void get_bucket_lifecycle_configuration(const obs_options *options, obs_lifecycle_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
+    obs_status st = OBS_STATUS_OK;
+    if (handler->get_lifecycle_callback) st = handler->get_lifecycle_callback(NULL, 0, callback_data);
+    if (handler->response_handler.complete_callback) handler->response_handler.complete_callback(st, NULL, callback_data);
+}
+void set_bucket_cors_configuration(const obs_options *options, obs_bucket_cors_conf *obs_cors_conf_info,
+                                   unsigned int conf_num, obs_response_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, handler, callback_data) != OBS_STATUS_OK) return;
+    if (handler->complete_callback) handler->complete_callback(OBS_STATUS_OK, NULL, callback_data);
+}
+void get_bucket_cors_configuration(const obs_options *options, obs_cors_handler *handler, void *callback_data) {
+    if (mock_simple_call(options, MOCK_SDK_OP_BUCKET, &handler->response_handler, callback_data) != OBS_STATUS_OK) return;
+    obs_status st = OBS_STATUS_OK;
+    if (handler->get_cors_callback) st = handler->get_cors_callback(NULL, 0, callback_data);
+    if (handler->response_handler.complete_callback) handler->response_handler.complete_callback(st, NULL, callback_data);
+}
@@ -0,0 +1,603 @@
+#include "../include/mock_eSDKOBS.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+// ----------------------------------------------------------------------------
+// Mock SDK 的有状态对象存储
+// - 对象表: 按 "<桶>/<Key>" 哈希分片 (分段锁), 对象带引用计数, 读取期间覆盖 / 删除不影响正在进行的 GET
+// - 数据块: 对象内容切成 64KB 块按内容去重 (同样分片加锁), 对象只保存块引用。压测数据来自同一
+//   pattern, 大量对象共享相同的块, 高线程数长时间写入时内存只随不同内容的数量增长
+// - 分段上传: UploadId -> 已上传分段, 合并时按分段号拼接块引用, 不复制数据
+// ----------------------------------------------------------------------------
+
+#define STORE_SHARDS            256
+#define BLOCK_SHARDS            64
+#define UPLOAD_SLOTS            1024
+
+typedef struct mock_block {
+    uint64_t hash;
+    uint32_t len;
+    long refs;
+    struct mock_block *next;
+    char data[];
+} mock_block;
+
+struct mock_object {
+    long refs;
+    uint64_t size;
+    int block_count;
+    int64_t mtime;
+    char etag[48];
+    uint64_t *starts;               // 各块在对象内的起始偏移
+    mock_block **blocks;
+};
+
+typedef struct obj_entry {
+    char *name;
+    mock_object *obj;
+    struct obj_entry *next;
+} obj_entry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    obj_entry **slots;
+    size_t slot_count;
+    size_t count;
+} obj_shard;
+
+typedef struct {
+    pthread_mutex_t lock;
+    mock_block **slots;
+    size_t slot_count;
+    size_t count;
+} block_shard;
+
+typedef struct upload {
+    char id[40];
+    char *name;
+    mock_object **parts;            // 下标为分段号
+    int part_cap;
+    struct upload *next;
+} upload;
+
+static obj_shard g_objects[STORE_SHARDS];
+static block_shard g_blocks[BLOCK_SHARDS];
+static upload *g_uploads[UPLOAD_SLOTS];
+static pthread_mutex_t g_upload_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_store_once = PTHREAD_ONCE_INIT;
+static uint64_t g_etag_seq = 0;
+static uint64_t g_upload_seq = 0;
+
+static uint64_t hash_str(const char *s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// 按 8 字节处理的内容哈希, 块去重时还会逐字节比较, 碰撞不影响正确性
+static uint64_t hash_bytes(const char *p, size_t len) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        h = (h ^ v) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 29;
+    }
+    for (; i < len; i++) h = (h ^ (unsigned char)p[i]) * 1099511628211ULL;
+    return h ^ (h >> 32);
+}
+
+static void store_init(void) {
+    for (int i = 0; i < STORE_SHARDS; i++) {
+        pthread_mutex_init(&g_objects[i].lock, NULL);
+        g_objects[i].slot_count = 256;
+        g_objects[i].slots = (obj_entry **)calloc(g_objects[i].slot_count, sizeof(obj_entry *));
+    }
+    for (int i = 0; i < BLOCK_SHARDS; i++) {
+        pthread_mutex_init(&g_blocks[i].lock, NULL);
+        g_blocks[i].slot_count = 1024;
+        g_blocks[i].slots = (mock_block **)calloc(g_blocks[i].slot_count, sizeof(mock_block *));
+    }
+}
+
+static void store_ensure_init(void) {
+    pthread_once(&g_store_once, store_init);
+}
+
+// ----------------------------------------------------------------------------
+// 数据块
+// ----------------------------------------------------------------------------
+static mock_block *block_intern(const char *data, uint32_t len) {
+    uint64_t h = hash_bytes(data, len);
+    block_shard *sh = &g_blocks[h % BLOCK_SHARDS];
+    pthread_mutex_lock(&sh->lock);
+    mock_block **slot = &sh->slots[(h / BLOCK_SHARDS) % sh->slot_count];
+    for (mock_block *b = *slot; b; b = b->next) {
+        if (b->hash == h && b->len == len && memcmp(b->data, data, len) == 0) {
+            b->refs++;
+            pthread_mutex_unlock(&sh->lock);
+            return b;
+        }
+    }
+    mock_block *b = (mock_block *)malloc(sizeof(mock_block) + len);
+    if (b) {
+        b->hash = h;
+        b->len = len;
+        b->refs = 1;
+        memcpy(b->data, data, len);
+        b->next = *slot;
+        *slot = b;
+        if (++sh->count > sh->slot_count * 2) {
+            size_t n = sh->slot_count * 2;
+            mock_block **slots = (mock_block **)calloc(n, sizeof(mock_block *));
+            if (slots) {
+                for (size_t i = 0; i < sh->slot_count; i++) {
+                    for (mock_block *e = sh->slots[i], *next; e; e = next) {
+                        next = e->next;
+                        size_t idx = (e->hash / BLOCK_SHARDS) % n;
+                        e->next = slots[idx];
+                        slots[idx] = e;
+                    }
+                }
+                free(sh->slots);
+                sh->slots = slots;
+                sh->slot_count = n;
+            }
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return b;
+}
+
+static void block_ref(mock_block *b) {
+    block_shard *sh = &g_blocks[b->hash % BLOCK_SHARDS];
+    pthread_mutex_lock(&sh->lock);
+    b->refs++;
+    pthread_mutex_unlock(&sh->lock);
+}
+
+static void block_unref(mock_block *b) {
+    block_shard *sh = &g_blocks[b->hash % BLOCK_SHARDS];
+    pthread_mutex_lock(&sh->lock);
+    if (--b->refs == 0) {
+        mock_block **pp = &sh->slots[(b->hash / BLOCK_SHARDS) % sh->slot_count];
+        while (*pp && *pp != b) pp = &(*pp)->next;
+        if (*pp) *pp = b->next;
+        sh->count--;
+        free(b);
+    }
+    pthread_mutex_unlock(&sh->lock);
+}
+
+// ----------------------------------------------------------------------------
+// 对象
+// ----------------------------------------------------------------------------
+static mock_object *object_alloc(int block_count) {
+    mock_object *o = (mock_object *)calloc(1, sizeof(mock_object));
+    if (!o) return NULL;
+    o->refs = 1;
+    o->block_count = block_count;
+    o->starts = (uint64_t *)malloc((block_count + 1) * sizeof(uint64_t));
+    o->blocks = (mock_block **)malloc((block_count + 1) * sizeof(mock_block *));
+    if (!o->starts || !o->blocks) {
+        free(o->starts);
+        free(o->blocks);
+        free(o);
+        return NULL;
+    }
+    o->mtime = (int64_t)time(NULL);
+    uint64_t seq = __atomic_add_fetch(&g_etag_seq, 1, __ATOMIC_RELAXED);
+    snprintf(o->etag, sizeof(o->etag), "\"%016llx%016llx\"", (unsigned long long)seq,
+             (unsigned long long)(seq * 0x9e3779b97f4a7c15ULL));
+    return o;
+}
+
+void mock_object_ref(mock_object *obj) {
+    __atomic_add_fetch(&obj->refs, 1, __ATOMIC_RELAXED);
+}
+
+void mock_object_unref(mock_object *obj) {
+    if (!obj || __atomic_sub_fetch(&obj->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+    for (int i = 0; i < obj->block_count; i++) block_unref(obj->blocks[i]);
+    free(obj->starts);
+    free(obj->blocks);
+    free(obj);
+}
+
+uint64_t mock_object_size(const mock_object *obj) { return obj->size; }
+const char *mock_object_etag(const mock_object *obj) { return obj->etag; }
+int64_t mock_object_mtime(const mock_object *obj) { return obj->mtime; }
+
+// 返回 offset 处的连续数据, *avail 为到所在块末尾的长度
+const char *mock_object_read(const mock_object *obj, uint64_t offset, uint64_t *avail) {
+    int lo = 0, hi = obj->block_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (obj->starts[mid] <= offset) lo = mid;
+        else hi = mid - 1;
+    }
+    if (obj->block_count == 0 || offset >= obj->size) {
+        *avail = 0;
+        return NULL;
+    }
+    uint64_t in_block = offset - obj->starts[lo];
+    *avail = obj->blocks[lo]->len - in_block;
+    return obj->blocks[lo]->data + in_block;
+}
+
+// ----------------------------------------------------------------------------
+// 写入: 数据先攒满一个块再去重入库
+// ----------------------------------------------------------------------------
+void mock_writer_init(mock_writer *w) {
+    memset(w, 0, sizeof(*w));
+    store_ensure_init();
+}
+
+static int writer_flush(mock_writer *w) {
+    if (w->pending_len == 0) return 0;
+    if (w->block_count == w->block_cap) {
+        int cap = w->block_cap ? w->block_cap * 2 : 16;
+        mock_block **blocks = (mock_block **)realloc(w->blocks, cap * sizeof(mock_block *));
+        if (!blocks) return -1;
+        w->blocks = blocks;
+        w->block_cap = cap;
+    }
+    mock_block *b = block_intern(w->pending, w->pending_len);
+    if (!b) return -1;
+    w->blocks[w->block_count++] = b;
+    w->pending_len = 0;
+    return 0;
+}
+
+int mock_writer_append(mock_writer *w, const char *data, size_t len) {
+    while (len > 0) {
+        if (!w->pending && !(w->pending = (char *)malloc(MOCK_STORE_BLOCK_SIZE))) return -1;
+        size_t take = MOCK_STORE_BLOCK_SIZE - w->pending_len;
+        if (take > len) take = len;
+        memcpy(w->pending + w->pending_len, data, take);
+        w->pending_len += (uint32_t)take;
+        w->size += take;
+        data += take;
+        len -= take;
+        if (w->pending_len == MOCK_STORE_BLOCK_SIZE && writer_flush(w) != 0) return -1;
+    }
+    return 0;
+}
+
+mock_object *mock_writer_finish(mock_writer *w) {
+    mock_object *o = NULL;
+    if (writer_flush(w) == 0) o = object_alloc(w->block_count);
+    if (!o) {
+        mock_writer_abort(w);
+        return NULL;
+    }
+    uint64_t off = 0;
+    for (int i = 0; i < w->block_count; i++) {
+        o->blocks[i] = w->blocks[i];
+        o->starts[i] = off;
+        off += w->blocks[i]->len;
+    }
+    o->size = off;
+    free(w->pending);
+    free(w->blocks);
+    memset(w, 0, sizeof(*w));
+    return o;
+}
+
+void mock_writer_abort(mock_writer *w) {
+    for (int i = 0; i < w->block_count; i++) block_unref(w->blocks[i]);
+    free(w->pending);
+    free(w->blocks);
+    memset(w, 0, sizeof(*w));
+}
+
+// 拼接多个对象 (分段合并 / 复制), 只增加块引用
+static mock_object *object_concat(mock_object **parts, int count) {
+    int blocks = 0;
+    for (int i = 0; i < count; i++) blocks += parts[i]->block_count;
+    mock_object *o = object_alloc(blocks);
+    if (!o) return NULL;
+    int n = 0;
+    uint64_t off = 0;
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < parts[i]->block_count; k++) {
+            mock_block *b = parts[i]->blocks[k];
+            block_ref(b);
+            o->blocks[n] = b;
+            o->starts[n] = off;
+            off += b->len;
+            n++;
+        }
+    }
+    o->size = off;
+    return o;
+}
+
+mock_object *mock_object_copy(mock_object *src) {
+    return object_concat(&src, 1);
+}
+
+// ----------------------------------------------------------------------------
+// 对象表
+// ----------------------------------------------------------------------------
+static char *object_name(const char *bucket, const char *key) {
+    size_t blen = strlen(bucket ? bucket : ""), klen = strlen(key ? key : "");
+    char *name = (char *)malloc(blen + klen + 2);
+    if (!name) return NULL;
+    memcpy(name, bucket ? bucket : "", blen);
+    name[blen] = '/';
+    memcpy(name + blen + 1, key ? key : "", klen + 1);
+    return name;
+}
+
+// 写入 (obj 非 NULL, 接管其引用) 或删除 (obj 为 NULL)
+void mock_store_put(const char *bucket, const char *key, mock_object *obj) {
+    store_ensure_init();
+    char *name = object_name(bucket, key);
+    if (!name) {
+        mock_object_unref(obj);
+        return;
+    }
+    uint64_t h = hash_str(name);
+    obj_shard *sh = &g_objects[h % STORE_SHARDS];
+    mock_object *old = NULL;
+    pthread_mutex_lock(&sh->lock);
+    obj_entry **pp = &sh->slots[(h / STORE_SHARDS) % sh->slot_count];
+    while (*pp && strcmp((*pp)->name, name) != 0) pp = &(*pp)->next;
+    if (*pp) {
+        old = (*pp)->obj;
+        if (obj) {
+            (*pp)->obj = obj;
+        } else {
+            obj_entry *e = *pp;
+            *pp = e->next;
+            free(e->name);
+            free(e);
+            sh->count--;
+        }
+    } else if (obj) {
+        obj_entry *e = (obj_entry *)malloc(sizeof(obj_entry));
+        if (e) {
+            e->name = name;
+            name = NULL;
+            e->obj = obj;
+            e->next = *pp;
+            *pp = e;
+            if (++sh->count > sh->slot_count * 2) {
+                size_t n = sh->slot_count * 2;
+                obj_entry **slots = (obj_entry **)calloc(n, sizeof(obj_entry *));
+                if (slots) {
+                    for (size_t i = 0; i < sh->slot_count; i++) {
+                        for (obj_entry *x = sh->slots[i], *next; x; x = next) {
+                            next = x->next;
+                            size_t idx = (hash_str(x->name) / STORE_SHARDS) % n;
+                            x->next = slots[idx];
+                            slots[idx] = x;
+                        }
+                    }
+                    free(sh->slots);
+                    sh->slots = slots;
+                    sh->slot_count = n;
+                }
+            }
+        } else {
+            old = obj;
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    free(name);
+    mock_object_unref(old);
+}
+
+// 返回带引用的对象, 不存在时为 NULL
+mock_object *mock_store_get(const char *bucket, const char *key) {
+    store_ensure_init();
+    char *name = object_name(bucket, key);
+    if (!name) return NULL;
+    uint64_t h = hash_str(name);
+    obj_shard *sh = &g_objects[h % STORE_SHARDS];
+    mock_object *obj = NULL;
+    pthread_mutex_lock(&sh->lock);
+    for (obj_entry *e = sh->slots[(h / STORE_SHARDS) % sh->slot_count]; e; e = e->next) {
+        if (strcmp(e->name, name) == 0) {
+            obj = e->obj;
+            mock_object_ref(obj);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    free(name);
+    return obj;
+}
+
+static int list_item_cmp(const void *a, const void *b) {
+    return strcmp(((const mock_list_item *)a)->key, ((const mock_list_item *)b)->key);
+}
+
+// 桶内以 prefix 开头且大于 marker 的 Key, 按字典序返回前 max_keys 个 (带对象引用)
+mock_list_item *mock_store_list(const char *bucket, const char *prefix, const char *marker, int max_keys,
+                                int *out_count, int *out_truncated) {
+    store_ensure_init();
+    if (!prefix) prefix = "";
+    if (!marker) marker = "";
+    size_t blen = strlen(bucket ? bucket : ""), plen = strlen(prefix);
+    size_t cap = 64, count = 0;
+    mock_list_item *items = (mock_list_item *)malloc(cap * sizeof(mock_list_item));
+    for (int s = 0; s < STORE_SHARDS && items; s++) {
+        obj_shard *sh = &g_objects[s];
+        pthread_mutex_lock(&sh->lock);
+        for (size_t i = 0; i < sh->slot_count && items; i++) {
+            for (obj_entry *e = sh->slots[i]; e; e = e->next) {
+                if (strncmp(e->name, bucket ? bucket : "", blen) != 0 || e->name[blen] != '/') continue;
+                const char *key = e->name + blen + 1;
+                if (strncmp(key, prefix, plen) != 0 || strcmp(key, marker) <= 0) continue;
+                if (count == cap) {
+                    mock_list_item *grown = (mock_list_item *)realloc(items, cap * 2 * sizeof(mock_list_item));
+                    if (!grown) break;
+                    items = grown;
+                    cap *= 2;
+                }
+                items[count].key = strdup(key);
+                items[count].obj = e->obj;
+                mock_object_ref(e->obj);
+                count++;
+            }
+        }
+        pthread_mutex_unlock(&sh->lock);
+    }
+    if (!items) {
+        *out_count = 0;
+        *out_truncated = 0;
+        return NULL;
+    }
+    qsort(items, count, sizeof(mock_list_item), list_item_cmp);
+    size_t shown = (max_keys > 0 && count > (size_t)max_keys) ? (size_t)max_keys : count;
+    for (size_t i = shown; i < count; i++) {
+        free(items[i].key);
+        mock_object_unref(items[i].obj);
+    }
+    *out_count = (int)shown;
+    *out_truncated = shown < count;
+    return items;
+}
+
+void mock_store_list_free(mock_list_item *items, int count) {
+    for (int i = 0; i < count; i++) {
+        free(items[i].key);
+        mock_object_unref(items[i].obj);
+    }
+    free(items);
+}
+
+// ----------------------------------------------------------------------------
+// 分段上传
+// ----------------------------------------------------------------------------
+static upload *upload_find_locked(const char *id) {
+    for (upload *u = g_uploads[hash_str(id) % UPLOAD_SLOTS]; u; u = u->next) {
+        if (strcmp(u->id, id) == 0) return u;
+    }
+    return NULL;
+}
+
+static void upload_free(upload *u) {
+    for (int i = 0; i < u->part_cap; i++) mock_object_unref(u->parts[i]);
+    free(u->parts);
+    free(u->name);
+    free(u);
+}
+
+int mock_store_upload_begin(const char *bucket, const char *key, char *id_out, int id_len) {
+    store_ensure_init();
+    upload *u = (upload *)calloc(1, sizeof(upload));
+    if (!u) return -1;
+    u->name = object_name(bucket, key);
+    u->part_cap = 16;
+    u->parts = (mock_object **)calloc(u->part_cap, sizeof(mock_object *));
+    if (!u->name || !u->parts) {
+        upload_free(u);
+        return -1;
+    }
+    uint64_t seq = __atomic_add_fetch(&g_upload_seq, 1, __ATOMIC_RELAXED);
+    snprintf(u->id, sizeof(u->id), "mock%016llx", (unsigned long long)(seq * 0x9e3779b97f4a7c15ULL));
+    pthread_mutex_lock(&g_upload_lock);
+    upload **slot = &g_uploads[hash_str(u->id) % UPLOAD_SLOTS];
+    u->next = *slot;
+    *slot = u;
+    pthread_mutex_unlock(&g_upload_lock);
+    if (id_out && id_len > 0) snprintf(id_out, id_len, "%s", u->id);
+    return 0;
+}
+
+// 保存分段 (接管 part 的引用); UploadId 不存在时返回 OBS_STATUS_NoSuchUpload
+obs_status mock_store_upload_part(const char *upload_id, int part_number, mock_object *part) {
+    if (part_number < 1 || part_number > 10000) {
+        mock_object_unref(part);
+        return OBS_STATUS_InvalidPart;
+    }
+    mock_object *old = NULL;
+    obs_status st = OBS_STATUS_NoSuchUpload;
+    pthread_mutex_lock(&g_upload_lock);
+    upload *u = upload_find_locked(upload_id ? upload_id : "");
+    if (u && part_number >= u->part_cap) {
+        int cap = u->part_cap;
+        while (cap <= part_number) cap *= 2;
+        mock_object **parts = (mock_object **)realloc(u->parts, cap * sizeof(mock_object *));
+        if (parts) {
+            memset(parts + u->part_cap, 0, (cap - u->part_cap) * sizeof(mock_object *));
+            u->parts = parts;
+            u->part_cap = cap;
+        }
+    }
+    if (u && part_number < u->part_cap) {
+        old = u->parts[part_number];
+        u->parts[part_number] = part;
+        part = NULL;
+        st = OBS_STATUS_OK;
+    }
+    pthread_mutex_unlock(&g_upload_lock);
+    mock_object_unref(old);
+    mock_object_unref(part);
+    return st;
+}
+
+// 按列出的分段号依次拼接 (未列出时按分段号升序合并全部分段), 完成后对象可见
+obs_status mock_store_upload_complete(const char *upload_id, const unsigned int *part_numbers, int count,
+                                      char *etag_out, int etag_len) {
+    pthread_mutex_lock(&g_upload_lock);
+    upload **pp = &g_uploads[hash_str(upload_id ? upload_id : "") % UPLOAD_SLOTS];
+    while (*pp && strcmp((*pp)->id, upload_id ? upload_id : "") != 0) pp = &(*pp)->next;
+    upload *u = *pp;
+    if (u) *pp = u->next;
+    pthread_mutex_unlock(&g_upload_lock);
+    if (!u) return OBS_STATUS_NoSuchUpload;
+
+    int n = 0;
+    mock_object **list = (mock_object **)malloc((count > 0 ? count : u->part_cap) * sizeof(mock_object *));
+    obs_status st = list ? OBS_STATUS_OK : OBS_STATUS_OutOfMemory;
+    if (list && count > 0) {
+        for (int i = 0; i < count && st == OBS_STATUS_OK; i++) {
+            unsigned int pn = part_numbers[i];
+            if (pn >= (unsigned int)u->part_cap || !u->parts[pn]) st = OBS_STATUS_InvalidPart;
+            else if (i > 0 && pn <= part_numbers[i - 1]) st = OBS_STATUS_InvalidPartOrder;
+            else list[n++] = u->parts[pn];
+        }
+    } else if (list) {
+        for (int i = 1; i < u->part_cap; i++) {
+            if (u->parts[i]) list[n++] = u->parts[i];
+        }
+    }
+    if (st == OBS_STATUS_OK) {
+        mock_object *obj = object_concat(list, n);
+        if (!obj) {
+            st = OBS_STATUS_OutOfMemory;
+        } else {
+            // 分段合并对象的 ETag 形如 "<hex>-<分段数>"
+            snprintf(obj->etag + 33, sizeof(obj->etag) - 33, "-%d\"", n);
+            if (etag_out && etag_len > 0) snprintf(etag_out, etag_len, "%s", obj->etag);
+            char *slash = strchr(u->name, '/');
+            *slash = '\0';
+            mock_store_put(u->name, slash + 1, obj);
+            *slash = '/';
+        }
+    }
+    if (st != OBS_STATUS_OK && st != OBS_STATUS_OutOfMemory) {
+        // 失败时恢复上传任务, 与服务端一致可以修正后重试合并
+        pthread_mutex_lock(&g_upload_lock);
+        upload **slot = &g_uploads[hash_str(u->id) % UPLOAD_SLOTS];
+        u->next = *slot;
+        *slot = u;
+        pthread_mutex_unlock(&g_upload_lock);
+        free(list);
+        return st;
+    }
+    free(list);
+    upload_free(u);
+    return st;
+}
@@ -19,6 +19,7 @@ typedef struct {
     
     char request_id[64];
     uint64_t last_reported_bytes; 
+    int force_validation;           // 可见性探测: 无论 EnableDataValidation 是否开启均校验内容
 } transfer_context;
 
 obs_status response_properties_callback(const obs_response_properties *properties, void *callback_data) {
@@ -57,7 +58,7 @@ int put_buffer_callback_optimized(int buffer_size, char *buffer, void *callback_
     
     if (!args->pattern_buffer || !buffer) return 0;
 
-    long long offset = ctx->total_processed & args->pattern_mask;
+    long long offset = (ctx->pattern_start_offset + ctx->total_processed) & args->pattern_mask;
     int bytes_copied = 0;
     while (bytes_copied < buffer_size) {
         int available = args->pattern_size - offset;
@@ -70,7 +71,7 @@ int put_buffer_callback_optimized(int buffer_size, char *buffer, void *callback_
 
         bytes_copied += to_copy;
         ctx->total_processed += to_copy;
-        offset = ctx->total_processed & args->pattern_mask; 
+        offset = (ctx->pattern_start_offset + ctx->total_processed) & args->pattern_mask;
     }
     return bytes_copied;
 }
@@ -81,7 +82,7 @@ obs_status get_buffer_callback_optimized(int buffer_size, const char *buffer, vo
     transfer_context *ctx = (transfer_context *)callback_data;
     WorkerArgs *args = ctx->args;
 
-    if (!args->config->enable_data_validation || ctx->skip_validation) {
+    if ((!args->config->enable_data_validation && !ctx->force_validation) || ctx->skip_validation) {
         ctx->total_processed += buffer_size;
         args->stats.total_success_bytes += buffer_size; // 实时累加
         return OBS_STATUS_OK;
@@ -102,6 +103,8 @@ obs_status get_buffer_callback_optimized(int buffer_size, const char *buffer, vo
         
         if (memcmp(buffer + bytes_checked, args->pattern_buffer + offset, to_check) != 0) {
              ctx->validation_failed = 1;
+             // 可见性探测自行统计内容不一致, 轮询期间不逐次打印
+             if (ctx->force_validation) return OBS_STATUS_InternalError;
              LOG_ERROR("[DATA_CORRUPTION] ReqID: %s, ObjectCtx: %s, Abs Offset: %lld, Pattern Offset: %lld, Check Len: %d", 
                        (strlen(ctx->request_id) > 0) ? ctx->request_id : "UNKNOWN_REQ_ID",
                        args->username, absolute_pos + bytes_checked, offset, to_check);
@@ -181,8 +184,39 @@ static int client_sign_password_callback(void *context, char *buf, int buf_len)
     return len;
 }
 
-static void setup_options(obs_options *option, WorkerArgs *args) {
-    memset(option, 0, sizeof(obs_options));
+// 服务端加密参数; 未开启时返回 NULL
+// SSE-KMS 只在创建对象的请求上携带, 读取与上传分段只需 SSE-C 密钥; 复制时还要提供源对象的 SSE-C 密钥
+#define SSE_USE_CREATE  0
+#define SSE_USE_ACCESS  1
+#define SSE_USE_COPY    2
+static server_side_encryption_params *setup_encryption(server_side_encryption_params *params, WorkerArgs *args, int use) {
+    const Config *cfg = args->config;
+    if (cfg->sse_mode == SSE_MODE_NONE) return NULL;
+    if (cfg->sse_mode == SSE_MODE_KMS && use == SSE_USE_ACCESS) return NULL;
+
+    memset(params, 0, sizeof(*params));
+    if (cfg->sse_mode == SSE_MODE_KMS) {
+        params->encryption_type = OBS_ENCRYPTION_KMS;
+        params->kms_server_side_encryption = "kms";
+        if (strlen(cfg->sse_kms_key_id) > 0) params->kms_key_id = (char *)cfg->sse_kms_key_id;
+    } else {
+        params->encryption_type = OBS_ENCRYPTION_SSEC;
+        params->ssec_customer_algorithm = "AES256";
+        params->ssec_customer_key = (char *)cfg->sse_c_key;
+        if (use == SSE_USE_COPY) {
+            params->des_ssec_customer_algorithm = "AES256";
+            params->des_ssec_customer_key = (char *)cfg->sse_c_key;
+        }
+    }
+    return params;
+}
+
+// 构造本线程的请求模板: 连接/鉴权参数与各类 handler 在线程生命周期内不变,
+// 指针字段指向 WorkerArgs 内的 effective_* 数组, 请求间切换桶名无需重建
+void adapter_build_template(WorkerArgs *args) {
+    RequestTemplate *t = &args->req_tmpl;
+    memset(t, 0, sizeof(RequestTemplate));
+    obs_options *option = &t->options;
     init_obs_options(option);
     
     option->bucket_options.host_name = args->config->endpoint;
@@ -202,7 +236,7 @@ static void setup_options(obs_options *option, WorkerArgs *args) {
 
     // Default values
     option->bucket_options.useCname = false;
-    option->bucket_options.uri_style = OBS_URI_STYLE_VIRTUALHOST;
+    option->bucket_options.uri_style = args->config->path_style ? OBS_URI_STYLE_PATH : OBS_URI_STYLE_VIRTUALHOST;
 
     if (strlen(args->config->gm_auth_mode) > 0) {
         option->bucket_options.useCname = true;
@@ -242,26 +276,57 @@ static void setup_options(obs_options *option, WorkerArgs *args) {
             option->request_options.server_cert_path = args->config->server_cert_path;
         }
     }
+
+    t->response_handler.properties_callback = &response_properties_callback;
+    t->response_handler.complete_callback = &response_complete_callback;
+
+    t->put_handler.response_handler = t->response_handler;
+    t->put_handler.put_object_data_callback = &put_buffer_callback_optimized;
+
+    t->get_handler.response_handler = t->response_handler;
+    t->get_handler.get_object_data_callback = &get_buffer_callback_optimized;
+
+    t->list_handler.response_handler = t->response_handler;
+    t->list_handler.list_Objects_callback = &list_objects_callback;
+
+    t->upload_part_handler.response_handler = t->response_handler;
+    t->upload_part_handler.upload_data_callback = (obs_upload_data_callback *)&put_buffer_callback_optimized;
+
+    t->complete_handler.response_handler = t->response_handler;
+    t->complete_handler.complete_multipart_upload_callback = &complete_multipart_upload_callback;
+
+    t->upload_file_handler.response_handler = t->response_handler;
+    t->upload_file_handler.upload_file_callback = &upload_file_complete_callback;
+    t->upload_file_handler.progress_callback = &resumable_progress_callback;
+
+    t->ready = 1;
+}
+
+// 每个请求从模板复制 options; 未经 worker_setup 的调用方首次使用时构造模板
+void adapter_setup_options(obs_options *option, WorkerArgs *args) {
+    if (!args->req_tmpl.ready) adapter_build_template(args);
+    *option = args->req_tmpl.options;
 }
 
 obs_status run_put_benchmark(WorkerArgs *args, char *key, long long object_size, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
 
     obs_put_properties put_props;
     init_put_properties(&put_props);
 
-    obs_put_object_handler handler = {0};
-    handler.response_handler.properties_callback = &response_properties_callback;
-    handler.response_handler.complete_callback = &response_complete_callback;
-    handler.put_object_data_callback = &put_buffer_callback_optimized;
+    ctx.pattern_start_offset = args->pattern_offset;
+
+    obs_put_object_handler handler = args->req_tmpl.put_handler;
 
-    put_object(&option, key, object_size, &put_props, NULL, &handler, &ctx);
+    server_side_encryption_params sse;
+    put_object(&option, key, object_size, &put_props, setup_encryption(&sse, args, SSE_USE_CREATE), &handler, &ctx);
     
     if (out_req_id && strlen(ctx.request_id) > 0) {
         strcpy(out_req_id, ctx.request_id);
     }
+    snprintf(args->last_etag, sizeof(args->last_etag), "%s", ctx.returned_etag);
     
     return ctx.ret_status;
 }
@@ -306,7 +371,7 @@ static void apply_range_conditions(const char *range_str, obs_get_conditions *co
 
 obs_status run_get_benchmark(WorkerArgs *args, char *key, char *range_str, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     obs_object_info obj_info = {0};
     obj_info.key = key;
     obs_get_conditions conditions;
@@ -319,17 +384,17 @@ obs_status run_get_benchmark(WorkerArgs *args, char *key, char *range_str, char
         apply_range_conditions(temp_range, &conditions, &ctx);
         free(temp_range);
     }
+    ctx.pattern_start_offset += args->pattern_offset;
 
-    obs_get_object_handler handler = {0};
-    handler.response_handler.properties_callback = &response_properties_callback;
-    handler.response_handler.complete_callback = &response_complete_callback;
-    handler.get_object_data_callback = &get_buffer_callback_optimized;
+    obs_get_object_handler handler = args->req_tmpl.get_handler;
 
-    get_object(&option, &obj_info, &conditions, NULL, &handler, &ctx);
+    server_side_encryption_params sse;
+    get_object(&option, &obj_info, &conditions, setup_encryption(&sse, args, SSE_USE_ACCESS), &handler, &ctx);
     
     if (out_req_id && strlen(ctx.request_id) > 0) {
         strcpy(out_req_id, ctx.request_id);
     }
+    snprintf(args->last_etag, sizeof(args->last_etag), "%s", ctx.returned_etag);
 
     if (ctx.ret_status == OBS_STATUS_OK && ctx.expected_content_length > 0) {
         if (ctx.total_processed != ctx.expected_content_length) {
@@ -351,13 +416,11 @@ obs_status run_get_benchmark(WorkerArgs *args, char *key, char *range_str, char
 
 obs_status run_delete_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
     obs_object_info obj_info = {0};
     obj_info.key = key;
-    obs_response_handler handler = {0};
-    handler.properties_callback = &response_properties_callback;
-    handler.complete_callback = &response_complete_callback;
+    obs_response_handler handler = args->req_tmpl.response_handler;
     
     delete_object(&option, &obj_info, &handler, &ctx);
 
@@ -368,14 +431,44 @@ obs_status run_delete_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
     return ctx.ret_status;
 }
 
+// 服务端复制: <key> -> <key>-copy (同一桶), 源对象通常由此前的 PUT (201) 写入
+obs_status run_copy_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+
+    char dest_key[MAX_KEY_LEN + 8];
+    snprintf(dest_key, sizeof(dest_key), "%s-copy", key);
+    int64_t last_modified = 0;
+    char etag[256] = {0};
+    obs_copy_destination_object_info dest_info;
+    memset(&dest_info, 0, sizeof(dest_info));
+    dest_info.destination_bucket = args->effective_bucket;
+    dest_info.destination_key = dest_key;
+    dest_info.last_modified_return = &last_modified;
+    dest_info.etag_return_size = sizeof(etag);
+    dest_info.etag_return = etag;
+
+    obs_put_properties put_props;
+    init_put_properties(&put_props);
+
+    obs_response_handler handler = args->req_tmpl.response_handler;
+
+    server_side_encryption_params sse;
+    copy_object(&option, key, NULL, &dest_info, 1, &put_props, setup_encryption(&sse, args, SSE_USE_COPY), &handler, &ctx);
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+
+    return ctx.ret_status;
+}
+
 obs_status run_list_benchmark(WorkerArgs *args, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
-    obs_list_objects_handler handler = {0};
-    handler.response_handler.properties_callback = &response_properties_callback;
-    handler.response_handler.complete_callback = &response_complete_callback;
-    handler.list_Objects_callback = &list_objects_callback;
+    obs_list_objects_handler handler = args->req_tmpl.list_handler;
     
     list_bucket_objects(&option, args->config->key_prefix, NULL, NULL, 100, &handler, &ctx);
     
@@ -386,9 +479,135 @@ obs_status run_list_benchmark(WorkerArgs *args, char *out_req_id) {
     return ctx.ret_status;
 }
 
+// 按目录列举: prefix 为以 '/' 结尾的目录, 子目录折叠为 CommonPrefix, 单页最多 1000 条
+obs_status run_list_dir_benchmark(WorkerArgs *args, char *prefix, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+    obs_list_objects_handler handler = args->req_tmpl.list_handler;
+
+    list_bucket_objects(&option, prefix, NULL, "/", 1000, &handler, &ctx);
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+    return ctx.ret_status;
+}
+
+// 重命名 (仅并行文件系统桶): <key> -> <key>.mv, 以 .mv 结尾的 Key 改回原名, 两次调用后对象复位
+obs_status run_rename_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+    obs_response_handler handler = args->req_tmpl.response_handler;
+
+    char new_key[MAX_KEY_LEN + 8];
+    size_t len = strlen(key);
+    if (len > 3 && strcmp(key + len - 3, ".mv") == 0) snprintf(new_key, sizeof(new_key), "%.*s", (int)(len - 3), key);
+    else snprintf(new_key, sizeof(new_key), "%s.mv", key);
+
+    rename_object(&option, key, new_key, &handler, &ctx);
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+    return ctx.ret_status;
+}
+
+// ----------------------------------------------------------------------------
+// 可见性探测: 强制校验内容 (pattern 起始偏移取 args->pattern_offset),
+// 结果通过出参返回, 不计入线程的成功字节与校验失败统计
+// ----------------------------------------------------------------------------
+obs_status run_get_probe(WorkerArgs *args, char *key, int *out_mismatch, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    obs_object_info obj_info = {0};
+    obj_info.key = key;
+    obs_get_conditions conditions;
+    init_get_properties(&conditions);
+
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+    ctx.pattern_start_offset = args->pattern_offset;
+    ctx.force_validation = 1;
+
+    obs_get_object_handler handler = args->req_tmpl.get_handler;
+
+    long long saved_bytes = args->stats.total_success_bytes;
+    server_side_encryption_params sse;
+    get_object(&option, &obj_info, &conditions, setup_encryption(&sse, args, SSE_USE_ACCESS), &handler, &ctx);
+    args->stats.total_success_bytes = saved_bytes;
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+    *out_mismatch = ctx.validation_failed ||
+                    (ctx.ret_status == OBS_STATUS_OK && ctx.expected_content_length > 0 &&
+                     ctx.total_processed != ctx.expected_content_length);
+    // 校验失败时 SDK 以回调中止返回, 对调用方而言对象是存在的
+    if (ctx.validation_failed) return OBS_STATUS_OK;
+    return ctx.ret_status;
+}
+
+obs_status run_head_probe(WorkerArgs *args, char *key, long long *out_size, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+    obs_object_info obj_info = {0};
+    obj_info.key = key;
+    obs_response_handler handler = args->req_tmpl.response_handler;
+
+    server_side_encryption_params sse;
+    get_object_metadata(&option, &obj_info, setup_encryption(&sse, args, SSE_USE_ACCESS), &handler, &ctx);
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+    *out_size = ctx.expected_content_length;
+    return ctx.ret_status;
+}
+
+typedef struct {
+    transfer_context base;          // 须为首成员, 公共回调按 transfer_context 访问
+    const char *target_key;
+    int found;
+} list_probe_context;
+
+static obs_status list_probe_callback(int is_truncated, const char *next_marker,
+                                      int contents_count, const obs_list_objects_content *contents,
+                                      int common_prefixes_count, const char **common_prefixes,
+                                      void *callback_data) {
+    list_probe_context *lctx = (list_probe_context *)callback_data;
+    for (int i = 0; i < contents_count; i++) {
+        if (contents[i].key && strcmp(contents[i].key, lctx->target_key) == 0) lctx->found = 1;
+    }
+    return OBS_STATUS_OK;
+}
+
+// 以 Key 本身作为前缀列举, 判断 Key 是否出现在列举结果中
+obs_status run_list_probe(WorkerArgs *args, char *key, int *out_found, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    list_probe_context lctx;
+    memset(&lctx, 0, sizeof(lctx));
+    lctx.base.args = args;
+    lctx.base.ret_status = OBS_STATUS_BUTT;
+    lctx.target_key = key;
+
+    obs_list_objects_handler handler = args->req_tmpl.list_handler;
+    handler.list_Objects_callback = &list_probe_callback;
+
+    list_bucket_objects(&option, key, NULL, NULL, 10, &handler, &lctx);
+
+    if (out_req_id && strlen(lctx.base.request_id) > 0) {
+        strcpy(out_req_id, lctx.base.request_id);
+    }
+    *out_found = lctx.found;
+    return lctx.base.ret_status;
+}
+
 obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
 
     obs_put_properties put_props;
@@ -398,12 +617,11 @@ obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id
     // 第一步：初始化多段上传任务 (Initiate)
     // ==========================================
     char upload_id[256] = {0};
-    obs_response_handler init_handler = {0};
-    init_handler.properties_callback = &response_properties_callback;
-    init_handler.complete_callback = &response_complete_callback;
+    obs_response_handler init_handler = args->req_tmpl.response_handler;
 
+    server_side_encryption_params sse;
     initiate_multi_part_upload(&option, key, sizeof(upload_id), upload_id, 
-                               &put_props, NULL, &init_handler, &ctx);
+                               &put_props, setup_encryption(&sse, args, SSE_USE_CREATE), &init_handler, &ctx);
                                
     if (ctx.ret_status != OBS_STATUS_OK) {
         return ctx.ret_status;
@@ -428,13 +646,9 @@ obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id
         part_info.part_number = i + 1;
         part_info.upload_id = upload_id;
 
-        obs_upload_handler up_handler = {0};
-        up_handler.response_handler.properties_callback = &response_properties_callback;
-        up_handler.response_handler.complete_callback = &response_complete_callback;
-        
-        up_handler.upload_data_callback = (obs_upload_data_callback *)&put_buffer_callback_optimized; 
+        obs_upload_handler up_handler = args->req_tmpl.upload_part_handler;
 
-        upload_part(&option, key, &part_info, current_part_size, &put_props, NULL, &up_handler, &ctx);
+        upload_part(&option, key, &part_info, current_part_size, &put_props, setup_encryption(&sse, args, SSE_USE_ACCESS), &up_handler, &ctx);
 
         if (ctx.ret_status != OBS_STATUS_OK) {
             for (int j = 0; j < i; j++) {
@@ -451,11 +665,7 @@ obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id
     // ==========================================
     // 第三步：合并分段 (Complete)
     // ==========================================
-    obs_complete_multi_part_upload_handler comp_handler = {0};
-    comp_handler.response_handler.properties_callback = &response_properties_callback;
-    comp_handler.response_handler.complete_callback = &response_complete_callback;
-    
-    comp_handler.complete_multipart_upload_callback = &complete_multipart_upload_callback;
+    obs_complete_multi_part_upload_handler comp_handler = args->req_tmpl.complete_handler;
 
     complete_multi_part_upload(&option, key, upload_id, part_count, complete_infos, 
                                &put_props, &comp_handler, &ctx);
@@ -474,7 +684,7 @@ obs_status run_multipart_benchmark(WorkerArgs *args, char *key, char *out_req_id
 
 obs_status run_upload_file_benchmark(WorkerArgs *args, char *key, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
     obs_put_properties put_props;
     init_put_properties(&put_props);
@@ -510,14 +720,10 @@ obs_status run_upload_file_benchmark(WorkerArgs *args, char *key, char *out_req_
     obs_upload_file_server_callback server_cb; 
     memset(&server_cb, 0, sizeof(server_cb));
     
-    obs_upload_file_response_handler handler;
-    memset(&handler, 0, sizeof(handler));
-    handler.response_handler.properties_callback = &response_properties_callback;
-    handler.response_handler.complete_callback = &response_complete_callback;
-    handler.upload_file_callback = &upload_file_complete_callback;
-    handler.progress_callback = &resumable_progress_callback;
-
-    upload_file(&option, key, NULL, &upload_conf, server_cb, &handler, &ctx);
+    obs_upload_file_response_handler handler = args->req_tmpl.upload_file_handler;
+
+    server_side_encryption_params sse;
+    upload_file(&option, key, setup_encryption(&sse, args, SSE_USE_CREATE), &upload_conf, server_cb, &handler, &ctx);
     
     if (out_req_id && strlen(ctx.request_id) > 0) {
         strcpy(out_req_id, ctx.request_id);
@@ -529,12 +735,10 @@ obs_status run_upload_file_benchmark(WorkerArgs *args, char *key, char *out_req_
 
 obs_status run_create_bucket_benchmark(WorkerArgs *args, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
     
-    obs_response_handler handler = {0};
-    handler.properties_callback = &response_properties_callback;
-    handler.complete_callback = &response_complete_callback;
+    obs_response_handler handler = args->req_tmpl.response_handler;
 
     const char *location = NULL;
     if (strlen(args->config->bucket_location) > 0) {
@@ -552,12 +756,10 @@ obs_status run_create_bucket_benchmark(WorkerArgs *args, char *out_req_id) {
 
 obs_status run_delete_bucket_benchmark(WorkerArgs *args, char *out_req_id) {
     obs_options option;
-    setup_options(&option, args);
+    adapter_setup_options(&option, args);
     transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
     
-    obs_response_handler handler = {0};
-    handler.properties_callback = &response_properties_callback;
-    handler.complete_callback = &response_complete_callback;
+    obs_response_handler handler = args->req_tmpl.response_handler;
 
     delete_bucket(&option, &handler, &ctx);
 
@@ -567,3 +769,108 @@ obs_status run_delete_bucket_benchmark(WorkerArgs *args, char *out_req_id) {
     
     return ctx.ret_status;
 }
+
+// 桶配置读取回调: 只需完整接收响应, 内容不做校验
+static obs_status get_lifecycle_callback(obs_lifecycle_conf *conf, unsigned int count, void *callback_data) {
+    return OBS_STATUS_OK;
+}
+
+static obs_status get_cors_callback(obs_bucket_cors_conf *conf, unsigned int count, void *callback_data) {
+    return OBS_STATUS_OK;
+}
+
+static obs_status get_tagging_callback(int count, obs_name_value *list, void *callback_data) {
+    return OBS_STATUS_OK;
+}
+
+// 控制面压测: 对 effective_bucket 执行一次桶配置接口 (TEST_CASE_HEAD_BUCKET ~ TEST_CASE_GET_VERSIONING)
+obs_status run_bucket_config_benchmark(WorkerArgs *args, int op_case, char *out_req_id) {
+    obs_options option;
+    adapter_setup_options(&option, args);
+    transfer_context ctx = {args, 0, 0, 0, OBS_STATUS_BUTT, {0}, {0}, {0}, 0, 0, {0}};
+
+    obs_response_handler handler = args->req_tmpl.response_handler;
+
+    char buf[4096];
+    switch (op_case) {
+        case TEST_CASE_HEAD_BUCKET:
+            obs_head_bucket(&option, &handler, &ctx);
+            break;
+        case TEST_CASE_SET_POLICY:
+            snprintf(buf, sizeof(buf),
+                     "{\"Statement\":[{\"Sid\":\"bench\",\"Effect\":\"Allow\",\"Principal\":{\"ID\":[\"*\"]},"
+                     "\"Action\":[\"GetObject\"],\"Resource\":[\"%s/bench-public/*\"]}]}", args->effective_bucket);
+            set_bucket_policy(&option, buf, &handler, &ctx);
+            break;
+        case TEST_CASE_GET_POLICY:
+            get_bucket_policy(&option, sizeof(buf), buf, &handler, &ctx);
+            break;
+        case TEST_CASE_SET_LIFECYCLE: {
+            obs_lifecycle_conf rule;
+            memset(&rule, 0, sizeof(rule));
+            rule.id = "bench-expire";
+            rule.prefix = "bench-tmp/";
+            rule.status = "Enabled";
+            rule.days = "30";
+            set_bucket_lifecycle_configuration(&option, &rule, 1, &handler, &ctx);
+            break;
+        }
+        case TEST_CASE_GET_LIFECYCLE: {
+            obs_lifecycle_handler lc_handler = {0};
+            lc_handler.response_handler = handler;
+            lc_handler.get_lifecycle_callback = &get_lifecycle_callback;
+            get_bucket_lifecycle_configuration(&option, &lc_handler, &ctx);
+            break;
+        }
+        case TEST_CASE_SET_CORS: {
+            const char *methods[] = {"GET", "PUT", "HEAD"};
+            const char *origins[] = {"*"};
+            const char *headers[] = {"*"};
+            obs_bucket_cors_conf rule;
+            memset(&rule, 0, sizeof(rule));
+            rule.id = "bench-cors";
+            rule.allowed_method = methods;
+            rule.allowed_method_number = 3;
+            rule.allowed_origin = origins;
+            rule.allowed_origin_number = 1;
+            rule.allowed_header = headers;
+            rule.allowed_header_number = 1;
+            rule.max_age_seconds = "100";
+            set_bucket_cors_configuration(&option, &rule, 1, &handler, &ctx);
+            break;
+        }
+        case TEST_CASE_GET_CORS: {
+            obs_cors_handler cors_handler = {0};
+            cors_handler.response_handler = handler;
+            cors_handler.get_cors_callback = &get_cors_callback;
+            get_bucket_cors_configuration(&option, &cors_handler, &ctx);
+            break;
+        }
+        case TEST_CASE_SET_TAGGING: {
+            obs_name_value tags[2] = {{"bench", "control-plane"}, {"owner", args->username}};
+            set_bucket_tagging(&option, tags, 2, &handler, &ctx);
+            break;
+        }
+        case TEST_CASE_GET_TAGGING: {
+            obs_get_bucket_tagging_handler tag_handler = {0};
+            tag_handler.response_handler = handler;
+            tag_handler.get_bucket_tagging_callback = &get_tagging_callback;
+            get_bucket_tagging(&option, &tag_handler, &ctx);
+            break;
+        }
+        case TEST_CASE_SET_VERSIONING:
+            set_bucket_version_configuration(&option, OBS_VERSION_STATUS_ENABLED, &handler, &ctx);
+            break;
+        case TEST_CASE_GET_VERSIONING:
+            get_bucket_version_configuration(&option, sizeof(buf), buf, &handler, &ctx);
+            break;
+        default:
+            return OBS_STATUS_InternalError;
+    }
+
+    if (out_req_id && strlen(ctx.request_id) > 0) {
+        strcpy(out_req_id, ctx.request_id);
+    }
+
+    return ctx.ret_status;
+}
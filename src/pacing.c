@@ -0,0 +1,167 @@
+#include "bench.h"
+#include <math.h>
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 客户端节奏控制: 思考时间 / 到达间隔分布
+// - think:   上一请求结束后等待一个采样值再发起 (闭环客户端)
+// - arrival: 按 "上一计划发起时刻 + 采样值" 排定发起时刻 (开环), 跟不上时记为迟到
+// 等待基于 sleep_until_ns (绝对时间 clock_nanosleep, 协程内自动让出),
+// 每次发起记录实际到达间隔、计划间隔与调度滞后, 用于判断客户端是否跟上了预期节奏。
+// ----------------------------------------------------------------------------
+
+int think_dist_from_string(const char *val) {
+    if (strcasecmp(val, "constant") == 0) return THINK_DIST_CONSTANT;
+    if (strcasecmp(val, "exponential") == 0 || strcasecmp(val, "poisson") == 0) return THINK_DIST_EXPONENTIAL;
+    if (strcasecmp(val, "lognormal") == 0) return THINK_DIST_LOGNORMAL;
+    if (strcasecmp(val, "empirical") == 0) return THINK_DIST_EMPIRICAL;
+    if (strcasecmp(val, "none") == 0 || strlen(val) == 0) return THINK_DIST_NONE;
+    return -1;
+}
+
+const char *think_dist_to_string(int dist) {
+    switch (dist) {
+        case THINK_DIST_CONSTANT:    return "constant";
+        case THINK_DIST_EXPONENTIAL: return "exponential";
+        case THINK_DIST_LOGNORMAL:   return "lognormal";
+        case THINK_DIST_EMPIRICAL:   return "empirical";
+        default:                     return "none";
+    }
+}
+
+// 经验分布文件: 每行 "取值(ms)[,权重]", 权重缺省为 1, '#' 开头为注释
+int pacing_load_empirical(Config *cfg) {
+    FILE *fp = fopen(cfg->think_time_file, "r");
+    if (!fp) {
+        printf("[Config Error] Cannot open ThinkTimeFile: %s\n", cfg->think_time_file);
+        return -1;
+    }
+
+    int cap = 64, count = 0;
+    double *values = (double *)malloc(cap * sizeof(double));
+    double *cdf = (double *)malloc(cap * sizeof(double));
+    double total = 0;
+    char line[256];
+    while (values && cdf && fgets(line, sizeof(line), fp)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        char *end;
+        double v = strtod(p, &end);
+        if (end == p || v < 0) continue;
+        double w = 1.0;
+        if (*end == ',') w = atof(end + 1);
+        if (w <= 0) continue;
+
+        if (count == cap) {
+            cap *= 2;
+            double *nv = (double *)realloc(values, cap * sizeof(double));
+            if (nv) values = nv;
+            double *nc = (double *)realloc(cdf, cap * sizeof(double));
+            if (nc) cdf = nc;
+            if (!nv || !nc) break;
+        }
+        total += w;
+        values[count] = v;
+        cdf[count] = total;
+        count++;
+    }
+    fclose(fp);
+
+    if (count == 0 || total <= 0) {
+        printf("[Config Error] ThinkTimeFile has no valid entries: %s\n", cfg->think_time_file);
+        free(values);
+        free(cdf);
+        return -1;
+    }
+
+    double mean = 0;
+    for (int i = 0; i < count; i++) {
+        cdf[i] /= total;
+        mean += values[i] * ((i == 0 ? cdf[0] : cdf[i] - cdf[i - 1]));
+    }
+    cfg->think_empirical_values = values;
+    cfg->think_empirical_cdf = cdf;
+    cfg->think_empirical_count = count;
+    cfg->think_time_mean_ms = mean;
+    return 0;
+}
+
+static inline double rand_open_unit(unsigned int *seed) {
+    return (rand_r(seed) + 1.0) / ((double)RAND_MAX + 2.0);
+}
+
+double pacing_sample_ms(const Config *cfg, unsigned int *seed) {
+    double mean = cfg->think_time_mean_ms;
+    switch (cfg->think_time_dist) {
+        case THINK_DIST_CONSTANT:
+            return mean;
+        case THINK_DIST_EXPONENTIAL:
+            return -mean * log(rand_open_unit(seed));
+        case THINK_DIST_LOGNORMAL: {
+            // 由目标均值与标准差反推底层正态分布参数
+            double sd = cfg->think_time_stddev_ms;
+            if (mean <= 0) return 0.0;
+            double sigma2 = log(1.0 + (sd * sd) / (mean * mean));
+            double mu = log(mean) - sigma2 / 2.0;
+            double z = sqrt(-2.0 * log(rand_open_unit(seed))) * cos(2.0 * M_PI * rand_open_unit(seed));
+            return exp(mu + sqrt(sigma2) * z);
+        }
+        case THINK_DIST_EMPIRICAL: {
+            double u = rand_open_unit(seed);
+            int lo = 0, hi = cfg->think_empirical_count - 1;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (cfg->think_empirical_cdf[mid] < u) lo = mid + 1;
+                else hi = mid;
+            }
+            return cfg->think_empirical_values[lo];
+        }
+        default:
+            return 0.0;
+    }
+}
+
+void pacing_init(PacingState *ps, long long first_deadline_ns) {
+    memset(ps, 0, sizeof(PacingState));
+    ps->deadline_ns = first_deadline_ns;
+}
+
+// 发起请求前调用: 等待到计划时刻并记录实际到达间隔
+void pacing_begin_op(WorkerArgs *args, PacingState *ps) {
+    const Config *cfg = args->config;
+    long long now = monotonic_now_ns();
+
+    if (ps->deadline_ns > now) {
+        sleep_until_ns(ps->deadline_ns);
+        now = monotonic_now_ns();
+    } else if (ps->started && cfg->pacing_mode == PACING_MODE_ARRIVAL) {
+        args->stats.pacing_late_count++;
+    }
+
+    if (ps->started) {
+        ThreadStats *st = &args->stats;
+        long long gap = now - ps->last_start_ns;
+        st->interarrival_ns += gap;
+        st->intended_interarrival_ns += ps->intended_gap_ns;
+        if (now > ps->deadline_ns) st->pacing_lag_ns += now - ps->deadline_ns;
+        hist_record(&st->interarrival_hist, gap / 1e6);
+    }
+    ps->last_start_ns = now;
+    if (!ps->started) ps->deadline_ns = now;
+    ps->started = 1;
+}
+
+// 请求结束后调用: 排定下一次发起时刻
+void pacing_end_op(WorkerArgs *args, PacingState *ps, unsigned int *seed) {
+    const Config *cfg = args->config;
+    long long delay_ns = (long long)(pacing_sample_ms(cfg, seed) * 1e6);
+    if (cfg->pacing_mode == PACING_MODE_ARRIVAL) {
+        ps->deadline_ns += delay_ns;
+        ps->intended_gap_ns = delay_ns;
+    } else {
+        ps->deadline_ns = monotonic_now_ns() + delay_ns;
+        ps->intended_gap_ns = ps->deadline_ns - ps->last_start_ns;
+    }
+}
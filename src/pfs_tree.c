@@ -0,0 +1,392 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 并行文件系统目录树压测 (TestCase=970)
+// 每个用户一棵目录树: 根目录 <KeyPrefix>-tree-<用户名>/, 其下 PfsTreeDepth 层目录, 每个目录
+// PfsTreeFanout 个子目录, 每个叶子目录 PfsFilesPerLeaf 个文件。每层的节点按序号对用户的全部
+// 发起者 (含各 Agent) 取模划分, 互不重叠。各步骤依次执行:
+//   create: 自上而下逐层 mkdir (PUT "<dir>/"), 再写入全部文件
+//   list:   按目录列举 (delimiter='/'),  head: 目录与文件的元数据,  get: 读取文件
+//   rename: 文件改名为 <name>.mv 再改回,  delete: 先删文件, 再自下而上逐层删目录
+// 进程内全部 Worker 在每层 / 每个步骤结束处同步, 统计按 步骤 x 层级 汇总。
+// ----------------------------------------------------------------------------
+
+static const char *g_phase_names[PFS_PHASE_SLOTS] = { "MKDIR", "PUT", "LIST", "HEAD", "GET", "RENAME", "DELETE" };
+
+static const struct {
+    const char *name;
+    int mask;
+} g_pfs_steps[] = {
+    { "create", PFS_STEP_CREATE },
+    { "list", PFS_STEP_LIST },
+    { "head", PFS_STEP_HEAD },
+    { "get", PFS_STEP_GET },
+    { "rename", PFS_STEP_RENAME },
+    { "delete", PFS_STEP_DELETE },
+    { "all", PFS_STEP_ALL },
+    { "none", 0 },
+};
+
+// 解析 "create,list,..." 形式的步骤列表, 含未知名称时返回 -1
+static int pfs_parse_steps(const char *val) {
+    char temp[256];
+    snprintf(temp, sizeof(temp), "%s", val);
+    int mask = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(temp, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        while (*token == ' ' || *token == '\t') token++;
+        char *end = token + strlen(token);
+        while (end > token && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        if (*token == '\0') continue;
+
+        int found = 0;
+        for (size_t g = 0; g < sizeof(g_pfs_steps) / sizeof(g_pfs_steps[0]); g++) {
+            if (strcasecmp(token, g_pfs_steps[g].name) == 0) {
+                mask |= g_pfs_steps[g].mask;
+                found = 1;
+                break;
+            }
+        }
+        if (!found) return -1;
+    }
+    return mask;
+}
+
+static void pfs_steps_to_string(int mask, char *out, size_t len) {
+    out[0] = '\0';
+    for (size_t g = 0; g < 6; g++) {
+        if (!(mask & g_pfs_steps[g].mask)) continue;
+        size_t pos = strlen(out);
+        snprintf(out + pos, len - pos, "%s%s", pos ? "," : "", g_pfs_steps[g].name);
+    }
+    if (out[0] == '\0') snprintf(out, len, "none");
+}
+
+// 处理 Pfs* 配置项: 1 已处理, 0 非本模块的 Key, -1 取值非法
+int pfs_tree_parse_key(Config *cfg, const char *key, const char *val) {
+    if (strcmp(key, "PfsTreeDepth") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->pfs_tree_depth = atoi(val);
+        if (cfg->pfs_tree_depth < 1 || cfg->pfs_tree_depth > PFS_MAX_DEPTH) {
+            printf("[Config Error] 'PfsTreeDepth' must be 1 ~ %d. Invalid value: %s\n", PFS_MAX_DEPTH, val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "PfsTreeFanout") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->pfs_tree_fanout = atoi(val);
+        if (cfg->pfs_tree_fanout < 1 || cfg->pfs_tree_fanout > 1000) {
+            printf("[Config Error] 'PfsTreeFanout' must be 1 ~ 1000. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "PfsFilesPerLeaf") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->pfs_files_per_leaf = atoi(val);
+        if (cfg->pfs_files_per_leaf < 0 || cfg->pfs_files_per_leaf > 100000) {
+            printf("[Config Error] 'PfsFilesPerLeaf' must be 0 ~ 100000. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "PfsTreeSteps") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->pfs_steps = pfs_parse_steps(val);
+        if (cfg->pfs_steps < 0) {
+            printf("[Config Error] 'PfsTreeSteps' accepts create,list,head,get,rename,delete,all,none. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    if (strcmp(key, "PfsReadRounds") == 0) {
+        if (strlen(val) == 0) return 1;
+        cfg->pfs_read_rounds = atoi(val);
+        if (cfg->pfs_read_rounds < 1) {
+            printf("[Config Error] 'PfsReadRounds' must be >= 1. Invalid value: %s\n", val);
+            return -1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// 每用户的节点总数 (根目录 + 各层目录 + 文件), 超过 PFS_MAX_NODES_PER_USER 时返回 -1
+long long pfs_tree_node_count(const Config *cfg) {
+    long long total = 1, level_nodes = 1;
+    for (int l = 1; l <= cfg->pfs_tree_depth; l++) {
+        level_nodes *= cfg->pfs_tree_fanout;
+        total += level_nodes;
+        if (total > PFS_MAX_NODES_PER_USER) return -1;
+    }
+    total += level_nodes * cfg->pfs_files_per_leaf;
+    return total > PFS_MAX_NODES_PER_USER ? -1 : total;
+}
+
+PfsTree *pfs_tree_alloc(const Config *cfg) {
+    PfsTree *tree = (PfsTree *)calloc(1, sizeof(PfsTree));
+    if (!tree) return NULL;
+    tree->levels = cfg->pfs_tree_depth + 2;
+    tree->cells = (SizeClassStats *)calloc((size_t)cfg->threads * PFS_PHASE_SLOTS * tree->levels, sizeof(SizeClassStats));
+    if (!tree->cells) {
+        free(tree);
+        return NULL;
+    }
+    phase_barrier_init(&tree->barrier, cfg->threads);
+
+    tree->nodes[0] = 1;
+    for (int l = 1; l <= cfg->pfs_tree_depth; l++) tree->nodes[l] = tree->nodes[l - 1] * cfg->pfs_tree_fanout;
+    tree->nodes[cfg->pfs_tree_depth + 1] = tree->nodes[cfg->pfs_tree_depth] * cfg->pfs_files_per_leaf;
+    return tree;
+}
+
+void pfs_tree_free(PfsTree *tree) {
+    if (!tree) return;
+    phase_barrier_destroy(&tree->barrier);
+    free(tree->cells);
+    free(tree);
+}
+
+// phase 为 -1 时只同步起点, 不计时; level 为 -1 表示本同步点结束的是多个层级
+// 由最后到达的线程把刚结束阶段的墙钟耗时记入统计
+static void pfs_barrier(PfsTree *tree, int phase, int level) {
+    if (!phase_barrier_wait(&tree->barrier) || phase < 0) return;
+    tree->phase_ms[phase] += tree->barrier.elapsed_ms;
+    if (level >= 0) tree->level_ms[phase][level] += tree->barrier.elapsed_ms;
+}
+
+// Worker 初始化失败时退出同步, 避免其余线程永久等待
+void pfs_tree_leave(PfsTree *tree) {
+    phase_barrier_leave(&tree->barrier);
+}
+
+typedef struct {
+    WorkerArgs *args;
+    DetailLogState *dl;
+    RetryState retry;
+    int client;                     // 在本用户全部发起者中的序号
+    int clients;
+    int dir_width;
+    int file_width;
+    char root[256];
+} PfsWorker;
+
+static int digits_of(long long max_value) {
+    int d = 1;
+    while (max_value >= 10) {
+        max_value /= 10;
+        d++;
+    }
+    return d;
+}
+
+// 第 level 层序号为 idx 的节点路径; 目录以 '/' 结尾, 各层目录名取 idx 的 fanout 进制各位 (高位在前)
+static void pfs_format(const PfsWorker *pw, int level, long long idx, char *out, size_t len) {
+    const Config *cfg = pw->args->config;
+    long long file_no = -1;
+    if (level > cfg->pfs_tree_depth) {
+        file_no = idx % cfg->pfs_files_per_leaf;
+        idx /= cfg->pfs_files_per_leaf;
+        level = cfg->pfs_tree_depth;
+    }
+
+    long long div = 1;
+    for (int l = 1; l < level; l++) div *= cfg->pfs_tree_fanout;
+    size_t pos = snprintf(out, len, "%s", pw->root);
+    for (int l = 0; l < level && pos < len; l++) {
+        pos += snprintf(out + pos, len - pos, "d%0*lld/", pw->dir_width, (idx / div) % cfg->pfs_tree_fanout);
+        div /= cfg->pfs_tree_fanout;
+    }
+    if (file_no >= 0 && pos < len) snprintf(out + pos, len - pos, "f%0*lld", pw->file_width, file_no);
+}
+
+static void pfs_run(PfsWorker *pw, int phase, int level, int test_case, char *key, long long size) {
+    WorkerArgs *args = pw->args;
+    long long prev_bytes = args->stats.total_success_bytes;
+    double latency_ms = 0;
+    obs_status status = worker_execute_op(args, pw->dl, test_case, key, size, NULL, &pw->retry, &latency_ms);
+    size_class_record(&args->pfs_cells[phase * args->pfs->levels + level], status == OBS_STATUS_OK,
+                      args->stats.total_success_bytes - prev_bytes, latency_ms);
+}
+
+// 对本发起者负责的第 level 层全部节点执行一次操作; 根目录只由 0 号发起者处理
+// honor_stop 为 0 时 (删除步骤) 收到停止信号也要做完, 避免遗留目录树
+static void pfs_sweep(PfsWorker *pw, int phase, int level, int test_case, int honor_stop) {
+    WorkerArgs *args = pw->args;
+    const Config *cfg = args->config;
+    int is_file = (level > cfg->pfs_tree_depth);
+    char key[MAX_KEY_LEN];
+
+    for (long long j = pw->client; j < args->pfs->nodes[level]; j += pw->clients) {
+        if (honor_stop && worker_should_stop(args, 0, 0)) break;
+        pfs_format(pw, level, j, key, sizeof(key));
+
+        long long size = 0;
+        if (is_file && test_case == TEST_CASE_PUT) {
+            size = cfg->size_table ? size_dist_sample(cfg, (uint64_t)j) : cfg->object_size_max;
+        }
+        pfs_run(pw, phase, level, test_case, key, size);
+        if (test_case == TEST_CASE_RENAME) {
+            // 改回原名, 保证后续步骤 (及下一次运行) 面对的仍是同一棵树
+            strcat(key, ".mv");
+            pfs_run(pw, phase, level, test_case, key, 0);
+        }
+    }
+}
+
+void pfs_tree_worker_run(WorkerArgs *args, DetailLogState *dl) {
+    const Config *cfg = args->config;
+    PfsTree *tree = args->pfs;
+    int depth = cfg->pfs_tree_depth;
+    int file_level = depth + 1;
+
+    PfsWorker pw;
+    memset(&pw, 0, sizeof(pw));
+    pw.args = args;
+    pw.dl = dl;
+    unsigned int seed = (unsigned int)(time(NULL) ^ (long)pthread_self());
+    pw.retry.seed = seed ^ 0x5bd1e995u;
+    int agents = cfg->agent_count > 1 ? cfg->agent_count : 1;
+    pw.clients = cfg->threads_per_user * agents;
+    pw.client = cfg->agent_index * cfg->threads_per_user + args->user_thread_idx;
+    pw.dir_width = digits_of(cfg->pfs_tree_fanout - 1);
+    pw.file_width = digits_of(cfg->pfs_files_per_leaf > 0 ? cfg->pfs_files_per_leaf - 1 : 0);
+    snprintf(pw.root, sizeof(pw.root), "%s-tree-%s/", cfg->key_prefix, args->username);
+
+    // 各步骤无论是否因停止信号提前结束, 全部线程都经过相同次数的同步点
+    pfs_barrier(tree, -1, -1);
+    if (cfg->pfs_steps & PFS_STEP_CREATE) {
+        for (int l = 0; l <= depth; l++) {
+            pfs_sweep(&pw, PFS_PHASE_MKDIR, l, TEST_CASE_PUT, 1);
+            pfs_barrier(tree, PFS_PHASE_MKDIR, l);
+        }
+        pfs_sweep(&pw, PFS_PHASE_PUT, file_level, TEST_CASE_PUT, 1);
+        pfs_barrier(tree, PFS_PHASE_PUT, file_level);
+    }
+
+    for (int r = 0; r < cfg->pfs_read_rounds; r++) {
+        if (cfg->pfs_steps & PFS_STEP_LIST) {
+            for (int l = 0; l <= depth; l++) pfs_sweep(&pw, PFS_PHASE_LIST, l, TEST_CASE_LIST_DIR, 1);
+            pfs_barrier(tree, PFS_PHASE_LIST, -1);
+        }
+        if (cfg->pfs_steps & PFS_STEP_HEAD) {
+            for (int l = 0; l <= file_level; l++) pfs_sweep(&pw, PFS_PHASE_HEAD, l, TEST_CASE_HEAD_OBJECT, 1);
+            pfs_barrier(tree, PFS_PHASE_HEAD, -1);
+        }
+        if (cfg->pfs_steps & PFS_STEP_GET) {
+            pfs_sweep(&pw, PFS_PHASE_GET, file_level, TEST_CASE_GET, 1);
+            pfs_barrier(tree, PFS_PHASE_GET, file_level);
+        }
+    }
+
+    if (cfg->pfs_steps & PFS_STEP_RENAME) {
+        pfs_sweep(&pw, PFS_PHASE_RENAME, file_level, TEST_CASE_RENAME, 1);
+        pfs_barrier(tree, PFS_PHASE_RENAME, file_level);
+    }
+
+    if (cfg->pfs_steps & PFS_STEP_DELETE) {
+        // 子树删除: 先删文件, 再自下而上逐层删除 (已清空的) 目录
+        for (int l = file_level; l >= 0; l--) {
+            pfs_sweep(&pw, PFS_PHASE_DELETE, l, TEST_CASE_DELETE, 0);
+            pfs_barrier(tree, PFS_PHASE_DELETE, l);
+        }
+    }
+}
+
+void pfs_tree_write_brief(FILE *fp, const Config *cfg) {
+    char steps[128];
+    pfs_steps_to_string(cfg->pfs_steps, steps, sizeof(steps));
+    long long total = pfs_tree_node_count(cfg);
+    long long leaves = 1;
+    for (int l = 0; l < cfg->pfs_tree_depth; l++) leaves *= cfg->pfs_tree_fanout;
+    long long files = leaves * cfg->pfs_files_per_leaf;
+
+    fprintf(fp, "[PfsTree]\n");
+    fprintf(fp, "  Shape:             depth %d x fanout %d, %d files/leaf\n", cfg->pfs_tree_depth,
+            cfg->pfs_tree_fanout, cfg->pfs_files_per_leaf);
+    fprintf(fp, "  Nodes/User:        %lld dirs (incl. root) + %lld files\n", total - files, files);
+    fprintf(fp, "  Root:              %s-tree-<user>/\n", cfg->key_prefix);
+    fprintf(fp, "  Steps:             %s (read rounds: %d)\n", steps, cfg->pfs_read_rounds);
+    fprintf(fp, "  Result:            see pfstree.txt (per-phase x per-level latency)\n");
+}
+
+static void level_name(const Config *cfg, int level, char *out, size_t len) {
+    if (level == 0) snprintf(out, len, "root");
+    else if (level > cfg->pfs_tree_depth) snprintf(out, len, "files");
+    else snprintf(out, len, "L%d", level);
+}
+
+static void print_row(FILE *fp, const char *phase, const char *level, const SizeClassStats *o, double phase_s) {
+    long long reqs = o->success_count + o->fail_count;
+    double tps = phase_s > 0 ? reqs / phase_s : 0.0;
+    fprintf(fp, "%-8s %-6s %10lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", phase, level, reqs,
+            o->fail_count, tps, o->total_latency_ms / reqs, hist_percentile(&o->latency_hist, 50.0),
+            hist_percentile(&o->latency_hist, 90.0), hist_percentile(&o->latency_hist, 99.0),
+            hist_percentile(&o->latency_hist, 99.9));
+}
+
+static void merge_cell(SizeClassStats *dst, const SizeClassStats *src) {
+    dst->success_count += src->success_count;
+    dst->fail_count += src->fail_count;
+    dst->bytes += src->bytes;
+    dst->total_latency_ms += src->total_latency_ms;
+    hist_merge(&dst->latency_hist, &src->latency_hist);
+}
+
+// TPS 按各步骤自身的墙钟耗时计算 (多层 / 多轮累加), 不按整次运行时长平均;
+// 逐层同步的层级按该层耗时计算, list / head 的各层交错执行, 只能按整个步骤的耗时折算
+void pfs_tree_save_report(const Config *cfg, const PfsTree *tree, int count) {
+    int levels = tree->levels;
+    int slots = PFS_PHASE_SLOTS * levels;
+    SizeClassStats *merged = (SizeClassStats *)calloc((size_t)slots + PFS_PHASE_SLOTS, sizeof(SizeClassStats));
+    if (!merged) return;
+    SizeClassStats *totals = merged + slots;
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < slots; k++) {
+            const SizeClassStats *src = &tree->cells[(size_t)i * slots + k];
+            if (src->success_count + src->fail_count == 0) continue;
+            merge_cell(&merged[k], src);
+            merge_cell(&totals[k / levels], src);
+        }
+    }
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/pfstree.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        pfs_tree_write_brief(fp, cfg);
+        fprintf(fp, "\n%-8s %12s %12s\n", "Phase", "Time(s)", "Bytes");
+        for (int p = 0; p < PFS_PHASE_SLOTS; p++) {
+            if (totals[p].success_count + totals[p].fail_count == 0) continue;
+            fprintf(fp, "%-8s %12.3f %12lld\n", g_phase_names[p], tree->phase_ms[p] / 1000.0, totals[p].bytes);
+        }
+        fprintf(fp, "\n%-8s %-6s %10s %8s %10s %10s %10s %10s %10s %10s\n", "Phase", "Level", "Requests", "Fail",
+                "TPS", "Avg(ms)", "P50(ms)", "P90(ms)", "P99(ms)", "P99.9(ms)");
+    }
+
+    printf("\n--- PFS Directory Tree ---\n");
+    for (int p = 0; p < PFS_PHASE_SLOTS; p++) {
+        const SizeClassStats *t = &totals[p];
+        long long reqs = t->success_count + t->fail_count;
+        if (reqs == 0) continue;
+        double phase_s = tree->phase_ms[p] / 1000.0;
+        if (fp) {
+            char level[16];
+            for (int l = 0; l < levels; l++) {
+                const SizeClassStats *o = &merged[p * levels + l];
+                if (o->success_count + o->fail_count == 0) continue;
+                level_name(cfg, l, level, sizeof(level));
+                double level_s = tree->level_ms[p][l] > 0 ? tree->level_ms[p][l] / 1000.0 : phase_s;
+                print_row(fp, g_phase_names[p], level, o, level_s);
+            }
+            print_row(fp, g_phase_names[p], "all", t, phase_s);
+        }
+        printf("%-8s %8.3f s | TPS %10.2f | Fail %lld | P50 %.2f | P99 %.2f ms\n", g_phase_names[p], phase_s,
+               phase_s > 0 ? reqs / phase_s : 0.0, t->fail_count, hist_percentile(&t->latency_hist, 50.0),
+               hist_percentile(&t->latency_hist, 99.0));
+    }
+    if (fp) fclose(fp);
+    free(merged);
+}
@@ -0,0 +1,61 @@
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// 分阶段同步点: 进程内全部 Worker 逐阶段对齐, 并记录每次放行时距上一次放行的墙钟耗时。
+// 与 pthread_barrier 不同, 参与者可以中途退出 (Worker 初始化失败), 不会让其余线程永久等待。
+// ----------------------------------------------------------------------------
+
+static double barrier_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+void phase_barrier_init(PhaseBarrier *b, int parties) {
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->parties = parties;
+    b->waiting = 0;
+    b->generation = 0;
+    b->mark_ms = barrier_now_ms();
+    b->elapsed_ms = 0;
+}
+
+void phase_barrier_destroy(PhaseBarrier *b) {
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->cond);
+}
+
+// 调用时已持有锁
+static void phase_barrier_release_locked(PhaseBarrier *b) {
+    double now = barrier_now_ms();
+    b->elapsed_ms = now - b->mark_ms;
+    b->mark_ms = now;
+    b->waiting = 0;
+    b->generation++;
+    pthread_cond_broadcast(&b->cond);
+}
+
+// 返回 1 表示本线程最后到达并放行了其余线程, 此时可读取 elapsed_ms 记账;
+// 下一次放行同样需要本线程到达, 因此在此之前 elapsed_ms 不会被改写
+int phase_barrier_wait(PhaseBarrier *b) {
+    int serial = 0;
+    pthread_mutex_lock(&b->lock);
+    if (++b->waiting >= b->parties) {
+        phase_barrier_release_locked(b);
+        serial = 1;
+    } else {
+        unsigned long gen = b->generation;
+        while (gen == b->generation) pthread_cond_wait(&b->cond, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+    return serial;
+}
+
+// 退出同步; 若其余参与者都已到达则代为放行 (该阶段的耗时不被记账)
+void phase_barrier_leave(PhaseBarrier *b) {
+    pthread_mutex_lock(&b->lock);
+    b->parties--;
+    if (b->waiting > 0 && b->waiting >= b->parties) phase_barrier_release_locked(b);
+    pthread_mutex_unlock(&b->lock);
+}
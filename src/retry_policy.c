@@ -0,0 +1,106 @@
+#include "bench.h"
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 重试与退避策略
+// - 仅重试 SDK obs_status_is_retryable() 认可的状态, 数据校验失败永不重试
+// - 指数退避 + 抖动 (none / full / decorrelated), 避免所有线程同步 "波浪式" 回归
+// - 重试预算: 每个逻辑请求存入 ratio 个令牌, 每次重试消耗 1 个, 上限 RetryBudgetMin,
+//   稳态下重试放大倍数不超过 1 + ratio; 令牌以千分之一为单位, CAS 无锁更新
+// ----------------------------------------------------------------------------
+
+// 未知取值返回 -1
+int retry_jitter_from_string(const char *val) {
+    if (strcasecmp(val, "none") == 0) return RETRY_JITTER_NONE;
+    if (strcasecmp(val, "full") == 0) return RETRY_JITTER_FULL;
+    if (strcasecmp(val, "decorrelated") == 0) return RETRY_JITTER_DECORRELATED;
+    return -1;
+}
+
+const char *retry_jitter_to_string(int jitter) {
+    switch (jitter) {
+        case RETRY_JITTER_NONE:         return "none";
+        case RETRY_JITTER_DECORRELATED: return "decorrelated";
+        default:                        return "full";
+    }
+}
+
+void retry_budget_init(RetryBudget *b, const Config *cfg) {
+    memset(b, 0, sizeof(RetryBudget));
+    b->enabled = (cfg->retry_max_attempts > 1 && cfg->retry_budget_ratio > 0);
+    b->capacity_milli = (long long)cfg->retry_budget_min * 1000;
+    b->deposit_milli = (long long)(cfg->retry_budget_ratio * 1000.0);
+    b->tokens_milli = b->capacity_milli;
+}
+
+void retry_budget_deposit(RetryBudget *b) {
+    if (!b || !b->enabled) return;
+    long long cur = __atomic_load_n(&b->tokens_milli, __ATOMIC_RELAXED);
+    for (;;) {
+        if (cur >= b->capacity_milli) return;
+        long long next = cur + b->deposit_milli;
+        if (next > b->capacity_milli) next = b->capacity_milli;
+        if (__atomic_compare_exchange_n(&b->tokens_milli, &cur, next, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return;
+    }
+}
+
+static int retry_budget_withdraw(RetryBudget *b) {
+    if (!b || !b->enabled) return 1;
+    long long cur = __atomic_load_n(&b->tokens_milli, __ATOMIC_RELAXED);
+    for (;;) {
+        if (cur < 1000) return 0;
+        if (__atomic_compare_exchange_n(&b->tokens_milli, &cur, cur - 1000, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return 1;
+    }
+}
+
+// attempt 为已完成的尝试次数 (>=1)
+int retry_policy_should_retry(WorkerArgs *args, obs_status status, int attempt, int validation_failed) {
+    const Config *cfg = args->config;
+    if (status == OBS_STATUS_OK || validation_failed || g_graceful_stop) return 0;
+    if (attempt >= cfg->retry_max_attempts) return 0;
+    if (!obs_status_is_retryable(status)) return 0;
+    if (!retry_budget_withdraw(args->retry_budget)) {
+        args->stats.retry_budget_exhausted++;
+        return 0;
+    }
+    return 1;
+}
+
+static inline double rand_unit(unsigned int *seed) {
+    return rand_r(seed) / ((double)RAND_MAX + 1.0);
+}
+
+// 第 attempt 次失败后的等待时长
+double retry_policy_backoff_ms(const Config *cfg, RetryState *st, int attempt) {
+    double base = cfg->retry_base_delay_ms;
+    double cap = cfg->retry_max_delay_ms;
+    if (base <= 0) return 0.0;
+
+    double exp_delay = base;
+    for (int i = 1; i < attempt && exp_delay < cap; i++) exp_delay *= 2.0;
+    if (exp_delay > cap) exp_delay = cap;
+
+    double delay;
+    switch (cfg->retry_jitter) {
+        case RETRY_JITTER_NONE:
+            delay = exp_delay;
+            break;
+        case RETRY_JITTER_DECORRELATED: {
+            double prev = st->prev_delay_ms > base ? st->prev_delay_ms : base;
+            double upper = prev * 3.0;
+            delay = base + rand_unit(&st->seed) * (upper - base);
+            if (delay > cap) delay = cap;
+            break;
+        }
+        default:
+            delay = rand_unit(&st->seed) * exp_delay;
+            break;
+    }
+    st->prev_delay_ms = delay;
+    return delay;
+}
+
+void retry_policy_sleep(const Config *cfg, RetryState *st, int attempt) {
+    double delay_ms = retry_policy_backoff_ms(cfg, st, attempt);
+    if (delay_ms > 0) sleep_until_ns(monotonic_now_ns() + (long long)(delay_ms * 1e6));
+}
@@ -0,0 +1,361 @@
+#include "bench.h"
+#include <ctype.h>
+#include <math.h>
+#include <strings.h>
+
+// ----------------------------------------------------------------------------
+// 对象大小分布
+// 所有分布 (uniform / buckets / lognormal / cdf) 统一编译为若干区间 [lo, hi] 及其权重,
+// 再构建 Vose 别名表: 每次采样只需一次 64 位随机数选区间 + 一次随机数在区间内均匀取值。
+// 随机数由 Key 种子经 SplitMix64 派生, 同一个 Key 的大小是确定的,
+// 因此 GET / DELETE 与写入时的大小档位一致。
+// ----------------------------------------------------------------------------
+
+static inline uint64_t splitmix64_next(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// [0, n) 上的均匀整数: 乘法取高位代替取模, 避免 rand() % n 的偏差与除法开销
+static inline uint64_t bounded(uint64_t r, uint64_t n) {
+    return (uint64_t)(((__uint128_t)r * n) >> 64);
+}
+
+int size_dist_from_string(const char *val) {
+    if (strcasecmp(val, "fixed") == 0) return SIZE_DIST_FIXED;
+    if (strcasecmp(val, "uniform") == 0) return SIZE_DIST_UNIFORM;
+    if (strcasecmp(val, "buckets") == 0) return SIZE_DIST_BUCKETS;
+    if (strcasecmp(val, "lognormal") == 0) return SIZE_DIST_LOGNORMAL;
+    if (strcasecmp(val, "cdf") == 0) return SIZE_DIST_CDF;
+    return -1;
+}
+
+const char *size_dist_to_string(int dist) {
+    switch (dist) {
+        case SIZE_DIST_UNIFORM:   return "uniform";
+        case SIZE_DIST_BUCKETS:   return "buckets";
+        case SIZE_DIST_LOGNORMAL: return "lognormal";
+        case SIZE_DIST_CDF:       return "cdf";
+        default:                  return "fixed";
+    }
+}
+
+// 解析 "4096" / "4KB" / "64K" / "1.5MB" / "1GB", 失败返回 -1
+long long parse_size_bytes(const char *s) {
+    while (*s == ' ') s++;
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0) return -1;
+    while (*end == ' ') end++;
+    double mul = 1;
+    switch (toupper((unsigned char)*end)) {
+        case 'K': mul = 1024.0; break;
+        case 'M': mul = 1024.0 * 1024; break;
+        case 'G': mul = 1024.0 * 1024 * 1024; break;
+        case 'T': mul = 1024.0 * 1024 * 1024 * 1024; break;
+        case 'B': case '\0': case '\r': case '\n': break;
+        default: return -1;
+    }
+    return (long long)(v * mul);
+}
+
+static void format_size(long long bytes, char *buf, size_t size) {
+    const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+    int u = 0;
+    double v = (double)bytes;
+    while (v >= 1024.0 && u < 4 && fmod(v, 1024.0) == 0) { v /= 1024.0; u++; }
+    snprintf(buf, size, "%.0f%s", v, units[u]);
+}
+
+typedef struct {
+    long long lo, hi;
+    double weight;
+} SizeRange;
+
+static int add_range(SizeRange **ranges, int *count, int *cap, long long lo, long long hi, double weight) {
+    if (weight <= 0 || lo < 0 || hi < lo) return 0;
+    if (*count == *cap) {
+        int ncap = *cap ? *cap * 2 : 32;
+        SizeRange *n = (SizeRange *)realloc(*ranges, ncap * sizeof(SizeRange));
+        if (!n) return -1;
+        *ranges = n;
+        *cap = ncap;
+    }
+    (*ranges)[*count].lo = lo;
+    (*ranges)[*count].hi = hi;
+    (*ranges)[*count].weight = weight;
+    (*count)++;
+    return 0;
+}
+
+// "4KB:50,64KB-1MB:30,1GB:1": 单值或区间, 冒号后为权重
+static int parse_buckets(const char *spec, SizeRange **ranges, int *count, int *cap) {
+    char *copy = strdup(spec);
+    if (!copy) return -1;
+    char *saveptr = NULL;
+    for (char *tok = strtok_r(copy, ",", &saveptr); tok; tok = strtok_r(NULL, ",", &saveptr)) {
+        char *colon = strchr(tok, ':');
+        double weight = 1.0;
+        if (colon) {
+            *colon = '\0';
+            weight = atof(colon + 1);
+        }
+        char *dash = strchr(tok, '-');
+        long long lo, hi;
+        if (dash) {
+            *dash = '\0';
+            lo = parse_size_bytes(tok);
+            hi = parse_size_bytes(dash + 1);
+        } else {
+            lo = hi = parse_size_bytes(tok);
+        }
+        if (lo < 0 || hi < lo || weight <= 0) {
+            printf("[Config Error] Invalid ObjectSizeBuckets entry near '%s'\n", tok);
+            free(copy);
+            return -1;
+        }
+        if (add_range(ranges, count, cap, lo, hi, weight) != 0) { free(copy); return -1; }
+    }
+    free(copy);
+    return 0;
+}
+
+// CDF 文件: 每行 "大小,累计概率", 大小递增; 相邻两行构成一个区间
+static int parse_cdf_file(const char *path, SizeRange **ranges, int *count, int *cap) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        printf("[Config Error] Cannot open ObjectSizeFile: %s\n", path);
+        return -1;
+    }
+    char line[256];
+    long long prev_size = 0;
+    double prev_p = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        char *comma = strchr(p, ',');
+        if (!comma) continue;
+        *comma = '\0';
+        long long size = parse_size_bytes(p);
+        double cp = atof(comma + 1);
+        if (size < prev_size || cp < prev_p || cp > 1.0 + 1e-9) {
+            printf("[Config Error] ObjectSizeFile must be monotonic (size, cumulative probability <= 1): %s\n", path);
+            fclose(fp);
+            return -1;
+        }
+        long long lo = (*count == 0 && prev_p == 0) ? size : prev_size + 1;
+        if (lo > size) lo = size;
+        if (add_range(ranges, count, cap, lo, size, cp - prev_p) != 0) { fclose(fp); return -1; }
+        prev_size = size;
+        prev_p = cp;
+    }
+    fclose(fp);
+    return 0;
+}
+
+// 对数正态离散为 256 个对数等距区间; ObjectSize 配置为区间时截断在 [min, max], 否则取 ±5 sigma
+static int build_lognormal(const Config *cfg, SizeRange **ranges, int *count, int *cap) {
+    const int bins = 256;
+    double mu = log(cfg->object_size_median);
+    double sigma = cfg->object_size_sigma;
+    double lo_b = cfg->is_dynamic_size ? (double)cfg->object_size_min : exp(mu - 5 * sigma);
+    double hi_b = cfg->is_dynamic_size ? (double)cfg->object_size_max : exp(mu + 5 * sigma);
+    if (lo_b < 1) lo_b = 1;
+    double llo = log(lo_b), lhi = log(hi_b);
+    if (lhi <= llo) return add_range(ranges, count, cap, (long long)lo_b, (long long)lo_b, 1.0);
+
+    double step = (lhi - llo) / bins;
+    long long prev_hi = (long long)lo_b - 1;
+    for (int i = 0; i < bins; i++) {
+        double a = llo + i * step, b = a + step;
+        // 区间概率 = Phi((b-mu)/sigma) - Phi((a-mu)/sigma)
+        double w = 0.5 * (erfc(-(b - mu) / (sigma * M_SQRT2)) - erfc(-(a - mu) / (sigma * M_SQRT2)));
+        long long lo = prev_hi + 1;
+        long long hi = (i == bins - 1) ? (long long)hi_b : (long long)exp(b);
+        if (hi < lo) continue;
+        if (add_range(ranges, count, cap, lo, hi, w) != 0) return -1;
+        prev_hi = hi;
+    }
+    return 0;
+}
+
+int size_dist_build(Config *cfg) {
+    SizeRange *ranges = NULL;
+    int count = 0, cap = 0, rc = 0;
+
+    switch (cfg->object_size_dist) {
+        case SIZE_DIST_FIXED:
+            return 0;
+        case SIZE_DIST_UNIFORM:
+            rc = add_range(&ranges, &count, &cap, cfg->object_size_min, cfg->object_size_max, 1.0);
+            break;
+        case SIZE_DIST_BUCKETS:
+            rc = parse_buckets(cfg->object_size_buckets, &ranges, &count, &cap);
+            break;
+        case SIZE_DIST_LOGNORMAL:
+            if (cfg->object_size_median <= 0 || cfg->object_size_sigma <= 0) {
+                printf("[Config Error] lognormal ObjectSizeDistribution requires ObjectSizeMedian and ObjectSizeSigma > 0.\n");
+                return -1;
+            }
+            rc = build_lognormal(cfg, &ranges, &count, &cap);
+            break;
+        case SIZE_DIST_CDF:
+            rc = parse_cdf_file(cfg->object_size_file, &ranges, &count, &cap);
+            break;
+    }
+    if (rc != 0 || count == 0) {
+        if (rc == 0) printf("[Config Error] Object size distribution '%s' has no valid buckets.\n", size_dist_to_string(cfg->object_size_dist));
+        free(ranges);
+        return -1;
+    }
+
+    SizeDistTable *t = (SizeDistTable *)calloc(1, sizeof(SizeDistTable));
+    if (!t) { free(ranges); return -1; }
+    t->n = count;
+    t->lo = (long long *)malloc(count * sizeof(long long));
+    t->hi = (long long *)malloc(count * sizeof(long long));
+    t->threshold = (uint32_t *)malloc(count * sizeof(uint32_t));
+    t->alias = (int *)malloc(count * sizeof(int));
+    double *scaled = (double *)malloc(count * sizeof(double));
+    int *small = (int *)malloc(count * sizeof(int));
+    int *large = (int *)malloc(count * sizeof(int));
+    if (!t->lo || !t->hi || !t->threshold || !t->alias || !scaled || !small || !large) {
+        free(scaled); free(small); free(large); free(ranges);
+        size_dist_free(t);
+        return -1;
+    }
+
+    double total = 0;
+    for (int i = 0; i < count; i++) total += ranges[i].weight;
+    for (int i = 0; i < count; i++) {
+        t->lo[i] = ranges[i].lo;
+        t->hi[i] = ranges[i].hi;
+        t->mean += (ranges[i].weight / total) * (ranges[i].lo + ranges[i].hi) / 2.0;
+        if (ranges[i].hi > t->max) t->max = ranges[i].hi;
+    }
+
+    // Vose 别名法
+    int ns = 0, nl = 0;
+    for (int i = 0; i < count; i++) {
+        scaled[i] = ranges[i].weight / total * count;
+        if (scaled[i] < 1.0) small[ns++] = i;
+        else large[nl++] = i;
+    }
+    while (ns > 0 && nl > 0) {
+        int s = small[--ns], l = large[--nl];
+        t->threshold[s] = (uint32_t)(scaled[s] * 4294967295.0);
+        t->alias[s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0) small[ns++] = l;
+        else large[nl++] = l;
+    }
+    while (nl > 0) { int l = large[--nl]; t->threshold[l] = UINT32_MAX; t->alias[l] = l; }
+    while (ns > 0) { int s = small[--ns]; t->threshold[s] = UINT32_MAX; t->alias[s] = s; }
+
+    free(scaled); free(small); free(large); free(ranges);
+    cfg->size_table = t;
+    return 0;
+}
+
+void size_dist_free(SizeDistTable *t) {
+    if (!t) return;
+    free(t->lo);
+    free(t->hi);
+    free(t->threshold);
+    free(t->alias);
+    free(t);
+}
+
+long long size_dist_sample(const Config *cfg, uint64_t key_seed) {
+    const SizeDistTable *t = cfg->size_table;
+    if (!t) return cfg->object_size_max;
+    uint64_t state = key_seed ^ 0xd1b54a32d192ed03ULL;
+    uint64_t r = splitmix64_next(&state);
+    int i = (int)bounded(r, (uint64_t)t->n);
+    if ((uint32_t)r > t->threshold[i]) i = t->alias[i];
+    long long span = t->hi[i] - t->lo[i];
+    if (span <= 0) return t->lo[i];
+    return t->lo[i] + (long long)bounded(splitmix64_next(&state), (uint64_t)span + 1);
+}
+
+// ----------------------------------------------------------------------------
+// 按大小档位统计
+// ----------------------------------------------------------------------------
+int size_class_init(Config *cfg) {
+    static const long long defaults[] = { 4LL << 10, 64LL << 10, 1LL << 20, 16LL << 20, 256LL << 20, 4LL << 30 };
+    cfg->size_class_count = 0;
+    if (strlen(cfg->object_size_report_buckets) > 0) {
+        char *copy = strdup(cfg->object_size_report_buckets);
+        char *saveptr = NULL;
+        long long prev = 0;
+        for (char *tok = strtok_r(copy, ",", &saveptr); tok && cfg->size_class_count < SIZE_CLASS_MAX - 1;
+             tok = strtok_r(NULL, ",", &saveptr)) {
+            long long b = parse_size_bytes(tok);
+            if (b <= prev) {
+                printf("[Config Error] ObjectSizeReportBuckets must be increasing sizes: %s\n", cfg->object_size_report_buckets);
+                free(copy);
+                return -1;
+            }
+            cfg->size_class_bounds[cfg->size_class_count++] = b;
+            prev = b;
+        }
+        free(copy);
+    } else {
+        for (size_t i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) cfg->size_class_bounds[cfg->size_class_count++] = defaults[i];
+    }
+    return 0;
+}
+
+// 档位 i 覆盖 [bounds[i-1], bounds[i]), 最后一档为 [bounds[n-1], +inf)
+int size_class_of(const Config *cfg, long long size) {
+    for (int i = 0; i < cfg->size_class_count; i++) {
+        if (size < cfg->size_class_bounds[i]) return i;
+    }
+    return cfg->size_class_count;
+}
+
+void size_class_record(SizeClassStats *sc, int ok, long long bytes, double latency_ms) {
+    if (ok) sc->success_count++;
+    else sc->fail_count++;
+    sc->bytes += bytes;
+    sc->total_latency_ms += latency_ms;
+    hist_record(&sc->latency_hist, latency_ms);
+}
+
+void size_class_save_report(const Config *cfg, const SizeClassStats *classes, double elapsed_s) {
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/size_classes.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (!fp) return;
+
+    fprintf(fp, "ObjectSizeDistribution: %s", size_dist_to_string(cfg->object_size_dist));
+    if (cfg->size_table) fprintf(fp, " (%d buckets, mean %.0f bytes, max %lld bytes)", cfg->size_table->n, cfg->size_table->mean, cfg->size_table->max);
+    fprintf(fp, "\n\n%-20s %10s %8s %10s %10s %10s %10s %10s %10s\n", "SizeClass", "Requests", "Fail", "TPS", "BW(MB/s)",
+            "Avg(ms)", "P50(ms)", "P99(ms)", "P99.9(ms)");
+    printf("\n--- Per-Size-Class Result ---\n");
+    for (int i = 0; i <= cfg->size_class_count; i++) {
+        const SizeClassStats *sc = &classes[i];
+        long long reqs = sc->success_count + sc->fail_count;
+        if (reqs == 0) continue;
+
+        char lo[32], hi[32], label[80];
+        format_size(i == 0 ? 0 : cfg->size_class_bounds[i - 1], lo, sizeof(lo));
+        if (i < cfg->size_class_count) {
+            format_size(cfg->size_class_bounds[i], hi, sizeof(hi));
+            snprintf(label, sizeof(label), "[%s, %s)", lo, hi);
+        } else {
+            snprintf(label, sizeof(label), ">= %s", lo);
+        }
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        double mbps = elapsed_s > 0 ? sc->bytes / 1024.0 / 1024.0 / elapsed_s : 0.0;
+        fprintf(fp, "%-20s %10lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", label, reqs, sc->fail_count, tps, mbps,
+                sc->total_latency_ms / reqs, hist_percentile(&sc->latency_hist, 50.0),
+                hist_percentile(&sc->latency_hist, 99.0), hist_percentile(&sc->latency_hist, 99.9));
+        printf("%-20s TPS %10.2f | BW %8.2f MB/s | P50 %.2f | P99 %.2f ms\n", label, tps, mbps,
+               hist_percentile(&sc->latency_hist, 50.0), hist_percentile(&sc->latency_hist, 99.0));
+    }
+    fclose(fp);
+}
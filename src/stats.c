@@ -0,0 +1,110 @@
+#include "bench.h"
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------
+// 对数-线性时延直方图 (HDR 风格)
+// 单位为微秒; 每个 2 的幂区间再切分为 HIST_SUB_BUCKETS 个子桶, 相对误差约 3%。
+// 直方图可以无损合并, 多线程/多节点的全局分位数由合并后的直方图计算,
+// 而不是对各自的分位数取平均。
+// ----------------------------------------------------------------------------
+static inline int hist_index_of(uint64_t us) {
+    if (us < HIST_SUB_BUCKETS) return (int)us;
+    int mag = 63 - __builtin_clzll(us);
+    if (mag >= HIST_MAX_MAGNITUDE) return HIST_BUCKET_COUNT - 1;
+    int group = mag - HIST_SUB_BUCKET_BITS + 1;
+    int sub = (int)((us >> (mag - HIST_SUB_BUCKET_BITS)) & (HIST_SUB_BUCKETS - 1));
+    return group * HIST_SUB_BUCKETS + sub;
+}
+
+// 返回桶的上界 (微秒), 用于保守地估计分位数
+static inline uint64_t hist_upper_bound_of(int idx) {
+    if (idx < HIST_SUB_BUCKETS) return (uint64_t)idx;
+    int group = idx / HIST_SUB_BUCKETS;
+    int sub = idx % HIST_SUB_BUCKETS;
+    uint64_t lower = (uint64_t)(HIST_SUB_BUCKETS + sub) << (group - 1);
+    return lower + ((uint64_t)1 << (group - 1)) - 1;
+}
+
+void hist_reset(LatencyHistogram *h) {
+    memset(h, 0, sizeof(LatencyHistogram));
+}
+
+void hist_record(LatencyHistogram *h, double latency_ms) {
+    if (latency_ms < 0) latency_ms = 0;
+    uint64_t us = (uint64_t)(latency_ms * 1000.0);
+    h->buckets[hist_index_of(us)]++;
+    h->count++;
+}
+
+void hist_merge(LatencyHistogram *dst, const LatencyHistogram *src) {
+    for (int i = 0; i < HIST_BUCKET_COUNT; i++) dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+}
+
+double hist_percentile(const LatencyHistogram *h, double pct) {
+    if (h->count <= 0) return 0.0;
+    long long target = (long long)((pct / 100.0) * h->count + 0.5);
+    if (target < 1) target = 1;
+    if (target > h->count) target = h->count;
+
+    long long cumul = 0;
+    for (int i = 0; i < HIST_BUCKET_COUNT; i++) {
+        cumul += h->buckets[i];
+        if (cumul >= target) return hist_upper_bound_of(i) / 1000.0;
+    }
+    return hist_upper_bound_of(HIST_BUCKET_COUNT - 1) / 1000.0;
+}
+
+double hist_bucket_upper_ms(int idx) {
+    return hist_upper_bound_of(idx) / 1000.0;
+}
+
+// ----------------------------------------------------------------------------
+// ThreadStats 聚合
+// ----------------------------------------------------------------------------
+void stats_init(ThreadStats *s) {
+    memset(s, 0, sizeof(ThreadStats));
+    s->min_latency_ms = -1.0;
+}
+
+void stats_merge(ThreadStats *dst, const ThreadStats *src) {
+    dst->success_count         += src->success_count;
+    dst->fail_403_count        += src->fail_403_count;
+    dst->fail_404_count        += src->fail_404_count;
+    dst->fail_409_count        += src->fail_409_count;
+    dst->fail_4xx_other_count  += src->fail_4xx_other_count;
+    dst->fail_5xx_count        += src->fail_5xx_count;
+    dst->fail_other_count      += src->fail_other_count;
+    dst->fail_validation_count += src->fail_validation_count;
+    dst->total_success_bytes   += src->total_success_bytes;
+    dst->total_latency_ms      += src->total_latency_ms;
+    dst->throttled_ns          += src->throttled_ns;
+    dst->throttled_count       += src->throttled_count;
+    dst->attempt_count         += src->attempt_count;
+    dst->retry_count           += src->retry_count;
+    dst->retry_budget_exhausted += src->retry_budget_exhausted;
+    dst->interarrival_ns       += src->interarrival_ns;
+    dst->intended_interarrival_ns += src->intended_interarrival_ns;
+    dst->pacing_lag_ns         += src->pacing_lag_ns;
+    dst->pacing_late_count     += src->pacing_late_count;
+    dst->cpu_ns                += src->cpu_ns;
+    if (src->max_latency_ms > dst->max_latency_ms) dst->max_latency_ms = src->max_latency_ms;
+    if (src->min_latency_ms >= 0 && (dst->min_latency_ms < 0 || src->min_latency_ms < dst->min_latency_ms)) {
+        dst->min_latency_ms = src->min_latency_ms;
+    }
+    hist_merge(&dst->latency_hist, &src->latency_hist);
+    hist_merge(&dst->first_attempt_hist, &src->first_attempt_hist);
+    hist_merge(&dst->interarrival_hist, &src->interarrival_hist);
+}
+
+long long stats_total_fail(const ThreadStats *s) {
+    return s->fail_403_count + s->fail_404_count + s->fail_409_count + s->fail_4xx_other_count +
+           s->fail_5xx_count + s->fail_other_count + s->fail_validation_count;
+}
+
+void stats_record_latency(ThreadStats *s, double latency_ms) {
+    s->total_latency_ms += latency_ms;
+    if (latency_ms > s->max_latency_ms) s->max_latency_ms = latency_ms;
+    if (s->min_latency_ms < 0 || latency_ms < s->min_latency_ms) s->min_latency_ms = latency_ms;
+    hist_record(&s->latency_hist, latency_ms);
+}
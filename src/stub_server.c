@@ -0,0 +1,1282 @@
+// ----------------------------------------------------------------------------
+// obs_stub_server: 本地 OBS / S3 兼容替身服务
+// 用于离线压测真实 SDK 路径 (libcurl / TLS / 签名 / HTTP 解析) 的客户端开销与工具自身的 TPS 上限。
+// - 每个工作线程独立的 epoll 与 SO_REUSEPORT 监听套接字, 线程之间不共享连接
+// - 内存对象存储 (分片哈希表 + 引用计数), 支持 PUT / GET (Range) / HEAD / DELETE / LIST /
+//   分段上传 / 复制 / 建删桶, 桶配置类接口返回固定内容
+// - 不校验签名; 桶无需预先创建
+// - 编译时 STUB_SERVER_TLS=1 可启用 TLS (OpenSSL)
+// ----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <getopt.h>
+#include <ctype.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "log.h"
+
+#ifdef STUB_SERVER_TLS
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#endif
+
+#define STUB_SHARDS             256
+#define STUB_HEADER_MAX         (64 * 1024)
+#define STUB_READ_CHUNK         (64 * 1024)
+#define STUB_UPLOAD_SLOTS       1024
+#define STUB_MAX_PARTS          10000
+#define STUB_LIST_MAX_KEYS      1000
+
+enum { OP_PUT, OP_GET, OP_HEAD, OP_DELETE, OP_LIST, OP_MULTIPART, OP_COPY, OP_BUCKET, OP_ERROR, OP_SLOTS };
+static const char *g_op_names[OP_SLOTS] = { "PUT", "GET", "HEAD", "DELETE", "LIST", "MULTIPART", "COPY", "BUCKET", "ERROR" };
+
+static volatile sig_atomic_t g_stop = 0;
+
+// ----------------------------------------------------------------------------
+// 对象存储
+// ----------------------------------------------------------------------------
+typedef struct {
+    long refs;
+    size_t size;
+    time_t mtime;
+    char etag[40];
+    char data[];
+} StubObject;
+
+typedef struct Entry {
+    char *name;                     // "<bucket>/<key>"
+    StubObject *obj;
+    struct Entry *next;
+} Entry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Entry **slots;
+    size_t slot_count;
+    size_t count;
+} Shard;
+
+typedef struct Upload {
+    char id[40];
+    char *name;
+    StubObject **parts;             // 下标为分段号
+    int part_cap;
+    struct Upload *next;
+} Upload;
+
+static Shard g_shards[STUB_SHARDS];
+static Upload *g_uploads[STUB_UPLOAD_SLOTS];
+static pthread_mutex_t g_upload_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t g_etag_seq = 0;
+static uint64_t g_upload_seq = 0;
+
+static uint64_t hash_str(const char *s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static StubObject *object_new(size_t size) {
+    StubObject *o = (StubObject *)malloc(sizeof(StubObject) + size);
+    if (!o) return NULL;
+    o->refs = 1;
+    o->size = size;
+    o->mtime = time(NULL);
+    uint64_t seq = __atomic_add_fetch(&g_etag_seq, 1, __ATOMIC_RELAXED);
+    snprintf(o->etag, sizeof(o->etag), "%016llx%016llx", (unsigned long long)seq,
+             (unsigned long long)(seq * 0x9e3779b97f4a7c15ULL ^ size));
+    return o;
+}
+
+static void object_ref(StubObject *o) { __atomic_add_fetch(&o->refs, 1, __ATOMIC_RELAXED); }
+
+static void object_unref(StubObject *o) {
+    if (o && __atomic_sub_fetch(&o->refs, 1, __ATOMIC_ACQ_REL) == 0) free(o);
+}
+
+static void store_init(void) {
+    for (int i = 0; i < STUB_SHARDS; i++) {
+        pthread_mutex_init(&g_shards[i].lock, NULL);
+        g_shards[i].slot_count = 1024;
+        g_shards[i].slots = (Entry **)calloc(g_shards[i].slot_count, sizeof(Entry *));
+    }
+}
+
+static void shard_grow(Shard *sh) {
+    size_t n = sh->slot_count * 2;
+    Entry **slots = (Entry **)calloc(n, sizeof(Entry *));
+    if (!slots) return;
+    for (size_t i = 0; i < sh->slot_count; i++) {
+        Entry *e = sh->slots[i];
+        while (e) {
+            Entry *next = e->next;
+            size_t idx = (hash_str(e->name) / STUB_SHARDS) % n;
+            e->next = slots[idx];
+            slots[idx] = e;
+            e = next;
+        }
+    }
+    free(sh->slots);
+    sh->slots = slots;
+    sh->slot_count = n;
+}
+
+// 写入 (obj 非 NULL) 或删除 (obj 为 NULL); 接管 obj 的引用
+static void store_put(const char *name, StubObject *obj) {
+    uint64_t h = hash_str(name);
+    Shard *sh = &g_shards[h % STUB_SHARDS];
+    StubObject *old = NULL;
+    pthread_mutex_lock(&sh->lock);
+    Entry **pp = &sh->slots[(h / STUB_SHARDS) % sh->slot_count];
+    while (*pp && strcmp((*pp)->name, name) != 0) pp = &(*pp)->next;
+    if (*pp) {
+        old = (*pp)->obj;
+        if (obj) {
+            (*pp)->obj = obj;
+        } else {
+            Entry *e = *pp;
+            *pp = e->next;
+            free(e->name);
+            free(e);
+            sh->count--;
+        }
+    } else if (obj) {
+        Entry *e = (Entry *)malloc(sizeof(Entry));
+        if (e && (e->name = strdup(name)) != NULL) {
+            e->obj = obj;
+            e->next = *pp;
+            *pp = e;
+            if (++sh->count > sh->slot_count * 2) shard_grow(sh);
+        } else {
+            free(e);
+            old = obj;
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    object_unref(old);
+}
+
+// 返回带引用的对象, 不存在时为 NULL
+static StubObject *store_get(const char *name) {
+    uint64_t h = hash_str(name);
+    Shard *sh = &g_shards[h % STUB_SHARDS];
+    StubObject *obj = NULL;
+    pthread_mutex_lock(&sh->lock);
+    for (Entry *e = sh->slots[(h / STUB_SHARDS) % sh->slot_count]; e; e = e->next) {
+        if (strcmp(e->name, name) == 0) {
+            obj = e->obj;
+            object_ref(obj);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    return obj;
+}
+
+typedef struct {
+    char *key;
+    StubObject *obj;
+} ListItem;
+
+static int list_item_cmp(const void *a, const void *b) {
+    return strcmp(((const ListItem *)a)->key, ((const ListItem *)b)->key);
+}
+
+// 收集 <bucket>/ 下以 prefix 开头、且大于 marker 的 Key (已排序, 带引用)
+static ListItem *store_list(const char *bucket, const char *prefix, const char *marker, size_t *out_count) {
+    size_t cap = 256, count = 0;
+    ListItem *items = (ListItem *)malloc(cap * sizeof(ListItem));
+    size_t blen = strlen(bucket), plen = strlen(prefix);
+    for (int s = 0; s < STUB_SHARDS && items; s++) {
+        Shard *sh = &g_shards[s];
+        pthread_mutex_lock(&sh->lock);
+        for (size_t i = 0; i < sh->slot_count && items; i++) {
+            for (Entry *e = sh->slots[i]; e; e = e->next) {
+                if (strncmp(e->name, bucket, blen) != 0 || e->name[blen] != '/') continue;
+                const char *key = e->name + blen + 1;
+                if (strncmp(key, prefix, plen) != 0 || strcmp(key, marker) <= 0) continue;
+                if (count == cap) {
+                    ListItem *grown = (ListItem *)realloc(items, cap * 2 * sizeof(ListItem));
+                    if (!grown) break;
+                    items = grown;
+                    cap *= 2;
+                }
+                items[count].key = strdup(key);
+                items[count].obj = e->obj;
+                object_ref(e->obj);
+                count++;
+            }
+        }
+        pthread_mutex_unlock(&sh->lock);
+    }
+    if (items) qsort(items, count, sizeof(ListItem), list_item_cmp);
+    *out_count = items ? count : 0;
+    return items;
+}
+
+static Upload *upload_find_locked(const char *id) {
+    for (Upload *u = g_uploads[hash_str(id) % STUB_UPLOAD_SLOTS]; u; u = u->next) {
+        if (strcmp(u->id, id) == 0) return u;
+    }
+    return NULL;
+}
+
+static void upload_free(Upload *u) {
+    for (int i = 0; i < u->part_cap; i++) object_unref(u->parts[i]);
+    free(u->parts);
+    free(u->name);
+    free(u);
+}
+
+static Upload *upload_detach(const char *id) {
+    pthread_mutex_lock(&g_upload_lock);
+    Upload **pp = &g_uploads[hash_str(id) % STUB_UPLOAD_SLOTS];
+    while (*pp && strcmp((*pp)->id, id) != 0) pp = &(*pp)->next;
+    Upload *u = *pp;
+    if (u) *pp = u->next;
+    pthread_mutex_unlock(&g_upload_lock);
+    return u;
+}
+
+// ----------------------------------------------------------------------------
+// 连接与 HTTP 解析
+// ----------------------------------------------------------------------------
+enum { CONN_HEADERS, CONN_BODY, CONN_RESPONDING };
+
+typedef struct {
+    char method[8];
+    char path[2048];                // 已解码
+    char query[2048];
+    char bucket[256];
+    const char *key;                // 指向 path 内部
+    long long content_length;
+    char range[64];
+    char copy_source[2048];
+    int expect_continue;
+    int keep_alive;
+    int obs_family;                 // 请求带 x-obs- 头时按 OBS 协议回应
+} Request;
+
+typedef struct {
+    int fd;
+#ifdef STUB_SERVER_TLS
+    SSL *ssl;
+    int handshake_done;
+#endif
+    int state;
+    int events;                     // 当前注册的 epoll 事件
+    char *in;
+    size_t in_len, in_cap;
+    Request req;
+    StubObject *body;               // 接收中的请求体
+    size_t body_got;
+    char *out;
+    size_t out_len, out_off, out_cap;
+    StubObject *send_obj;           // 响应体引用的对象数据
+    size_t send_off, send_end;
+} Conn;
+
+typedef struct {
+    int index;
+    int epfd;
+    int listen_fd;
+    long long ops[OP_SLOTS];
+    long long bytes_in, bytes_out;
+    long long conns;
+    uint64_t req_seq;
+    time_t date_sec;
+    char date[64];
+} ServerThread;
+
+typedef struct {
+    char bind_addr[64];
+    int port;
+    int threads;
+    char vhost_domain[256];         // 非空时支持 <bucket>.<domain> 形式的虚拟主机访问
+    long long max_object;
+#ifdef STUB_SERVER_TLS
+    SSL_CTX *ssl_ctx;
+#endif
+} ServerConfig;
+
+static ServerConfig g_cfg;
+
+static ssize_t conn_read(Conn *c, char *buf, size_t len) {
+#ifdef STUB_SERVER_TLS
+    if (c->ssl) {
+        int n = SSL_read(c->ssl, buf, (int)(len > INT32_MAX ? INT32_MAX : len));
+        if (n > 0) return n;
+        int err = SSL_get_error(c->ssl, n);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) { errno = EAGAIN; return -1; }
+        return err == SSL_ERROR_ZERO_RETURN ? 0 : -1;
+    }
+#endif
+    return recv(c->fd, buf, len, 0);
+}
+
+static ssize_t conn_write(Conn *c, const char *buf, size_t len) {
+#ifdef STUB_SERVER_TLS
+    if (c->ssl) {
+        int n = SSL_write(c->ssl, buf, (int)(len > INT32_MAX ? INT32_MAX : len));
+        if (n > 0) return n;
+        int err = SSL_get_error(c->ssl, n);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) { errno = EAGAIN; return -1; }
+        return -1;
+    }
+#endif
+    return send(c->fd, buf, len, MSG_NOSIGNAL);
+}
+
+static void conn_close(ServerThread *st, Conn *c) {
+    epoll_ctl(st->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+#ifdef STUB_SERVER_TLS
+    if (c->ssl) SSL_free(c->ssl);
+#endif
+    close(c->fd);
+    object_unref(c->body);
+    object_unref(c->send_obj);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+static void conn_set_events(ServerThread *st, Conn *c, int events) {
+    if (c->events == events) return;
+    struct epoll_event ev = { .events = (uint32_t)events, .data.ptr = c };
+    epoll_ctl(st->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->events = events;
+}
+
+static int out_reserve(Conn *c, size_t extra) {
+    if (c->out_len + extra <= c->out_cap) return 0;
+    size_t cap = c->out_cap ? c->out_cap : 4096;
+    while (cap < c->out_len + extra) cap *= 2;
+    char *p = (char *)realloc(c->out, cap);
+    if (!p) return -1;
+    c->out = p;
+    c->out_cap = cap;
+    return 0;
+}
+
+static void out_append(Conn *c, const char *data, size_t len) {
+    if (out_reserve(c, len) != 0) return;
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+}
+
+static void out_printf(Conn *c, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void out_printf(Conn *c, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int need = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (need < 0 || out_reserve(c, (size_t)need + 1) != 0) return;
+    va_start(ap, fmt);
+    vsnprintf(c->out + c->out_len, (size_t)need + 1, fmt, ap);
+    va_end(ap);
+    c->out_len += (size_t)need;
+}
+
+static const char *http_date(ServerThread *st) {
+    time_t now = time(NULL);
+    if (now != st->date_sec) {
+        struct tm tm_res;
+        gmtime_r(&now, &tm_res);
+        strftime(st->date, sizeof(st->date), "%a, %d %b %Y %H:%M:%S GMT", &tm_res);
+        st->date_sec = now;
+    }
+    return st->date;
+}
+
+static void format_http_time(time_t t, char *buf, size_t len) {
+    struct tm tm_res;
+    gmtime_r(&t, &tm_res);
+    strftime(buf, len, "%a, %d %b %Y %H:%M:%S GMT", &tm_res);
+}
+
+static void format_iso_time(time_t t, char *buf, size_t len) {
+    struct tm tm_res;
+    gmtime_r(&t, &tm_res);
+    strftime(buf, len, "%Y-%m-%dT%H:%M:%S.000Z", &tm_res);
+}
+
+// 写响应头; body_len 为 Content-Length, extra 为附加头 (每行以 \r\n 结尾)
+static void respond_head(ServerThread *st, Conn *c, int code, const char *reason, long long body_len,
+                         const char *content_type, const char *extra) {
+    const char *fam = c->req.obs_family ? "x-obs" : "x-amz";
+    uint64_t seq = ++st->req_seq;
+    out_printf(c, "HTTP/1.1 %d %s\r\nServer: OBS\r\nDate: %s\r\n%s-request-id: %04X%012llX\r\n%s-id-2: stub-%d\r\n"
+               "Content-Length: %lld\r\n%s%s%s%s\r\n",
+               code, reason, http_date(st), fam, st->index, (unsigned long long)seq, fam, st->index, body_len,
+               content_type ? "Content-Type: " : "", content_type ? content_type : "", content_type ? "\r\n" : "",
+               c->req.keep_alive ? "" : "Connection: close\r\n");
+    if (extra) {
+        // 附加头插入到结尾空行之前
+        c->out_len -= 2;
+        out_printf(c, "%s\r\n", extra);
+    }
+}
+
+static void respond_body(ServerThread *st, Conn *c, int code, const char *reason, const char *content_type,
+                         const char *body, const char *extra) {
+    size_t len = body ? strlen(body) : 0;
+    respond_head(st, c, code, reason, (long long)len, content_type, extra);
+    if (len && strcasecmp(c->req.method, "HEAD") != 0) out_append(c, body, len);
+}
+
+static void respond_error(ServerThread *st, Conn *c, int code, const char *reason, const char *err_code, const char *msg) {
+    char body[1024];
+    snprintf(body, sizeof(body),
+             "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Error><Code>%s</Code><Message>%s</Message>"
+             "<RequestId>stub</RequestId><HostId>stub</HostId></Error>", err_code, msg);
+    respond_body(st, c, code, reason, "application/xml", body, NULL);
+    st->ops[OP_ERROR]++;
+}
+
+static int hexval(int ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    ch = tolower(ch);
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    return -1;
+}
+
+static void url_decode(char *dst, size_t dst_len, const char *src, size_t src_len) {
+    size_t o = 0;
+    for (size_t i = 0; i < src_len && o + 1 < dst_len; i++) {
+        if (src[i] == '%' && i + 2 < src_len && hexval(src[i + 1]) >= 0 && hexval(src[i + 2]) >= 0) {
+            dst[o++] = (char)(hexval(src[i + 1]) * 16 + hexval(src[i + 2]));
+            i += 2;
+        } else if (src[i] == '+') {
+            dst[o++] = ' ';
+        } else {
+            dst[o++] = src[i];
+        }
+    }
+    dst[o] = '\0';
+}
+
+// 查询参数: 存在返回 1 (值解码到 out, 可为空串), 否则返回 0
+static int query_get(const char *query, const char *name, char *out, size_t out_len) {
+    size_t nlen = strlen(name);
+    const char *p = query;
+    while (p && *p) {
+        const char *end = strchr(p, '&');
+        size_t seg = end ? (size_t)(end - p) : strlen(p);
+        if (seg >= nlen && strncmp(p, name, nlen) == 0 && (seg == nlen || p[nlen] == '=')) {
+            if (out) {
+                if (seg == nlen) out[0] = '\0';
+                else url_decode(out, out_len, p + nlen + 1, seg - nlen - 1);
+            }
+            return 1;
+        }
+        p = end ? end + 1 : NULL;
+    }
+    return 0;
+}
+
+static void xml_escape(char *dst, size_t dst_len, const char *src) {
+    size_t o = 0;
+    for (; *src && o + 7 < dst_len; src++) {
+        switch (*src) {
+            case '&': o += (size_t)snprintf(dst + o, dst_len - o, "&amp;"); break;
+            case '<': o += (size_t)snprintf(dst + o, dst_len - o, "&lt;"); break;
+            case '>': o += (size_t)snprintf(dst + o, dst_len - o, "&gt;"); break;
+            case '"': o += (size_t)snprintf(dst + o, dst_len - o, "&quot;"); break;
+            default: dst[o++] = *src;
+        }
+    }
+    dst[o] = '\0';
+}
+
+// 解析请求头; 返回 1 完成, 0 需更多数据, -1 格式错误
+static int parse_headers(Conn *c, size_t *header_len) {
+    char *end = (char *)memmem(c->in, c->in_len, "\r\n\r\n", 4);
+    if (!end) return c->in_len >= STUB_HEADER_MAX ? -1 : 0;
+    *header_len = (size_t)(end - c->in) + 4;
+
+    Request *r = &c->req;
+    memset(r, 0, sizeof(*r));
+    r->key = "";
+
+    char *line = c->in;
+    char *eol = (char *)memmem(line, (size_t)(end - line) + 2, "\r\n", 2);
+    char *sp1 = (char *)memchr(line, ' ', (size_t)(eol - line));
+    if (!sp1) return -1;
+    char *uri = sp1 + 1;
+    char *sp2 = (char *)memchr(uri, ' ', (size_t)(eol - uri));
+    if (!sp2 || (size_t)(sp1 - line) >= sizeof(r->method)) return -1;
+    memcpy(r->method, line, (size_t)(sp1 - line));
+    r->keep_alive = (strncmp(sp2 + 1, "HTTP/1.1", 8) == 0);
+
+    char *q = (char *)memchr(uri, '?', (size_t)(sp2 - uri));
+    size_t path_len = (size_t)((q ? q : sp2) - uri);
+    url_decode(r->path, sizeof(r->path), uri, path_len);
+    if (q) {
+        size_t qlen = (size_t)(sp2 - q - 1);
+        if (qlen >= sizeof(r->query)) qlen = sizeof(r->query) - 1;
+        memcpy(r->query, q + 1, qlen);
+        r->query[qlen] = '\0';
+    }
+
+    char host[256] = "";
+    for (line = eol + 2; line < end; line = eol + 2) {
+        eol = (char *)memmem(line, (size_t)(end - line) + 2, "\r\n", 2);
+        char *colon = (char *)memchr(line, ':', (size_t)(eol - line));
+        if (!colon) continue;
+        size_t nlen = (size_t)(colon - line);
+        char *v = colon + 1;
+        while (v < eol && (*v == ' ' || *v == '\t')) v++;
+        size_t vlen = (size_t)(eol - v);
+
+        if (nlen == 14 && strncasecmp(line, "Content-Length", 14) == 0) {
+            r->content_length = strtoll(v, NULL, 10);
+        } else if (nlen == 4 && strncasecmp(line, "Host", 4) == 0) {
+            snprintf(host, sizeof(host), "%.*s", (int)vlen, v);
+        } else if (nlen == 5 && strncasecmp(line, "Range", 5) == 0) {
+            snprintf(r->range, sizeof(r->range), "%.*s", (int)vlen, v);
+        } else if (nlen == 6 && strncasecmp(line, "Expect", 6) == 0) {
+            r->expect_continue = (vlen >= 3 && strncmp(v, "100", 3) == 0);
+        } else if (nlen == 10 && strncasecmp(line, "Connection", 10) == 0) {
+            if (vlen >= 5 && strncasecmp(v, "close", 5) == 0) r->keep_alive = 0;
+            else if (vlen >= 10 && strncasecmp(v, "keep-alive", 10) == 0) r->keep_alive = 1;
+        } else if (nlen == 17 && strncasecmp(line, "Transfer-Encoding", 17) == 0) {
+            return -1;      // 不支持 chunked 请求体, SDK 上传均带 Content-Length
+        } else if ((nlen == 17 && strncasecmp(line, "x-amz-copy-source", 17) == 0) ||
+                   (nlen == 17 && strncasecmp(line, "x-obs-copy-source", 17) == 0)) {
+            url_decode(r->copy_source, sizeof(r->copy_source), v, vlen);
+        }
+        if (nlen > 6 && strncasecmp(line, "x-obs-", 6) == 0) r->obs_family = 1;
+    }
+    if (r->content_length < 0) return -1;
+
+    // 定位桶与 Key: 虚拟主机 (<bucket>.<domain>) 或路径 (/<bucket>/<key>)
+    char *colon = strchr(host, ':');
+    if (colon) *colon = '\0';
+    size_t dlen = strlen(g_cfg.vhost_domain);
+    size_t hlen = strlen(host);
+    const char *p = r->path[0] == '/' ? r->path + 1 : r->path;
+    if (dlen > 0 && hlen > dlen + 1 && host[hlen - dlen - 1] == '.' && strcasecmp(host + hlen - dlen, g_cfg.vhost_domain) == 0) {
+        snprintf(r->bucket, sizeof(r->bucket), "%.*s", (int)(hlen - dlen - 1), host);
+        r->key = p;
+    } else {
+        const char *slash = strchr(p, '/');
+        size_t blen = slash ? (size_t)(slash - p) : strlen(p);
+        if (blen >= sizeof(r->bucket)) return -1;
+        memcpy(r->bucket, p, blen);
+        r->bucket[blen] = '\0';
+        r->key = slash ? slash + 1 : "";
+    }
+    return 1;
+}
+
+// ----------------------------------------------------------------------------
+// 请求处理
+// ----------------------------------------------------------------------------
+static void object_name(char *out, size_t len, const char *bucket, const char *key) {
+    snprintf(out, len, "%s/%s", bucket, key);
+}
+
+static void handle_get_object(ServerThread *st, Conn *c, int head_only) {
+    Request *r = &c->req;
+    char name[2400];
+    object_name(name, sizeof(name), r->bucket, r->key);
+    StubObject *obj = store_get(name);
+    if (!obj) {
+        if (head_only) respond_head(st, c, 404, "Not Found", 0, NULL, NULL);
+        else respond_error(st, c, 404, "Not Found", "NoSuchKey", "The specified key does not exist.");
+        return;
+    }
+
+    size_t start = 0, end = obj->size;     // [start, end)
+    int partial = 0;
+    if (r->range[0] && !head_only && obj->size > 0) {
+        long long a = -1, b = -1;
+        const char *spec = r->range + (strncmp(r->range, "bytes=", 6) == 0 ? 6 : 0);
+        if (spec[0] == '-') {
+            b = strtoll(spec + 1, NULL, 10);
+            a = b >= (long long)obj->size ? 0 : (long long)obj->size - b;
+            b = (long long)obj->size - 1;
+        } else {
+            char *dash = NULL;
+            a = strtoll(spec, &dash, 10);
+            b = (dash && *dash == '-' && dash[1]) ? strtoll(dash + 1, NULL, 10) : (long long)obj->size - 1;
+        }
+        if (a < 0 || a >= (long long)obj->size || b < a) {
+            object_unref(obj);
+            respond_error(st, c, 416, "Requested Range Not Satisfiable", "InvalidRange", "The requested range cannot be satisfied.");
+            return;
+        }
+        if (b >= (long long)obj->size) b = (long long)obj->size - 1;
+        start = (size_t)a;
+        end = (size_t)b + 1;
+        partial = 1;
+    }
+
+    char extra[512], mtime[64];
+    format_http_time(obj->mtime, mtime, sizeof(mtime));
+    if (partial) {
+        snprintf(extra, sizeof(extra), "ETag: \"%s\"\r\nLast-Modified: %s\r\nAccept-Ranges: bytes\r\nContent-Range: bytes %zu-%zu/%zu\r\n",
+                 obj->etag, mtime, start, end - 1, obj->size);
+    } else {
+        snprintf(extra, sizeof(extra), "ETag: \"%s\"\r\nLast-Modified: %s\r\nAccept-Ranges: bytes\r\n", obj->etag, mtime);
+    }
+    respond_head(st, c, partial ? 206 : 200, partial ? "Partial Content" : "OK", (long long)(end - start),
+                 "binary/octet-stream", extra);
+    if (head_only || end == start) {
+        object_unref(obj);
+    } else {
+        c->send_obj = obj;
+        c->send_off = start;
+        c->send_end = end;
+    }
+    st->ops[head_only ? OP_HEAD : OP_GET]++;
+}
+
+static void handle_list(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    char prefix[1024] = "", marker[1024] = "", max_keys[32] = "";
+    query_get(r->query, "prefix", prefix, sizeof(prefix));
+    query_get(r->query, "marker", marker, sizeof(marker));
+    int max = query_get(r->query, "max-keys", max_keys, sizeof(max_keys)) ? atoi(max_keys) : STUB_LIST_MAX_KEYS;
+    if (max <= 0 || max > STUB_LIST_MAX_KEYS) max = STUB_LIST_MAX_KEYS;
+
+    size_t count = 0;
+    ListItem *items = store_list(r->bucket, prefix, marker, &count);
+    size_t shown = count < (size_t)max ? count : (size_t)max;
+
+    // 先写到独立缓冲再生成响应头, 以便填入 Content-Length
+    Conn tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    char esc[4096], esc2[1024], mtime[64];
+    xml_escape(esc, sizeof(esc), r->bucket);
+    xml_escape(esc2, sizeof(esc2), prefix);
+    out_printf(&tmp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+               "<Name>%s</Name><Prefix>%s</Prefix>", esc, esc2);
+    xml_escape(esc2, sizeof(esc2), marker);
+    out_printf(&tmp, "<Marker>%s</Marker><MaxKeys>%d</MaxKeys><IsTruncated>%s</IsTruncated>", esc2, max,
+               count > shown ? "true" : "false");
+    if (count > shown && shown > 0) {
+        xml_escape(esc, sizeof(esc), items[shown - 1].key);
+        out_printf(&tmp, "<NextMarker>%s</NextMarker>", esc);
+    }
+    for (size_t i = 0; i < shown; i++) {
+        xml_escape(esc, sizeof(esc), items[i].key);
+        format_iso_time(items[i].obj->mtime, mtime, sizeof(mtime));
+        out_printf(&tmp, "<Contents><Key>%s</Key><LastModified>%s</LastModified><ETag>\"%s\"</ETag><Size>%zu</Size>"
+                   "<Owner><ID>stub</ID></Owner><StorageClass>STANDARD</StorageClass></Contents>",
+                   esc, mtime, items[i].obj->etag, items[i].obj->size);
+    }
+    out_printf(&tmp, "</ListBucketResult>");
+    for (size_t i = 0; i < count; i++) {
+        free(items[i].key);
+        object_unref(items[i].obj);
+    }
+    free(items);
+
+    respond_head(st, c, 200, "OK", (long long)tmp.out_len, "application/xml", NULL);
+    out_append(c, tmp.out, tmp.out_len);
+    free(tmp.out);
+    st->ops[OP_LIST]++;
+}
+
+// 桶配置类子资源: 写入 / 删除直接成功, 读取返回固定内容
+static int handle_bucket_subresource(ServerThread *st, Conn *c) {
+    static const struct { const char *name; const char *body; const char *type; } subs[] = {
+        { "policy", "{\"Statement\":[]}", "application/json" },
+        { "lifecycle", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<LifecycleConfiguration></LifecycleConfiguration>", "application/xml" },
+        { "cors", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CORSConfiguration></CORSConfiguration>", "application/xml" },
+        { "tagging", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Tagging><TagSet></TagSet></Tagging>", "application/xml" },
+        { "versioning", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<VersioningConfiguration><Status>Enabled</Status></VersioningConfiguration>", "application/xml" },
+        { "location", "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CreateBucketConfiguration><LocationConstraint></LocationConstraint></CreateBucketConfiguration>", "application/xml" },
+    };
+    for (size_t i = 0; i < sizeof(subs) / sizeof(subs[0]); i++) {
+        if (!query_get(c->req.query, subs[i].name, NULL, 0)) continue;
+        if (strcmp(c->req.method, "GET") == 0) respond_body(st, c, 200, "OK", subs[i].type, subs[i].body, NULL);
+        else if (strcmp(c->req.method, "DELETE") == 0) respond_body(st, c, 204, "No Content", NULL, NULL, NULL);
+        else respond_body(st, c, 200, "OK", NULL, NULL, NULL);
+        st->ops[OP_BUCKET]++;
+        return 1;
+    }
+    return 0;
+}
+
+static void handle_bucket(ServerThread *st, Conn *c) {
+    const char *m = c->req.method;
+    if (strcmp(m, "GET") == 0 && query_get(c->req.query, "uploads", NULL, 0)) {
+        respond_error(st, c, 501, "Not Implemented", "NotImplemented", "ListMultipartUploads is not supported.");
+    } else if (handle_bucket_subresource(st, c)) {
+        return;
+    } else if (strcmp(m, "GET") == 0) {
+        handle_list(st, c);
+    } else if (strcmp(m, "HEAD") == 0) {
+        respond_head(st, c, 200, "OK", 0, NULL, "x-obs-api: 3.0\r\nx-obs-bucket-location: local\r\n");
+        st->ops[OP_BUCKET]++;
+    } else if (strcmp(m, "PUT") == 0) {
+        respond_body(st, c, 200, "OK", NULL, NULL, NULL);
+        st->ops[OP_BUCKET]++;
+    } else if (strcmp(m, "DELETE") == 0) {
+        respond_body(st, c, 204, "No Content", NULL, NULL, NULL);
+        st->ops[OP_BUCKET]++;
+    } else {
+        respond_error(st, c, 405, "Method Not Allowed", "MethodNotAllowed", "The specified method is not allowed.");
+    }
+}
+
+static void handle_copy(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    const char *src = r->copy_source[0] == '/' ? r->copy_source + 1 : r->copy_source;
+    char src_name[2400];
+    snprintf(src_name, sizeof(src_name), "%s", src);
+    char *qmark = strchr(src_name, '?');
+    if (qmark) *qmark = '\0';
+    StubObject *from = store_get(src_name);
+    if (!from) {
+        respond_error(st, c, 404, "Not Found", "NoSuchKey", "The specified copy source does not exist.");
+        return;
+    }
+    StubObject *obj = object_new(from->size);
+    if (!obj) {
+        object_unref(from);
+        respond_error(st, c, 500, "Internal Server Error", "InternalError", "Out of memory.");
+        return;
+    }
+    memcpy(obj->data, from->data, from->size);
+    object_unref(from);
+
+    char name[2400], body[512], mtime[64];
+    object_name(name, sizeof(name), r->bucket, r->key);
+    format_iso_time(obj->mtime, mtime, sizeof(mtime));
+    snprintf(body, sizeof(body), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CopyObjectResult><LastModified>%s</LastModified>"
+             "<ETag>\"%s\"</ETag></CopyObjectResult>", mtime, obj->etag);
+    store_put(name, obj);
+    respond_body(st, c, 200, "OK", "application/xml", body, NULL);
+    st->ops[OP_COPY]++;
+}
+
+// 请求体接收完毕后的对象写入 / 分段上传 / 完成分段
+static void handle_object_body(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    StubObject *obj = c->body;
+    c->body = NULL;
+    char upload_id[64], part[32], name[2400], extra[128];
+    object_name(name, sizeof(name), r->bucket, r->key);
+
+    if (strcmp(r->method, "PUT") == 0 && query_get(r->query, "uploadId", upload_id, sizeof(upload_id)) &&
+        query_get(r->query, "partNumber", part, sizeof(part))) {
+        int n = atoi(part);
+        if (n < 1 || n > STUB_MAX_PARTS) {
+            object_unref(obj);
+            respond_error(st, c, 400, "Bad Request", "InvalidArgument", "Part number must be 1~10000.");
+            return;
+        }
+        snprintf(extra, sizeof(extra), "ETag: \"%s\"\r\n", obj->etag);
+        pthread_mutex_lock(&g_upload_lock);
+        Upload *u = upload_find_locked(upload_id);
+        if (u && n >= u->part_cap) {
+            int cap = u->part_cap;
+            while (cap <= n) cap *= 2;
+            StubObject **parts = (StubObject **)realloc(u->parts, cap * sizeof(StubObject *));
+            if (parts) {
+                memset(parts + u->part_cap, 0, (cap - u->part_cap) * sizeof(StubObject *));
+                u->parts = parts;
+                u->part_cap = cap;
+            }
+        }
+        StubObject *old = NULL;
+        if (u && n < u->part_cap) {
+            old = u->parts[n];
+            u->parts[n] = obj;
+            obj = NULL;
+        }
+        pthread_mutex_unlock(&g_upload_lock);
+        object_unref(old);
+        if (obj) {
+            object_unref(obj);
+            respond_error(st, c, 404, "Not Found", "NoSuchUpload", "The specified upload does not exist.");
+            return;
+        }
+        respond_body(st, c, 200, "OK", NULL, NULL, extra);
+        st->ops[OP_MULTIPART]++;
+        return;
+    }
+
+    if (strcmp(r->method, "POST") == 0 && query_get(r->query, "uploadId", upload_id, sizeof(upload_id))) {
+        // 完成分段上传: 按分段号升序拼接已上传的分段 (请求体中的分段列表不做核对)
+        object_unref(obj);
+        Upload *u = upload_detach(upload_id);
+        if (!u) {
+            respond_error(st, c, 404, "Not Found", "NoSuchUpload", "The specified upload does not exist.");
+            return;
+        }
+        size_t total = 0;
+        int parts = 0;
+        for (int i = 1; i < u->part_cap; i++) {
+            if (u->parts[i]) {
+                total += u->parts[i]->size;
+                parts++;
+            }
+        }
+        StubObject *merged = object_new(total);
+        if (!merged) {
+            upload_free(u);
+            respond_error(st, c, 500, "Internal Server Error", "InternalError", "Out of memory.");
+            return;
+        }
+        size_t off = 0;
+        for (int i = 1; i < u->part_cap; i++) {
+            if (!u->parts[i]) continue;
+            memcpy(merged->data + off, u->parts[i]->data, u->parts[i]->size);
+            off += u->parts[i]->size;
+        }
+        snprintf(merged->etag + 32 - 6, 7, "-%05d", parts > 99999 ? 99999 : parts);
+        char body[8192], esc[2400];
+        xml_escape(esc, sizeof(esc), r->key);
+        snprintf(body, sizeof(body), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<CompleteMultipartUploadResult>"
+                 "<Location>/%s/%s</Location><Bucket>%s</Bucket><Key>%s</Key><ETag>\"%s\"</ETag></CompleteMultipartUploadResult>",
+                 r->bucket, esc, r->bucket, esc, merged->etag);
+        store_put(u->name, merged);
+        upload_free(u);
+        respond_body(st, c, 200, "OK", "application/xml", body, NULL);
+        st->ops[OP_MULTIPART]++;
+        return;
+    }
+
+    if (strcmp(r->method, "PUT") == 0 && r->key[0] && !r->copy_source[0] && !r->query[0]) {
+        snprintf(extra, sizeof(extra), "ETag: \"%s\"\r\n", obj->etag);
+        store_put(name, obj);
+        respond_body(st, c, 200, "OK", NULL, NULL, extra);
+        st->ops[OP_PUT]++;
+        return;
+    }
+
+    object_unref(obj);
+    respond_error(st, c, 501, "Not Implemented", "NotImplemented", "The request is not supported by the stub server.");
+}
+
+static void handle_object(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    const char *m = r->method;
+    char upload_id[64];
+
+    if (strcmp(m, "GET") == 0 && !r->query[0]) {
+        handle_get_object(st, c, 0);
+    } else if (strcmp(m, "HEAD") == 0) {
+        handle_get_object(st, c, 1);
+    } else if (strcmp(m, "GET") == 0) {
+        // 带查询参数的 GET (如 versionId / response-*), 忽略参数按普通下载处理
+        handle_get_object(st, c, 0);
+    } else if (strcmp(m, "DELETE") == 0 && query_get(r->query, "uploadId", upload_id, sizeof(upload_id))) {
+        Upload *u = upload_detach(upload_id);
+        if (u) upload_free(u);
+        respond_body(st, c, 204, "No Content", NULL, NULL, NULL);
+        st->ops[OP_MULTIPART]++;
+    } else if (strcmp(m, "DELETE") == 0) {
+        char name[2400];
+        object_name(name, sizeof(name), r->bucket, r->key);
+        store_put(name, NULL);
+        respond_body(st, c, 204, "No Content", NULL, NULL, NULL);
+        st->ops[OP_DELETE]++;
+    } else if (strcmp(m, "POST") == 0 && query_get(r->query, "uploads", NULL, 0)) {
+        Upload *u = (Upload *)calloc(1, sizeof(Upload));
+        char name[2400];
+        object_name(name, sizeof(name), r->bucket, r->key);
+        if (u) {
+            u->name = strdup(name);
+            u->part_cap = 16;
+            u->parts = (StubObject **)calloc(u->part_cap, sizeof(StubObject *));
+        }
+        if (!u || !u->name || !u->parts) {
+            if (u) upload_free(u);
+            respond_error(st, c, 500, "Internal Server Error", "InternalError", "Out of memory.");
+            return;
+        }
+        uint64_t seq = __atomic_add_fetch(&g_upload_seq, 1, __ATOMIC_RELAXED);
+        snprintf(u->id, sizeof(u->id), "stub%016llx", (unsigned long long)(seq * 0x9e3779b97f4a7c15ULL));
+        pthread_mutex_lock(&g_upload_lock);
+        Upload **slot = &g_uploads[hash_str(u->id) % STUB_UPLOAD_SLOTS];
+        u->next = *slot;
+        *slot = u;
+        pthread_mutex_unlock(&g_upload_lock);
+
+        char body[8192], esc[2400];
+        xml_escape(esc, sizeof(esc), r->key);
+        snprintf(body, sizeof(body), "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<InitiateMultipartUploadResult>"
+                 "<Bucket>%s</Bucket><Key>%s</Key><UploadId>%s</UploadId></InitiateMultipartUploadResult>",
+                 r->bucket, esc, u->id);
+        respond_body(st, c, 200, "OK", "application/xml", body, NULL);
+        st->ops[OP_MULTIPART]++;
+    } else if (strcmp(m, "PUT") == 0 && r->copy_source[0]) {
+        handle_copy(st, c);
+    } else {
+        respond_error(st, c, 405, "Method Not Allowed", "MethodNotAllowed", "The specified method is not allowed.");
+    }
+}
+
+// 请求头解析完成: 需要请求体时转入接收状态, 否则直接处理
+static int request_begin(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    int has_body = (r->content_length > 0);
+    if (has_body && r->content_length > g_cfg.max_object) {
+        r->keep_alive = 0;
+        respond_error(st, c, 400, "Bad Request", "EntityTooLarge", "Your proposed upload exceeds the maximum allowed size.");
+        return 0;
+    }
+    if (has_body || (strcmp(r->method, "PUT") == 0 && r->key[0] && !r->copy_source[0]) || strcmp(r->method, "POST") == 0) {
+        c->body = object_new((size_t)r->content_length);
+        if (!c->body) {
+            r->keep_alive = 0;
+            respond_error(st, c, 500, "Internal Server Error", "InternalError", "Out of memory.");
+            return 0;
+        }
+        c->body_got = 0;
+        return 1;
+    }
+    if (!r->bucket[0]) {
+        respond_body(st, c, 200, "OK", "application/xml",
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ListAllMyBucketsResult><Owner><ID>stub</ID></Owner>"
+                     "<Buckets></Buckets></ListAllMyBucketsResult>", NULL);
+    } else if (!r->key[0]) {
+        handle_bucket(st, c);
+    } else {
+        handle_object(st, c);
+    }
+    return 0;
+}
+
+static void request_body_done(ServerThread *st, Conn *c) {
+    Request *r = &c->req;
+    if (!r->key[0] || (strcmp(r->method, "PUT") == 0 && r->copy_source[0]) ||
+        (strcmp(r->method, "POST") == 0 && query_get(r->query, "uploads", NULL, 0))) {
+        // 桶级请求 (建桶 / 配置写入)、复制与初始化分段上传的请求体不保存
+        object_unref(c->body);
+        c->body = NULL;
+        if (!r->bucket[0]) respond_error(st, c, 405, "Method Not Allowed", "MethodNotAllowed", "The specified method is not allowed.");
+        else if (!r->key[0]) handle_bucket(st, c);
+        else if (r->copy_source[0]) handle_copy(st, c);
+        else handle_object(st, c);
+        return;
+    }
+    handle_object_body(st, c);
+}
+
+// 发送缓冲区中的响应; 返回 1 全部发完, 0 需等待可写, -1 出错
+static int conn_flush(ServerThread *st, Conn *c) {
+    while (c->out_off < c->out_len) {
+        ssize_t n = conn_write(c, c->out + c->out_off, c->out_len - c->out_off);
+        if (n < 0) return errno == EAGAIN ? 0 : -1;
+        c->out_off += (size_t)n;
+        st->bytes_out += n;
+    }
+    c->out_off = c->out_len = 0;
+    while (c->send_obj && c->send_off < c->send_end) {
+        size_t chunk = c->send_end - c->send_off;
+        if (chunk > 1024 * 1024) chunk = 1024 * 1024;
+        ssize_t n = conn_write(c, c->send_obj->data + c->send_off, chunk);
+        if (n < 0) return errno == EAGAIN ? 0 : -1;
+        c->send_off += (size_t)n;
+        st->bytes_out += n;
+    }
+    object_unref(c->send_obj);
+    c->send_obj = NULL;
+    return 1;
+}
+
+static void conn_consume(Conn *c, size_t len) {
+    memmove(c->in, c->in + len, c->in_len - len);
+    c->in_len -= len;
+}
+
+static void conn_process(ServerThread *st, Conn *c) {
+#ifdef STUB_SERVER_TLS
+    if (c->ssl && !c->handshake_done) {
+        int ret = SSL_accept(c->ssl);
+        if (ret != 1) {
+            int err = SSL_get_error(c->ssl, ret);
+            if (err == SSL_ERROR_WANT_READ) conn_set_events(st, c, EPOLLIN);
+            else if (err == SSL_ERROR_WANT_WRITE) conn_set_events(st, c, EPOLLOUT);
+            else conn_close(st, c);
+            return;
+        }
+        c->handshake_done = 1;
+    }
+#endif
+    for (;;) {
+        // 1. 先发完待发送的数据 (含 100 Continue)
+        if (c->out_len > 0 || c->send_obj) {
+            int r = conn_flush(st, c);
+            if (r < 0) { conn_close(st, c); return; }
+            if (r == 0) { conn_set_events(st, c, EPOLLOUT); return; }
+            if (c->state == CONN_RESPONDING) {
+                if (!c->req.keep_alive) { conn_close(st, c); return; }
+                c->state = CONN_HEADERS;
+            }
+        }
+
+        // 2. 解析请求头
+        if (c->state == CONN_HEADERS && c->in_len > 0) {
+            size_t hlen = 0;
+            int r = parse_headers(c, &hlen);
+            if (r < 0) {
+                c->req.keep_alive = 0;
+                respond_error(st, c, 400, "Bad Request", "MalformedRequest", "The request could not be parsed.");
+                c->state = CONN_RESPONDING;
+                c->in_len = 0;
+                continue;
+            }
+            if (r > 0) {
+                conn_consume(c, hlen);
+                if (request_begin(st, c)) {
+                    c->state = CONN_BODY;
+                    if (c->req.expect_continue && (long long)c->in_len < c->req.content_length) {
+                        out_append(c, "HTTP/1.1 100 Continue\r\n\r\n", 25);
+                    }
+                } else {
+                    c->state = CONN_RESPONDING;
+                }
+                continue;
+            }
+        }
+
+        // 3. 接收请求体: 先取缓冲区中已读到的部分
+        if (c->state == CONN_BODY) {
+            size_t need = c->body->size - c->body_got;
+            size_t take = c->in_len < need ? c->in_len : need;
+            if (take > 0) {
+                memcpy(c->body->data + c->body_got, c->in, take);
+                c->body_got += take;
+                conn_consume(c, take);
+            }
+            if (c->body_got == c->body->size) {
+                request_body_done(st, c);
+                c->state = CONN_RESPONDING;
+                continue;
+            }
+            // 大请求体直接读入对象缓冲, 避免二次拷贝
+            ssize_t n = conn_read(c, c->body->data + c->body_got, c->body->size - c->body_got);
+            if (n > 0) {
+                c->body_got += (size_t)n;
+                st->bytes_in += n;
+                continue;
+            }
+            if (n < 0 && errno == EAGAIN) { conn_set_events(st, c, EPOLLIN); return; }
+            conn_close(st, c);
+            return;
+        }
+
+        // 4. 读更多请求头数据
+        if (c->in_cap - c->in_len < STUB_READ_CHUNK / 4) {
+            size_t cap = c->in_cap ? c->in_cap * 2 : STUB_READ_CHUNK;
+            if (cap > STUB_HEADER_MAX * 2) cap = STUB_HEADER_MAX * 2;
+            if (cap <= c->in_cap) { conn_close(st, c); return; }
+            char *p = (char *)realloc(c->in, cap);
+            if (!p) { conn_close(st, c); return; }
+            c->in = p;
+            c->in_cap = cap;
+        }
+        ssize_t n = conn_read(c, c->in + c->in_len, c->in_cap - c->in_len);
+        if (n > 0) {
+            c->in_len += (size_t)n;
+            st->bytes_in += n;
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) { conn_set_events(st, c, EPOLLIN); return; }
+        conn_close(st, c);
+        return;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 工作线程
+// ----------------------------------------------------------------------------
+static int open_listener(void) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)g_cfg.port);
+    if (inet_pton(AF_INET, g_cfg.bind_addr, &addr.sin_addr) != 1 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 4096) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_all(ServerThread *st) {
+    for (;;) {
+        int fd = accept4(st->listen_fd, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0) return;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        Conn *c = (Conn *)calloc(1, sizeof(Conn));
+        if (!c) { close(fd); continue; }
+        c->fd = fd;
+        c->state = CONN_HEADERS;
+#ifdef STUB_SERVER_TLS
+        if (g_cfg.ssl_ctx) {
+            c->ssl = SSL_new(g_cfg.ssl_ctx);
+            if (!c->ssl) { close(fd); free(c); continue; }
+            SSL_set_fd(c->ssl, fd);
+        }
+#endif
+        c->events = EPOLLIN;
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if (epoll_ctl(st->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+#ifdef STUB_SERVER_TLS
+            if (c->ssl) SSL_free(c->ssl);
+#endif
+            close(fd);
+            free(c);
+            continue;
+        }
+        st->conns++;
+    }
+}
+
+static void *server_thread(void *arg) {
+    ServerThread *st = (ServerThread *)arg;
+    struct epoll_event evs[256];
+    while (!g_stop) {
+        int n = epoll_wait(st->epfd, evs, 256, 500);
+        for (int i = 0; i < n; i++) {
+            if (evs[i].data.ptr == NULL) accept_all(st);
+            else conn_process(st, (Conn *)evs[i].data.ptr);
+        }
+    }
+    return NULL;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -b <addr>     bind address (default 127.0.0.1)\n");
+    printf("  -p <port>     listen port (default 9000)\n");
+    printf("  -t <n>        worker threads, each with its own epoll loop (default 4)\n");
+    printf("  -d <domain>   accept virtual-host requests <bucket>.<domain> (default: path-style only)\n");
+    printf("  -m <MB>       max request body size in MB (default 5120)\n");
+#ifdef STUB_SERVER_TLS
+    printf("  -c <file>     TLS certificate (PEM); enables HTTPS together with -k\n");
+    printf("  -k <file>     TLS private key (PEM)\n");
+#endif
+}
+
+int main(int argc, char **argv) {
+    memset(&g_cfg, 0, sizeof(g_cfg));
+    strcpy(g_cfg.bind_addr, "127.0.0.1");
+    g_cfg.port = 9000;
+    g_cfg.threads = 4;
+    g_cfg.max_object = 5120LL * 1024 * 1024;
+    const char *cert = NULL, *key = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:p:t:d:m:c:k:h")) != -1) {
+        switch (opt) {
+            case 'b': snprintf(g_cfg.bind_addr, sizeof(g_cfg.bind_addr), "%s", optarg); break;
+            case 'p': g_cfg.port = atoi(optarg); break;
+            case 't': g_cfg.threads = atoi(optarg); break;
+            case 'd': snprintf(g_cfg.vhost_domain, sizeof(g_cfg.vhost_domain), "%s", optarg); break;
+            case 'm': g_cfg.max_object = atoll(optarg) * 1024 * 1024; break;
+            case 'c': cert = optarg; break;
+            case 'k': key = optarg; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (g_cfg.port <= 0 || g_cfg.port > 65535 || g_cfg.threads <= 0 || g_cfg.max_object <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    log_init(LOG_INFO);
+
+    if (cert || key) {
+#ifdef STUB_SERVER_TLS
+        if (!cert || !key) {
+            LOG_ERROR("TLS requires both -c <cert> and -k <key>.");
+            return 1;
+        }
+        g_cfg.ssl_ctx = SSL_CTX_new(TLS_server_method());
+        if (!g_cfg.ssl_ctx || SSL_CTX_use_certificate_chain_file(g_cfg.ssl_ctx, cert) != 1 ||
+            SSL_CTX_use_PrivateKey_file(g_cfg.ssl_ctx, key, SSL_FILETYPE_PEM) != 1) {
+            LOG_ERROR("Failed to load TLS certificate / key: %s", ERR_reason_error_string(ERR_get_error()));
+            return 1;
+        }
+        SSL_CTX_set_mode(g_cfg.ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+#else
+        LOG_ERROR("TLS support is not compiled in; rebuild with 'make stub_server STUB_SERVER_TLS=1'.");
+        return 1;
+#endif
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    store_init();
+    ServerThread *threads = (ServerThread *)calloc(g_cfg.threads, sizeof(ServerThread));
+    pthread_t *tids = (pthread_t *)calloc(g_cfg.threads, sizeof(pthread_t));
+    if (!threads || !tids) {
+        LOG_ERROR("Failed to allocate %d server threads.", g_cfg.threads);
+        return 1;
+    }
+    for (int i = 0; i < g_cfg.threads; i++) {
+        ServerThread *st = &threads[i];
+        st->index = i;
+        st->listen_fd = open_listener();
+        st->epfd = epoll_create1(0);
+        if (st->listen_fd < 0 || st->epfd < 0) {
+            LOG_ERROR("Failed to listen on %s:%d: %s", g_cfg.bind_addr, g_cfg.port, strerror(errno));
+            return 1;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+        epoll_ctl(st->epfd, EPOLL_CTL_ADD, st->listen_fd, &ev);
+    }
+    for (int i = 0; i < g_cfg.threads; i++) pthread_create(&tids[i], NULL, server_thread, &threads[i]);
+
+    LOG_INFO("obs_stub_server listening on %s://%s:%d with %d threads%s%s", cert ? "https" : "http", g_cfg.bind_addr,
+             g_cfg.port, g_cfg.threads, g_cfg.vhost_domain[0] ? ", virtual-host domain " : "", g_cfg.vhost_domain);
+
+    for (int i = 0; i < g_cfg.threads; i++) pthread_join(tids[i], NULL);
+
+    long long ops[OP_SLOTS] = {0}, bytes_in = 0, bytes_out = 0, conns = 0, total = 0;
+    for (int i = 0; i < g_cfg.threads; i++) {
+        for (int k = 0; k < OP_SLOTS; k++) ops[k] += threads[i].ops[k];
+        bytes_in += threads[i].bytes_in;
+        bytes_out += threads[i].bytes_out;
+        conns += threads[i].conns;
+    }
+    printf("\n--- Stub Server ---\n");
+    for (int k = 0; k < OP_SLOTS; k++) {
+        if (ops[k] == 0) continue;
+        printf("%-10s %lld\n", g_op_names[k], ops[k]);
+        total += ops[k];
+    }
+    printf("Requests:  %lld over %lld connections\n", total, conns);
+    printf("Traffic:   %.2f MB in, %.2f MB out\n", bytes_in / 1024.0 / 1024.0, bytes_out / 1024.0 / 1024.0);
+    return 0;
+}
@@ -0,0 +1,466 @@
+#include "bench.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+// 生产流量回放 (TestCase=910)
+// 读取线程流式读取 trace, 按 Key 哈希分片到各 Worker 的有界队列 (同一 Key 的操作
+// 始终由同一 Worker 顺序执行, 保证单 Key 上的先后顺序), Worker 在按 TraceSpeedup
+// 压缩后的计划时刻发起请求, 并记录实际发起相对计划的调度滞后。
+// - CSV:    每行 "时间戳,操作,Key,大小", 逐行读取
+// - binary: 头部 8 字节 "OBSTRC01", 随后每条记录为
+//           int64 ts_us | int64 size | uint16 op | uint16 key_len | key (无结尾 0)
+//           通过 mmap 顺序读取, 已消费的页定期归还, 常驻内存与 trace 大小无关
+// 队列满时读取线程等待, trace 从不整体载入内存。
+// ----------------------------------------------------------------------------
+
+#define TRACE_READ_AHEAD_NS     (100 * 1000000LL)       // 起跑前的预读窗口
+#define TRACE_POLL_NS           (200 * 1000LL)
+#define TRACE_LATE_NS           1000000LL
+#define TRACE_RELEASE_CHUNK     (64LL * 1024 * 1024)
+#define TRACE_BIN_HEADER_LEN    20
+
+static const struct {
+    const char *name;
+    int op;
+} g_trace_ops[] = {
+    { "PUT", TEST_CASE_PUT },       { "PutObject", TEST_CASE_PUT },       { "REST.PUT.OBJECT", TEST_CASE_PUT },
+    { "GET", TEST_CASE_GET },       { "GetObject", TEST_CASE_GET },       { "REST.GET.OBJECT", TEST_CASE_GET },
+    { "DELETE", TEST_CASE_DELETE }, { "DeleteObject", TEST_CASE_DELETE }, { "REST.DELETE.OBJECT", TEST_CASE_DELETE },
+};
+
+// 支持的操作名或 TestCase 编号, 不支持的返回 -1
+int trace_op_from_string(const char *val) {
+    if (isdigit((unsigned char)val[0])) {
+        int op = atoi(val);
+        return (op == TEST_CASE_PUT || op == TEST_CASE_GET || op == TEST_CASE_DELETE) ? op : -1;
+    }
+    for (size_t i = 0; i < sizeof(g_trace_ops) / sizeof(g_trace_ops[0]); i++) {
+        if (strcasecmp(val, g_trace_ops[i].name) == 0) return g_trace_ops[i].op;
+    }
+    return -1;
+}
+
+static int op_slot(int op) {
+    if (op == TEST_CASE_GET) return 1;
+    if (op == TEST_CASE_DELETE) return 2;
+    return 0;
+}
+
+static const char *slot_name(int slot) {
+    static const char *names[TRACE_OP_SLOTS] = { "PUT", "GET", "DELETE" };
+    return names[slot];
+}
+
+// FNV-1a, 只用于分片
+static uint64_t key_hash(const char *key, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// 解析一行 CSV: 返回 1 为有效记录, 0 为注释/表头/空行, -1 为格式错误
+// Key 中允许出现逗号: 取第二个逗号之后、最后一个逗号之前的部分
+static int parse_csv_line(char *line, double *ts, char **op_str, char **key, size_t *key_len, long long *size) {
+    size_t n = strlen(line);
+    while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) line[--n] = '\0';
+    if (n == 0 || line[0] == '#') return 0;
+
+    char *end;
+    *ts = strtod(line, &end);
+    if (end == line) return isalpha((unsigned char)line[0]) ? 0 : -1;
+
+    char *c1 = strchr(line, ',');
+    char *c2 = c1 ? strchr(c1 + 1, ',') : NULL;
+    char *c3 = c2 ? strrchr(c2 + 1, ',') : NULL;
+    if (!c3) return -1;
+    *c1 = *c2 = *c3 = '\0';
+
+    *op_str = c1 + 1;
+    while (**op_str == ' ') (*op_str)++;
+    *key = c2 + 1;
+    *key_len = (size_t)(c3 - *key);
+    *size = atoll(c3 + 1);
+    return 1;
+}
+
+int trace_replay_init(TraceReplay *tr, const Config *cfg, double stop_timestamp_ms) {
+    memset(tr, 0, sizeof(TraceReplay));
+    tr->cfg = cfg;
+    tr->fd = -1;
+    tr->queue_count = cfg->threads;
+    tr->first_ts_us = LLONG_MIN;
+    tr->stop_ns = stop_timestamp_ms < 9e12 ? (long long)(stop_timestamp_ms * 1e6) : LLONG_MAX;
+
+    tr->fd = open(cfg->trace_file, O_RDONLY);
+    if (tr->fd < 0) {
+        LOG_ERROR("Cannot open TraceFile %s: %s", cfg->trace_file, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(tr->fd, &st) != 0) {
+        LOG_ERROR("Cannot stat TraceFile %s: %s", cfg->trace_file, strerror(errno));
+        trace_replay_release(tr);
+        return -1;
+    }
+    tr->file_size = st.st_size;
+
+    int format = cfg->trace_format;
+    if (format == TRACE_FORMAT_AUTO) {
+        char magic[8];
+        format = (pread(tr->fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+                  memcmp(magic, TRACE_BIN_MAGIC, sizeof(magic)) == 0) ? TRACE_FORMAT_BIN : TRACE_FORMAT_CSV;
+    }
+
+    if (format == TRACE_FORMAT_BIN) {
+        if (tr->file_size < 8) {
+            LOG_ERROR("TraceFile %s is too short for the binary format.", cfg->trace_file);
+            trace_replay_release(tr);
+            return -1;
+        }
+        void *map = mmap(NULL, tr->file_size, PROT_READ, MAP_PRIVATE, tr->fd, 0);
+        if (map == MAP_FAILED) {
+            LOG_ERROR("mmap TraceFile %s failed: %s", cfg->trace_file, strerror(errno));
+            trace_replay_release(tr);
+            return -1;
+        }
+        tr->map = (const unsigned char *)map;
+        madvise(map, tr->file_size, MADV_SEQUENTIAL);
+        if (memcmp(tr->map, TRACE_BIN_MAGIC, 8) != 0) {
+            LOG_ERROR("TraceFile %s is not a binary trace (bad magic).", cfg->trace_file);
+            trace_replay_release(tr);
+            return -1;
+        }
+    } else {
+        tr->csv_fp = fdopen(tr->fd, "r");
+        if (!tr->csv_fp) {
+            trace_replay_release(tr);
+            return -1;
+        }
+        tr->fd = -1;
+    }
+
+    long long depth = 1;
+    while (depth < cfg->trace_queue_depth) depth <<= 1;
+    tr->queues = (TraceQueue *)aligned_alloc(64, tr->queue_count * sizeof(TraceQueue));
+    tr->stats = (TraceWorkerStats *)calloc(tr->queue_count, sizeof(TraceWorkerStats));
+    if (!tr->queues || !tr->stats) {
+        trace_replay_release(tr);
+        return -1;
+    }
+    memset(tr->queues, 0, tr->queue_count * sizeof(TraceQueue));
+    for (int i = 0; i < tr->queue_count; i++) {
+        tr->queues[i].mask = depth - 1;
+        tr->queues[i].slots = (TraceRecord *)malloc(depth * sizeof(TraceRecord));
+        if (!tr->queues[i].slots) {
+            LOG_ERROR("Failed to allocate trace queue (%lld slots) for worker %d", depth, i);
+            trace_replay_release(tr);
+            return -1;
+        }
+    }
+    LOG_INFO("Trace replay: %s (%s, %lld bytes), speedup x%.2f, queue depth %lld/worker",
+             cfg->trace_file, tr->map ? "binary" : "csv", tr->file_size, cfg->trace_speedup, depth);
+    return 0;
+}
+
+void trace_replay_release(TraceReplay *tr) {
+    if (tr->queues) {
+        for (int i = 0; i < tr->queue_count; i++) free(tr->queues[i].slots);
+        free(tr->queues);
+        tr->queues = NULL;
+    }
+    free(tr->stats);
+    tr->stats = NULL;
+    if (tr->map) munmap((void *)tr->map, tr->file_size);
+    tr->map = NULL;
+    if (tr->csv_fp) fclose(tr->csv_fp);
+    tr->csv_fp = NULL;
+    if (tr->fd >= 0) close(tr->fd);
+    tr->fd = -1;
+}
+
+// 分片并入队; 返回 -1 表示应停止读取 (停止时间已到或优雅退出)
+static int trace_push(TraceReplay *tr, long long ts_us, int op, const char *key, size_t key_len, long long size) {
+    const Config *cfg = tr->cfg;
+    tr->records_read++;
+    if (op < 0) {
+        tr->skipped_op++;
+        return 0;
+    }
+    if (key_len == 0 || key_len >= MAX_KEY_LEN) {
+        tr->skipped_malformed++;
+        return 0;
+    }
+    if (tr->first_ts_us == LLONG_MIN) tr->first_ts_us = ts_us;
+    tr->last_ts_us = ts_us;
+
+    // 全局分片号覆盖所有 Agent 的 Worker, 每个 Agent 只回放属于自己的分片
+    int agents = cfg->agent_count > 0 ? cfg->agent_count : 1;
+    int shard = (int)(key_hash(key, key_len) % (uint64_t)(tr->queue_count * agents)) - cfg->agent_index * tr->queue_count;
+    if (shard < 0 || shard >= tr->queue_count) return 0;
+    tr->records_local++;
+
+    long long sched = tr->start_ns + (long long)((ts_us - tr->first_ts_us) * 1000.0 / cfg->trace_speedup);
+    if (sched >= tr->stop_ns) return -1;
+
+    TraceQueue *q = &tr->queues[shard];
+    long long head = q->head;
+    long long wait_start = 0;
+    while (head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) > q->mask) {
+        long long now = monotonic_now_ns();
+        if (g_graceful_stop || now >= tr->stop_ns) return -1;
+        if (__atomic_load_n(&q->closed, __ATOMIC_ACQUIRE)) return 0;
+        if (!wait_start) wait_start = now;
+        sleep_until_ns(now + TRACE_POLL_NS);
+    }
+    long long now = monotonic_now_ns();
+    if (wait_start) tr->reader_blocked_ns += now - wait_start;
+    if (sched < now) tr->reader_late++;
+
+    TraceRecord *r = &q->slots[head & q->mask];
+    r->sched_ns = sched;
+    r->size = size;
+    r->op = op;
+    memcpy(r->key, key, key_len);
+    r->key[key_len] = '\0';
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static void read_csv(TraceReplay *tr) {
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t n;
+    while ((n = getline(&line, &cap, tr->csv_fp)) > 0) {
+        tr->bytes_read += n;
+        double ts;
+        char *op_str, *key;
+        size_t key_len;
+        long long size;
+        int rc = parse_csv_line(line, &ts, &op_str, &key, &key_len, &size);
+        if (rc == 0) continue;
+        if (rc < 0) {
+            tr->records_read++;
+            tr->skipped_malformed++;
+            continue;
+        }
+        if (trace_push(tr, (long long)(ts * tr->cfg->trace_time_unit_us), trace_op_from_string(op_str), key, key_len, size) != 0) break;
+    }
+    free(line);
+}
+
+static void read_bin(TraceReplay *tr) {
+    const unsigned char *p = tr->map + 8;
+    const unsigned char *end = tr->map + tr->file_size;
+    long long page = sysconf(_SC_PAGESIZE);
+    long long released = 0;
+
+    while (p + TRACE_BIN_HEADER_LEN <= end) {
+        long long ts_us, size;
+        uint16_t op, key_len;
+        memcpy(&ts_us, p, 8);
+        memcpy(&size, p + 8, 8);
+        memcpy(&op, p + 16, 2);
+        memcpy(&key_len, p + 18, 2);
+        p += TRACE_BIN_HEADER_LEN;
+        if (p + key_len > end) {
+            tr->records_read++;
+            tr->skipped_malformed++;
+            break;
+        }
+        int valid_op = (op == TEST_CASE_PUT || op == TEST_CASE_GET || op == TEST_CASE_DELETE);
+        int rc = trace_push(tr, ts_us, valid_op ? op : -1, (const char *)p, key_len, size);
+        p += key_len;
+
+        long long off = p - tr->map;
+        tr->bytes_read = off;
+        // 已消费的页及时归还, 避免长 trace 把页缓存映射全部留在 RSS 中
+        if (off - released >= TRACE_RELEASE_CHUNK) {
+            long long upto = off & ~(page - 1);
+            madvise((void *)(tr->map + released), upto - released, MADV_DONTNEED);
+            released = upto;
+        }
+        if (rc != 0) break;
+    }
+}
+
+void *trace_reader_routine(void *arg) {
+    TraceReplay *tr = (TraceReplay *)arg;
+    tr->start_ns = monotonic_now_ns() + TRACE_READ_AHEAD_NS;
+    if (tr->map) read_bin(tr);
+    else read_csv(tr);
+
+    for (int i = 0; i < tr->queue_count; i++) __atomic_store_n(&tr->queues[i].eof, 1, __ATOMIC_RELEASE);
+    LOG_INFO("Trace reader finished: %lld records read, %lld replayed by this process", tr->records_read, tr->records_local);
+    return NULL;
+}
+
+double trace_progress(const TraceReplay *tr) {
+    return tr->file_size > 0 ? tr->bytes_read * 100.0 / tr->file_size : 0.0;
+}
+
+// Worker 侧: 按计划时刻依次执行本分片的记录
+void trace_worker_run(WorkerArgs *args, DetailLogState *dl) {
+    TraceQueue *q = args->trace_queue;
+    TraceWorkerStats *ts = args->trace_stats;
+    RetryState retry_state = { (unsigned int)(time(NULL) ^ (long)pthread_self()) ^ 0x5bd1e995u, 0.0 };
+    long long stop_ns = args->stop_timestamp_ms < 9e12 ? (long long)(args->stop_timestamp_ms * 1e6) : LLONG_MAX;
+
+    while (!g_graceful_stop) {
+        long long tail = q->tail;
+        if (tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&q->eof, __ATOMIC_ACQUIRE) && tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) break;
+            long long now = monotonic_now_ns();
+            if (now >= stop_ns) break;
+            sleep_until_ns(now + TRACE_POLL_NS);
+            continue;
+        }
+
+        TraceRecord *r = &q->slots[tail & q->mask];
+        if (r->sched_ns >= stop_ns) break;
+        sleep_until_ns(r->sched_ns);
+        if (g_graceful_stop) break;
+
+        long long lag = monotonic_now_ns() - r->sched_ns;
+        if (lag < 0) lag = 0;
+        ts->issued++;
+        ts->lag_ns += lag;
+        if (lag > TRACE_LATE_NS) ts->late_count++;
+        hist_record(&ts->lag_hist, lag / 1e6);
+
+        long long prev_bytes = args->stats.total_success_bytes;
+        double latency_ms = 0;
+        obs_status status = worker_execute_op(args, dl, r->op, r->key, r->size, NULL, &retry_state, &latency_ms);
+        size_class_record(&ts->ops[op_slot(r->op)], status == OBS_STATUS_OK, args->stats.total_success_bytes - prev_bytes, latency_ms);
+        __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    }
+    // 不再消费, 读取线程丢弃本分片的后续记录而不是阻塞
+    __atomic_store_n(&q->closed, 1, __ATOMIC_RELEASE);
+}
+
+// 输出 trace.txt: 读取统计、调度滞后与分操作结果
+void trace_save_report(const TraceReplay *tr, double elapsed_s) {
+    const Config *cfg = tr->cfg;
+    TraceWorkerStats total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < tr->queue_count; i++) {
+        const TraceWorkerStats *s = &tr->stats[i];
+        total.issued += s->issued;
+        total.lag_ns += s->lag_ns;
+        total.late_count += s->late_count;
+        hist_merge(&total.lag_hist, &s->lag_hist);
+        for (int k = 0; k < TRACE_OP_SLOTS; k++) {
+            total.ops[k].success_count += s->ops[k].success_count;
+            total.ops[k].fail_count += s->ops[k].fail_count;
+            total.ops[k].bytes += s->ops[k].bytes;
+            total.ops[k].total_latency_ms += s->ops[k].total_latency_ms;
+            hist_merge(&total.ops[k].latency_hist, &s->ops[k].latency_hist);
+        }
+    }
+
+    double span_s = tr->first_ts_us != LLONG_MIN ? (tr->last_ts_us - tr->first_ts_us) / 1e6 : 0.0;
+    double avg_lag_ms = total.issued > 0 ? total.lag_ns / 1e6 / total.issued : 0.0;
+    const LatencyHistogram *lh = &total.lag_hist;
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/trace.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "TraceFile:           %s (%s, %lld bytes, %.1f%% read)\n", cfg->trace_file,
+                tr->map ? "binary" : "csv", tr->file_size, trace_progress(tr));
+        fprintf(fp, "Speedup:             x%.2f\n", cfg->trace_speedup);
+        fprintf(fp, "Trace Span:          %.2f s (scaled %.2f s, actual run %.2f s)\n", span_s, span_s / cfg->trace_speedup, elapsed_s);
+        fprintf(fp, "[Reader]\n");
+        fprintf(fp, "  Records Read:      %lld\n", tr->records_read);
+        fprintf(fp, "  Replayed Here:     %lld\n", tr->records_local);
+        fprintf(fp, "  Skipped Malformed: %lld\n", tr->skipped_malformed);
+        fprintf(fp, "  Skipped Op:        %lld (only PUT / GET / DELETE are replayed)\n", tr->skipped_op);
+        fprintf(fp, "  Late Enqueue:      %lld (reader behind schedule)\n", tr->reader_late);
+        fprintf(fp, "  Blocked On Queue:  %.2f s\n", tr->reader_blocked_ns / 1e9);
+        fprintf(fp, "[Schedule]\n");
+        fprintf(fp, "  Issued:            %lld\n", total.issued);
+        fprintf(fp, "  Avg Lag:           %.3f ms\n", avg_lag_ms);
+        fprintf(fp, "  Lag (ms):          P50 %.3f | P90 %.3f | P99 %.3f | P99.9 %.3f\n",
+                hist_percentile(lh, 50.0), hist_percentile(lh, 90.0), hist_percentile(lh, 99.0), hist_percentile(lh, 99.9));
+        fprintf(fp, "  Late (>1ms):       %lld (%.2f%%)\n", total.late_count,
+                total.issued > 0 ? total.late_count * 100.0 / total.issued : 0.0);
+        fprintf(fp, "\n%-8s %10s %8s %10s %10s %10s %10s %10s %10s\n", "Op", "Requests", "Fail", "TPS", "BW(MB/s)",
+                "Avg(ms)", "P50(ms)", "P99(ms)", "P99.9(ms)");
+    }
+
+    printf("\n--- Trace Replay ---\n");
+    printf("Records:         %lld read, %lld replayed, %lld skipped\n", tr->records_read, tr->records_local,
+           tr->skipped_malformed + tr->skipped_op);
+    printf("Schedule Lag:    avg %.3f | P50 %.3f | P99 %.3f ms, late %lld\n", avg_lag_ms,
+           hist_percentile(lh, 50.0), hist_percentile(lh, 99.0), total.late_count);
+    for (int k = 0; k < TRACE_OP_SLOTS; k++) {
+        const SizeClassStats *o = &total.ops[k];
+        long long reqs = o->success_count + o->fail_count;
+        if (reqs == 0) continue;
+        double tps = elapsed_s > 0 ? reqs / elapsed_s : 0.0;
+        double mbps = elapsed_s > 0 ? o->bytes / 1024.0 / 1024.0 / elapsed_s : 0.0;
+        if (fp) {
+            fprintf(fp, "%-8s %10lld %8lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", slot_name(k), reqs, o->fail_count,
+                    tps, mbps, o->total_latency_ms / reqs, hist_percentile(&o->latency_hist, 50.0),
+                    hist_percentile(&o->latency_hist, 99.0), hist_percentile(&o->latency_hist, 99.9));
+        }
+        printf("%-8s TPS %10.2f | BW %8.2f MB/s | Fail %lld | P50 %.2f | P99 %.2f ms\n", slot_name(k), tps, mbps,
+               o->fail_count, hist_percentile(&o->latency_hist, 50.0), hist_percentile(&o->latency_hist, 99.0));
+    }
+    if (fp) fclose(fp);
+}
+
+// CSV -> 二进制格式转换 (obs_c_bench --trace-convert in.csv out.bin [s|ms|us])
+int trace_convert(const char *csv_path, const char *bin_path, double time_unit_us) {
+    FILE *in = fopen(csv_path, "r");
+    if (!in) {
+        printf("[Error] Cannot open %s\n", csv_path);
+        return -1;
+    }
+    FILE *out = fopen(bin_path, "wb");
+    if (!out) {
+        printf("[Error] Cannot create %s\n", bin_path);
+        fclose(in);
+        return -1;
+    }
+    fwrite(TRACE_BIN_MAGIC, 1, 8, out);
+
+    char *line = NULL;
+    size_t cap = 0;
+    long long written = 0, skipped = 0;
+    while (getline(&line, &cap, in) > 0) {
+        double ts;
+        char *op_str, *key;
+        size_t key_len;
+        long long size;
+        int rc = parse_csv_line(line, &ts, &op_str, &key, &key_len, &size);
+        if (rc == 0) continue;
+        int op = rc > 0 ? trace_op_from_string(op_str) : -1;
+        if (op < 0 || key_len == 0 || key_len >= MAX_KEY_LEN) {
+            skipped++;
+            continue;
+        }
+        long long ts_us = (long long)(ts * time_unit_us);
+        uint16_t op16 = (uint16_t)op, len16 = (uint16_t)key_len;
+        fwrite(&ts_us, 8, 1, out);
+        fwrite(&size, 8, 1, out);
+        fwrite(&op16, 2, 1, out);
+        fwrite(&len16, 2, 1, out);
+        fwrite(key, 1, key_len, out);
+        written++;
+    }
+    free(line);
+    fclose(in);
+    int rc = fclose(out);
+    printf("Converted %lld records (%lld skipped) -> %s\n", written, skipped, bin_path);
+    return rc == 0 ? 0 : -1;
+}
@@ -0,0 +1,305 @@
+#include "bench.h"
+
+// ----------------------------------------------------------------------------
+// 读写可见性探测 (TestCase=920)
+// 每个用户的线程按 (1 写者 + VisibilityReaders 读者) 分组。写者 PUT 一个新 Key,
+// 内容从按 Key 计算的 pattern 偏移开始写入 (打戳), 收到响应后通知读者; 读者以
+// GET (校验内容) 或 HEAD 以及 LIST 轮询, 直到观察到对象以正确内容出现。随后写者
+// DELETE, 读者轮询直到 GET 返回 404 且 LIST 不再包含该 Key。
+// 可见性时延 = 写入确认 -> 首次观察到新状态的那次探测的发起时刻。
+// 违例: 超时仍不可见、观察到新状态后又读到旧状态、读到的内容与写入不一致。
+// ----------------------------------------------------------------------------
+
+static const char *g_metric_names[VIS_METRICS] = {
+    "GET after PUT", "LIST after PUT", "GET after DELETE", "LIST after DELETE"
+};
+
+static inline uint64_t stamp_mix(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void visibility_channel_init(VisibilityChannel *ch, int readers) {
+    memset(ch, 0, sizeof(VisibilityChannel));
+    pthread_mutex_init(&ch->lock, NULL);
+    pthread_cond_init(&ch->cond, NULL);
+    ch->readers = readers;
+}
+
+void visibility_channel_destroy(VisibilityChannel *ch) {
+    pthread_mutex_destroy(&ch->lock);
+    pthread_cond_destroy(&ch->cond);
+}
+
+static void cond_wait_100ms(VisibilityChannel *ch) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 100 * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&ch->cond, &ch->lock, &ts);
+}
+
+// 写者: 发布一个探测阶段并等待全部读者完成; 优雅退出时返回 -1
+static int publish_and_wait(VisibilityChannel *ch, int phase, const char *key, long long size, long long stamp) {
+    long long ack_ns = monotonic_now_ns();
+    pthread_mutex_lock(&ch->lock);
+    snprintf(ch->key, sizeof(ch->key), "%s", key);
+    ch->size = size;
+    ch->stamp = stamp;
+    ch->phase = phase;
+    ch->ack_ns = ack_ns;
+    ch->pending = ch->readers;
+    ch->epoch++;
+    pthread_cond_broadcast(&ch->cond);
+    while (ch->pending > 0 && !g_graceful_stop) cond_wait_100ms(ch);
+    pthread_mutex_unlock(&ch->lock);
+    return g_graceful_stop ? -1 : 0;
+}
+
+static void writer_loop(WorkerArgs *args, DetailLogState *dl) {
+    const Config *cfg = args->config;
+    VisibilityChannel *ch = args->vis_channel;
+    RetryState retry_state = { (unsigned int)(time(NULL) ^ (long)pthread_self()) ^ 0x5bd1e995u, 0.0 };
+    long long planned = cfg->requests_per_thread;
+    long long seq = 0;
+
+    while (!worker_should_stop(args, seq, planned)) {
+        char key[MAX_KEY_LEN];
+        snprintf(key, sizeof(key), "%s-vis-%s-%d-%lld", cfg->key_prefix, args->username, args->thread_id, seq);
+        uint64_t key_seed = ((uint64_t)args->thread_id << 32) ^ (uint64_t)seq;
+        long long size = cfg->size_table ? size_dist_sample(cfg, key_seed) : cfg->object_size_max;
+        long long stamp = (long long)(stamp_mix(key_seed) & (uint64_t)args->pattern_mask);
+        seq++;
+
+        args->pattern_offset = stamp;
+        obs_status status = worker_execute_op(args, dl, TEST_CASE_PUT, key, size, NULL, &retry_state, NULL);
+        args->pattern_offset = 0;
+        if (status != OBS_STATUS_OK) continue;
+        if (publish_and_wait(ch, VIS_PHASE_PUT, key, size, stamp) != 0) break;
+
+        status = worker_execute_op(args, dl, TEST_CASE_DELETE, key, 0, NULL, &retry_state, NULL);
+        if (status == OBS_STATUS_OK && publish_and_wait(ch, VIS_PHASE_DELETE, key, size, stamp) != 0) break;
+        args->vis_stats->probes++;
+    }
+
+    pthread_mutex_lock(&ch->lock);
+    ch->phase = VIS_PHASE_STOP;
+    ch->epoch++;
+    pthread_cond_broadcast(&ch->cond);
+    pthread_mutex_unlock(&ch->lock);
+}
+
+// 单次 GET / HEAD: 返回 1 存在, 0 不存在, -1 探测失败; 内容不符每次探测只记一次
+static int read_present(WorkerArgs *args, char *key, long long size, int want_present, int *mismatch_seen) {
+    VisibilityStats *vs = args->vis_stats;
+    char req_id[64] = "-";
+    int mismatch = 0;
+    obs_status status;
+
+    vs->polls++;
+    if (args->config->visibility_read_head) {
+        long long got_size = 0;
+        status = run_head_probe(args, key, &got_size, req_id);
+        mismatch = (status == OBS_STATUS_OK && got_size != size);
+    } else {
+        status = run_get_probe(args, key, &mismatch, req_id);
+    }
+
+    if (status == OBS_STATUS_OK) {
+        if (!mismatch) return 1;
+        if (!*mismatch_seen) {
+            *mismatch_seen = 1;
+            vs->content_mismatch++;
+            LOG_WARN("[VISIBILITY] Content mismatch on %s (ReqID: %s)", key, req_id);
+        }
+        // 内容不对视为新对象尚未可见; 删除阶段则仍算存在
+        return want_present ? 0 : 1;
+    }
+    if (status == OBS_STATUS_NoSuchKey || status == OBS_STATUS_HttpErrorNotFound) return 0;
+    vs->poll_errors++;
+    return -1;
+}
+
+static int list_present(WorkerArgs *args, char *key) {
+    VisibilityStats *vs = args->vis_stats;
+    char req_id[64] = "-";
+    int found = 0;
+    vs->polls++;
+    obs_status status = run_list_probe(args, key, &found, req_id);
+    if (status != OBS_STATUS_OK) {
+        vs->poll_errors++;
+        return -1;
+    }
+    return found;
+}
+
+// 记录一个指标的单次探测结果; done: 0 未观察到, 1 已观察到, 2 已观察到且发生过回退
+static void observe(VisibilityStats *vs, int metric, int present, int want_present, int *done, int first,
+                   long long poll_start_ns, long long ack_ns) {
+    if (present < 0) return;
+    if (present == want_present) {
+        if (!*done) {
+            *done = 1;
+            hist_record(&vs->hist[metric], (poll_start_ns - ack_ns) / 1e6);
+        }
+    } else {
+        if (first) vs->first_miss[metric]++;
+        if (*done == 1) {
+            *done = 2;      // 只记一次回退
+            vs->regressions[metric]++;
+        }
+    }
+}
+
+static void probe_phase(WorkerArgs *args, int phase, char *key, long long size, long long stamp, long long ack_ns) {
+    const Config *cfg = args->config;
+    VisibilityStats *vs = args->vis_stats;
+    int want_present = (phase == VIS_PHASE_PUT);
+    int m_get = want_present ? VIS_GET_AFTER_PUT : VIS_GET_AFTER_DELETE;
+    int m_list = want_present ? VIS_LIST_AFTER_PUT : VIS_LIST_AFTER_DELETE;
+    int get_done = 0, list_done = cfg->visibility_check_list ? 0 : 1;
+    int mismatch_seen = 0;
+    long long deadline_ns = ack_ns + (long long)(cfg->visibility_timeout_ms * 1e6);
+    long long interval_ns = (long long)(cfg->visibility_poll_ms * 1e6);
+
+    // 探测直接调用 SDK 接口, 需自行按 Key 选桶
+    bucket_route(args, key);
+    args->pattern_offset = stamp;
+    for (int first = 1;; first = 0) {
+        long long poll_start = monotonic_now_ns();
+        // GET 在 LIST 满足之前持续轮询, 以便发现状态回退
+        observe(vs, m_get, read_present(args, key, size, want_present, &mismatch_seen), want_present, &get_done, first, poll_start, ack_ns);
+        if (!list_done) {
+            long long list_start = monotonic_now_ns();
+            observe(vs, m_list, list_present(args, key), want_present, &list_done, first, list_start, ack_ns);
+        }
+        if (get_done && list_done) break;
+
+        if (monotonic_now_ns() >= deadline_ns) {
+            if (!get_done) vs->timeouts[m_get]++;
+            if (!list_done) vs->timeouts[m_list]++;
+            LOG_WARN("[VISIBILITY] %s not %s within %.0f ms", key, want_present ? "visible" : "gone", cfg->visibility_timeout_ms);
+            break;
+        }
+        if (worker_should_stop(args, 0, 0)) break;
+        if (interval_ns > 0) sleep_until_ns(poll_start + interval_ns);
+    }
+    args->pattern_offset = 0;
+}
+
+static void reader_loop(WorkerArgs *args) {
+    VisibilityChannel *ch = args->vis_channel;
+    long long seen_epoch = 0;
+    char key[MAX_KEY_LEN];
+
+    for (;;) {
+        pthread_mutex_lock(&ch->lock);
+        while (ch->epoch == seen_epoch && !g_graceful_stop) cond_wait_100ms(ch);
+        if (g_graceful_stop || ch->phase == VIS_PHASE_STOP) {
+            pthread_mutex_unlock(&ch->lock);
+            break;
+        }
+        seen_epoch = ch->epoch;
+        int phase = ch->phase;
+        long long size = ch->size, stamp = ch->stamp, ack_ns = ch->ack_ns;
+        snprintf(key, sizeof(key), "%s", ch->key);
+        pthread_mutex_unlock(&ch->lock);
+
+        probe_phase(args, phase, key, size, stamp, ack_ns);
+
+        pthread_mutex_lock(&ch->lock);
+        ch->pending--;
+        pthread_cond_broadcast(&ch->cond);
+        pthread_mutex_unlock(&ch->lock);
+    }
+}
+
+void visibility_worker_run(WorkerArgs *args, DetailLogState *dl) {
+    if (args->vis_reader) reader_loop(args);
+    else writer_loop(args, dl);
+}
+
+// 输出 visibility.txt: 分指标的可见性时延分位数、直方图 (2 的幂毫秒分档) 与违例计数
+void visibility_save_report(const Config *cfg, const VisibilityStats *stats, int count) {
+    VisibilityStats total;
+    memset(&total, 0, sizeof(total));
+    long long writes = 0;
+    for (int i = 0; i < count; i++) {
+        const VisibilityStats *s = &stats[i];
+        writes += s->probes;
+        total.polls += s->polls;
+        total.poll_errors += s->poll_errors;
+        total.content_mismatch += s->content_mismatch;
+        for (int m = 0; m < VIS_METRICS; m++) {
+            total.first_miss[m] += s->first_miss[m];
+            total.timeouts[m] += s->timeouts[m];
+            total.regressions[m] += s->regressions[m];
+            hist_merge(&total.hist[m], &s->hist[m]);
+        }
+    }
+
+    long long violations = total.content_mismatch;
+    for (int m = 0; m < VIS_METRICS; m++) violations += total.timeouts[m] + total.regressions[m];
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/visibility.txt", cfg->task_log_dir);
+    FILE *fp = fopen(filepath, "w");
+    if (fp) {
+        fprintf(fp, "Readers/Writer:      %d (%s%s)\n", cfg->visibility_readers, cfg->visibility_read_head ? "HEAD" : "GET + content check",
+                cfg->visibility_check_list ? " + LIST" : "");
+        fprintf(fp, "PollInterval:        %.1f ms, Timeout %.0f ms\n", cfg->visibility_poll_ms, cfg->visibility_timeout_ms);
+        fprintf(fp, "Completed Probes:    %lld (PUT + DELETE cycles)\n", writes);
+        fprintf(fp, "Reader Polls:        %lld (errors %lld)\n", total.polls, total.poll_errors);
+        fprintf(fp, "Violations:          %lld (content mismatch %lld)\n\n", violations, total.content_mismatch);
+
+        fprintf(fp, "%-18s %9s %9s %9s %9s %10s %10s %10s %10s\n", "Metric", "Samples", "1stMiss", "Timeout", "Regress",
+                "P50(ms)", "P90(ms)", "P99(ms)", "P99.9(ms)");
+        for (int m = 0; m < VIS_METRICS; m++) {
+            const LatencyHistogram *h = &total.hist[m];
+            if (m % 2 == 1 && !cfg->visibility_check_list) continue;
+            fprintf(fp, "%-18s %9lld %9lld %9lld %9lld %10.2f %10.2f %10.2f %10.2f\n", g_metric_names[m], h->count,
+                    total.first_miss[m], total.timeouts[m], total.regressions[m], hist_percentile(h, 50.0),
+                    hist_percentile(h, 90.0), hist_percentile(h, 99.0), hist_percentile(h, 99.9));
+        }
+
+        fprintf(fp, "\n[Histogram] visibility latency, samples per bucket\n");
+        fprintf(fp, "%-14s", "UpTo(ms)");
+        for (int m = 0; m < VIS_METRICS; m++) fprintf(fp, " %18s", g_metric_names[m]);
+        fprintf(fp, "\n");
+        long long bins[VIS_METRICS][40];
+        memset(bins, 0, sizeof(bins));
+        int max_bin = 0;
+        for (int m = 0; m < VIS_METRICS; m++) {
+            for (int i = 0; i < HIST_BUCKET_COUNT; i++) {
+                if (total.hist[m].buckets[i] == 0) continue;
+                // 分档: <=1ms, <=2ms, <=4ms, ...
+                double ms = hist_bucket_upper_ms(i);
+                int b = 0;
+                while (b < 39 && ms > (double)(1LL << b)) b++;
+                bins[m][b] += total.hist[m].buckets[i];
+                if (b > max_bin) max_bin = b;
+            }
+        }
+        for (int b = 0; b <= max_bin; b++) {
+            fprintf(fp, "%-14lld", 1LL << b);
+            for (int m = 0; m < VIS_METRICS; m++) fprintf(fp, " %18lld", bins[m][b]);
+            fprintf(fp, "\n");
+        }
+        fclose(fp);
+    }
+
+    printf("\n--- Visibility ---\n");
+    printf("Probes:          %lld completed, %lld reader polls, violations %lld\n", writes, total.polls, violations);
+    for (int m = 0; m < VIS_METRICS; m++) {
+        const LatencyHistogram *h = &total.hist[m];
+        if (m % 2 == 1 && !cfg->visibility_check_list) continue;
+        printf("%-17s P50 %.2f | P99 %.2f | P99.9 %.2f ms | 1st-miss %lld | timeout %lld | regress %lld\n", g_metric_names[m],
+               hist_percentile(h, 50.0), hist_percentile(h, 99.0), hist_percentile(h, 99.9),
+               total.first_miss[m], total.timeouts[m], total.regressions[m]);
+    }
+}
@@ -15,26 +15,12 @@ void fill_pattern_buffer(char *buf, size_t size, int seed) {
     }
 }
 
-// SplitMix64-based kernel: extremely fast, good avalanche properties.
-// Perfect for high-performance key prefix generation.
-static inline uint64_t fast_mix64(uint64_t z) {
-    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
-    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
-    return z ^ (z >> 31);
+// 对象 Key 由本线程预编译的 KeyGen 生成 (命名方案见 key_gen.c)
+void worker_format_key(const WorkerArgs *args, int key_owner_id, long long object_seq_id, char *key, size_t len) {
+    key_gen_format(&args->key_gen, key_owner_id, object_seq_id, key, len);
 }
 
-// Ultra-fast u64 to hex using a static lookup table, bypassing snprintf overhead for hex formatting.
-static const char g_hex_lookup[] = "0123456789abcdef";
-static inline void fast_u128_to_hex32(uint64_t v1, uint64_t v2, char *out) {
-    for (int i = 15; i >= 0; i--) {
-        out[i] = g_hex_lookup[v1 & 0xf];
-        v1 >>= 4;
-        out[i + 16] = g_hex_lookup[v2 & 0xf];
-        v2 >>= 4;
-    }
-}
-
-static int infer_http_code(obs_status status) {
+int infer_http_code(obs_status status) {
     switch (status) {
         case OBS_STATUS_AccessDenied:
         case OBS_STATUS_InvalidAccessKeyId:
@@ -69,9 +55,93 @@ static int infer_http_code(obs_status status) {
     }
 }
 
-void *worker_routine(void *arg) {
-    WorkerArgs *args = (WorkerArgs *)arg;
-    
+static obs_status execute_request(WorkerArgs *args, int current_case, char *key, long long req_size,
+                                  char *selected_range, char *req_id) {
+    switch(current_case) {
+        case TEST_CASE_CREATE_BUCKET:
+            return run_create_bucket_benchmark(args, req_id);
+        case TEST_CASE_DELETE_BUCKET:
+            return run_delete_bucket_benchmark(args, req_id);
+        case TEST_CASE_PUT:
+            return run_put_benchmark(args, key, req_size, req_id);
+        case TEST_CASE_GET:
+            return run_get_benchmark(args, key, selected_range, req_id);
+        case TEST_CASE_DELETE:
+            return run_delete_benchmark(args, key, req_id);
+        case TEST_CASE_COPY:
+            return run_copy_benchmark(args, key, req_id);
+        case TEST_CASE_MULTIPART:
+            return run_multipart_benchmark(args, key, req_id);
+        case TEST_CASE_RESUMABLE:
+            return run_upload_file_benchmark(args, key, req_id);
+        case TEST_CASE_HEAD_OBJECT: {
+            long long size = 0;
+            return run_head_probe(args, key, &size, req_id);
+        }
+        case TEST_CASE_LIST_DIR:
+            return run_list_dir_benchmark(args, key, req_id);
+        case TEST_CASE_RENAME:
+            return run_rename_benchmark(args, key, req_id);
+        default:
+            if (current_case >= TEST_CASE_HEAD_BUCKET && current_case <= TEST_CASE_GET_VERSIONING) {
+                return run_bucket_config_benchmark(args, current_case, req_id);
+            }
+            return OBS_STATUS_InternalError;
+    }
+}
+
+static void detail_log_flush(WorkerArgs *args, DetailLogState *dl) {
+    char bucket[160];
+    for (int i = 0; i < dl->batch_count; i++) {
+        const char *bucket_name = bucket, *key = dl->batch_buffer[i].key;
+        if (dl->batch_buffer[i].bucket_index == BUCKET_INDEX_TEMP) {
+            bucket_name = key;
+            key = "-";
+        } else {
+            bucket_format_name(bucket, sizeof(bucket), args->bucket_base, dl->batch_buffer[i].bucket_index);
+        }
+        fprintf(dl->detail_fp, "%.3f,%d,%s,%s,%.2f,%d,%d,%lld,%s\n",
+                dl->batch_buffer[i].timestamp_s, dl->batch_buffer[i].op_type, bucket_name, key,
+                dl->batch_buffer[i].latency_ms, dl->batch_buffer[i].status_code,
+                dl->batch_buffer[i].http_code, dl->batch_buffer[i].bytes, dl->batch_buffer[i].request_id);
+    }
+    dl->total_written_rows += dl->batch_count;
+    dl->batch_count = 0;
+}
+
+// 追加一条明细记录, 攒满 BATCH_SIZE 条后批量写出, 单个文件超过 MAX_ROWS_PER_FILE 行时切换到下一个分片
+void detail_log_record(WorkerArgs *args, DetailLogState *dl, double timestamp_s, int op_type, const char *key,
+                       double latency_ms, obs_status status, int http_code, long long bytes, const char *request_id) {
+    ReqRecord *rec = &dl->batch_buffer[dl->batch_count];
+    rec->timestamp_s = timestamp_s;
+    rec->op_type = op_type;
+    snprintf(rec->key, sizeof(rec->key), "%s", key);
+    rec->latency_ms = latency_ms;
+    rec->status_code = status;
+    rec->http_code = http_code;
+    rec->bytes = bytes;
+    snprintf(rec->request_id, sizeof(rec->request_id), "%s", request_id);
+    rec->bucket_index = args->bucket_index;
+    dl->batch_count++;
+
+    if (dl->batch_count >= BATCH_SIZE) {
+        detail_log_flush(args, dl);
+        if (dl->total_written_rows >= MAX_ROWS_PER_FILE) {
+            fclose(dl->detail_fp);
+            dl->file_part_idx++;
+            dl->total_written_rows = 0;
+            char detail_filename[512];
+            snprintf(detail_filename, sizeof(detail_filename), "%s/detail_%d_part%d.csv", args->config->task_log_dir, args->thread_id, dl->file_part_idx);
+            dl->detail_fp = fopen(detail_filename, "w");
+            if (dl->detail_fp) fprintf(dl->detail_fp, "Timestamp(s),OpType,Bucket,Key,Latency(ms),SDKStatus,HTTPCode,Bytes,RequestID\n");
+        }
+    }
+}
+
+// 分配 pattern buffer 并打开明细日志; 需在 Worker (或承载线程) 自身内调用, 保证内存分配在本地节点
+int worker_setup(WorkerArgs *args, DetailLogState *dl) {
+    memset(dl, 0, sizeof(DetailLogState));
+
     args->pattern_size = PATTERN_BUF_SIZE;
     args->pattern_mask = PATTERN_BUF_SIZE - 1;
     args->pattern_buffer = (char *)malloc(args->pattern_size);
@@ -81,213 +151,348 @@ void *worker_routine(void *arg) {
         args->data_buffer = args->pattern_buffer;
     } else {
         LOG_ERROR("Thread %d failed to allocate pattern buffer", args->thread_id);
-        return NULL;
+        return -1;
     }
+    adapter_build_template(args);
 
-    long long reqs_per_op = args->config->requests_per_thread > 0 ? args->config->requests_per_thread : 1;
-    long long total_planned_requests = 0;
-    
-    if (args->config->use_mix_mode) {
-        total_planned_requests = (long long)args->config->mix_loop_count * args->config->mix_op_count * reqs_per_op;
-    } else {
-        total_planned_requests = (long long)args->config->requests_per_thread;
+    char err[256];
+    if (key_gen_compile(&args->key_gen, args->config, args->username, err, sizeof(err)) != 0) {
+        LOG_ERROR("Thread %d: invalid key naming for user %s: %s", args->thread_id, args->username, err);
+        free(args->pattern_buffer);
+        args->pattern_buffer = NULL;
+        return -1;
     }
 
-    unsigned int thread_seed = (unsigned int)(time(NULL) ^ (long)pthread_self());
-    FILE *detail_fp = NULL;
-    ReqRecord *batch_buffer = NULL;
-    int batch_count = 0;
-    int file_part_idx = 0;
-    long long total_written_rows = 0;
-    char detail_filename[512];
-
     if (args->config->enable_detail_log) {
+        char detail_filename[512];
         snprintf(detail_filename, sizeof(detail_filename), "%s/detail_%d_part%d.csv", 
-                 args->config->task_log_dir, args->thread_id, file_part_idx);
-        detail_fp = fopen(detail_filename, "w");
-        if (detail_fp) {
-            fprintf(detail_fp, "Timestamp(s),OpType,Bucket,Key,Latency(ms),SDKStatus,HTTPCode,Bytes,RequestID\n");
-            batch_buffer = (ReqRecord *)malloc(sizeof(ReqRecord) * BATCH_SIZE);
+                 args->config->task_log_dir, args->thread_id, dl->file_part_idx);
+        dl->detail_fp = fopen(detail_filename, "w");
+        if (dl->detail_fp) {
+            fprintf(dl->detail_fp, "Timestamp(s),OpType,Bucket,Key,Latency(ms),SDKStatus,HTTPCode,Bytes,RequestID\n");
+            dl->batch_buffer = (ReqRecord *)malloc(sizeof(ReqRecord) * BATCH_SIZE);
         }
     }
+    return 0;
+}
+
+void worker_teardown(WorkerArgs *args, DetailLogState *dl) {
+    if (dl->detail_fp) {
+        if (dl->batch_buffer && dl->batch_count > 0) detail_log_flush(args, dl);
+        fclose(dl->detail_fp);
+        dl->detail_fp = NULL;
+    }
+    if (dl->batch_buffer) free(dl->batch_buffer);
+    dl->batch_buffer = NULL;
+    if (args->pattern_buffer) free(args->pattern_buffer);
+    args->pattern_buffer = NULL;
+}
 
-    obs_status status = OBS_STATUS_OK;
-    long long op_index = 0;
-    
-    while (!g_graceful_stop) {
-        struct timespec ts_now;
-        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts_now);
-        double now_ms = ts_now.tv_sec * 1000.0 + ts_now.tv_nsec / 1000000.0;
-        
-        if (now_ms >= args->stop_timestamp_ms) break;
-        if (total_planned_requests > 0 && op_index >= total_planned_requests) break;
-
-        int current_case = args->config->test_case;
-        char *selected_range = NULL;
-        long long object_seq_id = op_index; 
-
-        if (args->config->use_mix_mode) {
-            long long current_block_idx = op_index / reqs_per_op;
-            int mix_idx = current_block_idx % args->config->mix_op_count;
-            current_case = args->config->mix_ops[mix_idx];
-            long long current_loop_iteration = op_index / (args->config->mix_op_count * reqs_per_op);
-            long long current_req_in_block = op_index % reqs_per_op;
-            object_seq_id = current_loop_iteration * reqs_per_op + current_req_in_block;
-        }
+// 多桶建 / 删桶的发起者总数: 用户在各 Agent 上的全部线程 (协程模式下为全部虚拟客户端)
+static long long bucket_clients(const Config *cfg) {
+    return (long long)cfg->threads_per_user * (cfg->agent_count > 1 ? cfg->agent_count : 1) *
+           (cfg->virtual_clients_per_thread > 0 ? cfg->virtual_clients_per_thread : 1);
+}
 
-        char key[MAX_KEY_LEN]; 
-        if (args->config->obj_name_pattern_hash) {
-             // 1. Combine thread_id and object_seq_id for strong determinism
-             uint64_t seed = ((uint64_t)args->thread_id << 32) ^ (uint64_t)object_seq_id;
-             
-             // 2. Generate two 64-bit blocks for a total of 128 bits (32 hex characters)
-             // Using golden ratio constant to maximize dispersion
-             uint64_t part1 = fast_mix64(seed + 0x9e3779b97f4a7c15ULL);
-             uint64_t part2 = fast_mix64(part1 + 0x9e3779b97f4a7c15ULL);
-
-             char hex_prefix[33];
-             fast_u128_to_hex32(part1, part2, hex_prefix);
-             hex_prefix[32] = '\0';
-
-             snprintf(key, sizeof(key), "%s-%s-%s-%d-%lld", hex_prefix, args->config->key_prefix, args->username, args->thread_id, object_seq_id);
-        } else {
-             snprintf(key, sizeof(key), "%s-%s-%d-%lld", args->config->key_prefix, args->username, args->thread_id, object_seq_id);
-        }
+long long worker_planned_requests(const Config *cfg) {
+    long long reqs_per_op = cfg->requests_per_thread > 0 ? cfg->requests_per_thread : 1;
+    if (cfg->use_mix_mode) return (long long)cfg->mix_loop_count * cfg->mix_op_count * reqs_per_op;
+    // 多桶建 / 删桶: 用户在各 Agent 上的全部线程分摊全部桶, 每个桶一次
+    if (cfg->buckets_per_user > 1 && (cfg->test_case == TEST_CASE_CREATE_BUCKET || cfg->test_case == TEST_CASE_DELETE_BUCKET)) {
+        long long clients = bucket_clients(cfg);
+        return (cfg->buckets_per_user + clients - 1) / clients;
+    }
+    return (long long)cfg->requests_per_thread;
+}
 
-        long long current_req_size = args->config->is_dynamic_size ? 
-            (args->config->object_size_min + (rand_r(&thread_seed) % (args->config->object_size_max - args->config->object_size_min + 1))) : 
-            args->config->object_size_max;
+int worker_should_stop(const WorkerArgs *args, long long op_index, long long planned) {
+    if (g_graceful_stop) return 1;
+    struct timespec ts_now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts_now);
+    double now_ms = ts_now.tv_sec * 1000.0 + ts_now.tv_nsec / 1000000.0;
+    if (now_ms >= args->stop_timestamp_ms) return 1;
+    if (planned > 0 && op_index >= planned) return 1;
+    return 0;
+}
 
-        // [核心修改]: 若为多段上传，强制替换 current_req_size 为真实产生的数据量，保证带宽统计准确
-        if (current_case == TEST_CASE_MULTIPART) {
-            long long p_size = args->config->part_size > 0 ? args->config->part_size : (5 * 1024 * 1024);
-            current_req_size = (long long)args->config->parts_for_each_upload_id * p_size;
-        }
+// 混合操作全部为建 / 删桶时, 桶分完后已无事可做
+static int mix_bucket_ops_only(const Config *cfg) {
+    for (int i = 0; i < cfg->mix_op_count; i++) {
+        if (cfg->mix_ops[i] != TEST_CASE_CREATE_BUCKET && cfg->mix_ops[i] != TEST_CASE_DELETE_BUCKET) return 0;
+    }
+    return 1;
+}
+
+// ----------------------------------------------------------
+// 执行一个逻辑请求 (含重试) 并记录统计
+// key_owner_id: 参与 Key 命名的发起者编号 (线程号, 或协程模式下的虚拟客户端号)
+// 返回 1 表示本发起者已没有可执行的请求 (多桶建 / 删桶分到的桶已处理完), 调用方应结束循环
+// ----------------------------------------------------------
+int worker_run_op(WorkerArgs *args, DetailLogState *dl, int key_owner_id, long long op_index,
+                  unsigned int *seed, RetryState *retry_state) {
+    long long reqs_per_op = args->config->requests_per_thread > 0 ? args->config->requests_per_thread : 1;
+    int current_case = args->config->test_case;
+    char *selected_range = NULL;
+    long long object_seq_id = op_index; 
+
+    // 热点 Key 竞争 / 稳态流转: Key 与操作按权重随机选取
+    if (current_case == TEST_CASE_HOTKEY) {
+        hotkey_run_op(args, dl, seed, retry_state);
+        return 0;
+    }
+    if (current_case == TEST_CASE_CHURN) {
+        churn_run_op(args, dl, seed, retry_state);
+        return 0;
+    }
+    if (current_case == TEST_CASE_CONTROL_PLANE) {
+        control_plane_run_cycle(args, dl, key_owner_id, op_index, retry_state);
+        return 0;
+    }
 
-        long long prev_val_count = args->stats.fail_validation_count;
-        struct timeval tv_abs;
-        gettimeofday(&tv_abs, NULL);
-        double abs_timestamp = tv_abs.tv_sec + tv_abs.tv_usec / 1000000.0;
-
-        struct timespec ts_start, ts_end;
-        clock_gettime(CLOCK_MONOTONIC, &ts_start);
-
-        char current_req_id[64] = "-";
-        int current_http_code = 0;
-
-        switch(current_case) {
-            case TEST_CASE_CREATE_BUCKET:
-                status = run_create_bucket_benchmark(args, current_req_id);
-                break;
-            case TEST_CASE_DELETE_BUCKET:
-                status = run_delete_bucket_benchmark(args, current_req_id);
-                break;
-            case TEST_CASE_PUT:
-                status = run_put_benchmark(args, key, current_req_size, current_req_id);
-                break;
-            case TEST_CASE_GET:
-                if (args->config->range_count > 0) {
-                    int r_idx = rand_r(&thread_seed) % args->config->range_count;
-                    selected_range = args->config->range_options[r_idx];
-                }
-                status = run_get_benchmark(args, key, selected_range, current_req_id);
-                break;
-            case TEST_CASE_DELETE:
-                status = run_delete_benchmark(args, key, current_req_id);
-                break;
-            case TEST_CASE_MULTIPART:
-                status = run_multipart_benchmark(args, key, current_req_id);
-                break;
-            case TEST_CASE_RESUMABLE:
-                status = run_upload_file_benchmark(args, key, current_req_id);
-                break;
-            default:
-                status = OBS_STATUS_InternalError;
-                break;
+    if (args->config->use_mix_mode) {
+        long long current_block_idx = op_index / reqs_per_op;
+        int mix_idx = current_block_idx % args->config->mix_op_count;
+        current_case = args->config->mix_ops[mix_idx];
+        long long current_loop_iteration = op_index / (args->config->mix_op_count * reqs_per_op);
+        long long current_req_in_block = op_index % reqs_per_op;
+        object_seq_id = current_loop_iteration * reqs_per_op + current_req_in_block;
+    }
+
+    if (args->config->buckets_per_user > 1 &&
+        (current_case == TEST_CASE_CREATE_BUCKET || current_case == TEST_CASE_DELETE_BUCKET)) {
+        // 桶号按发起者 (Agent 序号 x ThreadsPerUser + 用户内线程号, 协程模式下再展开到虚拟客户端) 交错划分,
+        // 各 Agent / 各虚拟客户端不会重复建 / 删同一个桶
+        const Config *cfg = args->config;
+        long long clients = bucket_clients(cfg);
+        long long client = (long long)cfg->agent_index * cfg->threads_per_user + args->user_thread_idx;
+        if (cfg->virtual_clients_per_thread > 0) {
+            client = client * cfg->virtual_clients_per_thread + key_owner_id % cfg->virtual_clients_per_thread;
         }
+        long long idx = client + object_seq_id * clients;
+        // 混合模式中还有对象操作时只跳过这一步
+        if (idx >= cfg->buckets_per_user) return !cfg->use_mix_mode || mix_bucket_ops_only(cfg);
+        bucket_select(args, (int)idx);
+    }
 
-        clock_gettime(CLOCK_MONOTONIC, &ts_end);
-        double latency_ms = (ts_end.tv_sec - ts_start.tv_sec) * 1000.0 + (ts_end.tv_nsec - ts_start.tv_nsec) / 1000000.0;
+    // Combine thread_id and object_seq_id for strong determinism
+    uint64_t key_seed = ((uint64_t)key_owner_id << 32) ^ (uint64_t)object_seq_id;
+
+    char key[MAX_KEY_LEN]; 
+    worker_format_key(args, key_owner_id, object_seq_id, key, sizeof(key));
+
+    // 对象大小由 Key 确定 (别名表采样), 同一 Key 的读写落在同一大小档位
+    long long current_req_size = args->config->size_table ?
+        size_dist_sample(args->config, key_seed) : args->config->object_size_max;
+
+    // [核心修改]: 若为多段上传，强制替换 current_req_size 为真实产生的数据量，保证带宽统计准确
+    if (current_case == TEST_CASE_MULTIPART) {
+        long long p_size = args->config->part_size > 0 ? args->config->part_size : (5 * 1024 * 1024);
+        current_req_size = (long long)args->config->parts_for_each_upload_id * p_size;
+    }
+
+    if (current_case == TEST_CASE_GET && args->config->range_count > 0) {
+        int r_idx = rand_r(seed) % args->config->range_count;
+        selected_range = args->config->range_options[r_idx];
+    }
+
+    worker_execute_op(args, dl, current_case, key, current_req_size, selected_range, retry_state, NULL);
+    return 0;
+}
+
+// ----------------------------------------------------------
+// 执行一个已确定 操作/Key/大小 的逻辑请求 (含重试), 记录统计与明细日志
+// out_latency_ms 可为 NULL
+// ----------------------------------------------------------
+obs_status worker_execute_op(WorkerArgs *args, DetailLogState *dl, int current_case, char *key, long long current_req_size,
+                             char *selected_range, RetryState *retry_state, double *out_latency_ms) {
+    obs_status status = OBS_STATUS_OK;
+    int carries_data = (current_case == TEST_CASE_PUT || current_case == TEST_CASE_GET ||
+                        current_case == TEST_CASE_MULTIPART || current_case == TEST_CASE_RESUMABLE);
+
+    long long prev_val_count = args->stats.fail_validation_count;
+    long long prev_bytes = args->stats.total_success_bytes;
+    struct timeval tv_abs;
+    gettimeofday(&tv_abs, NULL);
+    double abs_timestamp = tv_abs.tv_sec + tv_abs.tv_usec / 1000000.0;
 
-        if (status == OBS_STATUS_OK && args->stats.fail_validation_count > prev_val_count) {
-            status = OBS_STATUS_InternalError;
+    struct timespec ts_start, ts_end;
+    char current_req_id[64] = "-";
+    int current_http_code = 0;
+    int attempt = 0;
+    double latency_ms = 0;
+
+    // 桶级操作 (建删桶 / 控制面配置) 由调用方选定桶, 对象请求按 Key 路由
+    int bucket_op = (current_case == TEST_CASE_CREATE_BUCKET || current_case == TEST_CASE_DELETE_BUCKET ||
+                     (current_case >= TEST_CASE_HEAD_BUCKET && current_case <= TEST_CASE_GET_VERSIONING));
+    int op_bucket = args->bucket_index;
+
+    // ----------------------------------------------------------
+    // 逻辑请求: 首次尝试 + 按策略重试, 端到端时延包含退避等待
+    // ----------------------------------------------------------
+    for (;;) {
+        // 限速等待在计时之前完成, 不计入请求时延
+        if (args->rate_limit.active) {
+            rate_limit_acquire(args, carries_data ? current_req_size : 0);
         }
+        if (attempt == 0) clock_gettime(CLOCK_MONOTONIC, &ts_start);
+        // 限速与退避等待会让出给同线程的其他虚拟客户端, 桶与接入点的选择保存在共享的 args 中, 每次发送前重新设置
+        if (!bucket_op) bucket_route(args, key);
+        else if (op_bucket >= 0) bucket_select(args, op_bucket);
+        if (args->endpoint_stats) endpoint_route(args, key);
 
-        if (status == OBS_STATUS_OK) {
-            if (current_case == TEST_CASE_GET && selected_range != NULL) current_http_code = 206;
-            else if (current_case == TEST_CASE_DELETE || current_case == TEST_CASE_DELETE_BUCKET) current_http_code = 204;
-            else current_http_code = 200;
-        } else {
-            current_http_code = infer_http_code(status);
-            // 只有当服务端返回明确的 5xx 且有 Request ID 时，才计入 5xx 失败
-            // 否则归类为本地/网络类错误 (HTTP Code 改为 0)，避免干扰服务端压测指标
-            if (current_http_code >= 500 && current_http_code < 600) {
-                if (strcmp(current_req_id, "-") == 0 || strlen(current_req_id) == 0) {
-                    current_http_code = 0;
-                }
-            }
+        struct timespec ts_attempt;
+        clock_gettime(CLOCK_MONOTONIC, &ts_attempt);
+        strcpy(current_req_id, "-");
+        status = execute_request(args, current_case, key, current_req_size, selected_range, current_req_id);
+        attempt++;
+        args->stats.attempt_count++;
+        if (args->aimd) aimd_on_result(args->aimd, status, carries_data ? current_req_size : 0);
+
+        clock_gettime(CLOCK_MONOTONIC, &ts_end);
+        if (attempt == 1) {
+            double first_ms = (ts_end.tv_sec - ts_attempt.tv_sec) * 1000.0 + (ts_end.tv_nsec - ts_attempt.tv_nsec) / 1000000.0;
+            hist_record(&args->stats.first_attempt_hist, first_ms);
         }
 
-        if (detail_fp && batch_buffer) {
-            batch_buffer[batch_count].timestamp_s = abs_timestamp;
-            batch_buffer[batch_count].op_type = current_case;
-            snprintf(batch_buffer[batch_count].key, sizeof(batch_buffer[batch_count].key), "%s", key);
-            batch_buffer[batch_count].latency_ms = latency_ms;
-            batch_buffer[batch_count].status_code = status;
-            batch_buffer[batch_count].http_code = current_http_code;
-            batch_buffer[batch_count].bytes = current_req_size;
-            snprintf(batch_buffer[batch_count].request_id, sizeof(batch_buffer[batch_count].request_id), "%s", current_req_id);
-            batch_count++;
-
-            if (batch_count >= BATCH_SIZE) {
-                for (int i = 0; i < batch_count; i++) {
-                    fprintf(detail_fp, "%.3f,%d,%s,%s,%.2f,%d,%d,%lld,%s\n",
-                            batch_buffer[i].timestamp_s, batch_buffer[i].op_type, args->effective_bucket, batch_buffer[i].key,
-                            batch_buffer[i].latency_ms, batch_buffer[i].status_code,
-                            batch_buffer[i].http_code, batch_buffer[i].bytes, batch_buffer[i].request_id);
-                }
-                total_written_rows += batch_count;
-                batch_count = 0;
-                if (total_written_rows >= MAX_ROWS_PER_FILE) {
-                    fclose(detail_fp);
-                    file_part_idx++;
-                    total_written_rows = 0;
-                    snprintf(detail_filename, sizeof(detail_filename), "%s/detail_%d_part%d.csv", args->config->task_log_dir, args->thread_id, file_part_idx);
-                    detail_fp = fopen(detail_filename, "w");
-                    if (detail_fp) fprintf(detail_fp, "Timestamp(s),OpType,Bucket,Key,Latency(ms),SDKStatus,HTTPCode,Bytes,RequestID\n");
-                }
+        int validation_failed = (args->stats.fail_validation_count > prev_val_count);
+        if (!retry_policy_should_retry(args, status, attempt, validation_failed)) break;
+
+        args->stats.retry_count++;
+        retry_policy_sleep(args->config, retry_state, attempt);
+    }
+
+    latency_ms = (ts_end.tv_sec - ts_start.tv_sec) * 1000.0 + (ts_end.tv_nsec - ts_start.tv_nsec) / 1000000.0;
+    stats_record_latency(&args->stats, latency_ms);
+    retry_budget_deposit(args->retry_budget);
+
+    if (status == OBS_STATUS_OK && args->stats.fail_validation_count > prev_val_count) {
+        status = OBS_STATUS_InternalError;
+    }
+
+    if (status == OBS_STATUS_OK) {
+        if (current_case == TEST_CASE_GET && selected_range != NULL) current_http_code = 206;
+        else if (current_case == TEST_CASE_DELETE || current_case == TEST_CASE_DELETE_BUCKET) current_http_code = 204;
+        else current_http_code = 200;
+    } else {
+        current_http_code = infer_http_code(status);
+        // 只有当服务端返回明确的 5xx 且有 Request ID 时，才计入 5xx 失败
+        // 否则归类为本地/网络类错误 (HTTP Code 改为 0)，避免干扰服务端压测指标
+        if (current_http_code >= 500 && current_http_code < 600) {
+            if (strcmp(current_req_id, "-") == 0 || strlen(current_req_id) == 0) {
+                current_http_code = 0;
             }
         }
+    }
 
-        if (status == OBS_STATUS_OK) {
-            args->stats.success_count++;
-        } else {
-            if (args->stats.fail_validation_count == prev_val_count) {
-                if (current_http_code == 403) args->stats.fail_403_count++;
-                else if (current_http_code == 404) args->stats.fail_404_count++;
-                else if (current_http_code == 409) args->stats.fail_409_count++;
-                else if (current_http_code >= 400 && current_http_code < 500) args->stats.fail_4xx_other_count++;
-                else if (current_http_code >= 500 && current_http_code < 600) args->stats.fail_5xx_count++;
-                else args->stats.fail_other_count++;
-                usleep(50000); 
-            }
+    if (dl->detail_fp && dl->batch_buffer) {
+        detail_log_record(args, dl, abs_timestamp, current_case, key, latency_ms, status, current_http_code,
+                          current_req_size, current_req_id);
+    }
+
+    if (args->size_classes) {
+        size_class_record(&args->size_classes[size_class_of(args->config, current_req_size)], status == OBS_STATUS_OK,
+                          args->stats.total_success_bytes - prev_bytes, latency_ms);
+    }
+
+    if (args->bucket_stats && args->bucket_index >= 0) {
+        BucketStats *bs = &args->bucket_stats[args->bucket_index];
+        if (status == OBS_STATUS_OK) bs->success_count++;
+        else bs->fail_count++;
+        if (status == OBS_STATUS_SlowDown || status == OBS_STATUS_ServiceUnavailable) bs->throttled_count++;
+        bs->bytes += args->stats.total_success_bytes - prev_bytes;
+        bs->total_latency_ms += latency_ms;
+        if (latency_ms > bs->max_latency_ms) bs->max_latency_ms = latency_ms;
+    }
+
+    if (args->endpoint_stats) {
+        endpoint_record(args, status == OBS_STATUS_OK, current_http_code, args->stats.total_success_bytes - prev_bytes,
+                        latency_ms);
+    }
+
+    if (status == OBS_STATUS_OK) {
+        args->stats.success_count++;
+    } else {
+        if (args->stats.fail_validation_count == prev_val_count) {
+            if (current_http_code == 403) args->stats.fail_403_count++;
+            else if (current_http_code == 404) args->stats.fail_404_count++;
+            else if (current_http_code == 409) args->stats.fail_409_count++;
+            else if (current_http_code >= 400 && current_http_code < 500) args->stats.fail_4xx_other_count++;
+            else if (current_http_code >= 500 && current_http_code < 600) args->stats.fail_5xx_count++;
+            else args->stats.fail_other_count++;
+            // 最终失败后按退避策略冷却 (带抖动), 避免所有线程同步回归
+            retry_policy_sleep(args->config, retry_state, attempt);
         }
+    }
+    if (out_latency_ms) *out_latency_ms = latency_ms;
+    return status;
+}
+
+static long long thread_cpu_ns(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void worker_dispatch(WorkerArgs *args, DetailLogState *dl) {
+    // 回放模式: 按计划时刻执行读取线程分发的记录
+    if (args->config->test_case == TEST_CASE_TRACE) {
+        trace_worker_run(args, dl);
+        return;
+    }
+
+    if (args->config->test_case == TEST_CASE_VISIBILITY) {
+        visibility_worker_run(args, dl);
+        return;
+    }
+
+    if (args->config->test_case == TEST_CASE_PFS_TREE) {
+        pfs_tree_worker_run(args, dl);
+        return;
+    }
+
+    if (args->config->test_case == TEST_CASE_CONN_COST) {
+        conn_cost_worker_run(args, dl);
+        return;
+    }
+
+    // 协程模式: 本线程作为承载线程, 调度多个虚拟客户端
+    if (args->config->virtual_clients_per_thread > 0) {
+        fiber_carrier_run(args, dl);
+        return;
+    }
+
+    long long total_planned_requests = worker_planned_requests(args->config);
+    unsigned int thread_seed = (unsigned int)(time(NULL) ^ (long)pthread_self());
+    RetryState retry_state = { thread_seed ^ 0x5bd1e995u, 0.0 };
+
+    int paced = (args->config->think_time_dist != THINK_DIST_NONE);
+    PacingState pacing;
+    pacing_init(&pacing, 0);
+
+    long long op_index = 0;
+    while (!worker_should_stop(args, op_index, total_planned_requests)) {
+        if (paced) pacing_begin_op(args, &pacing);
+        int done = worker_run_op(args, dl, args->thread_id, op_index, &thread_seed, &retry_state);
         op_index++;
+        if (paced) pacing_end_op(args, &pacing, &thread_seed);
+        if (done) break;
     }
+}
 
-    if (detail_fp) {
-        if (batch_buffer && batch_count > 0) {
-            for (int i = 0; i < batch_count; i++) {
-                fprintf(detail_fp, "%.3f,%d,%s,%s,%.2f,%d,%d,%lld,%s\n",
-                        batch_buffer[i].timestamp_s, batch_buffer[i].op_type, args->effective_bucket, batch_buffer[i].key,
-                        batch_buffer[i].latency_ms, batch_buffer[i].status_code,
-                        batch_buffer[i].http_code, batch_buffer[i].bytes, batch_buffer[i].request_id);
-            }
-        }
-        fclose(detail_fp);
+void *worker_routine(void *arg) {
+    WorkerArgs *args = (WorkerArgs *)arg;
+    DetailLogState dl;
+    if (worker_setup(args, &dl) != 0) {
+        if (args->pfs) pfs_tree_leave(args->pfs);
+        if (args->conn_cost) conn_cost_leave(args->conn_cost);
+        return NULL;
     }
-    if (batch_buffer) free(batch_buffer);
-    if (args->pattern_buffer) free(args->pattern_buffer);
+
+    // 线程 CPU 时间不含阻塞等待, 即客户端自身 (SDK + 工具) 的开销
+    long long cpu_start = thread_cpu_ns();
+    worker_dispatch(args, &dl);
+    args->stats.cpu_ns += thread_cpu_ns() - cpu_start;
+
+    worker_teardown(args, &dl);
     return NULL;
 }
-